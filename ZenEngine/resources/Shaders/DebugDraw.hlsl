@@ -0,0 +1,43 @@
+#include "ZenShaderLib.hlsl"
+
+struct Vertex
+{
+    float3 Position: POSITION;
+    float4 Color: COLOR;
+    float DepthTest: TEXCOORD0;
+};
+
+struct Interpolators
+{
+    float4 Position: SV_POSITION;
+    float4 Color: COLOR;
+    float4 ClipPosition: TEXCOORD0;
+    float DepthTest: TEXCOORD1;
+};
+
+// depth of the scene, the debug geometry is drawn over the final image which has none
+Texture2D SceneDepth: register(t0);
+SamplerState SceneDepth_Sampler: register(s0);
+
+Interpolators VSMain(Vertex v)
+{
+    Interpolators i;
+    i.Position = mul(ZE_ViewProjectionMatrix, float4(v.Position, 1.0f));
+    i.Color = v.Color;
+    i.ClipPosition = i.Position;
+    i.DepthTest = v.DepthTest;
+    return i;
+}
+
+float4 PSMain(Interpolators i)
+{
+    float3 ndc = i.ClipPosition.xyz / i.ClipPosition.w;
+    if (i.DepthTest > 0.5f)
+    {
+        float sceneDepth = SceneDepth.Sample(SceneDepth_Sampler, ndc.xy * 0.5f + 0.5f).r;
+        // compared in view space with some slack, so lines lying on a surface do not flicker
+        if (LinearizeDepth(ndc.z * 0.5f + 0.5f) > LinearizeDepth(sceneDepth) * 1.001f)
+            discard;
+    }
+    return i.Color;
+}
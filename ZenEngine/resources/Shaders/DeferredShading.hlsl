@@ -18,7 +18,7 @@ Texture2D Normal: register(t1);
 SamplerState Normal_Sampler: register(s1);
 
 Texture2D Shininess : register(t2);
-SamplerState Shininess_Sampler : register(t2);
+SamplerState Shininess_Sampler : register(s2);
 
 Texture2D Depth: register(t3);
 SamplerState Depth_Sampler: register(s3);
@@ -0,0 +1,22 @@
+#include "ZenShaderLib.hlsl"
+
+struct Vertex
+{
+    float3 Position: POSITION;
+};
+
+struct Interpolators
+{
+    float4 Position: SV_POSITION;
+};
+
+Interpolators VSMain(Vertex v)
+{
+    Interpolators i;
+    i.Position = ObjectToClipPosition(v.Position);
+    return i;
+}
+
+void PSMain(Interpolators i)
+{
+}
@@ -0,0 +1,29 @@
+#include "ZenShaderLib.hlsl"
+
+// the full static mesh layout is declared so the instance attributes land on the same locations as in the material shaders
+struct Vertex
+{
+    float3 Position: POSITION;
+    float3 Normal: NORMAL;
+    float2 TexCoord: TEXCOORD;
+    float4 Instance0: INSTANCE0;
+    float4 Instance1: INSTANCE1;
+    float4 Instance2: INSTANCE2;
+    float4 Instance3: INSTANCE3;
+};
+
+struct Interpolators
+{
+    float4 Position: SV_POSITION;
+};
+
+Interpolators VSMain(Vertex v)
+{
+    Interpolators i;
+    i.Position = InstanceToClipPosition(v.Position, GetInstanceMatrix(v.Instance0, v.Instance1, v.Instance2, v.Instance3));
+    return i;
+}
+
+void PSMain(Interpolators i)
+{
+}
@@ -0,0 +1,56 @@
+#include "ZenShaderLib.hlsl"
+
+// the per particle data is a single matrix so it steps per instance on every backend.
+// first column is the world position and the size, second the color, the rest is unused
+struct Vertex
+{
+    float2 Corner: POSITION;
+    float4 Instance0: INSTANCE0;
+    float4 Instance1: INSTANCE1;
+    float4 Instance2: INSTANCE2;
+    float4 Instance3: INSTANCE3;
+};
+
+struct Interpolators
+{
+    float4 Position: SV_POSITION;
+    float4 Color: COLOR;
+    float2 TexCoord: TEXCOORD0;
+    float4 ClipPosition: TEXCOORD1;
+};
+
+// depth of the scene, the particles are drawn over the final image which has none
+Texture2D SceneDepth: register(t0);
+SamplerState SceneDepth_Sampler: register(s0);
+Texture2D ParticleTexture: register(t1);
+SamplerState ParticleTexture_Sampler: register(s1);
+
+// view space distance over which particles fade out in front of the scene, hides the cut where they cross it
+static const float SoftDistance = 0.25f;
+
+Interpolators VSMain(Vertex v)
+{
+    float3 right = mul(ZE_InverseViewMatrix, float4(1.0f, 0.0f, 0.0f, 0.0f)).xyz;
+    float3 up = mul(ZE_InverseViewMatrix, float4(0.0f, 1.0f, 0.0f, 0.0f)).xyz;
+    float3 position = v.Instance0.xyz + (right * v.Corner.x + up * v.Corner.y) * v.Instance0.w;
+
+    Interpolators i;
+    i.Position = mul(ZE_ViewProjectionMatrix, float4(position, 1.0f));
+    i.Color = v.Instance1;
+    i.TexCoord = v.Corner + 0.5f;
+    i.ClipPosition = i.Position;
+    return i;
+}
+
+float4 PSMain(Interpolators i)
+{
+    float3 ndc = i.ClipPosition.xyz / i.ClipPosition.w;
+    float sceneDepth = SceneDepth.Sample(SceneDepth_Sampler, ndc.xy * 0.5f + 0.5f).r;
+    float fade = saturate((LinearizeDepth(sceneDepth) - LinearizeDepth(ndc.z * 0.5f + 0.5f)) / SoftDistance);
+    if (fade <= 0.0f)
+        discard;
+
+    float4 color = ParticleTexture.Sample(ParticleTexture_Sampler, i.TexCoord) * i.Color;
+    color.a *= fade;
+    return color;
+}
@@ -0,0 +1,51 @@
+// sprites are transformed on the CPU while they are batched, the vertices arrive in clip space
+struct Vertex
+{
+    float4 Position: POSITION;
+    float4 Color: COLOR;
+    float2 TexCoord: TEXCOORD0;
+    float TextureIndex: TEXCOORD1;
+};
+
+struct Interpolators
+{
+    float4 Position: SV_POSITION;
+    float4 Color: COLOR;
+    float2 TexCoord: TEXCOORD0;
+    float TextureIndex: TEXCOORD1;
+};
+
+// one register per texture of the batch, picked by the index stored in the vertices
+#define SPRITE_TEXTURE(n) Texture2D Texture##n: register(t##n); SamplerState Texture##n##_Sampler: register(s##n);
+SPRITE_TEXTURE(0)  SPRITE_TEXTURE(1)  SPRITE_TEXTURE(2)  SPRITE_TEXTURE(3)
+SPRITE_TEXTURE(4)  SPRITE_TEXTURE(5)  SPRITE_TEXTURE(6)  SPRITE_TEXTURE(7)
+SPRITE_TEXTURE(8)  SPRITE_TEXTURE(9)  SPRITE_TEXTURE(10) SPRITE_TEXTURE(11)
+SPRITE_TEXTURE(12) SPRITE_TEXTURE(13) SPRITE_TEXTURE(14) SPRITE_TEXTURE(15)
+
+#define SPRITE_SAMPLE(n) case n: return Texture##n.Sample(Texture##n##_Sampler, texCoord);
+float4 SampleSpriteTexture(uint index, float2 texCoord)
+{
+    switch (index)
+    {
+    SPRITE_SAMPLE(0)  SPRITE_SAMPLE(1)  SPRITE_SAMPLE(2)  SPRITE_SAMPLE(3)
+    SPRITE_SAMPLE(4)  SPRITE_SAMPLE(5)  SPRITE_SAMPLE(6)  SPRITE_SAMPLE(7)
+    SPRITE_SAMPLE(8)  SPRITE_SAMPLE(9)  SPRITE_SAMPLE(10) SPRITE_SAMPLE(11)
+    SPRITE_SAMPLE(12) SPRITE_SAMPLE(13) SPRITE_SAMPLE(14) SPRITE_SAMPLE(15)
+    default: return float4(1.0f, 1.0f, 1.0f, 1.0f);
+    }
+}
+
+Interpolators VSMain(Vertex v)
+{
+    Interpolators i;
+    i.Position = v.Position;
+    i.Color = v.Color;
+    i.TexCoord = v.TexCoord;
+    i.TextureIndex = v.TextureIndex;
+    return i;
+}
+
+float4 PSMain(Interpolators i)
+{
+    return SampleSpriteTexture((uint)(i.TextureIndex + 0.5f), i.TexCoord) * i.Color;
+}
@@ -0,0 +1,113 @@
+#include "ZenShaderLib.hlsl"
+
+// the per patch data is a single matrix so it steps per instance on every backend.
+// first column is the patch origin on the xz plane, its size and level, second the distances its morph starts and ends at
+struct Vertex
+{
+    float2 GridPosition: POSITION;
+    float4 Instance0: INSTANCE0;
+    float4 Instance1: INSTANCE1;
+    float4 Instance2: INSTANCE2;
+    float4 Instance3: INSTANCE3;
+};
+
+struct Interpolators
+{
+    float4 Position: SV_POSITION;
+    float3 Normal: NORMAL;
+    float2 WorldPosition: TEXCOORD0;
+};
+
+struct GBufferOutput
+{
+    float4 BaseColor: SV_Target0;
+    float4 Normal: SV_Target1;
+    float4 Material: SV_Target2;
+};
+
+Texture2D BaseColorTexture: register(t0);
+SamplerState BaseColorTexture_Sampler: register(s0);
+// the clipmap levels stacked vertically, level 0 at the top
+Texture2D HeightClipmap: register(t1);
+SamplerState HeightClipmap_Sampler: register(s1);
+
+// clipmap center in samples, sample spacing, level count
+float4 ClipmapParameters;
+// the patches are clamped to the terrain
+float2 TerrainSize;
+float3 BaseColor;
+float Specular;
+float Shininess;
+float TextureScale;
+
+static const float PatchResolution = 32.0f;
+static const float ClipmapResolution = 256.0f;
+// texels kept free at the border of a level for the bilinear filter and the normal
+static const float ClipmapBorder = 2.0f;
+
+// the finest level whose area holds the position, so a position reads the same height from any patch
+float GetClipmapLevel(float2 samplePosition)
+{
+    float2 offset = abs(samplePosition - ClipmapParameters.xy);
+    float distance = max(offset.x, offset.y) / (ClipmapResolution * 0.5f - ClipmapBorder);
+    return clamp(ceil(log2(max(distance, 1.0f))), 0.0f, ClipmapParameters.w - 1.0f);
+}
+
+float SampleClipmap(float2 samplePosition, float level)
+{
+    float2 texel = (samplePosition - ClipmapParameters.xy) / exp2(level) + ClipmapResolution * 0.5f;
+    // never filter across two levels
+    texel = clamp(texel, 0.0f, ClipmapResolution - 1.0f);
+    float2 texCoord = float2(texel.x + 0.5f, texel.y + 0.5f + level * ClipmapResolution) / float2(ClipmapResolution, ClipmapResolution * ClipmapParameters.w);
+    return HeightClipmap.SampleLevel(HeightClipmap_Sampler, texCoord, 0.0f).r;
+}
+
+float SampleHeight(float2 localPosition)
+{
+    float2 samplePosition = localPosition / ClipmapParameters.z;
+    return SampleClipmap(samplePosition, GetClipmapLevel(samplePosition));
+}
+
+float3 SampleNormal(float2 localPosition)
+{
+    float2 samplePosition = localPosition / ClipmapParameters.z;
+    float level = GetClipmapLevel(samplePosition);
+    float step = exp2(level);
+    float left = SampleClipmap(samplePosition - float2(step, 0.0f), level);
+    float right = SampleClipmap(samplePosition + float2(step, 0.0f), level);
+    float back = SampleClipmap(samplePosition - float2(0.0f, step), level);
+    float front = SampleClipmap(samplePosition + float2(0.0f, step), level);
+    return normalize(float3(left - right, 2.0f * step * ClipmapParameters.z, back - front));
+}
+
+Interpolators VSMain(Vertex v)
+{
+    float2 origin = v.Instance0.xy;
+    float quadSize = v.Instance0.z / PatchResolution;
+
+    // the distance is taken at the unmorphed position, then the odd vertices slide onto the even ones
+    float2 localPosition = min(origin + v.GridPosition * quadSize, TerrainSize);
+    float3 worldPosition = mul(ZE_ModelMatrix, float4(localPosition.x, SampleHeight(localPosition), localPosition.y, 1.0f)).xyz;
+    float morph = saturate((distance(worldPosition, ZE_EyePosition) - v.Instance1.x) / (v.Instance1.y - v.Instance1.x));
+    float2 gridPosition = v.GridPosition - frac(v.GridPosition * 0.5f) * 2.0f * morph;
+
+    localPosition = min(origin + gridPosition * quadSize, TerrainSize);
+    float4 position = mul(ZE_ModelMatrix, float4(localPosition.x, SampleHeight(localPosition), localPosition.y, 1.0f));
+
+    Interpolators i;
+    i.Position = mul(ZE_ViewProjectionMatrix, position);
+    i.Normal = SampleNormal(localPosition);
+    i.WorldPosition = position.xz;
+    return i;
+}
+
+GBufferOutput PSMain(Interpolators i)
+{
+    float3 baseColor = BaseColor * BaseColorTexture.Sample(BaseColorTexture_Sampler, i.WorldPosition * TextureScale).rgb;
+
+    GBufferOutput output;
+    output.BaseColor = float4(baseColor, Specular);
+    output.Normal = float4(PackNormals(normalize(i.Normal)), 1.0f);
+    output.Material = float4(NormalizeShininess(Shininess), 0.0f, 0.0f, 1.0f);
+    return output;
+}
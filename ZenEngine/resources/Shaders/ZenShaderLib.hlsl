@@ -58,3 +58,29 @@ float GetShininessFromNormalizedValue(float nShininess)
 {
     return nShininess * ZE_MAX_SHININESS;
 }
+
+// transforms an object space position to clip space.
+// geometry shaders should use this so their depth matches the depth pre-pass, the geometry pass tests LESS_EQUAL
+// against it when the pre-pass is enabled. precise keeps the compiler from fusing or reordering the math differently
+// in each shader, so the same input gives the same bits in the pre-pass and in the material
+float4 ObjectToClipPosition(float3 osPosition)
+{
+    precise float4 position = mul(ZE_ViewProjectionMatrix, mul(ZE_ModelMatrix, float4(osPosition, 1.0f)));
+    return position;
+}
+
+
+// instanced geometry receives its transform as four per instance float4 attributes holding the matrix columns,
+// declared right after the mesh attributes, e.g. float4 Instance0: INSTANCE0 ... float4 Instance3: INSTANCE3.
+// the instance transform is relative to ZE_ModelMatrix
+float4x4 GetInstanceMatrix(float4 column0, float4 column1, float4 column2, float4 column3)
+{
+    return transpose(float4x4(column0, column1, column2, column3));
+}
+
+// the instanced counterpart of ObjectToClipPosition, instanced geometry shaders should use it for the same reason
+float4 InstanceToClipPosition(float3 osPosition, float4x4 instance)
+{
+    precise float4 position = mul(ZE_ViewProjectionMatrix, mul(ZE_ModelMatrix, mul(instance, float4(osPosition, 1.0f))));
+    return position;
+}
@@ -1,5 +1,6 @@
 #include "GLFWWindow.h"
 #include "ZenEngine/Core/Log.h"
+#include "ZenEngine/Core/Platform.h"
 #include "ZenEngine/Event/EventBus.h"
 #include "ZenEngine/Event/WindowEvents.h"
 #include "ZenEngine/Event/KeyEvents.h"
@@ -31,10 +32,13 @@ namespace ZenEngine
 
     void GLFWWindow::SetVSync(bool inEnabled)
     {
+    // without a GL context there is no swap interval, the software renderer does not present
+    #ifndef ZE_RENDERER_PLATFORM_SOFTWARE
         if (inEnabled)
             glfwSwapInterval(1);
         else
             glfwSwapInterval(0);
+    #endif
         mWindowData.VSync = inEnabled;
     }
 
@@ -64,6 +68,9 @@ namespace ZenEngine
             }
         }
 
+    #ifdef ZE_RENDERER_PLATFORM_SOFTWARE
+        glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
+    #endif
         mWindowHandle = glfwCreateWindow(mWindowData.Width, mWindowData.Height, mWindowData.Title.c_str(), nullptr, nullptr);
         glfwSetWindowUserPointer(mWindowHandle, &mWindowData);
         sGLFWWindowCount++;
@@ -0,0 +1,96 @@
+#include "OpenGLGLFWResourceLoader.h"
+
+#include <GLFW/glfw3.h>
+
+#include "ZenEngine/Core/Macros.h"
+
+namespace ZenEngine
+{
+    OpenGLGLFWResourceLoader::OpenGLGLFWResourceLoader(GLFWwindow *inMainWindow)
+    {
+        // windows can only be created on the main thread, the loader thread just makes the context current
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+        mLoaderWindow = glfwCreateWindow(1, 1, "ZenEngine Loader", nullptr, inMainWindow);
+        glfwWindowHint(GLFW_VISIBLE, GLFW_TRUE);
+        ZE_ASSERT_CORE_MSG(mLoaderWindow != nullptr, "Could not create the loader context!");
+        mThread = std::thread(&OpenGLGLFWResourceLoader::ThreadLoop, this);
+    }
+
+    OpenGLGLFWResourceLoader::~OpenGLGLFWResourceLoader()
+    {
+        {
+            std::scoped_lock lock(mMutex);
+            mStopping = true;
+        }
+        mCondition.notify_one();
+        mThread.join();
+
+        // the loads that did not finish are dropped, their resources with them
+        for (auto &finished : mFinished)
+            glDeleteSync(finished.Fence);
+        glfwDestroyWindow(mLoaderWindow);
+    }
+
+    void OpenGLGLFWResourceLoader::Enqueue(Job inLoad, Job inReady)
+    {
+        {
+            std::scoped_lock lock(mMutex);
+            mQueue.push_back({ std::move(inLoad), std::move(inReady) });
+        }
+        mCondition.notify_one();
+    }
+
+    void OpenGLGLFWResourceLoader::Update()
+    {
+        std::deque<FinishedLoad> ready;
+        {
+            std::scoped_lock lock(mMutex);
+            while (!mFinished.empty())
+            {
+                GLenum status = glClientWaitSync(mFinished.front().Fence, 0, 0);
+                if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) break;
+                glDeleteSync(mFinished.front().Fence);
+                ready.push_back(std::move(mFinished.front()));
+                mFinished.pop_front();
+            }
+        }
+        // outside the lock, a callback may enqueue another load
+        for (auto &finished : ready)
+            finished.Ready();
+    }
+
+    uint32_t OpenGLGLFWResourceLoader::GetPendingCount() const
+    {
+        std::scoped_lock lock(mMutex);
+        return static_cast<uint32_t>(mQueue.size() + mFinished.size()) + mRunning;
+    }
+
+    void OpenGLGLFWResourceLoader::ThreadLoop()
+    {
+        glfwMakeContextCurrent(mLoaderWindow);
+        // unpack state is per context, the same as the main one
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        while (true)
+        {
+            Load load;
+            {
+                std::unique_lock lock(mMutex);
+                mCondition.wait(lock, [this]() { return mStopping || !mQueue.empty(); });
+                if (mStopping) break;
+                load = std::move(mQueue.front());
+                mQueue.pop_front();
+                ++mRunning;
+            }
+
+            load.Run();
+            GLsync fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            // the fence has to reach the GPU before the main context can see it signal
+            glFlush();
+
+            std::scoped_lock lock(mMutex);
+            mFinished.push_back({ fence, std::move(load.Ready) });
+            --mRunning;
+        }
+        glfwMakeContextCurrent(nullptr);
+    }
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "ZenEngine/Renderer/ResourceLoader.h"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <glad/glad.h>
+
+class GLFWwindow;
+
+namespace ZenEngine
+{
+    /// @brief Runs the loads on a thread of its own, current to a hidden window whose context shares objects
+    /// with the main one. Each load is followed by a fence, its ready callback runs once the fence has signaled
+    class OpenGLGLFWResourceLoader : public ResourceLoader
+    {
+    public:
+        OpenGLGLFWResourceLoader(GLFWwindow *inMainWindow);
+        virtual ~OpenGLGLFWResourceLoader();
+
+        virtual void Enqueue(Job inLoad, Job inReady) override;
+        virtual void Update() override;
+        virtual uint32_t GetPendingCount() const override;
+    private:
+        struct Load
+        {
+            Job Run;
+            Job Ready;
+        };
+
+        struct FinishedLoad
+        {
+            GLsync Fence;
+            Job Ready;
+        };
+
+        GLFWwindow *mLoaderWindow = nullptr;
+        std::thread mThread;
+        mutable std::mutex mMutex;
+        std::condition_variable mCondition;
+        std::deque<Load> mQueue;
+        std::deque<FinishedLoad> mFinished;
+        // taken off the queue and still running
+        uint32_t mRunning = 0;
+        bool mStopping = false;
+
+        void ThreadLoop();
+    };
+}
@@ -0,0 +1,42 @@
+#include "OpenGLGPUTimer.h"
+
+#include <glad/glad.h>
+
+namespace ZenEngine
+{
+    OpenGLGPUTimer::OpenGLGPUTimer()
+    {
+        glCreateQueries(GL_TIME_ELAPSED, sQueryCount, mQueries.data());
+        mPending.fill(false);
+    }
+
+    OpenGLGPUTimer::~OpenGLGPUTimer()
+    {
+        glDeleteQueries(sQueryCount, mQueries.data());
+    }
+
+    void OpenGLGPUTimer::Begin()
+    {
+        // collect the result of the query we are about to reuse, if the GPU is done with it
+        uint32_t query = mQueries[mCurrentQuery];
+        if (mPending[mCurrentQuery])
+        {
+            GLint available = GL_FALSE;
+            glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+            if (available)
+            {
+                GLuint64 elapsed = 0;
+                glGetQueryObjectui64v(query, GL_QUERY_RESULT, &elapsed);
+                mElapsedMilliseconds = static_cast<float>(elapsed) / 1000000.0f;
+            }
+        }
+        glBeginQuery(GL_TIME_ELAPSED, query);
+    }
+
+    void OpenGLGPUTimer::End()
+    {
+        glEndQuery(GL_TIME_ELAPSED);
+        mPending[mCurrentQuery] = true;
+        mCurrentQuery = (mCurrentQuery + 1) % sQueryCount;
+    }
+}
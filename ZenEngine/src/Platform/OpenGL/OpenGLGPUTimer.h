@@ -0,0 +1,30 @@
+#pragma once
+
+#include "ZenEngine/Renderer/GPUTimer.h"
+
+#include <array>
+#include <stdint.h>
+
+namespace ZenEngine
+{
+    class OpenGLGPUTimer : public GPUTimer
+    {
+    public:
+        OpenGLGPUTimer();
+        virtual ~OpenGLGPUTimer();
+
+        virtual void Begin() override;
+        virtual void End() override;
+
+        virtual float GetElapsedMilliseconds() const override { return mElapsedMilliseconds; }
+
+    private:
+        // queries are recycled in a ring so we only read results that are a few frames old
+        static constexpr uint32_t sQueryCount = 4;
+
+        std::array<uint32_t, sQueryCount> mQueries;
+        std::array<bool, sQueryCount> mPending;
+        uint32_t mCurrentQuery = 0;
+        float mElapsedMilliseconds = 0.0f;
+    };
+}
@@ -0,0 +1,60 @@
+#include "OpenGLOcclusionQuery.h"
+
+#include <glad/glad.h>
+
+namespace ZenEngine
+{
+    OpenGLOcclusionQueryPool::~OpenGLOcclusionQueryPool()
+    {
+        if (!mQueries.empty())
+            glDeleteQueries(static_cast<GLsizei>(mQueries.size()), mQueries.data());
+    }
+
+    void OpenGLOcclusionQueryPool::Reserve(uint32_t inCount)
+    {
+        if (inCount <= mQueries.size()) return;
+        size_t first = mQueries.size();
+        mQueries.resize(inCount);
+        mIssued.resize(inCount, false);
+        // the conservative variant lets the driver answer from the hierarchical depth buffer
+        glCreateQueries(GL_ANY_SAMPLES_PASSED_CONSERVATIVE, static_cast<GLsizei>(inCount - first), mQueries.data() + first);
+    }
+
+    void OpenGLOcclusionQueryPool::Begin(uint32_t inQuery)
+    {
+        glBeginQuery(GL_ANY_SAMPLES_PASSED_CONSERVATIVE, mQueries[inQuery]);
+    }
+
+    void OpenGLOcclusionQueryPool::End(uint32_t inQuery)
+    {
+        glEndQuery(GL_ANY_SAMPLES_PASSED_CONSERVATIVE);
+        mIssued[inQuery] = true;
+    }
+
+    OcclusionQueryPool::Result OpenGLOcclusionQueryPool::GetResult(uint32_t inQuery)
+    {
+        if (!mIssued[inQuery]) return Result::Pending;
+
+        GLint available = GL_FALSE;
+        glGetQueryObjectiv(mQueries[inQuery], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) return Result::Pending;
+
+        GLuint anySamples = GL_FALSE;
+        glGetQueryObjectuiv(mQueries[inQuery], GL_QUERY_RESULT, &anySamples);
+        return anySamples ? Result::Visible : Result::Occluded;
+    }
+
+    void OpenGLOcclusionQueryPool::BeginConditionalRender(uint32_t inQuery)
+    {
+        if (!mIssued[inQuery]) return;
+        glBeginConditionalRender(mQueries[inQuery], GL_QUERY_NO_WAIT);
+        mConditional = true;
+    }
+
+    void OpenGLOcclusionQueryPool::EndConditionalRender()
+    {
+        if (!mConditional) return;
+        glEndConditionalRender();
+        mConditional = false;
+    }
+}
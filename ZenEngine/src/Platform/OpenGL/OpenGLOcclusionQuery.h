@@ -0,0 +1,33 @@
+#pragma once
+
+#include "ZenEngine/Renderer/OcclusionQuery.h"
+
+#include <vector>
+#include <stdint.h>
+
+namespace ZenEngine
+{
+    class OpenGLOcclusionQueryPool : public OcclusionQueryPool
+    {
+    public:
+        virtual ~OpenGLOcclusionQueryPool();
+
+        virtual void Reserve(uint32_t inCount) override;
+        virtual uint32_t GetSize() const override { return static_cast<uint32_t>(mQueries.size()); }
+
+        virtual void Begin(uint32_t inQuery) override;
+        virtual void End(uint32_t inQuery) override;
+        virtual Result GetResult(uint32_t inQuery) override;
+        virtual void Reset(uint32_t inQuery) override { mIssued[inQuery] = false; }
+
+        virtual void BeginConditionalRender(uint32_t inQuery) override;
+        virtual void EndConditionalRender() override;
+        virtual bool SupportsConditionalRender() const override { return true; }
+
+    private:
+        std::vector<uint32_t> mQueries;
+        // reading or predicating on a query that was never begun is an error
+        std::vector<bool> mIssued;
+        bool mConditional = false;
+    };
+}
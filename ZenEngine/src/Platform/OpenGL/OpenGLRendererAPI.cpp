@@ -4,6 +4,9 @@
 #include "ZenEngine/Core/Log.h"
 #include "ZenEngine/Core/Macros.h"
 #include "ZenEngine/Renderer/IndexBuffer.h"
+#include "ZenEngine/Renderer/ResourceRegistry.h"
+#include "ZenEngine/Renderer/Shader.h"
+#include "OpenGLShader.h"
 
 namespace ZenEngine
 {
@@ -71,6 +74,41 @@ namespace ZenEngine
         ZE_ASSERT_CORE_MSG(false, "Unsupported blend func!");
     }
 
+    static GLenum DepthFunctionToOpenGLDepthFunction(RendererAPI::DepthFunction inFunc)
+    {
+        switch (inFunc)
+        {
+        case RendererAPI::DepthFunction::Never:         return GL_NEVER;
+        case RendererAPI::DepthFunction::Less:          return GL_LESS;
+        case RendererAPI::DepthFunction::Equal:         return GL_EQUAL;
+        case RendererAPI::DepthFunction::LessEqual:     return GL_LEQUAL;
+        case RendererAPI::DepthFunction::Greater:       return GL_GREATER;
+        case RendererAPI::DepthFunction::NotEqual:      return GL_NOTEQUAL;
+        case RendererAPI::DepthFunction::GreaterEqual:  return GL_GEQUAL;
+        case RendererAPI::DepthFunction::Always:        return GL_ALWAYS;
+        }
+        ZE_ASSERT_CORE_MSG(false, "Unsupported depth func!");
+        return GL_LESS;
+    }
+
+    static GLenum PrimitiveTopologyToOpenGLMode(RendererAPI::PrimitiveTopology inTopology)
+    {
+        switch (inTopology)
+        {
+        case RendererAPI::PrimitiveTopology::Triangles: return GL_TRIANGLES;
+        case RendererAPI::PrimitiveTopology::Lines:     return GL_LINES;
+        case RendererAPI::PrimitiveTopology::Points:    return GL_POINTS;
+        }
+        ZE_ASSERT_CORE_MSG(false, "Unsupported primitive topology!");
+        return GL_TRIANGLES;
+    }
+
+    static void SetCapability(GLenum inCapability, bool inEnabled)
+    {
+        if (inEnabled) glEnable(inCapability);
+        else glDisable(inCapability);
+    }
+
     OpenGLRendererAPI::~OpenGLRendererAPI()
     {
     }
@@ -90,6 +128,8 @@ namespace ZenEngine
 
         glEnable(GL_DEPTH_TEST);
         glEnable(GL_LINE_SMOOTH);
+        // the rows of small mip levels of three and one channel textures are not 4 byte aligned
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
     }
 
     void OpenGLRendererAPI::SetViewport(uint32_t inX, uint32_t inY, uint32_t inWidth, uint32_t inHeight)
@@ -97,6 +137,51 @@ namespace ZenEngine
         glViewport(inX, inY, inWidth, inHeight);
     }
 
+    void OpenGLRendererAPI::SetPipelineState(const PipelineState &inState)
+    {
+        bool all = !mHasPipelineState;
+        const auto &current = mPipelineState;
+
+        // the object behind a handle can be swapped, e.g. when a shader is recompiled, so compare the program it resolves to
+        const auto *shader = static_cast<const OpenGLShader*>(ResourceRegistry::Get().Resolve(inState.Shader));
+        uint32_t program = shader != nullptr ? shader->GetRendererID() : 0;
+        if (all || program != mBoundProgram)
+        {
+            if (shader != nullptr) shader->Bind();
+            else glUseProgram(0);
+            mBoundProgram = program;
+        }
+
+        if (all || inState.Cull != current.Cull)
+        {
+            SetCapability(GL_CULL_FACE, inState.Cull != CullMode::None);
+            if (inState.Cull != CullMode::None)
+                glCullFace(inState.Cull == CullMode::Front ? GL_FRONT : GL_BACK);
+        }
+
+        if (all || inState.DepthTest != current.DepthTest)
+            SetCapability(GL_DEPTH_TEST, inState.DepthTest);
+        if (all || inState.DepthWrite != current.DepthWrite)
+            glDepthMask(inState.DepthWrite ? GL_TRUE : GL_FALSE);
+        if (all || inState.DepthFunction != current.DepthFunction)
+            glDepthFunc(DepthFunctionToOpenGLDepthFunction(inState.DepthFunction));
+        if (all || inState.ColorWrite != current.ColorWrite)
+        {
+            GLboolean mask = inState.ColorWrite ? GL_TRUE : GL_FALSE;
+            glColorMask(mask, mask, mask, mask);
+        }
+
+        if (all || inState.Blend != current.Blend)
+            SetCapability(GL_BLEND, inState.Blend);
+        if (all || inState.BlendMode != current.BlendMode)
+            glBlendEquation(BlendModeToOpenGLBLendMode(inState.BlendMode));
+        if (all || inState.SourceBlend != current.SourceBlend || inState.DestinationBlend != current.DestinationBlend)
+            glBlendFunc(BlendFunctionToOpenGLBlendFunction(inState.SourceBlend), BlendFunctionToOpenGLBlendFunction(inState.DestinationBlend));
+
+        mPipelineState = inState;
+        mHasPipelineState = true;
+    }
+
     void OpenGLRendererAPI::SetClearColor(const glm::vec4 &inColor)
     {
         glClearColor(inColor.r, inColor.g, inColor.b, inColor.a);
@@ -110,55 +195,109 @@ namespace ZenEngine
     void OpenGLRendererAPI::EnableDepthTest()
     {
         glEnable(GL_DEPTH_TEST);
+        mPipelineState.DepthTest = true;
     }
 
     void OpenGLRendererAPI::DisableDepthTest()
     {
         glDisable(GL_DEPTH_TEST);
+        mPipelineState.DepthTest = false;
     }
 
     void OpenGLRendererAPI::SetDepthMask(bool inMask)
     {
         glDepthMask(inMask? GL_TRUE : GL_FALSE);
+        mPipelineState.DepthWrite = inMask;
+    }
+
+    void OpenGLRendererAPI::SetDepthFunction(DepthFunction inFunction)
+    {
+        glDepthFunc(DepthFunctionToOpenGLDepthFunction(inFunction));
+        mPipelineState.DepthFunction = inFunction;
+    }
+
+    void OpenGLRendererAPI::SetColorMask(bool inMask)
+    {
+        GLboolean mask = inMask? GL_TRUE : GL_FALSE;
+        glColorMask(mask, mask, mask, mask);
+        mPipelineState.ColorWrite = inMask;
     }
 
     void OpenGLRendererAPI::EnableBlend()
     {
         glEnable(GL_BLEND);
+        mPipelineState.Blend = true;
     }
 
     void OpenGLRendererAPI::DisableBlend()
     {
         glDisable(GL_BLEND);
+        mPipelineState.Blend = false;
     }
 
     void OpenGLRendererAPI::SetBlendMode(BlendMode inMode)
     {
         glBlendEquation(BlendModeToOpenGLBLendMode(inMode));
+        mPipelineState.BlendMode = inMode;
     }
 
     void OpenGLRendererAPI::SetBlendFunction(BlendFunction inSource, BlendFunction inDestination)
     {
         glBlendFunc(BlendFunctionToOpenGLBlendFunction(inSource), BlendFunctionToOpenGLBlendFunction(inDestination));
+        mPipelineState.SourceBlend = inSource;
+        mPipelineState.DestinationBlend = inDestination;
+    }
+
+    void OpenGLRendererAPI::DrawIndexed(VertexArrayHandle inVertexArray)
+    {
+        auto *vertexArray = ResourceRegistry::Get().Resolve(inVertexArray);
+        if (vertexArray == nullptr) return;
+        vertexArray->Bind(mPipelineState.Streams);
+        glDrawElements(PrimitiveTopologyToOpenGLMode(mPipelineState.Topology), vertexArray->GetIndexBuffer()->GetCount(), GL_UNSIGNED_INT, nullptr);
+        vertexArray->Unbind();
     }
 
-    void OpenGLRendererAPI::DrawIndexed(const std::shared_ptr<VertexArray> &inVertexArray)
+    void OpenGLRendererAPI::DrawIndexed(VertexArrayHandle inVertexArray, uint32_t inIndexCount)
     {
-        inVertexArray->Bind();
-        glDrawElements(GL_TRIANGLES, inVertexArray->GetIndexBuffer()->GetCount(), GL_UNSIGNED_INT, nullptr);
-        inVertexArray->Unbind();
+        auto *vertexArray = ResourceRegistry::Get().Resolve(inVertexArray);
+        if (vertexArray == nullptr) return;
+        vertexArray->Bind(mPipelineState.Streams);
+        glDrawElements(PrimitiveTopologyToOpenGLMode(mPipelineState.Topology), inIndexCount, GL_UNSIGNED_INT, nullptr);
+        vertexArray->Unbind();
     }
 
-    void OpenGLRendererAPI::DrawIndexed(const std::shared_ptr<VertexArray> &inVertexArray, uint32_t inIndexCount)
+    void OpenGLRendererAPI::DrawIndexedInstanced(VertexArrayHandle inVertexArray, uint32_t inInstanceCount)
     {
-        inVertexArray->Bind();
-        glDrawElements(GL_TRIANGLES, inIndexCount, GL_UNSIGNED_INT, nullptr);
-        inVertexArray->Unbind();
+        auto *vertexArray = ResourceRegistry::Get().Resolve(inVertexArray);
+        if (vertexArray == nullptr) return;
+        vertexArray->Bind(mPipelineState.Streams);
+        glDrawElementsInstanced(PrimitiveTopologyToOpenGLMode(mPipelineState.Topology), vertexArray->GetIndexBuffer()->GetCount(), GL_UNSIGNED_INT, nullptr, inInstanceCount);
+        vertexArray->Unbind();
+    }
+
+    void OpenGLRendererAPI::DrawIndexedRanges(VertexArrayHandle inVertexArray, const IndexRange *inRanges, uint32_t inRangeCount)
+    {
+        auto *vertexArray = ResourceRegistry::Get().Resolve(inVertexArray);
+        if (vertexArray == nullptr || inRangeCount == 0) return;
+
+        mMultiDrawCounts.resize(inRangeCount);
+        mMultiDrawOffsets.resize(inRangeCount);
+        for (uint32_t i = 0; i < inRangeCount; ++i)
+        {
+            mMultiDrawCounts[i] = static_cast<int32_t>(inRanges[i].Count);
+            mMultiDrawOffsets[i] = reinterpret_cast<const void*>(static_cast<uintptr_t>(inRanges[i].First) * sizeof(uint32_t));
+        }
+
+        vertexArray->Bind(mPipelineState.Streams);
+        glMultiDrawElements(PrimitiveTopologyToOpenGLMode(mPipelineState.Topology), mMultiDrawCounts.data(), GL_UNSIGNED_INT, mMultiDrawOffsets.data(), static_cast<GLsizei>(inRangeCount));
+        vertexArray->Unbind();
     }
 
-    void OpenGLRendererAPI::DrawLines(const std::shared_ptr<VertexArray> &inVertexArray, uint32_t inVertexCount)
+    void OpenGLRendererAPI::DrawLines(VertexArrayHandle inVertexArray, uint32_t inVertexCount)
     {
-        inVertexArray->Bind();
+        auto *vertexArray = ResourceRegistry::Get().Resolve(inVertexArray);
+        if (vertexArray == nullptr) return;
+        vertexArray->Bind(mPipelineState.Streams);
         glDrawArrays(GL_LINES, 0, inVertexCount);
     }
 
@@ -1,7 +1,9 @@
 #pragma once
 
+#include <vector>
 #include "ZenEngine/Renderer/RendererAPI.h"
 #include "ZenEngine/Renderer/VertexArray.h"
+#include "ZenEngine/Renderer/PipelineState.h"
 
 namespace ZenEngine
 {
@@ -14,22 +16,39 @@ namespace ZenEngine
 
         virtual void Init() override;
         virtual void SetViewport(uint32_t inX, uint32_t inY, uint32_t inWidth, uint32_t inHeight) override;
+        virtual void SetPipelineState(const PipelineState &inState) override;
+        virtual void InvalidatePipelineState() override { mHasPipelineState = false; }
         virtual void SetClearColor(const glm::vec4 &inColor) override;
         virtual void Clear(uint32_t inFlags) override;
         
         virtual void EnableDepthTest() override;
         virtual void DisableDepthTest() override;
         virtual void SetDepthMask(bool inMask) override;
+        virtual void SetDepthFunction(DepthFunction inFunction) override;
+        virtual void SetColorMask(bool inMask) override;
         
         virtual void EnableBlend() override;
         virtual void DisableBlend() override;
         virtual void SetBlendMode(BlendMode inMode) override;
         virtual void SetBlendFunction(BlendFunction inSource, BlendFunction inDestination) override;
 
-        virtual void DrawIndexed(const std::shared_ptr<VertexArray> &inVertexArray) override;
-        virtual void DrawIndexed(const std::shared_ptr<VertexArray> &inVertexArray, uint32_t inIndexCount) override;
-        virtual void DrawLines(const std::shared_ptr<VertexArray> &inVertexArray, uint32_t inVertexCount) override;
+        virtual void DrawIndexed(VertexArrayHandle inVertexArray) override;
+        virtual void DrawIndexed(VertexArrayHandle inVertexArray, uint32_t inIndexCount) override;
+        virtual void DrawIndexedInstanced(VertexArrayHandle inVertexArray, uint32_t inInstanceCount) override;
+        virtual void DrawIndexedRanges(VertexArrayHandle inVertexArray, const IndexRange *inRanges, uint32_t inRangeCount) override;
+        virtual void DrawLines(VertexArrayHandle inVertexArray, uint32_t inVertexCount) override;
         
         virtual void SetLineWidth(float inWidth) override;
+
+    private:
+        // what the GL context currently has set, the immediate setters keep it up to date too
+        PipelineState mPipelineState;
+        // GL program in use. A name is not reused while its program is in use, unlike the address of a freed shader
+        uint32_t mBoundProgram = 0;
+        bool mHasPipelineState = false;
+
+        // glMultiDrawElements arguments kept between draws, the counts are GLsizei
+        std::vector<int32_t> mMultiDrawCounts;
+        std::vector<const void*> mMultiDrawOffsets;
     };
 }
\ No newline at end of file
@@ -29,6 +29,8 @@ namespace ZenEngine
 
         virtual ShaderUniformInfo GetShaderUniformInfo() const override { return mUniforms; }
         virtual ShaderTextureInfo GetShaderTextureInfo() const override { return mTextures; }
+
+        uint32_t GetRendererID() const { return mRendererId; }
     private:
         std::string mName;
         uint32_t mRendererId;
@@ -1,7 +1,19 @@
 #include "OpenGLTexture2D.h"
 
+#include "OpenGLUploadManager.h"
+
+#include <algorithm>
+
 #include "ZenEngine/Core/Macros.h"
 
+// S3TC is an extension that is not in the loader, it is available on every desktop driver
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT1_EXT 0x83F1
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+
 namespace ZenEngine
 {
     static GLenum Texture2DFormatToGLInternalFormat(Texture2D::Format inFormat)
@@ -12,6 +24,12 @@ namespace ZenEngine
         case Texture2D::Format::RGB8: return GL_RGB8;
         case Texture2D::Format::RGBA32F: return GL_RGBA32F;
         case Texture2D::Format::RGBA8: return GL_RGBA8; 
+        case Texture2D::Format::R32F: return GL_R32F;
+        case Texture2D::Format::BC1: return GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+        case Texture2D::Format::BC3: return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+        case Texture2D::Format::BC4: return GL_COMPRESSED_RED_RGTC1;
+        case Texture2D::Format::BC5: return GL_COMPRESSED_RG_RGTC2;
+        case Texture2D::Format::BC7: return GL_COMPRESSED_RGBA_BPTC_UNORM;
         default: ZE_ASSERT_CORE_MSG(false, "Could not convert Texture2D::Format!"); return 0;
         }
     }
@@ -24,10 +42,27 @@ namespace ZenEngine
         case Texture2D::Format::RGB8: return GL_RGB;
         case Texture2D::Format::RGBA32F: return GL_RGBA32F;
         case Texture2D::Format::RGBA8: return GL_RGBA;
+        case Texture2D::Format::R32F: return GL_RED;
         default: ZE_ASSERT_CORE_MSG(false, "Could not convert Texture2D::Format!"); return 0;
         }
     }
 
+    static GLenum Texture2DFormatToGLType(Texture2D::Format inFormat)
+    {
+        return inFormat == Texture2D::Format::R32F ? GL_FLOAT : GL_UNSIGNED_BYTE;
+    }
+
+    // compressed data is uploaded with its internal format, the upload manager tells it apart by the missing type
+    static GLenum Texture2DFormatToGLUploadFormat(Texture2D::Format inFormat)
+    {
+        return Texture2D::IsCompressedFormat(inFormat) ? Texture2DFormatToGLInternalFormat(inFormat) : Texture2DFormatToGLFormat(inFormat);
+    }
+
+    static GLenum Texture2DFormatToGLUploadType(Texture2D::Format inFormat)
+    {
+        return Texture2D::IsCompressedFormat(inFormat) ? 0 : Texture2DFormatToGLType(inFormat);
+    }
+
     static GLenum Texture2DFilterToGLFilter(Texture2D::Filter inFilter)
     {
         switch (inFilter)
@@ -38,13 +73,27 @@ namespace ZenEngine
         }
     }
 
+    static GLenum Texture2DFilterToGLMipmapFilter(Texture2D::Filter inFilter)
+    {
+        switch (inFilter)
+        {
+        case Texture2D::Filter::Linear: return GL_LINEAR_MIPMAP_LINEAR;
+        case Texture2D::Filter::Nearest: return GL_NEAREST_MIPMAP_NEAREST;
+        default: ZE_ASSERT_CORE_MSG(false, "Could not convert TEXTURE2D::Filter!"); return 0;
+        }
+    }
+
     OpenGLTexture2D::OpenGLTexture2D(const Texture2D::Properties &inProperties)
         : mProperties(inProperties)
     {
+        // the driver can not build the levels of compressed data, they come with it
+        if (IsCompressedFormat(mProperties.Format)) mProperties.GenerateMips = false;
+        mMipLevels = mProperties.GenerateMips ? GetFullMipCount(mProperties.Width, mProperties.Height) : std::max(mProperties.MipLevels, 1u);
         glCreateTextures(GL_TEXTURE_2D, 1, &mRendererId);
-        glTextureStorage2D(mRendererId, 1, Texture2DFormatToGLInternalFormat(mProperties.Format), mProperties.Width, mProperties.Height);
+        glTextureStorage2D(mRendererId, mMipLevels, Texture2DFormatToGLInternalFormat(mProperties.Format), mProperties.Width, mProperties.Height);
 
-        glTextureParameteri(mRendererId, GL_TEXTURE_MIN_FILTER, Texture2DFilterToGLFilter(mProperties.MinFilter));
+        GLenum minFilter = mMipLevels > 1 ? Texture2DFilterToGLMipmapFilter(mProperties.MinFilter) : Texture2DFilterToGLFilter(mProperties.MinFilter);
+        glTextureParameteri(mRendererId, GL_TEXTURE_MIN_FILTER, minFilter);
         glTextureParameteri(mRendererId, GL_TEXTURE_MAG_FILTER, Texture2DFilterToGLFilter(mProperties.MagFilter));
 
         // TODO make this a texture property
@@ -54,16 +103,44 @@ namespace ZenEngine
 
     OpenGLTexture2D::~OpenGLTexture2D()
     {
+        if (OpenGLUploadManager::IsAvailable()) OpenGLUploadManager::Get().CancelTexture(mRendererId);
         glDeleteTextures(1, &mRendererId);
     }
 
     void OpenGLTexture2D::SetData(void *inData, uint32_t inSize)
     {
-        uint32_t bpp = Texture2DFormatBytes(mProperties.Format);
-        ZE_ASSERT_CORE_MSG(inSize == mProperties.Width * mProperties.Height * bpp, "Data must be entire texture!");
-        glTextureSubImage2D(mRendererId, 0, 0, 0, mProperties.Width, mProperties.Height, Texture2DFormatToGLFormat(mProperties.Format), GL_UNSIGNED_BYTE, inData);
+        ZE_ASSERT_CORE_MSG(inSize == Texture2DDataSize(mProperties.Format, mProperties.Width, mProperties.Height), "Data must be entire texture!");
+        if (OpenGLUploadManager::IsAvailable())
+        {
+            // lands at the next flush, or later when the frame is out of upload budget
+            OpenGLUploadManager::Get().QueueTexture(mRendererId, 0, mProperties.Width, mProperties.Height, Texture2DFormatToGLUploadFormat(mProperties.Format), Texture2DFormatToGLUploadType(mProperties.Format), mProperties.GenerateMips, inData, inSize);
+            return;
+        }
+        UploadLevel(0, mProperties.Width, mProperties.Height, inData, inSize);
         if (mProperties.GenerateMips) glGenerateTextureMipmap(mRendererId);
     }
+
+    void OpenGLTexture2D::SetMipData(uint32_t inLevel, void *inData, uint32_t inSize)
+    {
+        ZE_ASSERT_CORE_MSG(inLevel < mMipLevels, "The texture does not have this level!");
+        uint32_t width = std::max(mProperties.Width >> inLevel, 1u);
+        uint32_t height = std::max(mProperties.Height >> inLevel, 1u);
+        ZE_ASSERT_CORE_MSG(inSize == Texture2DDataSize(mProperties.Format, width, height), "Data must be entire level!");
+        if (OpenGLUploadManager::IsAvailable())
+        {
+            OpenGLUploadManager::Get().QueueTexture(mRendererId, inLevel, width, height, Texture2DFormatToGLUploadFormat(mProperties.Format), Texture2DFormatToGLUploadType(mProperties.Format), false, inData, inSize);
+            return;
+        }
+        UploadLevel(inLevel, width, height, inData, inSize);
+    }
+
+    void OpenGLTexture2D::UploadLevel(uint32_t inLevel, uint32_t inWidth, uint32_t inHeight, const void *inData, uint32_t inSize)
+    {
+        if (IsCompressedFormat(mProperties.Format))
+            glCompressedTextureSubImage2D(mRendererId, inLevel, 0, 0, inWidth, inHeight, Texture2DFormatToGLInternalFormat(mProperties.Format), inSize, inData);
+        else
+            glTextureSubImage2D(mRendererId, inLevel, 0, 0, inWidth, inHeight, Texture2DFormatToGLFormat(mProperties.Format), Texture2DFormatToGLType(mProperties.Format), inData);
+    }
     
     void OpenGLTexture2D::Bind(uint32_t inSlot) const
     {
@@ -19,11 +19,15 @@ namespace ZenEngine
         virtual uint32_t GetRendererID() const override { return mRendererId; }
 
         virtual void SetData(void* inData, uint32_t inSize) override;
+        virtual void SetMipData(uint32_t inLevel, void *inData, uint32_t inSize) override;
 
         virtual void Bind(uint32_t inSlot = 0) const override;
     private:
         Texture2D::Properties mProperties;
         uint32_t mRendererId;
+        uint32_t mMipLevels;
         GLenum mInternalFormat;
+
+        void UploadLevel(uint32_t inLevel, uint32_t inWidth, uint32_t inHeight, const void *inData, uint32_t inSize);
     };
 }
\ No newline at end of file
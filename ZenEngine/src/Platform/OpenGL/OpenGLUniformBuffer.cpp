@@ -2,6 +2,8 @@
 
 #include <glad/glad.h>
 
+#include "OpenGLUploadManager.h"
+
 namespace ZenEngine
 {
     OpenGLUniformBuffer::OpenGLUniformBuffer(uint32_t inSize, uint32_t inBinding)
@@ -29,6 +31,11 @@ namespace ZenEngine
 
     void OpenGLUniformBuffer::SetData(const void *inData, uint32_t inSize, uint32_t inOffset)
     {
+        if (OpenGLUploadManager::IsAvailable())
+        {
+            OpenGLUploadManager::Get().UploadBuffer(mRendererId, inOffset, inData, inSize);
+            return;
+        }
         glNamedBufferSubData(mRendererId, inOffset, inSize, inData);
     }
 }
\ No newline at end of file
@@ -0,0 +1,178 @@
+#include "OpenGLUploadManager.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "ZenEngine/Core/Macros.h"
+
+namespace ZenEngine
+{
+    // enough for the pixel unpack offsets of every texture format
+    static constexpr uint64_t sStagingAlignment = 16;
+
+    OpenGLUploadManager *OpenGLUploadManager::sInstance = nullptr;
+
+    OpenGLUploadManager::OpenGLUploadManager()
+    {
+        ZE_ASSERT_CORE_MSG(sInstance == nullptr, "OpenGLUploadManager already exists!");
+        constexpr GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glCreateBuffers(1, &mRing);
+        glNamedBufferStorage(mRing, RingSize, nullptr, flags);
+        mMapped = static_cast<uint8_t*>(glMapNamedBufferRange(mRing, 0, RingSize, flags));
+        ZE_ASSERT_CORE_MSG(mMapped != nullptr, "Could not map the staging ring!");
+        mThread = std::this_thread::get_id();
+        sInstance = this;
+    }
+
+    OpenGLUploadManager::~OpenGLUploadManager()
+    {
+        sInstance = nullptr;
+        for (auto &frame : mFrames)
+            glDeleteSync(frame.Fence);
+        glUnmapNamedBuffer(mRing);
+        glDeleteBuffers(1, &mRing);
+    }
+
+    void OpenGLUploadManager::UploadBuffer(uint32_t inBuffer, uint32_t inOffset, const void *inData, uint32_t inSize)
+    {
+        ++mStatistics.Uploads;
+        mStatistics.Bytes += inSize;
+        auto offset = Allocate(inSize);
+        if (!offset)
+        {
+            ++mStatistics.Direct;
+            glNamedBufferSubData(inBuffer, inOffset, inSize, inData);
+            return;
+        }
+        std::memcpy(mMapped + *offset, inData, inSize);
+        glCopyNamedBufferSubData(mRing, inBuffer, static_cast<GLintptr>(*offset), inOffset, inSize);
+    }
+
+    void OpenGLUploadManager::QueueTexture(uint32_t inTexture, uint32_t inLevel, uint32_t inWidth, uint32_t inHeight, GLenum inFormat, GLenum inType, bool inGenerateMips, const void *inData, uint32_t inSize)
+    {
+        // the data is kept on the CPU until the upload runs, staging memory is only held by the frame that uses it
+        auto *bytes = static_cast<const uint8_t*>(inData);
+        auto it = std::find_if(mTextureQueue.begin(), mTextureQueue.end(), [inTexture, inLevel](const TextureUpload &inUpload) { return inUpload.Texture == inTexture && inUpload.Level == inLevel; });
+        if (it != mTextureQueue.end())
+        {
+            it->Data.assign(bytes, bytes + inSize);
+            return;
+        }
+        mTextureQueue.push_back({ inTexture, inLevel, inWidth, inHeight, inFormat, inType, inGenerateMips, std::vector<uint8_t>(bytes, bytes + inSize) });
+    }
+
+    void OpenGLUploadManager::CancelTexture(uint32_t inTexture)
+    {
+        std::erase_if(mTextureQueue, [inTexture](const TextureUpload &inUpload) { return inUpload.Texture == inTexture; });
+    }
+
+    void OpenGLUploadManager::Flush()
+    {
+        uint32_t uploaded = 0;
+        while (!mTextureQueue.empty())
+        {
+            auto &upload = mTextureQueue.front();
+            // the first one always goes, a texture bigger than the budget would never arrive otherwise
+            if (uploaded > 0 && mTextureBytes + upload.Data.size() > mFrameBudget) break;
+            UploadTexture(upload);
+            mTextureQueue.pop_front();
+            ++uploaded;
+        }
+    }
+
+    void OpenGLUploadManager::EndFrame()
+    {
+        // frames that draw no scene still get their textures, e.g. the editor with nothing open
+        Flush();
+        if (mFrameBytes > 0)
+        {
+            mFrames.push_back({ glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0), mFrameBytes });
+            mFrameBytes = 0;
+        }
+        RetireFrames();
+
+        mStatistics.PendingBytes = 0;
+        for (auto &upload : mTextureQueue)
+            mStatistics.PendingBytes += upload.Data.size();
+        mLastFrameStatistics = mStatistics;
+        mStatistics = {};
+        mTextureBytes = 0;
+    }
+
+    std::optional<uint64_t> OpenGLUploadManager::Allocate(uint64_t inSize)
+    {
+        uint64_t size = (inSize + sStagingAlignment - 1) & ~(sStagingAlignment - 1);
+        if (size > RingSize) return std::nullopt;
+
+        // an allocation never straddles the end of the ring, what is left of it is skipped
+        bool wrap = mHead + size > RingSize;
+        uint64_t needed = size + (wrap ? RingSize - mHead : 0);
+        while (mUsed + needed > RingSize)
+        {
+            // the frame being recorded holds the whole ring, it can not be waited for
+            if (mFrames.empty()) return std::nullopt;
+
+            auto &frame = mFrames.front();
+            GLenum status = glClientWaitSync(frame.Fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+            if (status == GL_TIMEOUT_EXPIRED)
+            {
+                ++mStatistics.Stalls;
+                do status = glClientWaitSync(frame.Fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+                while (status == GL_TIMEOUT_EXPIRED);
+            }
+            glDeleteSync(frame.Fence);
+            mUsed -= frame.Bytes;
+            mFrames.pop_front();
+        }
+
+        if (wrap) mHead = 0;
+        uint64_t offset = mHead;
+        mHead += size;
+        mUsed += needed;
+        mFrameBytes += needed;
+        return offset;
+    }
+
+    void OpenGLUploadManager::RetireFrames()
+    {
+        while (!mFrames.empty())
+        {
+            auto &frame = mFrames.front();
+            GLenum status = glClientWaitSync(frame.Fence, 0, 0);
+            if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) break;
+            glDeleteSync(frame.Fence);
+            mUsed -= frame.Bytes;
+            mFrames.pop_front();
+        }
+    }
+
+    void OpenGLUploadManager::UploadTexture(const TextureUpload &inUpload)
+    {
+        uint32_t size = static_cast<uint32_t>(inUpload.Data.size());
+        ++mStatistics.Uploads;
+        mStatistics.Bytes += size;
+        mTextureBytes += size;
+        auto offset = Allocate(size);
+        if (!offset)
+        {
+            ++mStatistics.Direct;
+            if (inUpload.Type == 0)
+                glCompressedTextureSubImage2D(inUpload.Texture, inUpload.Level, 0, 0, inUpload.Width, inUpload.Height, inUpload.Format, size, inUpload.Data.data());
+            else
+                glTextureSubImage2D(inUpload.Texture, inUpload.Level, 0, 0, inUpload.Width, inUpload.Height, inUpload.Format, inUpload.Type, inUpload.Data.data());
+        }
+        else
+        {
+            std::memcpy(mMapped + *offset, inUpload.Data.data(), size);
+            // with a pixel unpack buffer bound the pointer is an offset into it
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, mRing);
+            const void *pixels = reinterpret_cast<const void*>(static_cast<uintptr_t>(*offset));
+            if (inUpload.Type == 0)
+                glCompressedTextureSubImage2D(inUpload.Texture, inUpload.Level, 0, 0, inUpload.Width, inUpload.Height, inUpload.Format, size, pixels);
+            else
+                glTextureSubImage2D(inUpload.Texture, inUpload.Level, 0, 0, inUpload.Width, inUpload.Height, inUpload.Format, inUpload.Type, pixels);
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        }
+        if (inUpload.GenerateMips) glGenerateTextureMipmap(inUpload.Texture);
+    }
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "ZenEngine/Renderer/UploadManager.h"
+
+#include <deque>
+#include <optional>
+#include <thread>
+#include <vector>
+#include <glad/glad.h>
+
+namespace ZenEngine
+{
+    /// @brief Stages uploads in a ring buffer that stays mapped for the whole run, so writing data is a memcpy and
+    /// the driver never has to copy it or wait for the GPU on the spot. The memory written in a frame is fenced
+    /// at its end and written again only once the fence has signaled.
+    /// Only the thread of the main context uploads through it, the loader context writes its data directly
+    class OpenGLUploadManager : public UploadManager
+    {
+    public:
+        static constexpr uint64_t RingSize = 32 * 1024 * 1024;
+
+        OpenGLUploadManager();
+        virtual ~OpenGLUploadManager();
+
+        static bool IsAvailable() { return sInstance != nullptr && std::this_thread::get_id() == sInstance->mThread; }
+        static OpenGLUploadManager &Get() { return *sInstance; }
+
+        /// @brief Copies the data to the buffer, in order with the commands issued before and after
+        void UploadBuffer(uint32_t inBuffer, uint32_t inOffset, const void *inData, uint32_t inSize);
+        /// @brief Queues an upload of a whole level of the texture, replacing one already queued for it.
+        /// Block compressed data has no type, the format is then its internal format
+        void QueueTexture(uint32_t inTexture, uint32_t inLevel, uint32_t inWidth, uint32_t inHeight, GLenum inFormat, GLenum inType, bool inGenerateMips, const void *inData, uint32_t inSize);
+        /// @brief Drops the queued upload of a texture that is being deleted
+        void CancelTexture(uint32_t inTexture);
+
+        virtual void Flush() override;
+        virtual void EndFrame() override;
+    private:
+        struct TextureUpload
+        {
+            uint32_t Texture;
+            uint32_t Level;
+            uint32_t Width;
+            uint32_t Height;
+            GLenum Format;
+            GLenum Type;
+            bool GenerateMips;
+            std::vector<uint8_t> Data;
+        };
+
+        struct FrameRange
+        {
+            GLsync Fence;
+            // staging bytes the frame used, the wasted end of the ring included when it wrapped
+            uint64_t Bytes;
+        };
+
+        static OpenGLUploadManager *sInstance;
+
+        std::thread::id mThread;
+        uint32_t mRing = 0;
+        uint8_t *mMapped = nullptr;
+        uint64_t mHead = 0;
+        uint64_t mUsed = 0;
+        uint64_t mFrameBytes = 0;
+        // texture bytes uploaded this frame, what the budget is checked against
+        uint64_t mTextureBytes = 0;
+        std::deque<FrameRange> mFrames;
+        std::deque<TextureUpload> mTextureQueue;
+
+        std::optional<uint64_t> Allocate(uint64_t inSize);
+        void RetireFrames();
+        void UploadTexture(const TextureUpload &inUpload);
+    };
+}
@@ -1,5 +1,6 @@
 #include "OpenGLVertexArray.h"
 
+#include <algorithm>
 #include <glad/glad.h>
 
 #include "ZenEngine/Core/Macros.h"
@@ -37,6 +38,7 @@ namespace ZenEngine
     OpenGLVertexArray::~OpenGLVertexArray()
     {
         glDeleteVertexArrays(1, &mRendererId);
+        if (mPositionRendererId != 0) glDeleteVertexArrays(1, &mPositionRendererId);
     }
 
     void OpenGLVertexArray::Bind() const
@@ -44,19 +46,23 @@ namespace ZenEngine
         glBindVertexArray(mRendererId);
     }
 
+    void OpenGLVertexArray::Bind(Streams inStreams) const
+    {
+        glBindVertexArray(inStreams == Streams::Position && mPositionRendererId != 0 ? mPositionRendererId : mRendererId);
+    }
+
     void OpenGLVertexArray::Unbind() const
     {
         glBindVertexArray(0);
     }
 
-    void OpenGLVertexArray::AddVertexBuffer(const std::shared_ptr<VertexBuffer>& inVertexBuffer)
+    uint32_t OpenGLVertexArray::SetupAttributes(uint32_t inRendererId, const VertexBuffer &inVertexBuffer, uint32_t inFirstLocation)
     {
-        ZE_ASSERT_CORE_MSG(inVertexBuffer->GetLayout().GetElements().size(), "Vertex Buffer has no layout!");
-
-        glBindVertexArray(mRendererId);
-        inVertexBuffer->Bind();
+        glBindVertexArray(inRendererId);
+        inVertexBuffer.Bind();
 
-        const auto& layout = inVertexBuffer->GetLayout();
+        uint32_t location = inFirstLocation;
+        const auto& layout = inVertexBuffer.GetLayout();
         for (const auto& element : layout)
         {
             switch (element.Type)
@@ -66,14 +72,14 @@ namespace ZenEngine
             case ShaderDataType::Float3:
             case ShaderDataType::Float4:
             {
-                glEnableVertexAttribArray(mVertexBufferIndex);
-                glVertexAttribPointer(mVertexBufferIndex,
+                glEnableVertexAttribArray(location);
+                glVertexAttribPointer(location,
                     element.GetComponentCount(),
                     ShaderDataTypeToOpenGLBaseType(element.Type),
                     element.Normalized ? GL_TRUE : GL_FALSE,
                     layout.GetStride(),
                     (const void*)element.Offset);
-                mVertexBufferIndex++;
+                location++;
                 break;
             }
             case ShaderDataType::Int:
@@ -82,13 +88,13 @@ namespace ZenEngine
             case ShaderDataType::Int4:
             case ShaderDataType::Bool:
             {
-                glEnableVertexAttribArray(mVertexBufferIndex);
-                glVertexAttribIPointer(mVertexBufferIndex,
+                glEnableVertexAttribArray(location);
+                glVertexAttribIPointer(location,
                     element.GetComponentCount(),
                     ShaderDataTypeToOpenGLBaseType(element.Type),
                     layout.GetStride(),
                     (const void*)element.Offset);
-                mVertexBufferIndex++;
+                location++;
                 break;
             }
             case ShaderDataType::Mat3:
@@ -97,15 +103,15 @@ namespace ZenEngine
                 uint8_t count = element.GetComponentCount();
                 for (uint8_t i = 0; i < count; i++)
                 {
-                    glEnableVertexAttribArray(mVertexBufferIndex);
-                    glVertexAttribPointer(mVertexBufferIndex,
+                    glEnableVertexAttribArray(location);
+                    glVertexAttribPointer(location,
                         count,
                         ShaderDataTypeToOpenGLBaseType(element.Type),
                         element.Normalized ? GL_TRUE : GL_FALSE,
                         layout.GetStride(),
                         (const void*)(element.Offset + sizeof(float) * count * i));
-                    glVertexAttribDivisor(mVertexBufferIndex, 1);
-                    mVertexBufferIndex++;
+                    glVertexAttribDivisor(location, 1);
+                    location++;
                 }
                 break;
             }
@@ -114,13 +120,50 @@ namespace ZenEngine
             }
         }
 
+        return location;
+    }
+
+    void OpenGLVertexArray::AddVertexBuffer(const std::shared_ptr<VertexBuffer>& inVertexBuffer)
+    {
+        ZE_ASSERT_CORE_MSG(inVertexBuffer->GetLayout().GetElements().size(), "Vertex Buffer has no layout!");
+
+        uint32_t firstLocation = mVertexBufferIndex;
+        mVertexBufferIndex = SetupAttributes(mRendererId, *inVertexBuffer, firstLocation);
+
+        // the position only array keeps the same locations, the attributes it does not read are left disabled.
+        // Per instance data is still needed to place the instances
+        if (mPositionRendererId != 0)
+        {
+            const auto &elements = inVertexBuffer->GetLayout().GetElements();
+            bool perInstance = std::any_of(elements.begin(), elements.end(), [](const auto &inElement)
+            {
+                return inElement.Type == ShaderDataType::Mat3 || inElement.Type == ShaderDataType::Mat4;
+            });
+            if (inVertexBuffer == mPositionBuffer || perInstance)
+                SetupAttributes(mPositionRendererId, *inVertexBuffer, firstLocation);
+        }
+
+        Hash::Combine(mLayoutHash, inVertexBuffer->GetLayout().GetHash());
         mVertexBuffers.push_back(inVertexBuffer);
     }
 
+    void OpenGLVertexArray::AddPositionBuffer(const std::shared_ptr<VertexBuffer> &inVertexBuffer)
+    {
+        ZE_ASSERT_CORE_MSG(mVertexBuffers.empty(), "The position buffer has to be added first!");
+        if (mPositionRendererId == 0) glCreateVertexArrays(1, &mPositionRendererId);
+        mPositionBuffer = inVertexBuffer;
+        AddVertexBuffer(inVertexBuffer);
+    }
+
     void OpenGLVertexArray::SetIndexBuffer(const std::shared_ptr<IndexBuffer> &indexBuffer)
     {
         glBindVertexArray(mRendererId);
         indexBuffer->Bind();
+        if (mPositionRendererId != 0)
+        {
+            glBindVertexArray(mPositionRendererId);
+            indexBuffer->Bind();
+        }
         glBindVertexArray(0);
 
         mIndexBuffer = indexBuffer;
@@ -13,18 +13,29 @@ namespace ZenEngine
         virtual ~OpenGLVertexArray();
 
         virtual void Bind() const override;
+        virtual void Bind(Streams inStreams) const override;
         virtual void Unbind() const override;
 
         virtual void AddVertexBuffer(const std::shared_ptr<VertexBuffer> &inVertexBuffer) override;
+        virtual void AddPositionBuffer(const std::shared_ptr<VertexBuffer> &inVertexBuffer) override;
         virtual void SetIndexBuffer(const std::shared_ptr<IndexBuffer> &inIndexBuffer) override;
 
         virtual const std::vector<std::shared_ptr<VertexBuffer>> &GetVertexBuffers() const { return mVertexBuffers; }
         virtual const std::shared_ptr<IndexBuffer> &GetIndexBuffer() const { return mIndexBuffer; }
+        virtual const std::shared_ptr<VertexBuffer> &GetPositionBuffer() const override { return mPositionBuffer; }
+
+        virtual uint64_t GetLayoutHash() const override { return mLayoutHash; }
     private:
         uint32_t mRendererId;
+        // a second vertex array with the position buffer and the per instance buffers only, zero without a position buffer
+        uint32_t mPositionRendererId = 0;
         uint32_t mVertexBufferIndex = 0;
+        uint64_t mLayoutHash = 0;
         std::vector<std::shared_ptr<VertexBuffer>> mVertexBuffers;
         std::shared_ptr<IndexBuffer> mIndexBuffer;
+        std::shared_ptr<VertexBuffer> mPositionBuffer;
+
+        static uint32_t SetupAttributes(uint32_t inRendererId, const VertexBuffer &inVertexBuffer, uint32_t inFirstLocation);
     };
 
 }
\ No newline at end of file
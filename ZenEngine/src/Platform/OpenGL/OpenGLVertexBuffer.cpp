@@ -2,6 +2,8 @@
 
 #include <glad/glad.h>
 
+#include "OpenGLUploadManager.h"
+
 namespace ZenEngine
 {
     OpenGLVertexBuffer::OpenGLVertexBuffer(uint32_t inSize)
@@ -35,7 +37,11 @@ namespace ZenEngine
 
     void OpenGLVertexBuffer::SetData(const void* inData, uint32_t inSize)
     {
-        glBindBuffer(GL_ARRAY_BUFFER, mRendererId);
-        glBufferSubData(GL_ARRAY_BUFFER, 0, inSize, inData);
+        if (OpenGLUploadManager::IsAvailable())
+        {
+            OpenGLUploadManager::Get().UploadBuffer(mRendererId, 0, inData, inSize);
+            return;
+        }
+        glNamedBufferSubData(mRendererId, 0, inSize, inData);
     }
 }
\ No newline at end of file
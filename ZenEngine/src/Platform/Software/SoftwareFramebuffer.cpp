@@ -0,0 +1,119 @@
+#include "SoftwareFramebuffer.h"
+
+#include "ZenEngine/Core/Log.h"
+#include "SoftwareRendererAPI.h"
+
+namespace ZenEngine
+{
+    static const uint32_t MaxFramebufferSize = 8192;
+
+    static bool IsDepthFormat(Framebuffer::TextureFormat inFormat)
+    {
+        switch (inFormat)
+        {
+        case Framebuffer::TextureFormat::Depth24Stencil8:  return true;
+        }
+        return false;
+    }
+
+    static SoftwareImage::Format FBTextureFormatToSoftware(Framebuffer::TextureFormat inFormat)
+    {
+        switch (inFormat)
+        {
+        case Framebuffer::TextureFormat::RGBA8:             return SoftwareImage::Format::RGBA8;
+        case Framebuffer::TextureFormat::RedInteger:        return SoftwareImage::Format::R32I;
+        // there is no stencil, the depth is kept as a float
+        case Framebuffer::TextureFormat::Depth24Stencil8:   return SoftwareImage::Format::Depth32F;
+        }
+        ZE_ASSERT_CORE_MSG(false, "Unsupported framebuffer format!");
+        return SoftwareImage::Format::None;
+    }
+
+    SoftwareFramebuffer::SoftwareFramebuffer(const Framebuffer::Properties &inProperties)
+        : mProperties(inProperties)
+    {
+        ZE_ASSERT_CORE_MSG(mProperties.Samples == 1, "Multisampled framebuffers are not supported by the software renderer!");
+        for (auto textureProps : inProperties.AttachmentProps.Attachments)
+        {
+            auto format = FBTextureFormatToSoftware(textureProps.Format);
+            if (IsDepthFormat(textureProps.Format))
+                mDepthAttachment = SoftwareImage(mProperties.Width, mProperties.Height, format);
+            else
+                mColorAttachments.emplace_back(mProperties.Width, mProperties.Height, format);
+        }
+        ZE_ASSERT_CORE_MSG(mColorAttachments.size() <= SoftwareShaderProgram::MaxColorTargets, "Too many color attachments!");
+    }
+
+    SoftwareFramebuffer::~SoftwareFramebuffer()
+    {
+        if (!SoftwareRendererAPI::IsInitialized()) return;
+        auto &api = SoftwareRendererAPI::Get();
+        api.ReleaseFramebuffer(this);
+        for (auto &attachment : mColorAttachments)
+            api.ReleaseImage(&attachment);
+        api.ReleaseImage(&mDepthAttachment);
+    }
+
+    void SoftwareFramebuffer::Bind()
+    {
+        SoftwareRendererAPI::Get().BindFramebuffer(this);
+    }
+
+    void SoftwareFramebuffer::Unbind()
+    {
+        SoftwareRendererAPI::Get().BindFramebuffer(nullptr);
+    }
+
+    void SoftwareFramebuffer::Resize(uint32_t inWidth, uint32_t inHeight)
+    {
+        if (inWidth == 0 || inHeight == 0 || inWidth > MaxFramebufferSize || inHeight > MaxFramebufferSize)
+        {
+            ZE_CORE_WARN("Attempted to rezize framebuffer to {}, {}", inWidth, inHeight);
+            return;
+        }
+        mProperties.Width = inWidth;
+        mProperties.Height = inHeight;
+
+        for (auto &attachment : mColorAttachments)
+            attachment.Resize(inWidth, inHeight);
+        if (HasDepthAttachment())
+            mDepthAttachment.Resize(inWidth, inHeight);
+    }
+
+    SoftwareRenderTarget SoftwareFramebuffer::GetRenderTarget()
+    {
+        SoftwareRenderTarget target;
+        for (auto &attachment : mColorAttachments)
+            target.Colors[target.ColorCount++] = &attachment;
+        target.Depth = HasDepthAttachment() ? &mDepthAttachment : nullptr;
+        target.Width = mProperties.Width;
+        target.Height = mProperties.Height;
+        return target;
+    }
+
+    void SoftwareFramebuffer::BindColorAttachmentTexture(uint32_t inIndex, uint32_t inSlot) const
+    {
+        ZE_ASSERT_CORE_MSG(inIndex < mColorAttachments.size(), "Invalid index given!");
+        auto &attachment = mColorAttachments[inIndex];
+        SoftwareSampler sampler;
+        sampler.Linear = attachment.GetFormat() != SoftwareImage::Format::R32I;
+        SoftwareRendererAPI::Get().BindTexture(inSlot, &attachment, sampler);
+    }
+
+    void SoftwareFramebuffer::BindDepthAttachmentTexture(uint32_t inSlot) const
+    {
+        ZE_ASSERT_CORE_MSG(HasDepthAttachment(), "The framebuffer has no depth attachment!");
+        SoftwareSampler sampler;
+        sampler.Linear = false;
+        SoftwareRendererAPI::Get().BindTexture(inSlot, &mDepthAttachment, sampler);
+    }
+
+    void SoftwareFramebuffer::BindAllAttachments(uint32_t inStartingSlot) const
+    {
+        for (uint32_t i = 0; i < mColorAttachments.size(); ++i)
+        {
+            BindColorAttachmentTexture(i, inStartingSlot + i);
+        }
+        BindDepthAttachmentTexture(inStartingSlot + mColorAttachments.size());
+    }
+}
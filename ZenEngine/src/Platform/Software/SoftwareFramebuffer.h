@@ -0,0 +1,51 @@
+#pragma once
+
+#include <vector>
+
+#include "ZenEngine/Renderer/Framebuffer.h"
+#include "ZenEngine/Core/Macros.h"
+#include "SoftwareImage.h"
+#include "SoftwareRasterizer.h"
+
+namespace ZenEngine
+{
+    class SoftwareFramebuffer : public Framebuffer
+    {
+    public:
+        SoftwareFramebuffer(const Framebuffer::Properties& inProperties);
+        virtual ~SoftwareFramebuffer();
+
+        virtual void Bind() override;
+        virtual void Unbind() override;
+
+        virtual void Resize(uint32_t width, uint32_t height) override;
+
+        // attachments are plain memory, there is no name the editor could display
+        virtual uint32_t GetColorAttachmentRendererId(uint32_t inIndex = 0) const override
+        {
+            ZE_ASSERT_CORE_MSG(inIndex < mColorAttachments.size(), "Invalid index given!");
+            return 0;
+        }
+
+        virtual void BindColorAttachmentTexture(uint32_t inIndex = 0, uint32_t inSlot = 0) const override;
+        virtual void BindDepthAttachmentTexture(uint32_t inSlot = 0) const override;
+        virtual void BindAllAttachments(uint32_t inStartingSlot = 0) const override;
+
+        virtual const Properties &GetProperties() const override
+        {
+            return mProperties;
+        }
+
+        const SoftwareImage &GetColorAttachment(uint32_t inIndex) const { return mColorAttachments[inIndex]; }
+        const SoftwareImage &GetDepthAttachment() const { return mDepthAttachment; }
+        bool HasDepthAttachment() const { return mDepthAttachment.GetFormat() != SoftwareImage::Format::None; }
+
+        SoftwareRenderTarget GetRenderTarget();
+    private:
+        Properties mProperties;
+
+        // sized once, resizing only reallocates the texels so the bindings pointing at the images stay valid
+        std::vector<SoftwareImage> mColorAttachments;
+        SoftwareImage mDepthAttachment;
+    };
+}
@@ -0,0 +1,29 @@
+#include "SoftwareGLFWRenderContext.h"
+
+#include <GLFW/glfw3.h>
+#include "ZenEngine/Core/Log.h"
+#include "SoftwareRendererAPI.h"
+
+namespace ZenEngine
+{
+    void SoftwareGLFWRenderContext::Init()
+    {
+        ZE_CORE_INFO("Using the software renderer, frames are not presented to the window");
+        ResizeBackBuffer();
+    }
+
+    void SoftwareGLFWRenderContext::SwapBuffers()
+    {
+        ResizeBackBuffer();
+    }
+
+    void SoftwareGLFWRenderContext::ResizeBackBuffer()
+    {
+        // headless runs have no window, the back buffer then follows the viewport
+        if (mWindowHandle == nullptr || !SoftwareRendererAPI::IsInitialized()) return;
+        int width, height;
+        glfwGetFramebufferSize(mWindowHandle, &width, &height);
+        if (width > 0 && height > 0)
+            SoftwareRendererAPI::Get().ResizeBackBuffer(static_cast<uint32_t>(width), static_cast<uint32_t>(height));
+    }
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "ZenEngine/Renderer/RenderContext.h"
+
+struct GLFWwindow;
+
+namespace ZenEngine
+{
+
+    /// @brief Nothing is presented, the window only sizes the back buffer.
+    /// The frames can be read back from the renderer API, e.g. to compare them with golden images
+    class SoftwareGLFWRenderContext : public RenderContext
+    {
+    public:
+        SoftwareGLFWRenderContext(GLFWwindow *inWindowHandle)
+            : mWindowHandle(inWindowHandle)
+        {}
+
+        virtual void Init() override;
+        virtual void SwapBuffers() override;
+    private:
+        GLFWwindow *mWindowHandle;
+
+        void ResizeBackBuffer();
+    };
+
+}
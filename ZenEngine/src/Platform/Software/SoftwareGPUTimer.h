@@ -0,0 +1,26 @@
+#pragma once
+
+#include "ZenEngine/Renderer/GPUTimer.h"
+
+#include <chrono>
+
+namespace ZenEngine
+{
+    /// @brief Software draws complete before they return, so the wall clock time between Begin and End is the cost of the pass
+    class SoftwareGPUTimer : public GPUTimer
+    {
+    public:
+        virtual void Begin() override { mBegin = std::chrono::steady_clock::now(); }
+        virtual void End() override
+        {
+            std::chrono::duration<float, std::milli> elapsed = std::chrono::steady_clock::now() - mBegin;
+            mElapsedMilliseconds = elapsed.count();
+        }
+
+        virtual float GetElapsedMilliseconds() const override { return mElapsedMilliseconds; }
+
+    private:
+        std::chrono::steady_clock::time_point mBegin;
+        float mElapsedMilliseconds = 0.0f;
+    };
+}
@@ -0,0 +1,220 @@
+#include "SoftwareImage.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+
+#include "ZenEngine/Core/Log.h"
+
+namespace ZenEngine
+{
+    static uint8_t ToUnorm8(float inValue)
+    {
+        return static_cast<uint8_t>(std::lround(std::clamp(inValue, 0.0f, 1.0f) * 255.0f));
+    }
+
+    SoftwareImage::SoftwareImage(uint32_t inWidth, uint32_t inHeight, Format inFormat)
+        : mFormat(inFormat)
+    {
+        Resize(inWidth, inHeight);
+    }
+
+    void SoftwareImage::Resize(uint32_t inWidth, uint32_t inHeight)
+    {
+        mWidth = inWidth;
+        mHeight = inHeight;
+        mStride = (inWidth + 3) & ~3u;
+        mData.assign(static_cast<size_t>(mStride) * mHeight * GetChannels(), 0.0f);
+    }
+
+    void SoftwareImage::Clear(const glm::vec4 &inValue)
+    {
+        if (mData.empty()) return;
+        if (mFormat == Format::Depth32F)
+        {
+            std::fill(mData.begin(), mData.end(), std::clamp(inValue.r, 0.0f, 1.0f));
+            return;
+        }
+
+        // go through Store once so the clear value is quantized like any other write
+        Store(0, 0, inValue);
+        glm::vec4 value = Load(0, 0);
+        for (size_t i = 0; i < mData.size(); i += 4)
+        {
+            mData[i + 0] = value.r;
+            mData[i + 1] = value.g;
+            mData[i + 2] = value.b;
+            mData[i + 3] = value.a;
+        }
+    }
+
+    glm::vec4 SoftwareImage::Load(uint32_t inX, uint32_t inY) const
+    {
+        const float *row = GetRow(inY);
+        if (mFormat == Format::Depth32F)
+            return { row[inX], 0.0f, 0.0f, 1.0f };
+        const float *texel = row + inX * 4;
+        return { texel[0], texel[1], texel[2], texel[3] };
+    }
+
+    void SoftwareImage::Store(uint32_t inX, uint32_t inY, const glm::vec4 &inValue)
+    {
+        float *row = GetRow(inY);
+        switch (mFormat)
+        {
+        case Format::Depth32F:
+            row[inX] = std::clamp(inValue.r, 0.0f, 1.0f);
+            return;
+        case Format::RGBA8:
+        {
+            float *texel = row + inX * 4;
+            for (uint32_t i = 0; i < 4; ++i)
+                texel[i] = static_cast<float>(ToUnorm8(inValue[i])) / 255.0f;
+            return;
+        }
+        case Format::R32I:
+        {
+            float *texel = row + inX * 4;
+            texel[0] = std::trunc(inValue.r);
+            texel[1] = 0.0f;
+            texel[2] = 0.0f;
+            texel[3] = 1.0f;
+            return;
+        }
+        default:
+        {
+            float *texel = row + inX * 4;
+            texel[0] = inValue.r;
+            texel[1] = inValue.g;
+            texel[2] = inValue.b;
+            texel[3] = inValue.a;
+            return;
+        }
+        }
+    }
+
+    glm::vec4 SoftwareImage::Fetch(int32_t inX, int32_t inY, bool inRepeat) const
+    {
+        int32_t width = static_cast<int32_t>(mWidth);
+        int32_t height = static_cast<int32_t>(mHeight);
+        if (inRepeat)
+        {
+            inX = ((inX % width) + width) % width;
+            inY = ((inY % height) + height) % height;
+        }
+        else
+        {
+            inX = std::clamp(inX, 0, width - 1);
+            inY = std::clamp(inY, 0, height - 1);
+        }
+        return Load(static_cast<uint32_t>(inX), static_cast<uint32_t>(inY));
+    }
+
+    glm::vec4 SoftwareImage::Sample(const glm::vec2 &inTexCoord, const SoftwareSampler &inSampler) const
+    {
+        if (mWidth == 0 || mHeight == 0) return { 0.0f, 0.0f, 0.0f, 1.0f };
+
+        float x = inTexCoord.x * static_cast<float>(mWidth);
+        float y = inTexCoord.y * static_cast<float>(mHeight);
+        if (!inSampler.Linear)
+            return Fetch(static_cast<int32_t>(std::floor(x)), static_cast<int32_t>(std::floor(y)), inSampler.Repeat);
+
+        // texel centers sit at half coordinates, same as the GL_LINEAR footprint
+        x -= 0.5f;
+        y -= 0.5f;
+        float x0 = std::floor(x);
+        float y0 = std::floor(y);
+        float fx = x - x0;
+        float fy = y - y0;
+        int32_t ix = static_cast<int32_t>(x0);
+        int32_t iy = static_cast<int32_t>(y0);
+
+        glm::vec4 bottom = glm::mix(Fetch(ix, iy, inSampler.Repeat), Fetch(ix + 1, iy, inSampler.Repeat), fx);
+        glm::vec4 top = glm::mix(Fetch(ix, iy + 1, inSampler.Repeat), Fetch(ix + 1, iy + 1, inSampler.Repeat), fx);
+        return glm::mix(bottom, top, fy);
+    }
+
+    bool SoftwareImage::SavePPM(const std::filesystem::path &inFilepath) const
+    {
+        std::ofstream ofs(inFilepath, std::ios::binary);
+        if (!ofs)
+        {
+            ZE_CORE_ERROR("Could not open {} for writing", inFilepath.string());
+            return false;
+        }
+
+        ofs << "P6\n" << mWidth << " " << mHeight << "\n255\n";
+        std::vector<uint8_t> row(mWidth * 3);
+        for (uint32_t y = mHeight; y-- > 0;)
+        {
+            for (uint32_t x = 0; x < mWidth; ++x)
+            {
+                glm::vec4 texel = Load(x, y);
+                // depth has a single channel, show it as gray
+                if (mFormat == Format::Depth32F) texel = glm::vec4(texel.r);
+                row[x * 3 + 0] = ToUnorm8(texel.r);
+                row[x * 3 + 1] = ToUnorm8(texel.g);
+                row[x * 3 + 2] = ToUnorm8(texel.b);
+            }
+            ofs.write(reinterpret_cast<const char*>(row.data()), row.size());
+        }
+        return static_cast<bool>(ofs);
+    }
+
+    bool SoftwareImage::LoadPPM(const std::filesystem::path &inFilepath, SoftwareImage &outImage)
+    {
+        std::ifstream ifs(inFilepath, std::ios::binary);
+        std::string magic;
+        uint32_t width = 0, height = 0, maxValue = 0;
+        ifs >> magic >> width >> height >> maxValue;
+        if (!ifs || magic != "P6" || maxValue != 255 || width == 0 || height == 0)
+        {
+            ZE_CORE_ERROR("{} is not a binary 8 bit PPM", inFilepath.string());
+            return false;
+        }
+        // exactly one whitespace separates the header from the pixels
+        ifs.get();
+
+        std::vector<uint8_t> pixels(static_cast<size_t>(width) * height * 3);
+        ifs.read(reinterpret_cast<char*>(pixels.data()), pixels.size());
+        if (!ifs)
+        {
+            ZE_CORE_ERROR("{} is truncated", inFilepath.string());
+            return false;
+        }
+
+        outImage = SoftwareImage(width, height, Format::RGBA8);
+        for (uint32_t y = 0; y < height; ++y)
+        {
+            const uint8_t *row = pixels.data() + static_cast<size_t>(height - 1 - y) * width * 3;
+            for (uint32_t x = 0; x < width; ++x)
+                outImage.Store(x, y, glm::vec4(row[x * 3], row[x * 3 + 1], row[x * 3 + 2], 255.0f) / 255.0f);
+        }
+        return true;
+    }
+
+    uint32_t SoftwareImage::CountMismatches(const SoftwareImage &inA, const SoftwareImage &inB, uint32_t inTolerance)
+    {
+        if (inA.mWidth != inB.mWidth || inA.mHeight != inB.mHeight)
+            return std::max(inA.mWidth * inA.mHeight, inB.mWidth * inB.mHeight);
+
+        uint32_t mismatches = 0;
+        for (uint32_t y = 0; y < inA.mHeight; ++y)
+        {
+            for (uint32_t x = 0; x < inA.mWidth; ++x)
+            {
+                glm::vec4 a = inA.Load(x, y);
+                glm::vec4 b = inB.Load(x, y);
+                for (uint32_t c = 0; c < 3; ++c)
+                {
+                    if (static_cast<uint32_t>(std::abs(ToUnorm8(a[c]) - ToUnorm8(b[c]))) > inTolerance)
+                    {
+                        ++mismatches;
+                        break;
+                    }
+                }
+            }
+        }
+        return mismatches;
+    }
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <filesystem>
+#include <stdint.h>
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace ZenEngine
+{
+    struct SoftwareSampler
+    {
+        bool Linear = true;
+        // clamps to the edge otherwise
+        bool Repeat = false;
+    };
+
+    /// @brief CPU side image used for the textures and render targets of the software renderer.
+    /// Rows are stored bottom up like OpenGL textures, so texture coordinate (0, 0) is the first texel.
+    class SoftwareImage
+    {
+    public:
+        enum class Format
+        {
+            None = 0,
+            // stored as floats, but every write is quantized to 8 bits like a GL_RGBA8 target
+            RGBA8,
+            RGBA32F,
+            R32I,
+            Depth32F
+        };
+
+        SoftwareImage() = default;
+        SoftwareImage(uint32_t inWidth, uint32_t inHeight, Format inFormat);
+
+        void Resize(uint32_t inWidth, uint32_t inHeight);
+        void Clear(const glm::vec4 &inValue);
+
+        uint32_t GetWidth() const { return mWidth; }
+        uint32_t GetHeight() const { return mHeight; }
+        // texels per row, padded to a multiple of 4 so the rasterizer can always load whole SIMD lanes
+        uint32_t GetStride() const { return mStride; }
+        Format GetFormat() const { return mFormat; }
+        uint32_t GetChannels() const { return mFormat == Format::Depth32F ? 1 : 4; }
+
+        float *GetRow(uint32_t inY) { return mData.data() + static_cast<size_t>(inY) * mStride * GetChannels(); }
+        const float *GetRow(uint32_t inY) const { return mData.data() + static_cast<size_t>(inY) * mStride * GetChannels(); }
+
+        glm::vec4 Load(uint32_t inX, uint32_t inY) const;
+        void Store(uint32_t inX, uint32_t inY, const glm::vec4 &inValue);
+
+        glm::vec4 Sample(const glm::vec2 &inTexCoord, const SoftwareSampler &inSampler) const;
+
+        /// @brief Writes the image as a binary PPM, top row first. Alpha is dropped
+        bool SavePPM(const std::filesystem::path &inFilepath) const;
+        /// @brief Reads a binary PPM written by SavePPM into an RGBA8 image
+        static bool LoadPPM(const std::filesystem::path &inFilepath, SoftwareImage &outImage);
+
+        /// @brief Counts the texels whose 8 bit RGB values differ by more than the tolerance, used to compare against golden images.
+        /// Images of different sizes differ in every texel
+        static uint32_t CountMismatches(const SoftwareImage &inA, const SoftwareImage &inB, uint32_t inTolerance = 0);
+
+    private:
+        uint32_t mWidth = 0;
+        uint32_t mHeight = 0;
+        uint32_t mStride = 0;
+        Format mFormat = Format::None;
+        std::vector<float> mData;
+
+        glm::vec4 Fetch(int32_t inX, int32_t inY, bool inRepeat) const;
+    };
+}
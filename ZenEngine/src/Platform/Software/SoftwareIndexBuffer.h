@@ -0,0 +1,26 @@
+#pragma once
+
+#include <vector>
+#include "ZenEngine/Renderer/IndexBuffer.h"
+
+namespace ZenEngine
+{
+
+    class SoftwareIndexBuffer : public IndexBuffer
+    {
+    public:
+        SoftwareIndexBuffer(const uint32_t* inIndices, uint32_t inCount)
+            : mIndices(inIndices, inIndices + inCount)
+        {}
+
+        virtual void Bind() const {}
+        virtual void Unbind() const {}
+
+        virtual uint32_t GetCount() const { return static_cast<uint32_t>(mIndices.size()); }
+
+        const uint32_t *GetIndices() const { return mIndices.data(); }
+    private:
+        std::vector<uint32_t> mIndices;
+    };
+
+}
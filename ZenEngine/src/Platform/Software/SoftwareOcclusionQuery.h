@@ -0,0 +1,54 @@
+#pragma once
+
+#include "ZenEngine/Renderer/OcclusionQuery.h"
+#include "SoftwareRendererAPI.h"
+
+#include <atomic>
+#include <vector>
+
+namespace ZenEngine
+{
+    /// @brief Software draws complete before they return, so a query has its result as soon as it ends
+    class SoftwareOcclusionQueryPool : public OcclusionQueryPool
+    {
+    public:
+        virtual void Reserve(uint32_t inCount) override
+        {
+            if (inCount <= mSamples.size()) return;
+            mSamples.resize(inCount, 0);
+            mIssued.resize(inCount, false);
+        }
+        virtual uint32_t GetSize() const override { return static_cast<uint32_t>(mSamples.size()); }
+
+        virtual void Begin(uint32_t inQuery) override
+        {
+            mCounter.store(0, std::memory_order_relaxed);
+            SoftwareRendererAPI::Get().SetSampleCounter(&mCounter);
+        }
+        virtual void End(uint32_t inQuery) override
+        {
+            SoftwareRendererAPI::Get().SetSampleCounter(nullptr);
+            mSamples[inQuery] = mCounter.load(std::memory_order_relaxed);
+            mIssued[inQuery] = true;
+        }
+        virtual Result GetResult(uint32_t inQuery) override
+        {
+            if (!mIssued[inQuery]) return Result::Pending;
+            return mSamples[inQuery] > 0 ? Result::Visible : Result::Occluded;
+        }
+        virtual void Reset(uint32_t inQuery) override { mIssued[inQuery] = false; }
+
+        virtual void BeginConditionalRender(uint32_t inQuery) override
+        {
+            if (mIssued[inQuery] && mSamples[inQuery] == 0)
+                SoftwareRendererAPI::Get().SetDrawsDiscarded(true);
+        }
+        virtual void EndConditionalRender() override { SoftwareRendererAPI::Get().SetDrawsDiscarded(false); }
+        virtual bool SupportsConditionalRender() const override { return true; }
+
+    private:
+        std::atomic<uint64_t> mCounter = 0;
+        std::vector<uint64_t> mSamples;
+        std::vector<bool> mIssued;
+    };
+}
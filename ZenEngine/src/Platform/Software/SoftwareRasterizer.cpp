@@ -0,0 +1,486 @@
+#include "SoftwareRasterizer.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+#include "ZenEngine/Core/JobSystem.h"
+#include "ZenEngine/Core/Macros.h"
+
+#if defined(_M_X64) || defined(__SSE2__)
+    #include <emmintrin.h>
+#else
+    #error "The software renderer needs SSE2!"
+#endif
+
+namespace ZenEngine
+{
+    using DepthFunction = RendererAPI::DepthFunction;
+    using BlendFunction = RendererAPI::BlendFunction;
+    using BlendMode = RendererAPI::BlendMode;
+    using CullMode = RendererAPI::CullMode;
+
+    // vertices are snapped to 1/256 of a pixel, inside the guard band that keeps them exact in a float
+    static constexpr float SubPixelSteps = 256.0f;
+    static constexpr float GuardBand = 8192.0f;
+    static constexpr uint32_t MaxClipVertices = 3 + 6;
+    static constexpr uint32_t MinVerticesPerBatch = 256;
+
+    static bool DepthTest(DepthFunction inFunction, float inDepth, float inStored)
+    {
+        switch (inFunction)
+        {
+        case DepthFunction::Never:          return false;
+        case DepthFunction::Less:           return inDepth < inStored;
+        case DepthFunction::Equal:          return inDepth == inStored;
+        case DepthFunction::LessEqual:      return inDepth <= inStored;
+        case DepthFunction::Greater:        return inDepth > inStored;
+        case DepthFunction::NotEqual:       return inDepth != inStored;
+        case DepthFunction::GreaterEqual:   return inDepth >= inStored;
+        case DepthFunction::Always:         return true;
+        }
+        return true;
+    }
+
+    static __m128 DepthTest(DepthFunction inFunction, __m128 inDepth, __m128 inStored)
+    {
+        switch (inFunction)
+        {
+        case DepthFunction::Never:          return _mm_setzero_ps();
+        case DepthFunction::Less:           return _mm_cmplt_ps(inDepth, inStored);
+        case DepthFunction::Equal:          return _mm_cmpeq_ps(inDepth, inStored);
+        case DepthFunction::LessEqual:      return _mm_cmple_ps(inDepth, inStored);
+        case DepthFunction::Greater:        return _mm_cmpgt_ps(inDepth, inStored);
+        case DepthFunction::NotEqual:       return _mm_cmpneq_ps(inDepth, inStored);
+        case DepthFunction::GreaterEqual:   return _mm_cmpge_ps(inDepth, inStored);
+        case DepthFunction::Always:         break;
+        }
+        return _mm_castsi128_ps(_mm_set1_epi32(-1));
+    }
+
+    static glm::vec4 BlendFactor(BlendFunction inFunction, const glm::vec4 &inSource, const glm::vec4 &inDestination)
+    {
+        // the blend constant is never set, it keeps the OpenGL default of zero
+        switch (inFunction)
+        {
+        case BlendFunction::Zero:                       return glm::vec4(0.0f);
+        case BlendFunction::One:                        return glm::vec4(1.0f);
+        case BlendFunction::SourceColor:                return inSource;
+        case BlendFunction::OneMinusSourceColor:        return glm::vec4(1.0f) - inSource;
+        case BlendFunction::DestinationColor:           return inDestination;
+        case BlendFunction::OneMinusDestinationColor:   return glm::vec4(1.0f) - inDestination;
+        case BlendFunction::SourceAlpha:                return glm::vec4(inSource.a);
+        case BlendFunction::OneMinusSourceAlpha:        return glm::vec4(1.0f - inSource.a);
+        case BlendFunction::DestinationAlpha:           return glm::vec4(inDestination.a);
+        case BlendFunction::OneMinusDestinationAlpha:   return glm::vec4(1.0f - inDestination.a);
+        case BlendFunction::ConstantColor:
+        case BlendFunction::ConstantAlpha:              return glm::vec4(0.0f);
+        case BlendFunction::OneMinusConstantColor:
+        case BlendFunction::OneMinusConstantAlpha:      return glm::vec4(1.0f);
+        }
+        return glm::vec4(1.0f);
+    }
+
+    static glm::vec4 Blend(const PipelineState &inState, const glm::vec4 &inSource, const glm::vec4 &inDestination)
+    {
+        glm::vec4 source = glm::clamp(inSource, 0.0f, 1.0f);
+        glm::vec4 sourceTerm = source * BlendFactor(inState.SourceBlend, source, inDestination);
+        glm::vec4 destinationTerm = inDestination * BlendFactor(inState.DestinationBlend, source, inDestination);
+        switch (inState.BlendMode)
+        {
+        case BlendMode::Add:                return sourceTerm + destinationTerm;
+        case BlendMode::Subtract:           return sourceTerm - destinationTerm;
+        case BlendMode::ReverseSubtract:    return destinationTerm - sourceTerm;
+        // min and max ignore the factors, as in OpenGL
+        case BlendMode::Min:                return glm::min(source, inDestination);
+        case BlendMode::Max:                return glm::max(source, inDestination);
+        }
+        return sourceTerm + destinationTerm;
+    }
+
+    static float Snap(float inValue)
+    {
+        return std::round(inValue * SubPixelSteps) / SubPixelSteps;
+    }
+
+    static SoftwareClipVertex Lerp(const SoftwareClipVertex &inA, const SoftwareClipVertex &inB, float inT, uint32_t inVaryingCount)
+    {
+        SoftwareClipVertex result;
+        result.Position = glm::mix(inA.Position, inB.Position, inT);
+        for (uint32_t i = 0; i < inVaryingCount; ++i)
+            result.Varyings[i] = inA.Varyings[i] + (inB.Varyings[i] - inA.Varyings[i]) * inT;
+        return result;
+    }
+
+    // signed distances to the near and far planes of the OpenGL clip volume and to the guard band, inside is positive
+    static float PlaneDistance(const glm::vec4 &inPosition, uint32_t inPlane, const glm::vec2 &inGuardBand)
+    {
+        switch (inPlane)
+        {
+        case 0: return inPosition.z + inPosition.w;
+        case 1: return inPosition.w - inPosition.z;
+        case 2: return inGuardBand.x * inPosition.w + inPosition.x;
+        case 3: return inGuardBand.x * inPosition.w - inPosition.x;
+        case 4: return inGuardBand.y * inPosition.w + inPosition.y;
+        case 5: return inGuardBand.y * inPosition.w - inPosition.y;
+        }
+        return 0.0f;
+    }
+
+    // Sutherland-Hodgman against every plane, returns the vertex count of the clipped polygon
+    static uint32_t ClipPolygon(std::array<SoftwareClipVertex, MaxClipVertices> &ioPolygon, uint32_t inCount, uint32_t inVaryingCount, const glm::vec2 &inGuardBand)
+    {
+        std::array<SoftwareClipVertex, MaxClipVertices> clipped;
+        for (uint32_t plane = 0; plane < 6 && inCount > 0; ++plane)
+        {
+            uint32_t count = 0;
+            for (uint32_t i = 0; i < inCount; ++i)
+            {
+                const auto &current = ioPolygon[i];
+                const auto &next = ioPolygon[(i + 1) % inCount];
+                float currentDistance = PlaneDistance(current.Position, plane, inGuardBand);
+                float nextDistance = PlaneDistance(next.Position, plane, inGuardBand);
+
+                if (currentDistance >= 0.0f)
+                    clipped[count++] = current;
+                if ((currentDistance >= 0.0f) != (nextDistance >= 0.0f))
+                    clipped[count++] = Lerp(current, next, currentDistance / (currentDistance - nextDistance), inVaryingCount);
+            }
+            std::copy(clipped.begin(), clipped.begin() + count, ioPolygon.begin());
+            inCount = count;
+        }
+        return inCount;
+    }
+
+    SoftwareRasterizer::Bounds SoftwareRasterizer::GetScissor(const SoftwareDrawCall &inDraw)
+    {
+        Bounds scissor;
+        scissor.MinX = std::max(inDraw.Viewport[0], 0);
+        scissor.MinY = std::max(inDraw.Viewport[1], 0);
+        scissor.MaxX = std::min(inDraw.Viewport[0] + inDraw.Viewport[2], static_cast<int32_t>(inDraw.Target.Width)) - 1;
+        scissor.MaxY = std::min(inDraw.Viewport[1] + inDraw.Viewport[3], static_cast<int32_t>(inDraw.Target.Height)) - 1;
+        return scissor;
+    }
+
+    SoftwareRasterizer::ScreenVertex SoftwareRasterizer::ToScreen(const SoftwareDrawCall &inDraw, const SoftwareClipVertex &inVertex, uint32_t inVaryingCount)
+    {
+        ScreenVertex vertex;
+        vertex.InvW = 1.0f / inVertex.Position.w;
+        glm::vec3 ndc = glm::vec3(inVertex.Position) * vertex.InvW;
+        vertex.X = Snap(static_cast<float>(inDraw.Viewport[0]) + (ndc.x * 0.5f + 0.5f) * static_cast<float>(inDraw.Viewport[2]));
+        vertex.Y = Snap(static_cast<float>(inDraw.Viewport[1]) + (ndc.y * 0.5f + 0.5f) * static_cast<float>(inDraw.Viewport[3]));
+        vertex.Z = std::clamp(ndc.z * 0.5f + 0.5f, 0.0f, 1.0f);
+        for (uint32_t i = 0; i < inVaryingCount; ++i)
+            vertex.Varyings[i] = inVertex.Varyings[i] * vertex.InvW;
+        return vertex;
+    }
+
+    void SoftwareRasterizer::DrawTriangles(const SoftwareDrawCall &inDraw, const std::vector<SoftwareClipVertex> &inVertices, const uint32_t *inIndices, uint32_t inIndexCount)
+    {
+        Bounds scissor = GetScissor(inDraw);
+        if (scissor.MinX > scissor.MaxX || scissor.MinY > scissor.MaxY) return;
+
+        uint32_t varyingCount = inDraw.Program->GetVaryingCount();
+        glm::vec2 guardBand(GuardBand / std::max(inDraw.Viewport[2], 1), GuardBand / std::max(inDraw.Viewport[3], 1));
+
+        mTriangles.clear();
+        for (uint32_t i = 0; i + 2 < inIndexCount; i += 3)
+        {
+            std::array<SoftwareClipVertex, MaxClipVertices> polygon;
+            bool inside = true;
+            for (uint32_t j = 0; j < 3; ++j)
+            {
+                ZE_ASSERT_CORE_MSG(inIndices[i + j] < inVertices.size(), "Index {} is out of range!", inIndices[i + j]);
+                polygon[j] = inVertices[inIndices[i + j]];
+                for (uint32_t plane = 0; plane < 6; ++plane)
+                    inside &= PlaneDistance(polygon[j].Position, plane, guardBand) >= 0.0f;
+            }
+
+            uint32_t count = inside ? 3 : ClipPolygon(polygon, 3, varyingCount, guardBand);
+            if (count < 3) continue;
+
+            std::array<ScreenVertex, MaxClipVertices> screen;
+            for (uint32_t j = 0; j < count; ++j)
+                screen[j] = ToScreen(inDraw, polygon[j], varyingCount);
+            for (uint32_t j = 1; j + 1 < count; ++j)
+                SetupTriangle(inDraw, scissor, screen[0], screen[j], screen[j + 1]);
+        }
+        if (mTriangles.empty()) return;
+
+        uint32_t tilesX = (inDraw.Target.Width + TileSize - 1) / TileSize;
+        uint32_t tilesY = (inDraw.Target.Height + TileSize - 1) / TileSize;
+        mBins.resize(std::max<size_t>(mBins.size(), tilesX * tilesY));
+        mActiveTiles.clear();
+        for (uint32_t t = 0; t < mTriangles.size(); ++t)
+        {
+            const auto &triangle = mTriangles[t];
+            for (int32_t ty = triangle.MinY / TileSize; ty <= triangle.MaxY / TileSize; ++ty)
+            {
+                for (int32_t tx = triangle.MinX / TileSize; tx <= triangle.MaxX / TileSize; ++tx)
+                {
+                    uint32_t tile = ty * tilesX + tx;
+                    if (mBins[tile].empty()) mActiveTiles.push_back(tile);
+                    mBins[tile].push_back(t);
+                }
+            }
+        }
+
+        JobSystem::Get().ParallelFor(static_cast<uint32_t>(mActiveTiles.size()), 1, [&](uint32_t inBegin, uint32_t inEnd)
+        {
+            for (uint32_t i = inBegin; i < inEnd; ++i)
+                RasterizeTile(inDraw, scissor, mActiveTiles[i], tilesX);
+        });
+
+        for (uint32_t tile : mActiveTiles)
+            mBins[tile].clear();
+    }
+
+    void SoftwareRasterizer::SetupTriangle(const SoftwareDrawCall &inDraw, const Bounds &inScissor, const ScreenVertex &inV0, const ScreenVertex &inV1, const ScreenVertex &inV2)
+    {
+        double area = (static_cast<double>(inV1.X) - inV0.X) * (static_cast<double>(inV2.Y) - inV0.Y)
+                    - (static_cast<double>(inV2.X) - inV0.X) * (static_cast<double>(inV1.Y) - inV0.Y);
+        if (area == 0.0) return;
+
+        // window coordinates go up, so counter clockwise triangles are front facing like the OpenGL default
+        bool frontFacing = area > 0.0;
+        if (inDraw.State.Cull == CullMode::Back && !frontFacing) return;
+        if (inDraw.State.Cull == CullMode::Front && frontFacing) return;
+
+        Triangle triangle;
+        triangle.Vertices[0] = inV0;
+        triangle.Vertices[1] = frontFacing ? inV1 : inV2;
+        triangle.Vertices[2] = frontFacing ? inV2 : inV1;
+        triangle.InvArea = static_cast<float>(1.0 / std::abs(area));
+
+        const ScreenVertex *v = triangle.Vertices;
+        for (uint32_t i = 0; i < 3; ++i)
+        {
+            // every edge is set up from the same end, whichever triangle it belongs to, and flipped afterwards.
+            // a shared edge then gets exactly opposite functions, so no sample is covered twice or missed
+            const ScreenVertex *p = &v[(i + 1) % 3];
+            const ScreenVertex *q = &v[(i + 2) % 3];
+            bool flip = p->Y > q->Y || (p->Y == q->Y && p->X > q->X);
+            if (flip) std::swap(p, q);
+
+            double a = static_cast<double>(p->Y) - q->Y;
+            double b = static_cast<double>(q->X) - p->X;
+            double c = static_cast<double>(p->X) * q->Y - static_cast<double>(p->Y) * q->X;
+            if (flip) { a = -a; b = -b; c = -c; }
+
+            triangle.A[i] = a;
+            triangle.B[i] = b;
+            triangle.C[i] = c;
+            triangle.Owned[i] = a > 0.0 || (a == 0.0 && b > 0.0);
+        }
+
+        // samples sit at pixel centers
+        float minX = std::min({ v[0].X, v[1].X, v[2].X });
+        float minY = std::min({ v[0].Y, v[1].Y, v[2].Y });
+        float maxX = std::max({ v[0].X, v[1].X, v[2].X });
+        float maxY = std::max({ v[0].Y, v[1].Y, v[2].Y });
+        triangle.MinX = std::max(static_cast<int32_t>(std::floor(minX - 0.5f)), inScissor.MinX);
+        triangle.MinY = std::max(static_cast<int32_t>(std::floor(minY - 0.5f)), inScissor.MinY);
+        triangle.MaxX = std::min(static_cast<int32_t>(std::ceil(maxX - 0.5f)), inScissor.MaxX);
+        triangle.MaxY = std::min(static_cast<int32_t>(std::ceil(maxY - 0.5f)), inScissor.MaxY);
+        if (triangle.MinX > triangle.MaxX || triangle.MinY > triangle.MaxY) return;
+
+        mTriangles.push_back(triangle);
+    }
+
+    void SoftwareRasterizer::RasterizeTile(const SoftwareDrawCall &inDraw, const Bounds &inScissor, uint32_t inTile, uint32_t inTilesX) const
+    {
+        const int32_t tileX = static_cast<int32_t>(inTile % inTilesX) * TileSize;
+        const int32_t tileY = static_cast<int32_t>(inTile / inTilesX) * TileSize;
+        const uint32_t varyingCount = inDraw.Program->GetVaryingCount();
+        const bool depthTest = inDraw.State.DepthTest && inDraw.Target.Depth != nullptr;
+
+        const __m128 laneOffsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 one = _mm_set1_ps(1.0f);
+        // counted per tile so the tiles only meet once on the shared counter
+        uint64_t samplesPassed = 0;
+
+        for (uint32_t index : mBins[inTile])
+        {
+            const Triangle &triangle = mTriangles[index];
+            const ScreenVertex *v = triangle.Vertices;
+
+            int32_t minX = std::max(triangle.MinX, tileX);
+            int32_t minY = std::max(triangle.MinY, tileY);
+            int32_t maxX = std::min(triangle.MaxX, tileX + TileSize - 1);
+            int32_t maxY = std::min(triangle.MaxY, tileY + TileSize - 1);
+            if (minX > maxX || minY > maxY) continue;
+
+            // edge functions relative to the tile origin keep the values small and precise in single precision
+            __m128 a[3];
+            float b[3], c[3];
+            __m128 owned[3];
+            for (uint32_t i = 0; i < 3; ++i)
+            {
+                a[i] = _mm_set1_ps(static_cast<float>(triangle.A[i]));
+                b[i] = static_cast<float>(triangle.B[i]);
+                c[i] = static_cast<float>(triangle.C[i] + triangle.A[i] * tileX + triangle.B[i] * tileY);
+                owned[i] = triangle.Owned[i] ? _mm_castsi128_ps(_mm_set1_epi32(-1)) : zero;
+            }
+            const __m128 invArea = _mm_set1_ps(triangle.InvArea);
+            const __m128 z0 = _mm_set1_ps(v[0].Z), z1 = _mm_set1_ps(v[1].Z), z2 = _mm_set1_ps(v[2].Z);
+
+            for (int32_t y = minY; y <= maxY; ++y)
+            {
+                float localY = static_cast<float>(y - tileY) + 0.5f;
+                __m128 rows[3];
+                for (uint32_t i = 0; i < 3; ++i)
+                    rows[i] = _mm_set1_ps(b[i] * localY + c[i]);
+
+                float *depthRow = depthTest ? inDraw.Target.Depth->GetRow(y) : nullptr;
+                for (int32_t x = minX & ~3; x <= maxX; x += 4)
+                {
+                    __m128 localX = _mm_add_ps(_mm_set1_ps(static_cast<float>(x - tileX)), laneOffsets);
+                    __m128 e[3];
+                    __m128 covered = _mm_castsi128_ps(_mm_set1_epi32(-1));
+                    for (uint32_t i = 0; i < 3; ++i)
+                    {
+                        e[i] = _mm_add_ps(_mm_mul_ps(a[i], localX), rows[i]);
+                        __m128 inside = _mm_or_ps(_mm_cmpgt_ps(e[i], zero), _mm_and_ps(_mm_cmpeq_ps(e[i], zero), owned[i]));
+                        covered = _mm_and_ps(covered, inside);
+                    }
+
+                    int32_t mask = _mm_movemask_ps(covered);
+                    // lanes outside the triangle bounds, the scissor is already part of them
+                    for (int32_t lane = 0; lane < 4; ++lane)
+                    {
+                        if (x + lane < minX || x + lane > maxX) mask &= ~(1 << lane);
+                    }
+                    if (mask == 0) continue;
+
+                    __m128 l0 = _mm_mul_ps(e[0], invArea);
+                    __m128 l1 = _mm_mul_ps(e[1], invArea);
+                    __m128 l2 = _mm_mul_ps(e[2], invArea);
+                    __m128 depth = _mm_add_ps(_mm_add_ps(_mm_mul_ps(z0, l0), _mm_mul_ps(z1, l1)), _mm_mul_ps(z2, l2));
+                    depth = _mm_min_ps(_mm_max_ps(depth, zero), one);
+
+                    if (depthTest)
+                    {
+                        // the stride is padded, a whole group is always inside the row
+                        __m128 stored = _mm_loadu_ps(depthRow + x);
+                        mask &= _mm_movemask_ps(DepthTest(inDraw.State.DepthFunction, depth, stored));
+                        if (mask == 0) continue;
+                    }
+                    samplesPassed += std::popcount(static_cast<uint32_t>(mask));
+
+                    alignas(16) float weights[3][4];
+                    alignas(16) float depths[4];
+                    _mm_store_ps(weights[0], l0);
+                    _mm_store_ps(weights[1], l1);
+                    _mm_store_ps(weights[2], l2);
+                    _mm_store_ps(depths, depth);
+
+                    for (int32_t lane = 0; lane < 4; ++lane)
+                    {
+                        if ((mask & (1 << lane)) == 0) continue;
+
+                        float w0 = weights[0][lane], w1 = weights[1][lane], w2 = weights[2][lane];
+                        float w = 1.0f / (w0 * v[0].InvW + w1 * v[1].InvW + w2 * v[2].InvW);
+                        float varyings[SoftwareShaderProgram::MaxVaryings];
+                        for (uint32_t k = 0; k < varyingCount; ++k)
+                            varyings[k] = (w0 * v[0].Varyings[k] + w1 * v[1].Varyings[k] + w2 * v[2].Varyings[k]) * w;
+
+                        ShadeFragment(inDraw, x + lane, y, depths[lane], varyings);
+                    }
+                }
+            }
+        }
+        if (inDraw.SamplesPassed != nullptr && samplesPassed > 0)
+            inDraw.SamplesPassed->fetch_add(samplesPassed, std::memory_order_relaxed);
+    }
+
+    void SoftwareRasterizer::ShadeFragment(const SoftwareDrawCall &inDraw, int32_t inX, int32_t inY, float inDepth, const float *inVaryings) const
+    {
+        std::array<glm::vec4, SoftwareShaderProgram::MaxColorTargets> colors{};
+        if (!inDraw.Program->Pixel(inVaryings, colors.data(), *inDraw.Context)) return;
+
+        const auto &state = inDraw.State;
+        // like OpenGL, the depth buffer is only written while the test is enabled
+        if (state.DepthTest && state.DepthWrite && inDraw.Target.Depth != nullptr)
+            inDraw.Target.Depth->GetRow(inY)[inX] = inDepth;
+
+        if (!state.ColorWrite) return;
+        for (uint32_t i = 0; i < inDraw.Target.ColorCount; ++i)
+        {
+            SoftwareImage *target = inDraw.Target.Colors[i];
+            bool blend = state.Blend && target->GetFormat() != SoftwareImage::Format::R32I;
+            target->Store(inX, inY, blend ? Blend(state, colors[i], target->Load(inX, inY)) : colors[i]);
+        }
+    }
+
+    void SoftwareRasterizer::DrawLines(const SoftwareDrawCall &inDraw, const std::vector<SoftwareClipVertex> &inVertices, const uint32_t *inIndices, uint32_t inIndexCount)
+    {
+        Bounds scissor = GetScissor(inDraw);
+        if (scissor.MinX > scissor.MaxX || scissor.MinY > scissor.MaxY) return;
+        uint32_t varyingCount = inDraw.Program->GetVaryingCount();
+        bool depthTest = inDraw.State.DepthTest && inDraw.Target.Depth != nullptr;
+
+        for (uint32_t i = 0; i + 1 < inIndexCount; i += 2)
+        {
+            SoftwareClipVertex a = inVertices[inIndices[i]];
+            SoftwareClipVertex b = inVertices[inIndices[i + 1]];
+
+            // only the near and far planes, the scissor takes care of the rest
+            bool visible = true;
+            for (uint32_t plane = 0; plane < 2 && visible; ++plane)
+            {
+                float da = PlaneDistance(a.Position, plane, glm::vec2(0.0f));
+                float db = PlaneDistance(b.Position, plane, glm::vec2(0.0f));
+                if (da < 0.0f && db < 0.0f) visible = false;
+                else if (da < 0.0f) a = Lerp(a, b, da / (da - db), varyingCount);
+                else if (db < 0.0f) b = Lerp(b, a, db / (db - da), varyingCount);
+            }
+            if (!visible) continue;
+
+            ScreenVertex sa = ToScreen(inDraw, a, varyingCount);
+            ScreenVertex sb = ToScreen(inDraw, b, varyingCount);
+            float dx = sb.X - sa.X;
+            float dy = sb.Y - sa.Y;
+            uint32_t steps = static_cast<uint32_t>(std::ceil(std::max(std::abs(dx), std::abs(dy))));
+            if (steps > 2 * static_cast<uint32_t>(GuardBand)) continue;
+
+            for (uint32_t step = 0; step <= steps; ++step)
+            {
+                float t = steps > 0 ? static_cast<float>(step) / static_cast<float>(steps) : 0.0f;
+                int32_t x = static_cast<int32_t>(std::floor(sa.X + dx * t));
+                int32_t y = static_cast<int32_t>(std::floor(sa.Y + dy * t));
+                if (x < scissor.MinX || x > scissor.MaxX || y < scissor.MinY || y > scissor.MaxY) continue;
+
+                float depth = sa.Z + (sb.Z - sa.Z) * t;
+                if (depthTest && !DepthTest(inDraw.State.DepthFunction, depth, inDraw.Target.Depth->GetRow(y)[x])) continue;
+
+                float w = 1.0f / (sa.InvW + (sb.InvW - sa.InvW) * t);
+                float varyings[SoftwareShaderProgram::MaxVaryings];
+                for (uint32_t k = 0; k < varyingCount; ++k)
+                    varyings[k] = (sa.Varyings[k] + (sb.Varyings[k] - sa.Varyings[k]) * t) * w;
+                ShadeFragment(inDraw, x, y, depth, varyings);
+            }
+        }
+    }
+
+    void SoftwareRasterizer::DrawPoints(const SoftwareDrawCall &inDraw, const std::vector<SoftwareClipVertex> &inVertices, const uint32_t *inIndices, uint32_t inIndexCount)
+    {
+        Bounds scissor = GetScissor(inDraw);
+        uint32_t varyingCount = inDraw.Program->GetVaryingCount();
+        bool depthTest = inDraw.State.DepthTest && inDraw.Target.Depth != nullptr;
+
+        for (uint32_t i = 0; i < inIndexCount; ++i)
+        {
+            const auto &vertex = inVertices[inIndices[i]];
+            if (PlaneDistance(vertex.Position, 0, glm::vec2(0.0f)) < 0.0f || PlaneDistance(vertex.Position, 1, glm::vec2(0.0f)) < 0.0f) continue;
+
+            ScreenVertex screen = ToScreen(inDraw, vertex, varyingCount);
+            int32_t x = static_cast<int32_t>(std::floor(screen.X));
+            int32_t y = static_cast<int32_t>(std::floor(screen.Y));
+            if (x < scissor.MinX || x > scissor.MaxX || y < scissor.MinY || y > scissor.MaxY) continue;
+            if (depthTest && !DepthTest(inDraw.State.DepthFunction, screen.Z, inDraw.Target.Depth->GetRow(y)[x])) continue;
+
+            ShadeFragment(inDraw, x, y, screen.Z, vertex.Varyings);
+        }
+    }
+}
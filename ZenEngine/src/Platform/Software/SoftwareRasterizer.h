@@ -0,0 +1,90 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <vector>
+
+#include "ZenEngine/Renderer/PipelineState.h"
+#include "SoftwareImage.h"
+#include "SoftwareShaderProgram.h"
+
+namespace ZenEngine
+{
+    struct SoftwareRenderTarget
+    {
+        std::array<SoftwareImage*, SoftwareShaderProgram::MaxColorTargets> Colors{};
+        uint32_t ColorCount = 0;
+        SoftwareImage *Depth = nullptr;
+        uint32_t Width = 0;
+        uint32_t Height = 0;
+    };
+
+    /// @brief Everything a draw needs once the vertices are shaded, resolved on the calling thread
+    struct SoftwareDrawCall
+    {
+        const SoftwareShaderProgram *Program = nullptr;
+        const SoftwareShaderContext *Context = nullptr;
+        SoftwareRenderTarget Target;
+        PipelineState State;
+        // x, y, width, height in pixels, y going up like glViewport
+        int32_t Viewport[4] = { 0, 0, 0, 0 };
+        // samples of the triangles passing the depth test are added to it while an occlusion query is active
+        std::atomic<uint64_t> *SamplesPassed = nullptr;
+    };
+
+    struct SoftwareClipVertex
+    {
+        glm::vec4 Position;
+        float Varyings[SoftwareShaderProgram::MaxVaryings];
+    };
+
+    /// @brief Tiled triangle rasterizer following the OpenGL conventions.
+    /// Triangles are clipped and set up on the calling thread, binned into screen tiles and the tiles are shaded in parallel on the job system.
+    /// Each tile walks its triangles in submission order and edge functions are evaluated the same way for every tile,
+    /// so the output does not depend on the number of threads or on scheduling
+    class SoftwareRasterizer
+    {
+    public:
+        static constexpr int32_t TileSize = 64;
+
+        void DrawTriangles(const SoftwareDrawCall &inDraw, const std::vector<SoftwareClipVertex> &inVertices, const uint32_t *inIndices, uint32_t inIndexCount);
+        // lines are one pixel wide and drawn on the calling thread, they are only used for debug geometry
+        void DrawLines(const SoftwareDrawCall &inDraw, const std::vector<SoftwareClipVertex> &inVertices, const uint32_t *inIndices, uint32_t inIndexCount);
+        void DrawPoints(const SoftwareDrawCall &inDraw, const std::vector<SoftwareClipVertex> &inVertices, const uint32_t *inIndices, uint32_t inIndexCount);
+
+    private:
+        struct ScreenVertex
+        {
+            float X, Y, Z, InvW;
+            // divided by w, for perspective correct interpolation
+            float Varyings[SoftwareShaderProgram::MaxVaryings];
+        };
+
+        struct Triangle
+        {
+            ScreenVertex Vertices[3];
+            // edge i is the one opposite vertex i, positive inside
+            double A[3], B[3], C[3];
+            // samples exactly on an edge belong to the triangle that owns it
+            bool Owned[3];
+            float InvArea;
+            int32_t MinX, MinY, MaxX, MaxY;
+        };
+
+        struct Bounds
+        {
+            int32_t MinX, MinY, MaxX, MaxY;
+        };
+
+        std::vector<Triangle> mTriangles;
+        std::vector<std::vector<uint32_t>> mBins;
+        std::vector<uint32_t> mActiveTiles;
+
+        void SetupTriangle(const SoftwareDrawCall &inDraw, const Bounds &inScissor, const ScreenVertex &inV0, const ScreenVertex &inV1, const ScreenVertex &inV2);
+        void RasterizeTile(const SoftwareDrawCall &inDraw, const Bounds &inScissor, uint32_t inTile, uint32_t inTilesX) const;
+        void ShadeFragment(const SoftwareDrawCall &inDraw, int32_t inX, int32_t inY, float inDepth, const float *inVaryings) const;
+
+        static Bounds GetScissor(const SoftwareDrawCall &inDraw);
+        static ScreenVertex ToScreen(const SoftwareDrawCall &inDraw, const SoftwareClipVertex &inVertex, uint32_t inVaryingCount);
+    };
+}
@@ -0,0 +1,314 @@
+#include "SoftwareRendererAPI.h"
+
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+
+#include "ZenEngine/Core/JobSystem.h"
+#include "ZenEngine/Core/Log.h"
+#include "ZenEngine/Renderer/ResourceRegistry.h"
+#include "SoftwareFramebuffer.h"
+#include "SoftwareIndexBuffer.h"
+#include "SoftwareUniformBuffer.h"
+#include "SoftwareVertexArray.h"
+#include "SoftwareVertexBuffer.h"
+
+namespace ZenEngine
+{
+    SoftwareRendererAPI *SoftwareRendererAPI::sInstance = nullptr;
+
+    SoftwareRendererAPI::SoftwareRendererAPI()
+        : mBackBuffer(1, 1, SoftwareImage::Format::RGBA8), mBackBufferDepth(1, 1, SoftwareImage::Format::Depth32F)
+    {
+        ZE_ASSERT_CORE_MSG(sInstance == nullptr, "The software renderer API already exists!");
+        sInstance = this;
+    }
+
+    SoftwareRendererAPI::~SoftwareRendererAPI()
+    {
+        sInstance = nullptr;
+    }
+
+    void SoftwareRendererAPI::Init()
+    {
+        ZE_CORE_INFO("Software renderer rasterizing with {} threads", JobSystem::Get().GetThreadCount());
+    }
+
+    void SoftwareRendererAPI::SetViewport(uint32_t inX, uint32_t inY, uint32_t inWidth, uint32_t inHeight)
+    {
+        mViewport[0] = inX;
+        mViewport[1] = inY;
+        mViewport[2] = inWidth;
+        mViewport[3] = inHeight;
+    }
+
+    void SoftwareRendererAPI::SetPipelineState(const PipelineState &inState)
+    {
+        // the object behind a handle can be swapped, e.g. when a shader is recompiled, so compare what it resolves to
+        const Shader *shader = ResourceRegistry::Get().Resolve(inState.Shader);
+        if (!mHasPipelineState || static_cast<const SoftwareShader*>(shader) != mBoundShader)
+        {
+            if (shader != nullptr) shader->Bind();
+            else mBoundShader = nullptr;
+        }
+
+        // the fixed function state is read by every draw, it only has to be remembered here
+        mPipelineState = inState;
+        mHasPipelineState = true;
+    }
+
+    void SoftwareRendererAPI::SetBlendFunction(BlendFunction inSource, BlendFunction inDestination)
+    {
+        mPipelineState.SourceBlend = inSource;
+        mPipelineState.DestinationBlend = inDestination;
+    }
+
+    void SoftwareRendererAPI::Clear(uint32_t inFlags)
+    {
+        SoftwareRenderTarget target = GetRenderTarget();
+
+        // like glClear, the write masks apply. Integer targets take the clear color truncated, as Vulkan does
+        if ((inFlags & ColorBuffer) && mPipelineState.ColorWrite)
+        {
+            for (uint32_t i = 0; i < target.ColorCount; ++i)
+                target.Colors[i]->Clear(mClearColor);
+        }
+
+        if ((inFlags & DepthBuffer) && mPipelineState.DepthWrite && target.Depth != nullptr)
+            target.Depth->Clear(glm::vec4(1.0f));
+    }
+
+    void SoftwareRendererAPI::DrawIndexed(VertexArrayHandle inVertexArray)
+    {
+        auto *vertexArray = ResourceRegistry::Get().Resolve(inVertexArray);
+        if (vertexArray == nullptr) return;
+        Draw(vertexArray, vertexArray->GetIndexBuffer()->GetCount(), true, mPipelineState.Topology);
+    }
+
+    void SoftwareRendererAPI::DrawIndexed(VertexArrayHandle inVertexArray, uint32_t inIndexCount)
+    {
+        auto *vertexArray = ResourceRegistry::Get().Resolve(inVertexArray);
+        if (vertexArray == nullptr) return;
+        Draw(vertexArray, inIndexCount, true, mPipelineState.Topology);
+    }
+
+    void SoftwareRendererAPI::DrawIndexedInstanced(VertexArrayHandle inVertexArray, uint32_t inInstanceCount)
+    {
+        auto *vertexArray = ResourceRegistry::Get().Resolve(inVertexArray);
+        if (vertexArray == nullptr) return;
+        Draw(vertexArray, vertexArray->GetIndexBuffer()->GetCount(), true, mPipelineState.Topology, inInstanceCount);
+    }
+
+    void SoftwareRendererAPI::DrawIndexedRanges(VertexArrayHandle inVertexArray, const IndexRange *inRanges, uint32_t inRangeCount)
+    {
+        auto *vertexArray = ResourceRegistry::Get().Resolve(inVertexArray);
+        if (vertexArray == nullptr || inRangeCount == 0) return;
+        Draw(vertexArray, vertexArray->GetIndexBuffer()->GetCount(), true, mPipelineState.Topology, 1, inRanges, inRangeCount);
+    }
+
+    void SoftwareRendererAPI::DrawLines(VertexArrayHandle inVertexArray, uint32_t inVertexCount)
+    {
+        auto *vertexArray = ResourceRegistry::Get().Resolve(inVertexArray);
+        if (vertexArray == nullptr) return;
+        Draw(vertexArray, inVertexCount, false, PrimitiveTopology::Lines);
+    }
+
+    void SoftwareRendererAPI::BindShader(const SoftwareShader *inShader)
+    {
+        mBoundShader = inShader;
+    }
+
+    void SoftwareRendererAPI::BindUniformBuffer(uint32_t inBinding, SoftwareUniformBuffer *inUniformBuffer)
+    {
+        ZE_ASSERT_CORE_MSG(inBinding < MaxUniformBuffers, "Uniform buffer binding {} is out of range", inBinding);
+        mUniformBuffers[inBinding] = inUniformBuffer;
+    }
+
+    void SoftwareRendererAPI::BindTexture(uint32_t inSlot, const SoftwareImage *inImage, const SoftwareSampler &inSampler)
+    {
+        ZE_ASSERT_CORE_MSG(inSlot < MaxTextureSlots, "Texture slot {} is out of range", inSlot);
+        mTextures[inSlot] = { inImage, inSampler };
+    }
+
+    void SoftwareRendererAPI::BindFramebuffer(SoftwareFramebuffer *inFramebuffer)
+    {
+        mFramebuffer = inFramebuffer;
+
+        // binding a framebuffer resets the viewport to its size, like OpenGLFramebuffer::Bind
+        if (inFramebuffer != nullptr)
+        {
+            auto &props = inFramebuffer->GetProperties();
+            SetViewport(0, 0, props.Width, props.Height);
+        }
+    }
+
+    void SoftwareRendererAPI::ReleaseShader(const SoftwareShader *inShader)
+    {
+        if (mBoundShader == inShader) mBoundShader = nullptr;
+    }
+
+    void SoftwareRendererAPI::ReleaseUniformBuffer(const SoftwareUniformBuffer *inUniformBuffer)
+    {
+        for (auto &uniformBuffer : mUniformBuffers)
+        {
+            if (uniformBuffer == inUniformBuffer) uniformBuffer = nullptr;
+        }
+    }
+
+    void SoftwareRendererAPI::ReleaseImage(const SoftwareImage *inImage)
+    {
+        for (auto &texture : mTextures)
+        {
+            if (texture.Image == inImage) texture = SoftwareTextureBinding();
+        }
+    }
+
+    void SoftwareRendererAPI::ReleaseFramebuffer(const SoftwareFramebuffer *inFramebuffer)
+    {
+        if (mFramebuffer == inFramebuffer) mFramebuffer = nullptr;
+    }
+
+    void SoftwareRendererAPI::ResizeBackBuffer(uint32_t inWidth, uint32_t inHeight)
+    {
+        if (mBackBuffer.GetWidth() == inWidth && mBackBuffer.GetHeight() == inHeight) return;
+        mBackBuffer.Resize(inWidth, inHeight);
+        mBackBufferDepth.Resize(inWidth, inHeight);
+    }
+
+    SoftwareRenderTarget SoftwareRendererAPI::GetRenderTarget()
+    {
+        if (mFramebuffer != nullptr) return mFramebuffer->GetRenderTarget();
+
+        SoftwareRenderTarget target;
+        target.Colors[target.ColorCount++] = &mBackBuffer;
+        target.Depth = &mBackBufferDepth;
+        target.Width = mBackBuffer.GetWidth();
+        target.Height = mBackBuffer.GetHeight();
+        return target;
+    }
+
+    void SoftwareRendererAPI::FetchAttributes(const SoftwareVertexArray &inVertexArray, uint32_t inVertex, uint32_t inInstance, glm::vec4 *outAttributes)
+    {
+        auto &attributes = inVertexArray.GetAttributes();
+        auto &vertexBuffers = inVertexArray.GetVertexBuffers();
+        for (uint32_t location = 0; location < attributes.size(); ++location)
+        {
+            const auto &attribute = attributes[location];
+            const auto &vertexBuffer = static_cast<const SoftwareVertexBuffer&>(*vertexBuffers[attribute.Buffer]);
+            uint32_t element = attribute.PerInstance ? inInstance : inVertex;
+            const uint8_t *data = vertexBuffer.GetData() + static_cast<size_t>(element) * vertexBuffer.GetLayout().GetStride() + attribute.Offset;
+
+            // missing components read as (0, 0, 0, 1), like OpenGL
+            glm::vec4 value(0.0f, 0.0f, 0.0f, 1.0f);
+            for (uint32_t c = 0; c < attribute.Components && c < 4; ++c)
+            {
+                if (attribute.Integer)
+                {
+                    int32_t component;
+                    std::memcpy(&component, data + c * sizeof(int32_t), sizeof(int32_t));
+                    value[c] = static_cast<float>(component);
+                }
+                else
+                {
+                    std::memcpy(&value[c], data + c * sizeof(float), sizeof(float));
+                }
+            }
+            outAttributes[location] = value;
+        }
+    }
+
+    void SoftwareRendererAPI::Draw(VertexArray *inVertexArray, uint32_t inCount, bool inIndexed, PrimitiveTopology inTopology, uint32_t inInstanceCount,
+        const IndexRange *inRanges, uint32_t inRangeCount)
+    {
+        if (mBoundShader == nullptr || mDrawsDiscarded || inCount == 0 || inInstanceCount == 0) return;
+
+        SoftwareRenderTarget target = GetRenderTarget();
+        if (target.Width == 0 || target.Height == 0) return;
+
+        const auto &vertexArray = static_cast<const SoftwareVertexArray&>(*inVertexArray);
+        ZE_ASSERT_CORE_MSG(vertexArray.GetAttributes().size() <= SoftwareShaderProgram::MaxAttributes, "Too many vertex attributes!");
+        uint32_t vertexCount = vertexArray.GetVertexCount();
+        ZE_ASSERT_CORE_MSG(inInstanceCount <= vertexArray.GetInstanceCount(), "Drawing {} instances but the instance data only has {}", inInstanceCount, vertexArray.GetInstanceCount());
+        inInstanceCount = std::min(inInstanceCount, vertexArray.GetInstanceCount());
+
+        const uint32_t *indices;
+        if (inIndexed)
+        {
+            const auto &indexBuffer = static_cast<const SoftwareIndexBuffer&>(*vertexArray.GetIndexBuffer());
+            inCount = std::min(inCount, indexBuffer.GetCount());
+            indices = indexBuffer.GetIndices();
+        }
+        else
+        {
+            inCount = std::min(inCount, vertexCount);
+            if (mSequentialIndices.size() < inCount)
+            {
+                mSequentialIndices.resize(inCount);
+                std::iota(mSequentialIndices.begin(), mSequentialIndices.end(), 0u);
+            }
+            indices = mSequentialIndices.data();
+        }
+
+        const IndexRange wholeRange{ 0, inCount };
+        if (inRanges == nullptr)
+        {
+            inRanges = &wholeRange;
+            inRangeCount = 1;
+        }
+
+        // the bindings are snapshotted, the uniform data itself is read in place since the draw completes before returning
+        for (uint32_t i = 0; i < MaxUniformBuffers; ++i)
+            mContext.UniformBuffers[i] = mUniformBuffers[i] != nullptr ? mUniformBuffers[i]->GetData() : nullptr;
+        mContext.Textures = mTextures;
+        mContext.AttributeNames = &vertexArray.GetAttributeNames();
+
+        SoftwareShaderProgram &program = mBoundShader->GetProgram();
+        program.BeginDraw(mContext);
+
+        SoftwareDrawCall draw;
+        draw.Program = &program;
+        draw.Context = &mContext;
+        draw.Target = target;
+        draw.State = mPipelineState;
+        draw.State.Topology = inTopology;
+        draw.SamplesPassed = mSampleCounter;
+        if (mViewport[2] == 0 || mViewport[3] == 0)
+        {
+            draw.Viewport[2] = static_cast<int32_t>(target.Width);
+            draw.Viewport[3] = static_cast<int32_t>(target.Height);
+        }
+        else
+        {
+            for (uint32_t i = 0; i < 4; ++i)
+                draw.Viewport[i] = static_cast<int32_t>(mViewport[i]);
+        }
+
+        // instances are drawn one after the other, in order, so they overlap the same way they do on the GPU
+        mVertices.resize(vertexCount);
+        for (uint32_t instance = 0; instance < inInstanceCount; ++instance)
+        {
+            JobSystem::Get().ParallelFor(vertexCount, VerticesPerBatch, [&](uint32_t inBegin, uint32_t inEnd)
+            {
+                std::array<glm::vec4, SoftwareShaderProgram::MaxAttributes> attributes;
+                for (uint32_t v = inBegin; v < inEnd; ++v)
+                {
+                    FetchAttributes(vertexArray, v, instance, attributes.data());
+                    mVertices[v].Position = program.Vertex(attributes.data(), mVertices[v].Varyings, mContext);
+                }
+            });
+
+            for (uint32_t range = 0; range < inRangeCount; ++range)
+            {
+                // clamped to the index buffer like the first inCount indices are
+                uint32_t first = std::min(inRanges[range].First, inCount);
+                uint32_t count = std::min(inRanges[range].Count, inCount - first);
+                switch (inTopology)
+                {
+                case PrimitiveTopology::Triangles:  mRasterizer.DrawTriangles(draw, mVertices, indices + first, count); break;
+                case PrimitiveTopology::Lines:      mRasterizer.DrawLines(draw, mVertices, indices + first, count); break;
+                case PrimitiveTopology::Points:     mRasterizer.DrawPoints(draw, mVertices, indices + first, count); break;
+                }
+            }
+        }
+    }
+}
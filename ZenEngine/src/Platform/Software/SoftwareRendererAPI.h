@@ -0,0 +1,112 @@
+#pragma once
+
+#include <array>
+#include <filesystem>
+#include <vector>
+
+#include "ZenEngine/Renderer/RendererAPI.h"
+#include "ZenEngine/Renderer/VertexArray.h"
+#include "ZenEngine/Renderer/PipelineState.h"
+#include "SoftwareRasterizer.h"
+#include "SoftwareShader.h"
+
+namespace ZenEngine
+{
+    class SoftwareFramebuffer;
+    class SoftwareUniformBuffer;
+    class SoftwareVertexArray;
+
+    /// @brief CPU reference implementation of the RendererAPI, used to render deterministic images to test against.
+    /// Draws are executed before they return: vertices are shaded in batches on the job system, then the rasterizer
+    /// bins the triangles into tiles and shades the tiles in parallel. The result does not depend on the thread count.
+    class SoftwareRendererAPI : public RendererAPI
+    {
+    public:
+        static constexpr uint32_t MaxUniformBuffers = SoftwareShaderContext::MaxUniformBuffers;
+        static constexpr uint32_t MaxTextureSlots = SoftwareShaderContext::MaxTextureSlots;
+        static constexpr uint32_t VerticesPerBatch = 256;
+
+        SoftwareRendererAPI();
+        virtual ~SoftwareRendererAPI();
+
+        static SoftwareRendererAPI &Get() { ZE_ASSERT_CORE_MSG(sInstance != nullptr, "The software renderer API is not initialized!"); return *sInstance; }
+        static bool IsInitialized() { return sInstance != nullptr; }
+
+        virtual void Init() override;
+        virtual void SetViewport(uint32_t inX, uint32_t inY, uint32_t inWidth, uint32_t inHeight) override;
+        virtual void SetPipelineState(const PipelineState &inState) override;
+        virtual void InvalidatePipelineState() override { mHasPipelineState = false; }
+        virtual void SetClearColor(const glm::vec4 &inColor) override { mClearColor = inColor; }
+        virtual void Clear(uint32_t inFlags) override;
+
+        virtual void EnableDepthTest() override { mPipelineState.DepthTest = true; }
+        virtual void DisableDepthTest() override { mPipelineState.DepthTest = false; }
+        virtual void SetDepthMask(bool inMask) override { mPipelineState.DepthWrite = inMask; }
+        virtual void SetDepthFunction(DepthFunction inFunction) override { mPipelineState.DepthFunction = inFunction; }
+        virtual void SetColorMask(bool inMask) override { mPipelineState.ColorWrite = inMask; }
+
+        virtual void EnableBlend() override { mPipelineState.Blend = true; }
+        virtual void DisableBlend() override { mPipelineState.Blend = false; }
+        virtual void SetBlendMode(BlendMode inMode) override { mPipelineState.BlendMode = inMode; }
+        virtual void SetBlendFunction(BlendFunction inSource, BlendFunction inDestination) override;
+
+        virtual void DrawIndexed(VertexArrayHandle inVertexArray) override;
+        virtual void DrawIndexed(VertexArrayHandle inVertexArray, uint32_t inIndexCount) override;
+        virtual void DrawIndexedInstanced(VertexArrayHandle inVertexArray, uint32_t inInstanceCount) override;
+        virtual void DrawIndexedRanges(VertexArrayHandle inVertexArray, const IndexRange *inRanges, uint32_t inRangeCount) override;
+        virtual void DrawLines(VertexArrayHandle inVertexArray, uint32_t inVertexCount) override;
+
+        // lines are always one pixel wide
+        virtual void SetLineWidth(float inWidth) override {}
+
+        // bindings made by the software resources, they stand in for the OpenGL context state
+        void BindShader(const SoftwareShader *inShader);
+        void BindUniformBuffer(uint32_t inBinding, SoftwareUniformBuffer *inUniformBuffer);
+        void BindTexture(uint32_t inSlot, const SoftwareImage *inImage, const SoftwareSampler &inSampler);
+        /// @brief Draws that follow go to the framebuffer, or to the back buffer when it is null
+        void BindFramebuffer(SoftwareFramebuffer *inFramebuffer);
+        /// @brief The samples of the triangles passing the depth test are added to the counter until it is set back to null
+        void SetSampleCounter(std::atomic<uint64_t> *inCounter) { mSampleCounter = inCounter; }
+        /// @brief Draws are dropped while set, this is how a conditional render skips them
+        void SetDrawsDiscarded(bool inDiscarded) { mDrawsDiscarded = inDiscarded; }
+
+        // called by the resources when they go away, so nothing here points at them anymore
+        void ReleaseShader(const SoftwareShader *inShader);
+        void ReleaseUniformBuffer(const SoftwareUniformBuffer *inUniformBuffer);
+        void ReleaseImage(const SoftwareImage *inImage);
+        void ReleaseFramebuffer(const SoftwareFramebuffer *inFramebuffer);
+
+        void ResizeBackBuffer(uint32_t inWidth, uint32_t inHeight);
+        /// @brief The image the frame ends up in when rendering without a framebuffer bound
+        const SoftwareImage &GetBackBuffer() const { return mBackBuffer; }
+        bool SaveBackBuffer(const std::filesystem::path &inFilepath) const { return mBackBuffer.SavePPM(inFilepath); }
+    private:
+        PipelineState mPipelineState;
+        bool mHasPipelineState = false;
+        const SoftwareShader *mBoundShader = nullptr;
+        std::array<SoftwareUniformBuffer*, MaxUniformBuffers> mUniformBuffers{};
+        std::array<SoftwareTextureBinding, MaxTextureSlots> mTextures{};
+        glm::vec4 mClearColor{ 0.0f, 0.0f, 0.0f, 1.0f };
+        uint32_t mViewport[4] = { 0, 0, 0, 0 };
+
+        SoftwareFramebuffer *mFramebuffer = nullptr;
+        std::atomic<uint64_t> *mSampleCounter = nullptr;
+        bool mDrawsDiscarded = false;
+        SoftwareImage mBackBuffer;
+        SoftwareImage mBackBufferDepth;
+
+        // reused between draws to keep the allocations around
+        SoftwareRasterizer mRasterizer;
+        SoftwareShaderContext mContext;
+        std::vector<SoftwareClipVertex> mVertices;
+        std::vector<uint32_t> mSequentialIndices;
+
+        static SoftwareRendererAPI *sInstance;
+
+        SoftwareRenderTarget GetRenderTarget();
+        // without ranges the first inCount indices are drawn, with them inCount is ignored and the vertices are shaded once for all the ranges
+        void Draw(VertexArray *inVertexArray, uint32_t inCount, bool inIndexed, PrimitiveTopology inTopology, uint32_t inInstanceCount = 1,
+            const IndexRange *inRanges = nullptr, uint32_t inRangeCount = 0);
+        static void FetchAttributes(const SoftwareVertexArray &inVertexArray, uint32_t inVertex, uint32_t inInstance, glm::vec4 *outAttributes);
+    };
+}
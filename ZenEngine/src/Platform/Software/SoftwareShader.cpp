@@ -0,0 +1,120 @@
+#include "SoftwareShader.h"
+
+#include <algorithm>
+#include <filesystem>
+
+#include "ZenEngine/Core/Filesystem.h"
+#include "ZenEngine/Core/Log.h"
+#include "ZenEngine/Core/Macros.h"
+#include "ZenEngine/ShaderCompiler/ShaderCompiler.h"
+#include "SoftwareRendererAPI.h"
+
+namespace ZenEngine
+{
+    SoftwareShader::SoftwareShader(const std::string &inFilepath)
+    {
+        ZE_CORE_TRACE("Loading shader from file {}", inFilepath);
+        auto shaderSource = Filesystem::ReadFileToString(inFilepath);
+        std::filesystem::path shaderFilePath = inFilepath;
+        ZE_ASSERT_CORE_MSG(std::filesystem::exists(shaderFilePath), "The shader file {} does not exists", inFilepath);
+        mName = shaderFilePath.filename().replace_extension("").string();
+        CreateShader(shaderSource);
+    }
+
+    SoftwareShader::SoftwareShader(const std::string &inName, const std::string &inSrc)
+        : mName(inName)
+    {
+        CreateShader(inSrc);
+    }
+
+    SoftwareShader::~SoftwareShader()
+    {
+        if (SoftwareRendererAPI::IsInitialized())
+            SoftwareRendererAPI::Get().ReleaseShader(this);
+    }
+
+    void SoftwareShader::Bind() const
+    {
+        if (mUniformBuffer != nullptr) mUniformBuffer->Bind();
+        SoftwareRendererAPI::Get().BindShader(this);
+    }
+
+    void SoftwareShader::Unbind() const
+    {
+        SoftwareRendererAPI::Get().BindShader(nullptr);
+    }
+
+    void SoftwareShader::SetUniform(const std::string &inName, void *inData, ShaderReflector::ShaderType inShaderType)
+    {
+        if (mUniforms.contains(inName))
+        {
+            auto &uniformData = mUniforms[inName];
+            ZE_ASSERT_CORE_MSG(uniformData.Type == inShaderType, "{} is not at int", inName);
+            mUniformBuffer->SetData(inData, uniformData.Size, uniformData.Offset);
+        }
+    }
+
+    void SoftwareShader::SetInt(const std::string &inName, int inValue)
+    {
+        SetUniform(inName, (void*)&inValue, ShaderReflector::ShaderType::Int);
+    }
+
+    void SoftwareShader::SetFloat(const std::string &inName, float inValue)
+    {
+        SetUniform(inName, (void*)&inValue, ShaderReflector::ShaderType::Float);
+    }
+
+    void SoftwareShader::SetFloat2(const std::string &inName, const glm::vec2 &inValue)
+    {
+        SetUniform(inName, (void*)&inValue, ShaderReflector::ShaderType::Float2);
+    }
+
+    void SoftwareShader::SetFloat3(const std::string &inName, const glm::vec3 &inValue)
+    {
+        SetUniform(inName, (void*)&inValue, ShaderReflector::ShaderType::Float3);
+    }
+
+    void SoftwareShader::SetFloat4(const std::string &inName, const glm::vec4 &inValue)
+    {
+        SetUniform(inName, (void*)&inValue, ShaderReflector::ShaderType::Float4);
+    }
+
+    void SoftwareShader::SetMat4(const std::string &inName, const glm::mat4 &inValue)
+    {
+        SetUniform(inName, (void*)&inValue, ShaderReflector::ShaderType::Mat4);
+    }
+
+    void SoftwareShader::CreateShader(const std::string &inSrc)
+    {
+        ZE_CORE_INFO("Creating shader {}", mName);
+        // the Vulkan target stops at SPIR-V, which is all the reflection needs
+        ShaderCompiler compiler(mName);
+        auto res = compiler.Compile(inSrc, ShaderCompiler::Target::Vulkan);
+        Reflect(res.VertexReflectionInfo);
+        Reflect(res.PixelReflectionInfo);
+
+        mProgram = SoftwareShaderProgram::Create(*this);
+    }
+
+    void SoftwareShader::Reflect(const ShaderReflector::ReflectionResult &inResult)
+    {
+        auto it = std::find_if(inResult.UniformBuffers.begin(), inResult.UniformBuffers.end(), [](auto &ubInfo){ return ubInfo.Name == "$Global"; });
+        if (it != inResult.UniformBuffers.end())
+        {
+            if (mUniformBuffer == nullptr)
+            {
+                mUniformBuffer = UniformBuffer::Create(it->Size, it->Binding);
+                mGlobalsBinding = it->Binding;
+            }
+            for (auto &uniform : it->Members)
+            {
+                if (mUniforms.contains(uniform.Name)) continue;
+                ZE_CORE_TRACE("Adding uniform {}", uniform.Name);
+                mUniforms[uniform.Name] = uniform;
+            }
+        }
+
+        for (auto &texInfo : inResult.Textures)
+            mTextures[texInfo.Name] = texInfo;
+    }
+}
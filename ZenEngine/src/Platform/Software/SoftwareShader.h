@@ -0,0 +1,58 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "ZenEngine/Renderer/Shader.h"
+#include "ZenEngine/Renderer/UniformBuffer.h"
+#include "ZenEngine/ShaderCompiler/ShaderReflector.h"
+#include "SoftwareShaderProgram.h"
+
+namespace ZenEngine
+{
+
+    /// @brief The HLSL is still compiled, only to reflect the interface materials are built from.
+    /// Drawing runs the matching C++ reference program
+    class SoftwareShader : public Shader
+    {
+    public:
+        SoftwareShader(const std::string &inFilepath);
+        SoftwareShader(const std::string &inName, const std::string &inSrc);
+
+        virtual ~SoftwareShader();
+
+        virtual void Bind() const override;
+        virtual void Unbind() const override;
+
+        virtual void SetInt(const std::string &inName, int inValue) override;
+        virtual void SetFloat(const std::string &inName, float inValue) override;
+        virtual void SetFloat2(const std::string &inName, const glm::vec2 &inValue) override;
+        virtual void SetFloat3(const std::string &inName, const glm::vec3 &inValue) override;
+        virtual void SetFloat4(const std::string &inName, const glm::vec4 &inValue) override;
+        virtual void SetMat4(const std::string &inName, const glm::mat4 &inValue) override;
+
+        virtual ShaderUniformInfo GetShaderUniformInfo() const override { return mUniforms; }
+        virtual ShaderTextureInfo GetShaderTextureInfo() const override { return mTextures; }
+
+        const std::string &GetName() const { return mName; }
+        const ShaderUniformInfo &GetUniforms() const { return mUniforms; }
+        const ShaderTextureInfo &GetTextures() const { return mTextures; }
+        // binding of the $Global buffer holding the loose uniforms
+        uint32_t GetGlobalsBinding() const { return mGlobalsBinding; }
+
+        SoftwareShaderProgram &GetProgram() const { return *mProgram; }
+    private:
+        std::string mName;
+        ShaderUniformInfo mUniforms;
+        ShaderTextureInfo mTextures;
+        uint32_t mGlobalsBinding = 0;
+
+        std::shared_ptr<UniformBuffer> mUniformBuffer;
+        std::unique_ptr<SoftwareShaderProgram> mProgram;
+
+        void CreateShader(const std::string &inSrc);
+        void Reflect(const ShaderReflector::ReflectionResult &inResult);
+
+        void SetUniform(const std::string &inName, void *inData, ShaderReflector::ShaderType inShaderType);
+    };
+
+}
@@ -0,0 +1,571 @@
+#include "SoftwareShaderProgram.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <unordered_map>
+
+#include "ZenEngine/Core/Log.h"
+#include "ZenEngine/Core/Macros.h"
+#include "ZenEngine/Renderer/Renderer.h"
+#include "SoftwareShader.h"
+
+namespace ZenEngine
+{
+    int32_t SoftwareShaderContext::FindAttribute(const std::string &inName) const
+    {
+        if (AttributeNames == nullptr) return -1;
+        auto it = std::find(AttributeNames->begin(), AttributeNames->end(), inName);
+        return it != AttributeNames->end() ? static_cast<int32_t>(it - AttributeNames->begin()) : -1;
+    }
+
+    // ports of the helpers in ZenShaderLib.hlsl, reading the globals the renderer binds to register b1
+    namespace ShaderLib
+    {
+        static constexpr uint32_t GlobalsBinding = 1;
+        static constexpr float MaxShininess = 256.0f;
+
+        static const Renderer::ShaderGlobals &Globals(const SoftwareShaderContext &inContext)
+        {
+            const auto *globals = inContext.GetUniformBuffer<Renderer::ShaderGlobals>(GlobalsBinding);
+            ZE_ASSERT_CORE_MSG(globals != nullptr, "The engine globals are not bound!");
+            return *globals;
+        }
+
+        static glm::vec3 WorldPositionFromDepth(float inDepth, const glm::vec2 &inTexCoord, const SoftwareShaderContext &inContext)
+        {
+            const auto &globals = Globals(inContext);
+            float z = inDepth * 2.0f - 1.0f;
+            glm::vec4 clipSpacePosition(inTexCoord * 2.0f - 1.0f, z, 1.0f);
+            glm::vec4 viewSpacePosition = globals.InverseProjectionMatrix * clipSpacePosition;
+            viewSpacePosition /= viewSpacePosition.w;
+            return glm::vec3(globals.InverseViewMatrix * viewSpacePosition);
+        }
+
+        static float LinearizeDepth(float inDepth, const SoftwareShaderContext &inContext)
+        {
+            const auto &globals = Globals(inContext);
+            float zn = 2.0f * inDepth - 1.0f;
+            return 2.0f * globals.NearPlane * globals.FarPlane / (globals.FarPlane + globals.NearPlane - zn * (globals.FarPlane - globals.NearPlane));
+        }
+
+        static glm::vec3 PackNormals(const glm::vec3 &inNormal) { return (inNormal + glm::vec3(1.0f)) / 2.0f; }
+        static glm::vec3 UnpackNormals(const glm::vec3 &inPacked) { return inPacked * 2.0f - glm::vec3(1.0f); }
+        static float NormalizeShininess(float inShininess) { return inShininess / MaxShininess; }
+        static float GetShininessFromNormalizedValue(float inShininess) { return inShininess * MaxShininess; }
+
+        static glm::vec4 ObjectToClipPosition(const glm::vec3 &inPosition, const SoftwareShaderContext &inContext)
+        {
+            const auto &globals = Globals(inContext);
+            return globals.ViewProjectionMatrix * (globals.ModelMatrix * glm::vec4(inPosition, 1.0f));
+        }
+
+        // the per instance transform arrives as four column attributes, see GetInstanceMatrix
+        static glm::mat4 GetInstanceMatrix(const glm::vec4 *inAttributes, int32_t inLocation)
+        {
+            return glm::mat4(inAttributes[inLocation], inAttributes[inLocation + 1], inAttributes[inLocation + 2], inAttributes[inLocation + 3]);
+        }
+
+        static glm::vec4 InstanceToClipPosition(const glm::vec3 &inPosition, const glm::mat4 &inInstance, const SoftwareShaderContext &inContext)
+        {
+            const auto &globals = Globals(inContext);
+            return globals.ViewProjectionMatrix * (globals.ModelMatrix * (inInstance * glm::vec4(inPosition, 1.0f)));
+        }
+    }
+
+    // loose uniforms of a shader, read from its $Global buffer by reflected offset
+    namespace ShaderParameters
+    {
+        struct Parameter
+        {
+            int32_t Offset = -1;
+            uint32_t Components = 0;
+        };
+
+        static Parameter Find(const Shader::ShaderUniformInfo &inUniforms, std::initializer_list<const char*> inNames)
+        {
+            for (const char *name : inNames)
+            {
+                auto it = inUniforms.find(name);
+                if (it == inUniforms.end()) continue;
+                switch (it->second.Type)
+                {
+                case ShaderReflector::ShaderType::Float:  return { static_cast<int32_t>(it->second.Offset), 1 };
+                case ShaderReflector::ShaderType::Float2: return { static_cast<int32_t>(it->second.Offset), 2 };
+                case ShaderReflector::ShaderType::Float3: return { static_cast<int32_t>(it->second.Offset), 3 };
+                case ShaderReflector::ShaderType::Float4: return { static_cast<int32_t>(it->second.Offset), 4 };
+                default: break;
+                }
+            }
+            return {};
+        }
+
+        static glm::vec4 Read(const uint8_t *inParameters, const Parameter &inParameter, const glm::vec4 &inDefault)
+        {
+            if (inParameters == nullptr || inParameter.Offset < 0) return inDefault;
+            glm::vec4 value = inDefault;
+            std::memcpy(&value, inParameters + inParameter.Offset, inParameter.Components * sizeof(float));
+            return value;
+        }
+    }
+
+    /// @brief The VSMain shared by the blit and lighting shaders, a quad covering the screen
+    class FullScreenProgram : public SoftwareShaderProgram
+    {
+    public:
+        virtual uint32_t GetVaryingCount() const override { return 2; }
+
+        virtual glm::vec4 Vertex(const glm::vec4 *inAttributes, float *outVaryings, const SoftwareShaderContext &inContext) const override
+        {
+            glm::vec2 position(inAttributes[0]);
+            outVaryings[0] = 0.5f * (position.x + 1.0f);
+            outVaryings[1] = 0.5f * (position.y + 1.0f);
+            return { position, 0.0f, 1.0f };
+        }
+
+        virtual bool Pixel(const float *inVaryings, glm::vec4 *outColors, const SoftwareShaderContext &inContext) const override
+        {
+            outColors[0] = Shade({ inVaryings[0], inVaryings[1] }, inContext);
+            return true;
+        }
+
+    protected:
+        virtual glm::vec4 Shade(const glm::vec2 &inTexCoord, const SoftwareShaderContext &inContext) const = 0;
+    };
+
+    class BlitRGBProgram : public FullScreenProgram
+    {
+    protected:
+        virtual glm::vec4 Shade(const glm::vec2 &inTexCoord, const SoftwareShaderContext &inContext) const override
+        {
+            return { glm::vec3(inContext.Sample(0, inTexCoord)), 1.0f };
+        }
+    };
+
+    class BlitAlphaProgram : public FullScreenProgram
+    {
+    protected:
+        virtual glm::vec4 Shade(const glm::vec2 &inTexCoord, const SoftwareShaderContext &inContext) const override
+        {
+            float sample = inContext.Sample(0, inTexCoord).a;
+            return { sample, sample, sample, 1.0f };
+        }
+    };
+
+    class BlitDepthProgram : public FullScreenProgram
+    {
+    protected:
+        virtual glm::vec4 Shade(const glm::vec2 &inTexCoord, const SoftwareShaderContext &inContext) const override
+        {
+            float sample = ShaderLib::LinearizeDepth(inContext.Sample(0, inTexCoord).r, inContext) / ShaderLib::Globals(inContext).FarPlane;
+            return { sample, sample, sample, 1.0f };
+        }
+    };
+
+    class BlitWorldPositionProgram : public FullScreenProgram
+    {
+    protected:
+        virtual glm::vec4 Shade(const glm::vec2 &inTexCoord, const SoftwareShaderContext &inContext) const override
+        {
+            return { ShaderLib::WorldPositionFromDepth(inContext.Sample(0, inTexCoord).r, inTexCoord, inContext), 1.0f };
+        }
+    };
+
+    class DeferredShadingProgram : public FullScreenProgram
+    {
+    protected:
+        virtual glm::vec4 Shade(const glm::vec2 &inTexCoord, const SoftwareShaderContext &inContext) const override
+        {
+            const auto &globals = ShaderLib::Globals(inContext);
+
+            glm::vec4 baseColorSpecular = inContext.Sample(0, inTexCoord);
+            glm::vec4 shininessSample = inContext.Sample(2, inTexCoord);
+
+            float depth = inContext.Sample(3, inTexCoord).r;
+            glm::vec3 wsPosition = ShaderLib::WorldPositionFromDepth(depth, inTexCoord, inContext);
+            glm::vec3 normal = ShaderLib::UnpackNormals(glm::vec3(inContext.Sample(1, inTexCoord)));
+            glm::vec3 baseColor = glm::vec3(baseColorSpecular);
+            float specular = baseColorSpecular.a;
+            float shininess = ShaderLib::GetShininessFromNormalizedValue(shininessSample.r);
+
+            glm::vec3 ambientLight = globals.AmbientLightColor * globals.AmbientLightIntensity;
+
+            float directionalFactor = std::max(glm::dot(normal, -globals.DirectionalLightDirection), 0.0f);
+            glm::vec3 diffuseLight = (directionalFactor * globals.DirectionalLightIntensity) * globals.DirectionalLightColor;
+
+            glm::vec3 viewDirection = glm::normalize(globals.EyePosition - wsPosition);
+            glm::vec3 directionalLightReflectDirection = glm::reflect(globals.DirectionalLightDirection, normal);
+            float specularFactor = std::max(glm::dot(viewDirection, directionalLightReflectDirection), 0.0f);
+            specularFactor = specular * std::pow(specularFactor, shininess);
+            glm::vec3 specularLight = (specularFactor * globals.DirectionalLightIntensity) * globals.DirectionalLightColor;
+
+            glm::vec3 color = (ambientLight + diffuseLight + specularLight) * baseColor;
+            return { color, 1.0f };
+        }
+    };
+
+    /// @brief Covers DepthPrePassInstanced too, the instance transform is applied when the vertex array has one
+    class DepthPrePassProgram : public SoftwareShaderProgram
+    {
+    public:
+        virtual uint32_t GetVaryingCount() const override { return 0; }
+
+        virtual void BeginDraw(const SoftwareShaderContext &inContext) override
+        {
+            mPositionLocation = std::max(inContext.FindAttribute("Position"), 0);
+            mInstanceLocation = inContext.FindAttribute("InstanceTransform");
+        }
+
+        virtual glm::vec4 Vertex(const glm::vec4 *inAttributes, float *outVaryings, const SoftwareShaderContext &inContext) const override
+        {
+            glm::vec3 position(inAttributes[mPositionLocation]);
+            if (mInstanceLocation >= 0)
+                return ShaderLib::InstanceToClipPosition(position, ShaderLib::GetInstanceMatrix(inAttributes, mInstanceLocation), inContext);
+            return ShaderLib::ObjectToClipPosition(position, inContext);
+        }
+
+        virtual bool Pixel(const float *inVaryings, glm::vec4 *outColors, const SoftwareShaderContext &inContext) const override
+        {
+            return true;
+        }
+
+    private:
+        int32_t mPositionLocation = 0;
+        int32_t mInstanceLocation = -1;
+    };
+
+    class DebugDrawProgram : public SoftwareShaderProgram
+    {
+    public:
+        // color, clip position and the depth test flag
+        virtual uint32_t GetVaryingCount() const override { return 9; }
+
+        virtual glm::vec4 Vertex(const glm::vec4 *inAttributes, float *outVaryings, const SoftwareShaderContext &inContext) const override
+        {
+            glm::vec4 position = ShaderLib::Globals(inContext).ViewProjectionMatrix * glm::vec4(glm::vec3(inAttributes[0]), 1.0f);
+            std::memcpy(outVaryings, &inAttributes[1], 4 * sizeof(float));
+            std::memcpy(outVaryings + 4, &position, 4 * sizeof(float));
+            outVaryings[8] = inAttributes[2].x;
+            return position;
+        }
+
+        virtual bool Pixel(const float *inVaryings, glm::vec4 *outColors, const SoftwareShaderContext &inContext) const override
+        {
+            glm::vec3 ndc = glm::vec3(inVaryings[4], inVaryings[5], inVaryings[6]) / inVaryings[7];
+            if (inVaryings[8] > 0.5f)
+            {
+                float sceneDepth = inContext.Sample(0, glm::vec2(ndc) * 0.5f + 0.5f).r;
+                if (ShaderLib::LinearizeDepth(ndc.z * 0.5f + 0.5f, inContext) > ShaderLib::LinearizeDepth(sceneDepth, inContext) * 1.001f)
+                    return false;
+            }
+            outColors[0] = { inVaryings[0], inVaryings[1], inVaryings[2], inVaryings[3] };
+            return true;
+        }
+    };
+
+    class SpriteProgram : public SoftwareShaderProgram
+    {
+    public:
+        // color, texture coordinates and texture index
+        virtual uint32_t GetVaryingCount() const override { return 7; }
+
+        virtual glm::vec4 Vertex(const glm::vec4 *inAttributes, float *outVaryings, const SoftwareShaderContext &inContext) const override
+        {
+            std::memcpy(outVaryings, &inAttributes[1], 4 * sizeof(float));
+            outVaryings[4] = inAttributes[2].x;
+            outVaryings[5] = inAttributes[2].y;
+            outVaryings[6] = inAttributes[3].x;
+            return inAttributes[0];
+        }
+
+        virtual bool Pixel(const float *inVaryings, glm::vec4 *outColors, const SoftwareShaderContext &inContext) const override
+        {
+            uint32_t slot = static_cast<uint32_t>(inVaryings[6] + 0.5f);
+            glm::vec4 color(inVaryings[0], inVaryings[1], inVaryings[2], inVaryings[3]);
+            glm::vec4 texel = slot < SoftwareShaderContext::MaxTextureSlots ? inContext.Sample(slot, { inVaryings[4], inVaryings[5] }) : glm::vec4(1.0f);
+            outColors[0] = texel * color;
+            return true;
+        }
+    };
+
+    class ParticleProgram : public SoftwareShaderProgram
+    {
+    public:
+        static constexpr float SoftDistance = 0.25f;
+
+        // color, texture coordinates and clip position
+        virtual uint32_t GetVaryingCount() const override { return 10; }
+
+        virtual void BeginDraw(const SoftwareShaderContext &inContext) override
+        {
+            mCornerLocation = std::max(inContext.FindAttribute("Corner"), 0);
+            mParticleLocation = std::max(inContext.FindAttribute("ParticleData"), 1);
+        }
+
+        virtual glm::vec4 Vertex(const glm::vec4 *inAttributes, float *outVaryings, const SoftwareShaderContext &inContext) const override
+        {
+            const auto &globals = ShaderLib::Globals(inContext);
+            glm::vec2 corner(inAttributes[mCornerLocation]);
+            const glm::vec4 &particle = inAttributes[mParticleLocation];
+            glm::vec3 right(globals.InverseViewMatrix[0]);
+            glm::vec3 up(globals.InverseViewMatrix[1]);
+            glm::vec3 position = glm::vec3(particle) + (right * corner.x + up * corner.y) * particle.w;
+
+            glm::vec4 clipPosition = globals.ViewProjectionMatrix * glm::vec4(position, 1.0f);
+            std::memcpy(outVaryings, &inAttributes[mParticleLocation + 1], 4 * sizeof(float));
+            outVaryings[4] = corner.x + 0.5f;
+            outVaryings[5] = corner.y + 0.5f;
+            std::memcpy(outVaryings + 6, &clipPosition, 4 * sizeof(float));
+            return clipPosition;
+        }
+
+        virtual bool Pixel(const float *inVaryings, glm::vec4 *outColors, const SoftwareShaderContext &inContext) const override
+        {
+            glm::vec3 ndc = glm::vec3(inVaryings[6], inVaryings[7], inVaryings[8]) / inVaryings[9];
+            float sceneDepth = inContext.Sample(0, glm::vec2(ndc) * 0.5f + 0.5f).r;
+            float distance = ShaderLib::LinearizeDepth(sceneDepth, inContext) - ShaderLib::LinearizeDepth(ndc.z * 0.5f + 0.5f, inContext);
+            float fade = std::clamp(distance / SoftDistance, 0.0f, 1.0f);
+            if (fade <= 0.0f) return false;
+
+            glm::vec4 color = inContext.Sample(1, { inVaryings[4], inVaryings[5] }) * glm::vec4(inVaryings[0], inVaryings[1], inVaryings[2], inVaryings[3]);
+            color.a *= fade;
+            outColors[0] = color;
+            return true;
+        }
+
+    private:
+        int32_t mCornerLocation = 0;
+        int32_t mParticleLocation = 1;
+    };
+
+    /// @brief Stand-in for material shaders, which have no C++ port.
+    /// Fills the G-buffer the way a typical material does, from the parameters and textures it can find by name
+    class SurfaceProgram : public SoftwareShaderProgram
+    {
+    public:
+        SurfaceProgram(const SoftwareShader &inShader)
+            : mGlobalsBinding(inShader.GetGlobalsBinding())
+        {
+            const auto &uniforms = inShader.GetUniforms();
+            mBaseColor = ShaderParameters::Find(uniforms, { "BaseColor", "Color", "Albedo", "Diffuse" });
+            mSpecular = ShaderParameters::Find(uniforms, { "Specular" });
+            mShininess = ShaderParameters::Find(uniforms, { "Shininess" });
+
+            // the texture in the lowest register is taken as the base color map
+            for (const auto &[name, info] : inShader.GetTextures())
+            {
+                if (mBaseColorSlot < 0 || info.Binding < static_cast<uint32_t>(mBaseColorSlot))
+                    mBaseColorSlot = static_cast<int32_t>(info.Binding);
+            }
+        }
+
+        virtual uint32_t GetVaryingCount() const override { return 5; }
+
+        virtual void BeginDraw(const SoftwareShaderContext &inContext) override
+        {
+            mPositionLocation = std::max(inContext.FindAttribute("Position"), 0);
+            mNormalLocation = inContext.FindAttribute("Normal");
+            mTexCoordLocation = inContext.FindAttribute("TexCoord");
+            mInstanceLocation = inContext.FindAttribute("InstanceTransform");
+        }
+
+        virtual glm::vec4 Vertex(const glm::vec4 *inAttributes, float *outVaryings, const SoftwareShaderContext &inContext) const override
+        {
+            const auto &globals = ShaderLib::Globals(inContext);
+            glm::vec3 normal = mNormalLocation >= 0 ? glm::vec3(inAttributes[mNormalLocation]) : glm::vec3(0.0f, 0.0f, 1.0f);
+            glm::mat4 instance = mInstanceLocation >= 0 ? ShaderLib::GetInstanceMatrix(inAttributes, mInstanceLocation) : glm::mat4(1.0f);
+            glm::vec3 wsNormal = glm::mat3(globals.ModelMatrix * instance) * normal;
+            glm::vec2 texCoord = mTexCoordLocation >= 0 ? glm::vec2(inAttributes[mTexCoordLocation]) : glm::vec2(0.0f);
+
+            outVaryings[0] = wsNormal.x;
+            outVaryings[1] = wsNormal.y;
+            outVaryings[2] = wsNormal.z;
+            outVaryings[3] = texCoord.x;
+            outVaryings[4] = texCoord.y;
+            glm::vec3 position(inAttributes[mPositionLocation]);
+            if (mInstanceLocation >= 0)
+                return ShaderLib::InstanceToClipPosition(position, instance, inContext);
+            return ShaderLib::ObjectToClipPosition(position, inContext);
+        }
+
+        virtual bool Pixel(const float *inVaryings, glm::vec4 *outColors, const SoftwareShaderContext &inContext) const override
+        {
+            glm::vec3 normal = glm::normalize(glm::vec3(inVaryings[0], inVaryings[1], inVaryings[2]));
+            glm::vec2 texCoord(inVaryings[3], inVaryings[4]);
+
+            const uint8_t *parameters = inContext.UniformBuffers[mGlobalsBinding];
+            glm::vec3 baseColor = ShaderParameters::Read(parameters, mBaseColor, glm::vec4(1.0f));
+            if (mBaseColorSlot >= 0)
+                baseColor *= glm::vec3(inContext.Sample(mBaseColorSlot, texCoord));
+            float specular = ShaderParameters::Read(parameters, mSpecular, glm::vec4(0.0f)).x;
+            float shininess = ShaderParameters::Read(parameters, mShininess, glm::vec4(32.0f)).x;
+
+            outColors[0] = { baseColor, specular };
+            outColors[1] = { ShaderLib::PackNormals(normal), 1.0f };
+            outColors[2] = { ShaderLib::NormalizeShininess(shininess), 0.0f, 0.0f, 1.0f };
+            return true;
+        }
+
+    private:
+        using Parameter = ShaderParameters::Parameter;
+
+        uint32_t mGlobalsBinding;
+        Parameter mBaseColor;
+        Parameter mSpecular;
+        Parameter mShininess;
+        int32_t mBaseColorSlot = -1;
+
+        int32_t mPositionLocation = 0;
+        int32_t mNormalLocation = -1;
+        int32_t mTexCoordLocation = -1;
+        int32_t mInstanceLocation = -1;
+    };
+
+    /// @brief Port of Terrain.hlsl, the patches are displaced by the height clipmap bound to slot 1
+    class TerrainProgram : public SoftwareShaderProgram
+    {
+    public:
+        static constexpr float PatchResolution = 32.0f;
+        static constexpr float ClipmapResolution = 256.0f;
+        static constexpr float ClipmapBorder = 2.0f;
+
+        TerrainProgram(const SoftwareShader &inShader)
+            : mGlobalsBinding(inShader.GetGlobalsBinding())
+        {
+            const auto &uniforms = inShader.GetUniforms();
+            mClipmapParameters = ShaderParameters::Find(uniforms, { "ClipmapParameters" });
+            mTerrainSize = ShaderParameters::Find(uniforms, { "TerrainSize" });
+            mBaseColor = ShaderParameters::Find(uniforms, { "BaseColor" });
+            mSpecular = ShaderParameters::Find(uniforms, { "Specular" });
+            mShininess = ShaderParameters::Find(uniforms, { "Shininess" });
+            mTextureScale = ShaderParameters::Find(uniforms, { "TextureScale" });
+        }
+
+        // world space normal and xz position
+        virtual uint32_t GetVaryingCount() const override { return 5; }
+
+        virtual void BeginDraw(const SoftwareShaderContext &inContext) override
+        {
+            mGridLocation = std::max(inContext.FindAttribute("GridPosition"), 0);
+            mPatchLocation = std::max(inContext.FindAttribute("PatchData"), 1);
+        }
+
+        virtual glm::vec4 Vertex(const glm::vec4 *inAttributes, float *outVaryings, const SoftwareShaderContext &inContext) const override
+        {
+            const auto &globals = ShaderLib::Globals(inContext);
+            const uint8_t *parameters = inContext.UniformBuffers[mGlobalsBinding];
+            glm::vec4 clipmap = ShaderParameters::Read(parameters, mClipmapParameters, glm::vec4(0.0f, 0.0f, 1.0f, 1.0f));
+            glm::vec2 terrainSize(ShaderParameters::Read(parameters, mTerrainSize, glm::vec4(0.0f)));
+
+            glm::vec2 grid(inAttributes[mGridLocation]);
+            const glm::vec4 &patch = inAttributes[mPatchLocation];
+            const glm::vec4 &morphRange = inAttributes[mPatchLocation + 1];
+            glm::vec2 origin(patch.x, patch.y);
+            float quadSize = patch.z / PatchResolution;
+
+            glm::vec2 localPosition = glm::min(origin + grid * quadSize, terrainSize);
+            glm::vec3 worldPosition(globals.ModelMatrix * glm::vec4(localPosition.x, SampleHeight(localPosition, clipmap, inContext), localPosition.y, 1.0f));
+            float morph = std::clamp((glm::distance(worldPosition, globals.EyePosition) - morphRange.x) / (morphRange.y - morphRange.x), 0.0f, 1.0f);
+            glm::vec2 morphedGrid = grid - glm::fract(grid * 0.5f) * 2.0f * morph;
+
+            localPosition = glm::min(origin + morphedGrid * quadSize, terrainSize);
+            glm::vec4 position = globals.ModelMatrix * glm::vec4(localPosition.x, SampleHeight(localPosition, clipmap, inContext), localPosition.y, 1.0f);
+            glm::vec3 normal = SampleNormal(localPosition, clipmap, inContext);
+
+            outVaryings[0] = normal.x;
+            outVaryings[1] = normal.y;
+            outVaryings[2] = normal.z;
+            outVaryings[3] = position.x;
+            outVaryings[4] = position.z;
+            return globals.ViewProjectionMatrix * position;
+        }
+
+        virtual bool Pixel(const float *inVaryings, glm::vec4 *outColors, const SoftwareShaderContext &inContext) const override
+        {
+            const uint8_t *parameters = inContext.UniformBuffers[mGlobalsBinding];
+            glm::vec3 normal = glm::normalize(glm::vec3(inVaryings[0], inVaryings[1], inVaryings[2]));
+            float textureScale = ShaderParameters::Read(parameters, mTextureScale, glm::vec4(1.0f)).x;
+            glm::vec3 baseColor = glm::vec3(ShaderParameters::Read(parameters, mBaseColor, glm::vec4(1.0f)))
+                * glm::vec3(inContext.Sample(0, glm::vec2(inVaryings[3], inVaryings[4]) * textureScale));
+            float specular = ShaderParameters::Read(parameters, mSpecular, glm::vec4(0.0f)).x;
+            float shininess = ShaderParameters::Read(parameters, mShininess, glm::vec4(32.0f)).x;
+
+            outColors[0] = { baseColor, specular };
+            outColors[1] = { ShaderLib::PackNormals(normal), 1.0f };
+            outColors[2] = { ShaderLib::NormalizeShininess(shininess), 0.0f, 0.0f, 1.0f };
+            return true;
+        }
+
+    private:
+        using Parameter = ShaderParameters::Parameter;
+
+        uint32_t mGlobalsBinding;
+        Parameter mClipmapParameters;
+        Parameter mTerrainSize;
+        Parameter mBaseColor;
+        Parameter mSpecular;
+        Parameter mShininess;
+        Parameter mTextureScale;
+
+        int32_t mGridLocation = 0;
+        int32_t mPatchLocation = 1;
+
+        static float GetClipmapLevel(const glm::vec2 &inSamplePosition, const glm::vec4 &inClipmap)
+        {
+            glm::vec2 offset = glm::abs(inSamplePosition - glm::vec2(inClipmap));
+            float distance = std::max(offset.x, offset.y) / (ClipmapResolution * 0.5f - ClipmapBorder);
+            return std::clamp(std::ceil(std::log2(std::max(distance, 1.0f))), 0.0f, inClipmap.w - 1.0f);
+        }
+
+        static float SampleClipmap(const glm::vec2 &inSamplePosition, float inLevel, const glm::vec4 &inClipmap, const SoftwareShaderContext &inContext)
+        {
+            glm::vec2 texel = (inSamplePosition - glm::vec2(inClipmap)) / std::exp2(inLevel) + ClipmapResolution * 0.5f;
+            texel = glm::clamp(texel, 0.0f, ClipmapResolution - 1.0f);
+            glm::vec2 texCoord = glm::vec2(texel.x + 0.5f, texel.y + 0.5f + inLevel * ClipmapResolution) / glm::vec2(ClipmapResolution, ClipmapResolution * inClipmap.w);
+            return inContext.Sample(1, texCoord).r;
+        }
+
+        static float SampleHeight(const glm::vec2 &inLocalPosition, const glm::vec4 &inClipmap, const SoftwareShaderContext &inContext)
+        {
+            glm::vec2 samplePosition = inLocalPosition / inClipmap.z;
+            return SampleClipmap(samplePosition, GetClipmapLevel(samplePosition, inClipmap), inClipmap, inContext);
+        }
+
+        static glm::vec3 SampleNormal(const glm::vec2 &inLocalPosition, const glm::vec4 &inClipmap, const SoftwareShaderContext &inContext)
+        {
+            glm::vec2 samplePosition = inLocalPosition / inClipmap.z;
+            float level = GetClipmapLevel(samplePosition, inClipmap);
+            float step = std::exp2(level);
+            float left = SampleClipmap(samplePosition - glm::vec2(step, 0.0f), level, inClipmap, inContext);
+            float right = SampleClipmap(samplePosition + glm::vec2(step, 0.0f), level, inClipmap, inContext);
+            float back = SampleClipmap(samplePosition - glm::vec2(0.0f, step), level, inClipmap, inContext);
+            float front = SampleClipmap(samplePosition + glm::vec2(0.0f, step), level, inClipmap, inContext);
+            return glm::normalize(glm::vec3(left - right, 2.0f * step * inClipmap.z, back - front));
+        }
+    };
+
+    std::unique_ptr<SoftwareShaderProgram> SoftwareShaderProgram::Create(const SoftwareShader &inShader)
+    {
+        static const std::unordered_map<std::string, std::function<std::unique_ptr<SoftwareShaderProgram>(const SoftwareShader &)>> sReferencePrograms = {
+            { "BlitRGB", [](const SoftwareShader &) { return std::make_unique<BlitRGBProgram>(); } },
+            { "BlitAlpha", [](const SoftwareShader &) { return std::make_unique<BlitAlphaProgram>(); } },
+            { "BlitDepth", [](const SoftwareShader &) { return std::make_unique<BlitDepthProgram>(); } },
+            { "BlitWorldPosition", [](const SoftwareShader &) { return std::make_unique<BlitWorldPositionProgram>(); } },
+            { "DeferredShading", [](const SoftwareShader &) { return std::make_unique<DeferredShadingProgram>(); } },
+            { "DepthPrePass", [](const SoftwareShader &) { return std::make_unique<DepthPrePassProgram>(); } },
+            { "DepthPrePassInstanced", [](const SoftwareShader &) { return std::make_unique<DepthPrePassProgram>(); } },
+            { "DebugDraw", [](const SoftwareShader &) { return std::make_unique<DebugDrawProgram>(); } },
+            { "Sprite", [](const SoftwareShader &) { return std::make_unique<SpriteProgram>(); } },
+            { "Particle", [](const SoftwareShader &) { return std::make_unique<ParticleProgram>(); } },
+            { "Terrain", [](const SoftwareShader &inShader) { return std::make_unique<TerrainProgram>(inShader); } }
+        };
+
+        auto it = sReferencePrograms.find(inShader.GetName());
+        if (it != sReferencePrograms.end())
+            return it->second(inShader);
+
+        ZE_CORE_WARN("Shader {} has no reference implementation, it is drawn as a generic surface", inShader.GetName());
+        return std::make_unique<SurfaceProgram>(inShader);
+    }
+}
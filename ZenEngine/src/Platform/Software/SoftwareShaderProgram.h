@@ -0,0 +1,74 @@
+#pragma once
+
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "SoftwareImage.h"
+
+namespace ZenEngine
+{
+    class SoftwareShader;
+
+    struct SoftwareTextureBinding
+    {
+        const SoftwareImage *Image = nullptr;
+        SoftwareSampler Sampler;
+    };
+
+    /// @brief What a program can reach while it runs, a snapshot of the bindings taken when the draw is issued
+    struct SoftwareShaderContext
+    {
+        static constexpr uint32_t MaxUniformBuffers = 8;
+        static constexpr uint32_t MaxTextureSlots = 16;
+
+        std::array<const uint8_t*, MaxUniformBuffers> UniformBuffers{};
+        std::array<SoftwareTextureBinding, MaxTextureSlots> Textures{};
+        // names of the vertex attributes by location, as laid out by the vertex array
+        const std::vector<std::string> *AttributeNames = nullptr;
+
+        template <typename T>
+        const T *GetUniformBuffer(uint32_t inBinding) const { return reinterpret_cast<const T*>(UniformBuffers[inBinding]); }
+
+        // unbound slots read as opaque black, like an incomplete texture in OpenGL
+        glm::vec4 Sample(uint32_t inSlot, const glm::vec2 &inTexCoord) const
+        {
+            const auto &texture = Textures[inSlot];
+            if (texture.Image == nullptr) return { 0.0f, 0.0f, 0.0f, 1.0f };
+            return texture.Image->Sample(inTexCoord, texture.Sampler);
+        }
+
+        int32_t FindAttribute(const std::string &inName) const;
+    };
+
+    /// @brief C++ reference implementation of a shader, run by the software renderer in place of the compiled HLSL.
+    /// Vertex and Pixel are called concurrently from the rasterizer workers and must not modify the program
+    class SoftwareShaderProgram
+    {
+    public:
+        static constexpr uint32_t MaxAttributes = 16;
+        static constexpr uint32_t MaxVaryings = 16;
+        static constexpr uint32_t MaxColorTargets = 4;
+
+        virtual ~SoftwareShaderProgram() = default;
+
+        /// @brief Number of floats passed from the vertex to the pixel stage
+        virtual uint32_t GetVaryingCount() const = 0;
+
+        /// @brief Called once per draw before any vertex is processed, e.g. to look up attribute locations
+        virtual void BeginDraw(const SoftwareShaderContext &inContext) {}
+
+        /// @brief Returns the clip space position
+        /// @param inAttributes the vertex attributes by location, missing components read as (0, 0, 0, 1)
+        virtual glm::vec4 Vertex(const glm::vec4 *inAttributes, float *outVaryings, const SoftwareShaderContext &inContext) const = 0;
+
+        /// @brief Returns false to discard the fragment
+        virtual bool Pixel(const float *inVaryings, glm::vec4 *outColors, const SoftwareShaderContext &inContext) const = 0;
+
+        /// @brief Picks the reference implementation matching the shader name.
+        /// Shaders without one, e.g. user materials, get a generic surface program fed by the reflected parameters
+        static std::unique_ptr<SoftwareShaderProgram> Create(const SoftwareShader &inShader);
+    };
+}
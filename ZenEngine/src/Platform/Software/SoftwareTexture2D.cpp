@@ -0,0 +1,74 @@
+#include "SoftwareTexture2D.h"
+
+#include "SoftwareRendererAPI.h"
+#include "ZenEngine/Renderer/TextureCompression.h"
+
+#include <vector>
+
+namespace ZenEngine
+{
+    SoftwareTexture2D::SoftwareTexture2D(const Texture2D::Properties &inProperties)
+        : mProperties(inProperties), mImage(inProperties.Width, inProperties.Height, SoftwareImage::Format::RGBA32F)
+    {
+        // without mips the minification filter is the one that applies at level 0
+        mSampler.Linear = mProperties.MinFilter != Texture2D::Filter::Nearest;
+        mSampler.Repeat = true;
+    }
+
+    SoftwareTexture2D::~SoftwareTexture2D()
+    {
+        if (SoftwareRendererAPI::IsInitialized())
+            SoftwareRendererAPI::Get().ReleaseImage(&mImage);
+    }
+
+    void SoftwareTexture2D::SetData(void *inData, uint32_t inSize)
+    {
+        ZE_ASSERT_CORE_MSG(inSize == Texture2DDataSize(mProperties.Format, mProperties.Width, mProperties.Height), "Data must be entire texture!");
+
+        if (IsCompressedFormat(mProperties.Format))
+        {
+            std::vector<uint8_t> texels(static_cast<size_t>(mProperties.Width) * mProperties.Height * 4);
+            TextureCompression::Decode(mProperties.Format, static_cast<const uint8_t*>(inData), mProperties.Width, mProperties.Height, texels.data());
+            StoreTexels(texels.data(), 4);
+            return;
+        }
+
+        if (mProperties.Format == Texture2D::Format::R32F)
+        {
+            const float *data = static_cast<const float*>(inData);
+            for (uint32_t y = 0; y < mProperties.Height; ++y)
+                for (uint32_t x = 0; x < mProperties.Width; ++x)
+                    mImage.Store(x, y, { data[static_cast<size_t>(y) * mProperties.Width + x], 0.0f, 0.0f, 1.0f });
+            return;
+        }
+
+        // the other formats are 8 bit per channel, the OpenGL backend uploads them as GL_UNSIGNED_BYTE
+        StoreTexels(static_cast<const uint8_t*>(inData), Texture2DFormatBytes(mProperties.Format));
+    }
+
+    void SoftwareTexture2D::StoreTexels(const uint8_t *inData, uint32_t inChannels)
+    {
+        for (uint32_t y = 0; y < mProperties.Height; ++y)
+        {
+            for (uint32_t x = 0; x < mProperties.Width; ++x)
+            {
+                const uint8_t *texel = inData + (static_cast<size_t>(y) * mProperties.Width + x) * inChannels;
+                glm::vec4 value(0.0f, 0.0f, 0.0f, 255.0f);
+                for (uint32_t c = 0; c < inChannels; ++c)
+                    value[c] = static_cast<float>(texel[c]);
+                mImage.Store(x, y, value / 255.0f);
+            }
+        }
+    }
+    
+    void SoftwareTexture2D::SetMipData(uint32_t inLevel, void *inData, uint32_t inSize)
+    {
+        // the lower levels would never be sampled
+        if (inLevel == 0) SetData(inData, inSize);
+    }
+
+    void SoftwareTexture2D::Bind(uint32_t inSlot) const
+    {
+        SoftwareRendererAPI::Get().BindTexture(inSlot, &mImage, mSampler);
+    }
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "ZenEngine/Renderer/Texture2D.h"
+#include "SoftwareImage.h"
+
+namespace ZenEngine
+{
+    /// @brief Texels are kept as floats, only the first mip level exists and is sampled
+    class SoftwareTexture2D : public Texture2D
+    {
+    public:
+        SoftwareTexture2D(const Texture2D::Properties &inProperties);
+        virtual ~SoftwareTexture2D();
+
+        virtual const Texture2D::Properties& GetProperties() const override { return mProperties; }
+
+        virtual uint32_t GetWidth() const override { return mProperties.Width; }
+        virtual uint32_t GetHeight() const override { return mProperties.Height; }
+        virtual uint32_t GetRendererID() const override { return 0; }
+
+        virtual void SetData(void* inData, uint32_t inSize) override;
+        virtual void SetMipData(uint32_t inLevel, void *inData, uint32_t inSize) override;
+
+        virtual void Bind(uint32_t inSlot = 0) const override;
+
+        const SoftwareImage &GetImage() const { return mImage; }
+    private:
+        Texture2D::Properties mProperties;
+        SoftwareImage mImage;
+        SoftwareSampler mSampler;
+
+        void StoreTexels(const uint8_t *inData, uint32_t inChannels);
+    };
+}
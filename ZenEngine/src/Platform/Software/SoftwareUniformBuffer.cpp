@@ -0,0 +1,35 @@
+#include "SoftwareUniformBuffer.h"
+
+#include <cstring>
+#include "SoftwareRendererAPI.h"
+
+namespace ZenEngine
+{
+    SoftwareUniformBuffer::SoftwareUniformBuffer(uint32_t inSize, uint32_t inBinding)
+        : mData(inSize, 0), mBinding(inBinding)
+    {
+        Bind();
+    }
+
+    SoftwareUniformBuffer::~SoftwareUniformBuffer()
+    {
+        if (SoftwareRendererAPI::IsInitialized())
+            SoftwareRendererAPI::Get().ReleaseUniformBuffer(this);
+    }
+
+    void SoftwareUniformBuffer::Bind()
+    {
+        Bind(mBinding);
+    }
+
+    void SoftwareUniformBuffer::Bind(uint32_t inBinding)
+    {
+        SoftwareRendererAPI::Get().BindUniformBuffer(inBinding, this);
+    }
+
+    void SoftwareUniformBuffer::SetData(const void *inData, uint32_t inSize, uint32_t inOffset)
+    {
+        ZE_ASSERT_CORE_MSG(inOffset + inSize <= mData.size(), "Writing past the end of the uniform buffer!");
+        std::memcpy(mData.data() + inOffset, inData, inSize);
+    }
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <vector>
+#include "ZenEngine/Renderer/UniformBuffer.h"
+
+namespace ZenEngine
+{
+
+    class SoftwareUniformBuffer : public UniformBuffer
+    {
+    public:
+        SoftwareUniformBuffer(uint32_t inSize, uint32_t inBinding);
+        ~SoftwareUniformBuffer();
+        
+        virtual void Bind() override;
+        virtual void Bind(uint32_t inBinding) override;
+        virtual void SetData(const void* inData, uint32_t inSize, uint32_t inOffset = 0) override;
+
+        const uint8_t *GetData() const { return mData.data(); }
+    private:
+        std::vector<uint8_t> mData;
+        uint32_t mBinding;
+    };
+}
@@ -0,0 +1,80 @@
+#include "SoftwareVertexArray.h"
+
+#include <algorithm>
+#include <limits>
+#include "ZenEngine/Core/Hash.h"
+#include "ZenEngine/Renderer/VertexBuffer.h"
+#include "SoftwareVertexBuffer.h"
+
+namespace ZenEngine
+{
+    void SoftwareVertexArray::AddVertexBuffer(const std::shared_ptr<VertexBuffer>& inVertexBuffer)
+    {
+        ZE_ASSERT_CORE_MSG(inVertexBuffer->GetLayout().GetElements().size(), "Vertex Buffer has no layout!");
+
+        uint32_t buffer = static_cast<uint32_t>(mVertexBuffers.size());
+        const auto& layout = inVertexBuffer->GetLayout();
+        for (const auto& element : layout)
+        {
+            uint32_t offset = static_cast<uint32_t>(element.Offset);
+            switch (element.Type)
+            {
+            case ShaderDataType::Float:
+            case ShaderDataType::Float2:
+            case ShaderDataType::Float3:
+            case ShaderDataType::Float4:
+                mAttributes.push_back({ buffer, offset, element.GetComponentCount(), false, element.Normalized, false });
+                mAttributeNames.push_back(element.Name);
+                break;
+            case ShaderDataType::Int:
+            case ShaderDataType::Int2:
+            case ShaderDataType::Int3:
+            case ShaderDataType::Int4:
+            case ShaderDataType::Bool:
+                mAttributes.push_back({ buffer, offset, element.GetComponentCount(), true, false, false });
+                mAttributeNames.push_back(element.Name);
+                break;
+            case ShaderDataType::Mat3:
+            case ShaderDataType::Mat4:
+            {
+                uint32_t count = element.GetComponentCount();
+                for (uint32_t i = 0; i < count; i++)
+                {
+                    mAttributes.push_back({ buffer, static_cast<uint32_t>(offset + sizeof(float) * count * i), count, false, element.Normalized, true });
+                    mAttributeNames.push_back(element.Name);
+                }
+                break;
+            }
+            default:
+                ZE_ASSERT_CORE_MSG(false, "Unknown ShaderDataType!");
+            }
+        }
+
+        Hash::Combine(mLayoutHash, layout.GetHash());
+        mVertexBuffers.push_back(inVertexBuffer);
+    }
+
+    uint32_t SoftwareVertexArray::GetElementCount(bool inPerInstance) const
+    {
+        uint32_t count = std::numeric_limits<uint32_t>::max();
+        for (const auto &attribute : mAttributes)
+        {
+            if (attribute.PerInstance != inPerInstance) continue;
+            const auto &vertexBuffer = static_cast<const SoftwareVertexBuffer&>(*mVertexBuffers[attribute.Buffer]);
+            uint32_t stride = vertexBuffer.GetLayout().GetStride();
+            count = std::min(count, stride > 0 ? vertexBuffer.GetSize() / stride : 0);
+        }
+        return count;
+    }
+
+    uint32_t SoftwareVertexArray::GetVertexCount() const
+    {
+        uint32_t count = GetElementCount(false);
+        return count == std::numeric_limits<uint32_t>::max() ? 0 : count;
+    }
+
+    uint32_t SoftwareVertexArray::GetInstanceCount() const
+    {
+        return GetElementCount(true);
+    }
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <string>
+#include "ZenEngine/Renderer/VertexArray.h"
+
+
+namespace ZenEngine
+{
+
+    class SoftwareVertexArray : public VertexArray
+    {
+    public:
+        /// @brief Where the attribute at a location is read from, locations are assigned like the OpenGL vertex array does
+        struct Attribute
+        {
+            uint32_t Buffer;
+            uint32_t Offset;
+            uint32_t Components;
+            bool Integer;
+            bool Normalized;
+            // matrix columns advance per instance, like the OpenGL vertex array sets them up
+            bool PerInstance;
+        };
+
+        virtual void Bind() const override {}
+        // every buffer is read, the depth only shaders take just the positions out of them
+        virtual void Bind(Streams inStreams) const override {}
+        virtual void Unbind() const override {}
+
+        virtual void AddVertexBuffer(const std::shared_ptr<VertexBuffer> &inVertexBuffer) override;
+        virtual void AddPositionBuffer(const std::shared_ptr<VertexBuffer> &inVertexBuffer) override { mPositionBuffer = inVertexBuffer; AddVertexBuffer(inVertexBuffer); }
+        virtual void SetIndexBuffer(const std::shared_ptr<IndexBuffer> &inIndexBuffer) override { mIndexBuffer = inIndexBuffer; }
+
+        virtual const std::vector<std::shared_ptr<VertexBuffer>> &GetVertexBuffers() const { return mVertexBuffers; }
+        virtual const std::shared_ptr<IndexBuffer> &GetIndexBuffer() const { return mIndexBuffer; }
+        virtual const std::shared_ptr<VertexBuffer> &GetPositionBuffer() const override { return mPositionBuffer; }
+
+        virtual uint64_t GetLayoutHash() const override { return mLayoutHash; }
+
+        const std::vector<Attribute> &GetAttributes() const { return mAttributes; }
+        const std::vector<std::string> &GetAttributeNames() const { return mAttributeNames; }
+        /// @brief Number of vertices every per vertex attribute can be read for
+        uint32_t GetVertexCount() const;
+        /// @brief Number of instances every per instance attribute can be read for, unbounded without per instance attributes
+        uint32_t GetInstanceCount() const;
+    private:
+        uint64_t mLayoutHash = 0;
+        std::vector<std::shared_ptr<VertexBuffer>> mVertexBuffers;
+        std::shared_ptr<IndexBuffer> mIndexBuffer;
+        std::shared_ptr<VertexBuffer> mPositionBuffer;
+        std::vector<Attribute> mAttributes;
+        std::vector<std::string> mAttributeNames;
+
+        uint32_t GetElementCount(bool inPerInstance) const;
+    };
+
+}
@@ -0,0 +1,22 @@
+#include "SoftwareVertexBuffer.h"
+
+#include <cstring>
+
+namespace ZenEngine
+{
+    SoftwareVertexBuffer::SoftwareVertexBuffer(uint32_t inSize)
+        : mData(inSize, 0)
+    {
+    }
+
+    SoftwareVertexBuffer::SoftwareVertexBuffer(const float *inVertices, uint32_t inSize)
+        : mData(reinterpret_cast<const uint8_t*>(inVertices), reinterpret_cast<const uint8_t*>(inVertices) + inSize)
+    {
+    }
+
+    void SoftwareVertexBuffer::SetData(const void *inData, uint32_t inSize)
+    {
+        ZE_ASSERT_CORE_MSG(inSize <= mData.size(), "Writing past the end of the vertex buffer!");
+        std::memcpy(mData.data(), inData, inSize);
+    }
+}
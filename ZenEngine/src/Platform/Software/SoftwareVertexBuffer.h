@@ -0,0 +1,30 @@
+#pragma once
+
+#include "ZenEngine/Renderer/VertexBuffer.h"
+#include <stdint.h>
+#include <vector>
+
+namespace ZenEngine
+{
+    
+    class SoftwareVertexBuffer : public VertexBuffer
+    {
+    public:
+        SoftwareVertexBuffer(uint32_t inSize);
+        SoftwareVertexBuffer(const float* inVertices, uint32_t inSize);
+
+        virtual void Bind() const override {}
+        virtual void Unbind() const override {}
+
+        virtual void SetData(const void* inData, uint32_t inSize) override;
+
+        virtual const BufferLayout& GetLayout() const override { return mLayout; }
+        virtual void SetLayout(const BufferLayout& inLayout) override { mLayout = inLayout; }
+
+        const uint8_t *GetData() const { return mData.data(); }
+        uint32_t GetSize() const { return static_cast<uint32_t>(mData.size()); }
+    private:
+        std::vector<uint8_t> mData;
+        BufferLayout mLayout;
+    };
+}
@@ -16,6 +16,12 @@ namespace ZenEngine
         virtual ~Asset() = default;
         virtual const char *GetAssetClassName() const = 0;
         UUID GetAssetId() const { return mId; }
+    protected:
+        /// @brief Runs on the thread that read the asset, before anyone else sees it. Work the asset would otherwise
+        /// do on first use can be moved here, it must not touch the GPU
+        virtual void OnLoad() {}
+        /// @brief Runs on the main thread once the asset is loaded, before it is handed out. GPU uploads start here
+        virtual void OnLoadFinished() {}
     private:
         UUID mId;
         friend class AssetManager;
@@ -0,0 +1,169 @@
+#include "AssetIndex.h"
+
+#include <fstream>
+#include <optional>
+
+#include "AssetLoader.h"
+#include "ZenEngine/Core/JobSystem.h"
+#include "ZenEngine/Core/Log.h"
+
+namespace ZenEngine
+{
+    // files opened by a single job, most of them only need their header read
+    static constexpr uint32_t FilesPerJob = 8;
+
+    static int64_t GetModifiedTime(const std::filesystem::path &inPath)
+    {
+        std::error_code error;
+        auto time = std::filesystem::last_write_time(inPath, error);
+        return error ? 0 : static_cast<int64_t>(time.time_since_epoch().count());
+    }
+
+    static bool GetFileStatus(const std::filesystem::path &inFilepath, AssetIndex::File &outFile)
+    {
+        std::error_code error;
+        outFile.Size = std::filesystem::file_size(inFilepath, error);
+        if (error) return false;
+        outFile.ModifiedTime = GetModifiedTime(inFilepath);
+        return true;
+    }
+
+    static std::optional<AssetIndex::File> ScanFile(const std::string &inFilepath)
+    {
+        for (auto *loader : AssetLoader::GetAllLoaders())
+        {
+            if (!loader->CanLoad(inFilepath)) continue;
+
+            AssetIndex::File file;
+            if (!GetFileStatus(inFilepath, file)) return std::nullopt;
+            try
+            {
+                auto [id, className] = loader->GetAssetIdAssetClass(inFilepath);
+                file.Id = id;
+                file.ClassName = className;
+            }
+            catch (const std::exception &e)
+            {
+                ZE_CORE_WARN("Could not read the asset header of {}: {}", inFilepath, e.what());
+                return std::nullopt;
+            }
+            return file;
+        }
+        return std::nullopt;
+    }
+
+    bool AssetIndex::Load(const std::filesystem::path &inFilepath)
+    {
+        std::ifstream ifs(inFilepath, std::ios::binary);
+        if (!ifs.is_open()) return false;
+        try
+        {
+            cereal::BinaryInputArchive archive(ifs);
+            uint32_t version = 0;
+            archive(version);
+            if (version != Version)
+            {
+                ZE_CORE_INFO("The asset index {} is out of date, the assets are scanned again", inFilepath.string());
+                return false;
+            }
+            archive(mDirectories, mFiles);
+        }
+        catch (const cereal::Exception &e)
+        {
+            ZE_CORE_WARN("Could not read the asset index {}: {}", inFilepath.string(), e.what());
+            mDirectories.clear();
+            mFiles.clear();
+            return false;
+        }
+        return true;
+    }
+
+    bool AssetIndex::Save(const std::filesystem::path &inFilepath) const
+    {
+        std::ofstream ofs(inFilepath, std::ios::binary);
+        if (!ofs.is_open())
+        {
+            ZE_CORE_WARN("Could not write the asset index {}", inFilepath.string());
+            return false;
+        }
+        cereal::BinaryOutputArchive archive(ofs);
+        archive(Version, mDirectories, mFiles);
+        return true;
+    }
+
+    void AssetIndex::Update(const std::filesystem::path &inRoot)
+    {
+        AssetIndex previous;
+        std::swap(previous.mDirectories, mDirectories);
+        std::swap(previous.mFiles, mFiles);
+        if (!std::filesystem::is_directory(inRoot))
+        {
+            ZE_CORE_ERROR("Asset import folder should be a directory");
+            return;
+        }
+
+        std::vector<std::string> changed;
+        Walk(inRoot, previous, changed);
+        size_t reused = mFiles.size();
+
+        std::vector<std::optional<File>> scanned(changed.size());
+        JobSystem::Get().ParallelFor(static_cast<uint32_t>(changed.size()), FilesPerJob, [&](uint32_t inBegin, uint32_t inEnd)
+        {
+            for (uint32_t i = inBegin; i < inEnd; ++i)
+                scanned[i] = ScanFile(changed[i]);
+        });
+        for (size_t i = 0; i < changed.size(); ++i)
+        {
+            if (!scanned[i].has_value()) continue;
+            mFiles[changed[i]] = *scanned[i];
+            mDirectories[std::filesystem::path(changed[i]).parent_path().generic_string()].Files.push_back(changed[i]);
+        }
+        ZE_CORE_INFO("Asset index: {} assets unchanged, {} files scanned", reused, changed.size());
+    }
+
+    void AssetIndex::Walk(const std::filesystem::path &inDirectory, const AssetIndex &inPrevious, std::vector<std::string> &outChanged)
+    {
+        // references to the elements stay valid while the subdirectories are added
+        auto &directory = mDirectories[inDirectory.generic_string()];
+        directory.ModifiedTime = GetModifiedTime(inDirectory);
+
+        std::vector<std::string> files;
+        auto cached = inPrevious.mDirectories.find(inDirectory.generic_string());
+        if (cached != inPrevious.mDirectories.end() && cached->second.ModifiedTime == directory.ModifiedTime)
+        {
+            // nothing was added, removed or renamed in it, the files may still have been written to
+            directory.Subdirectories = cached->second.Subdirectories;
+            files = cached->second.Files;
+        }
+        else
+        {
+            std::error_code error;
+            for (const auto &entry : std::filesystem::directory_iterator(inDirectory, error))
+            {
+                if (entry.is_directory(error))
+                    directory.Subdirectories.push_back(entry.path().generic_string());
+                else if (entry.is_regular_file(error))
+                    files.push_back(entry.path().generic_string());
+            }
+        }
+
+        for (const auto &filepath : files)
+        {
+            File status;
+            if (!GetFileStatus(filepath, status)) continue;
+            auto file = inPrevious.mFiles.find(filepath);
+            if (file != inPrevious.mFiles.end() && file->second.Size == status.Size && file->second.ModifiedTime == status.ModifiedTime)
+            {
+                mFiles[filepath] = file->second;
+                directory.Files.push_back(filepath);
+            }
+            else
+            {
+                outChanged.push_back(filepath);
+            }
+        }
+
+        for (const auto &subdirectory : directory.Subdirectories)
+            Walk(subdirectory, inPrevious, outChanged);
+    }
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "UUID.h"
+#include "Serialization.h"
+
+namespace ZenEngine
+{
+    /// @brief What the asset database was built from the last time, saved so that startup does not open every asset again.
+    /// A directory whose modification time is unchanged keeps its list of files, which are only checked for size and time.
+    /// The files that are new or changed are opened by the loaders in parallel on the job system
+    class AssetIndex
+    {
+    public:
+        static constexpr uint32_t Version = 2;
+
+        struct File
+        {
+            UUID Id = 0;
+            std::string ClassName;
+            uint64_t Size = 0;
+            int64_t ModifiedTime = 0;
+
+            template <typename Archive>
+            void Serialize(Archive &inArchive)
+            {
+                inArchive(Id, ClassName, Size, ModifiedTime);
+            }
+        };
+
+        struct Directory
+        {
+            int64_t ModifiedTime = 0;
+            std::vector<std::string> Subdirectories;
+            // only the files some loader took
+            std::vector<std::string> Files;
+
+            template <typename Archive>
+            void Serialize(Archive &inArchive)
+            {
+                inArchive(ModifiedTime, Subdirectories, Files);
+            }
+        };
+
+        /// @brief Returns false and leaves the index empty if there is no index or it was written by another version
+        bool Load(const std::filesystem::path &inFilepath);
+        bool Save(const std::filesystem::path &inFilepath) const;
+
+        /// @brief Brings the index up to date with what is under inRoot
+        void Update(const std::filesystem::path &inRoot);
+
+        /// @brief Asset files by path
+        const std::unordered_map<std::string, File> &GetFiles() const { return mFiles; }
+    private:
+        std::unordered_map<std::string, Directory> mDirectories;
+        std::unordered_map<std::string, File> mFiles;
+
+        void Walk(const std::filesystem::path &inDirectory, const AssetIndex &inPrevious, std::vector<std::string> &outChanged);
+    };
+}
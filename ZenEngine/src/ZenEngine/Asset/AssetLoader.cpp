@@ -1,5 +1,6 @@
 #include "AssetLoader.h"
 
+#include "BlobLoader.h"
 #include "Serialization.h"
 
 namespace ZenEngine
@@ -7,7 +8,20 @@ namespace ZenEngine
     std::shared_ptr<Asset> BinaryLoader::Load(const std::filesystem::path &inFilepath) const
     {
         std::ifstream ifs(inFilepath, std::ios::binary);
-        cereal::BinaryInputArchive archive(ifs);
+        return LoadFromStream(ifs);
+    }
+
+    std::shared_ptr<Asset> BinaryLoader::LoadPacked(const PackedAsset &inPacked) const
+    {
+        // the asset is deserialized into its own memory, the packed bytes are not needed after this
+        BlobStreamBuffer buffer(inPacked.Data);
+        std::istream stream(&buffer);
+        return LoadFromStream(stream);
+    }
+
+    std::shared_ptr<Asset> BinaryLoader::LoadFromStream(std::istream &inStream) const
+    {
+        cereal::BinaryInputArchive archive(inStream);
         UUID id;
         std::shared_ptr<Asset> assetInstance;
         std::string className;
@@ -15,7 +29,7 @@ namespace ZenEngine
         {
             archive(className, id, assetInstance);
         }
-        catch (cereal::Exception e)
+        catch (const std::exception &e)
         {
             ZE_CORE_ERROR("{}", e.what());
             return nullptr;
@@ -32,16 +46,47 @@ namespace ZenEngine
             return false;
         }
         std::ofstream os(inFilepath, std::ios::binary);
+        if (!os.is_open())
+        {
+            ZE_CORE_ERROR("Cannot write {}", inFilepath.string());
+            return false;
+        }
         cereal::BinaryOutputArchive archive(os);
         std::string className = inAssetInstance->GetAssetClassName();
         archive(className, inAssetInstance->GetAssetId(), inAssetInstance);
         return true;
     }
 
+    bool AssetLoader::Overwrite(const std::shared_ptr<Asset> &inAssetInstance, const std::filesystem::path &inFilepath) const
+    {
+        std::filesystem::path temporary = inFilepath;
+        temporary += ".tmp";
+        // left over from a save that did not finish
+        std::error_code error;
+        std::filesystem::remove(temporary, error);
+        if (!Save(inAssetInstance, temporary))
+        {
+            std::filesystem::remove(temporary, error);
+            return false;
+        }
+
+        Release(*inAssetInstance);
+        std::filesystem::rename(temporary, inFilepath, error);
+        if (error)
+        {
+            // the asset keeps what it has in memory, it is not read back from the old file
+            ZE_CORE_ERROR("Could not replace {}: {}", inFilepath.string(), error.message());
+            std::filesystem::remove(temporary, error);
+            return false;
+        }
+        return Reload(*inAssetInstance, inFilepath);
+    }
+
     bool BinaryLoader::CanLoad(const std::filesystem::path &inFilepath) const
     {
         // TODO think about this
-        return (inFilepath.extension().string() == ".zasset");
+        // the classes saved as blob files share the extension, their header tells them apart
+        return (inFilepath.extension().string() == ".zasset") && !BlobFile::ReadHeader(inFilepath).has_value();
     }
     
     std::pair<UUID, const char*> BinaryLoader::GetAssetIdAssetClass(const std::filesystem::path &inFilepath) const
@@ -1,7 +1,9 @@
 #pragma once
 
 #include "Asset.h"
+#include <istream>
 #include <memory>
+#include <span>
 #include <vector>
 #include <filesystem>
 
@@ -9,6 +11,17 @@ namespace ZenEngine
 {
     struct AssetInfo;
 
+    /// @brief The bytes of an asset file read from somewhere else than the file itself, e.g. a pak.
+    /// The owner keeps them in memory for as long as the asset holds on to it
+    struct PackedAsset
+    {
+        UUID Id;
+        // where the file was when it was packed
+        std::filesystem::path Filepath;
+        std::span<const uint8_t> Data;
+        std::shared_ptr<const void> Owner;
+    };
+
     class AssetLoader
     {
     public:
@@ -16,11 +29,20 @@ namespace ZenEngine
         virtual const char *GetName() const = 0;
         virtual bool Save(const std::shared_ptr<Asset> &inAssetInstance, const std::filesystem::path &inFilepath) const  = 0;
         virtual std::shared_ptr<Asset> Load(const std::filesystem::path &inFilepath) const = 0;
+        virtual std::shared_ptr<Asset> LoadPacked(const PackedAsset &inPacked) const = 0;
         virtual bool CanLoad(const std::filesystem::path &inFilepath) const = 0;
         virtual std::pair<UUID, const char*> GetAssetIdAssetClass(const std::filesystem::path &inFilepath) const = 0;
+        /// @brief Saves over the file the asset was loaded from. It is written next to it and moved over it, a save that
+        /// fails leaves the old file as it was
+        bool Overwrite(const std::shared_ptr<Asset> &inAssetInstance, const std::filesystem::path &inFilepath) const;
 
         static const std::vector<AssetLoader *> &GetAllLoaders() { return sAllLoaders; }
     protected:
+        /// @brief Lets go of the file the asset reads from in place, a mapped file can not be replaced on Windows
+        virtual void Release(Asset &ioAssetInstance) const {}
+        /// @brief Reads from the file again once it was replaced
+        virtual bool Reload(Asset &ioAssetInstance, const std::filesystem::path &inFilepath) const { return true; }
+
         void SetId(std::shared_ptr<Asset> &inAssetInstance, UUID inUUID) const { inAssetInstance->mId = inUUID; }
         
         static std::vector<AssetLoader *> sAllLoaders;
@@ -91,8 +113,11 @@ namespace ZenEngine
 
         virtual bool Save(const std::shared_ptr<Asset> &inAssetInstance, const std::filesystem::path &inFilepath) const override;
         virtual std::shared_ptr<Asset> Load(const std::filesystem::path &inFilepath) const override;
+        virtual std::shared_ptr<Asset> LoadPacked(const PackedAsset &inPacked) const override;
         virtual bool CanLoad(const std::filesystem::path &inFilepath) const override;
         virtual std::pair<UUID, const char*> GetAssetIdAssetClass(const std::filesystem::path &inFilepath) const override;
+    private:
+        std::shared_ptr<Asset> LoadFromStream(std::istream &inStream) const;
     };
 
     template <typename ClientMeta>
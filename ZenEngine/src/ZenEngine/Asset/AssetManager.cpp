@@ -1,9 +1,14 @@
 #include "AssetManager.h"
 
+#include <algorithm>
+
 #include "ZenEngine/Core/Macros.h"
 #include "StaticMesh.h"
 #include "ShaderAsset.h"
 #include "Texture2DAsset.h"
+#include "HLODAsset.h"
+#include "AssetIndex.h"
+#include "PakArchive.h"
 
 #include "Serialization.h"
 
@@ -12,9 +17,39 @@ namespace ZenEngine
     std::vector<AssetLoader *> AssetLoader::sAllLoaders;
     std::unique_ptr<AssetManager> AssetManager::sAssetManagerInstance;
     static const char *sAssetDirectory = "Assets";
+    // next to the asset directory rather than in it, writing it would otherwise change the directory it describes
+    static const char *sAssetIndexFile = "AssetIndex.zindex";
+    // mounted when there is one, what shipping builds read their assets from
+    static const char *sPakFile = "Assets.zpak";
+
+    // a packed asset is found by its id in the pak, the others are read from their own file
+    static std::shared_ptr<Asset> ReadAsset(const AssetLoader *inLoader, UUID inUUID, const std::filesystem::path &inFilepath, const PakArchive *inPak)
+    {
+        if (inPak == nullptr) return inLoader->Load(inFilepath);
+        const auto *entry = inPak->Find(inUUID);
+        if (entry == nullptr) return nullptr;
+        auto packed = inPak->Read(*entry);
+        if (packed.Owner == nullptr)
+        {
+            ZE_CORE_ERROR("The packed data of {} is corrupted", inFilepath.string());
+            return nullptr;
+        }
+        return inLoader->LoadPacked(packed);
+    }
 
     void AssetManager::Init()
-    {    
+    {
+        InitDatabase();
+        if (std::filesystem::exists(sPakFile)) MountPak(sPakFile);
+        SetPlaceholder(Texture2DAsset::GetStaticAssetClassName(), 1);
+
+        mStopLoading = false;
+        for (uint32_t i = 0; i < LoaderThreadCount; ++i)
+            mLoaderThreads.emplace_back([this]() { RunLoaderThread(); });
+    }
+
+    void AssetManager::InitDatabase()
+    {
         RegisterCoreAssets();
         if (!std::filesystem::exists(sAssetDirectory))
             std::filesystem::create_directories(sAssetDirectory);
@@ -27,6 +62,166 @@ namespace ZenEngine
         BuildAssetDatabase();
     }
 
+    AssetManager::~AssetManager()
+    {
+        Shutdown();
+    }
+
+    void AssetManager::Shutdown()
+    {
+        {
+            std::lock_guard lock(mLoadMutex);
+            mStopLoading = true;
+        }
+        mLoadCondition.notify_all();
+        for (auto &thread : mLoaderThreads)
+            thread.join();
+        mLoaderThreads.clear();
+
+        // whatever was still queued is dropped, the callbacks never run
+        for (auto &queue : mLoadQueues)
+            queue.clear();
+        mFinishedLoads.clear();
+        mPendingLoads.clear();
+        mPlaceholders.clear();
+    }
+
+    void AssetManager::Update()
+    {
+        std::vector<std::shared_ptr<AssetRequest>> finished;
+        {
+            std::lock_guard lock(mLoadMutex);
+            std::swap(finished, mFinishedLoads);
+        }
+
+        for (auto &request : finished)
+        {
+            mPendingLoads.erase(request->mId);
+            // a synchronous load may have got there first, there is only ever one instance of an asset
+            auto cached = mAssetCache.find(request->mId);
+            std::shared_ptr<Asset> loaded = cached != mAssetCache.end() ? cached->second.lock() : nullptr;
+            if (loaded != nullptr)
+            {
+                request->mAsset = loaded;
+            }
+            else if (request->mAsset != nullptr)
+            {
+                if (request->mAsset->GetAssetId() != request->mId) ZE_CORE_ERROR("The asset loaded from {} appears to not match UUID. Has the file been tampered with?", request->mFilepath);
+                mAssetCache[request->mId] = request->mAsset;
+                request->mAsset->OnLoadFinished();
+            }
+            else
+            {
+                ZE_CORE_ERROR("Could not load asset {}", (uint64_t)request->mId);
+            }
+
+            request->mDone = true;
+            for (auto &callback : request->mCallbacks)
+                callback(request->mAsset);
+            request->mCallbacks.clear();
+        }
+    }
+
+    std::shared_ptr<AssetRequest> AssetManager::LoadAssetAsync(UUID inUUID, AssetRequest::Priority inPriority, AssetRequest::Callback inCallback)
+    {
+        if (auto it = mPendingLoads.find(inUUID); it != mPendingLoads.end())
+        {
+            auto &pending = it->second;
+            if (inCallback) pending->mCallbacks.push_back(std::move(inCallback));
+            if (inPriority > pending->mPriority)
+            {
+                pending->mPriority = inPriority;
+                std::lock_guard lock(mLoadMutex);
+                if (!pending->mStarted)
+                {
+                    mLoadQueues[static_cast<size_t>(inPriority)].push_back(pending);
+                    mLoadCondition.notify_one();
+                }
+            }
+            return pending;
+        }
+
+        auto request = std::make_shared<AssetRequest>();
+        request->mId = inUUID;
+        request->mPriority = inPriority;
+
+        // loaded already, or nothing to read in the background: missing assets are reported by the synchronous path
+        auto cached = mAssetCache.find(inUUID);
+        bool isLoaded = cached != mAssetCache.end() && !cached->second.expired();
+        if (isLoaded || !Exists(inUUID) || mLoaderThreads.empty())
+        {
+            request->mAsset = LoadAsset(inUUID);
+            request->mDone = true;
+            if (inCallback) inCallback(request->mAsset);
+            return request;
+        }
+
+        const auto &asset = mAssetDatabase.at(inUUID);
+        request->mFilepath = asset.Filepath;
+        request->mPak = asset.Pak;
+        request->mLoader = mAssetLoaders[asset.ClassName];
+        request->mPlaceholder = GetPlaceholder(asset.ClassName);
+        if (inCallback) request->mCallbacks.push_back(std::move(inCallback));
+        mPendingLoads[inUUID] = request;
+        {
+            std::lock_guard lock(mLoadMutex);
+            mLoadQueues[static_cast<size_t>(inPriority)].push_back(request);
+        }
+        mLoadCondition.notify_one();
+        return request;
+    }
+
+    void AssetManager::RunLoaderThread()
+    {
+        while (true)
+        {
+            std::shared_ptr<AssetRequest> request;
+            {
+                std::unique_lock lock(mLoadMutex);
+                mLoadCondition.wait(lock, [this]()
+                {
+                    return mStopLoading || std::any_of(mLoadQueues.begin(), mLoadQueues.end(), [](const auto &inQueue) { return !inQueue.empty(); });
+                });
+                if (mStopLoading) return;
+                // highest priority first, a request raised to a higher one was already taken from there
+                for (auto queue = mLoadQueues.rbegin(); queue != mLoadQueues.rend() && request == nullptr; ++queue)
+                {
+                    while (!queue->empty() && request == nullptr)
+                    {
+                        auto front = std::move(queue->front());
+                        queue->pop_front();
+                        if (!front->mStarted) request = std::move(front);
+                    }
+                }
+                if (request == nullptr) continue;
+                request->mStarted = true;
+            }
+
+            auto asset = ReadAsset(request->mLoader, request->mId, request->mFilepath, request->mPak.get());
+            if (asset != nullptr) asset->OnLoad();
+            request->mAsset = std::move(asset);
+
+            std::lock_guard lock(mLoadMutex);
+            mFinishedLoads.push_back(std::move(request));
+        }
+    }
+
+    void AssetManager::SetPlaceholder(const char *inAssetClassName, UUID inPlaceholderId)
+    {
+        mPlaceholderIds[inAssetClassName] = inPlaceholderId;
+        mPlaceholders.erase(inAssetClassName);
+    }
+
+    std::shared_ptr<Asset> AssetManager::GetPlaceholder(const char *inAssetClassName)
+    {
+        auto id = mPlaceholderIds.find(inAssetClassName);
+        if (id == mPlaceholderIds.end()) return nullptr;
+        // kept loaded for as long as the manager, it is shown often
+        auto &placeholder = mPlaceholders[inAssetClassName];
+        if (placeholder == nullptr) placeholder = LoadAsset(id->second);
+        return placeholder;
+    }
+
     void AssetManager::Import(const std::filesystem::path &inFilepath)
     {
         Import(inFilepath, sAssetDirectory);
@@ -58,8 +253,9 @@ namespace ZenEngine
                 uint32_t index = 0;
                 for (auto &importedAsset : importer->Import(inFilepath))
                 {
-                    mAssetDatabase[inUUID] = AssetInfo(inUUID, importedAsset, inDestinationFolder);
-                    SaveAsset(importedAsset.Instance, mAssetDatabase[inUUID].Filepath);
+                    AssetInfo asset(inUUID, importedAsset, inDestinationFolder);
+                    AddToDatabase(asset);
+                    SaveAsset(importedAsset.Instance, asset.Filepath);
                 }
                 break;
             }
@@ -79,26 +275,48 @@ namespace ZenEngine
 
     const char *AssetManager::QueryFilepathAssetClassName(const std::filesystem::path &inFilepath) const
     {
-        for (auto &[uuid, asset] : mAssetDatabase)
-        {
-            if (asset.Filepath == inFilepath)
-            {
-                return asset.ClassName;
-            }
-        }
-        return nullptr;
+        auto id = QueryFilepathAssetId(inFilepath);
+        return id.has_value() ? mAssetDatabase.at(*id).ClassName : nullptr;
     }
 
     std::optional<UUID> AssetManager::QueryFilepathAssetId(const std::filesystem::path &inFilepath) const
     {
-        for (auto &[uuid, asset] : mAssetDatabase)
+        auto it = mAssetPaths.find(NormalizePath(inFilepath));
+        if (it == mAssetPaths.end()) return std::nullopt;
+        return it->second;
+    }
+
+    const std::unordered_set<UUID> &AssetManager::GetAssetsOfClass(const std::string &inClassName) const
+    {
+        static const std::unordered_set<UUID> none;
+        auto it = mAssetsByClass.find(inClassName);
+        return it != mAssetsByClass.end() ? it->second : none;
+    }
+
+    void AssetManager::MovePath(const std::filesystem::path &inOldPath, const std::filesystem::path &inNewPath)
+    {
+        std::string oldPath = NormalizePath(inOldPath);
+        std::string newPath = NormalizePath(inNewPath);
+        std::vector<std::pair<UUID, std::string>> moved;
+        if (auto it = mAssetPaths.find(oldPath); it != mAssetPaths.end())
         {
-            if (asset.Filepath == inFilepath)
-            {
-                return uuid;
-            }
+            moved.emplace_back(it->second, newPath);
+        }
+        else
+        {
+            // a directory, everything under it moves along
+            std::string prefix = oldPath + '/';
+            for (const auto &[path, id] : mAssetPaths)
+                if (path.starts_with(prefix)) moved.emplace_back(id, newPath + path.substr(oldPath.size()));
+        }
+
+        for (const auto &[id, path] : moved)
+        {
+            AssetInfo asset = mAssetDatabase.at(id);
+            RemoveFromDatabase(id);
+            asset.Filepath = path;
+            AddToDatabase(asset);
         }
-        return std::nullopt;
     }
 
     std::shared_ptr<Asset> AssetManager::LoadAsset(UUID inUUID)
@@ -118,15 +336,16 @@ namespace ZenEngine
             }
         }
 
-        auto &asset = mAssetDatabase[inUUID];
+        AssetInfo asset = mAssetDatabase[inUUID];
 
         // TODO maybe refactor this
-        if (!std::filesystem::exists(asset.Filepath))
+        if (asset.Pak == nullptr && !std::filesystem::exists(asset.Filepath))
         {
             ZE_CORE_WARN("The asset {} does not exist anymore. Maybe it was moved. Rebuilding database", asset.Filepath.string());
             BuildAssetDatabase();
-            asset = mAssetDatabase[inUUID];
-            if (!std::filesystem::exists(asset.Filepath))
+            // rebuilding replaces the entries, a deleted asset has none anymore
+            if (Exists(inUUID)) asset = mAssetDatabase[inUUID];
+            if (!Exists(inUUID) || !std::filesystem::exists(asset.Filepath))
             {
                 ZE_CORE_ERROR("Asset {} has been deleted. Removing it from database.", (uint64_t)inUUID);
                 mAssetCache.erase(inUUID);
@@ -135,7 +354,7 @@ namespace ZenEngine
         }
 
         auto &loader = mAssetLoaders[asset.ClassName];
-        std::shared_ptr<Asset> assetInstance = loader->Load(asset.Filepath);
+        std::shared_ptr<Asset> assetInstance = ReadAsset(loader, inUUID, asset.Filepath, asset.Pak.get());
 
         if (assetInstance == nullptr)
         {
@@ -143,7 +362,9 @@ namespace ZenEngine
             return nullptr;
         }
 
+        assetInstance->OnLoad();
         mAssetCache[inUUID] = assetInstance;
+        assetInstance->OnLoadFinished();
 
         if (assetInstance->GetAssetId() != inUUID) ZE_CORE_ERROR("The asset loaded from {} appears to not match UUID. Has the file been tampered with?", asset.Filepath);
         // TODO: if for some reason the id has changed we should save the asset with the new id?
@@ -160,6 +381,8 @@ namespace ZenEngine
         
         RegisterAssetClass<Texture2DAsset>();
         RegisterImporter<STBImageImporter>();
+
+        RegisterAssetClass<HLODAsset>();
     }
 
     bool AssetManager::SaveAsset(const std::shared_ptr<Asset> &inAssetInstance, const std::filesystem::path &inFilepath)
@@ -168,39 +391,38 @@ namespace ZenEngine
         return loader->Save(inAssetInstance, inFilepath);
     }
 
-    void AssetManager::BuildAssetDatabaseFrom(const std::filesystem::path &inImportFolder)
+    bool AssetManager::OverwriteAsset(const std::shared_ptr<Asset> &inAssetInstance)
     {
-        if (!std::filesystem::is_directory(inImportFolder))
+        auto it = mAssetDatabase.find(inAssetInstance->GetAssetId());
+        if (it == mAssetDatabase.end())
         {
-            ZE_CORE_ERROR("Asset import folder should be a directory");
-            return;
+            ZE_CORE_ERROR("The asset is not in the database, it has no file to save over");
+            return false;
         }
-        for (auto &dirEntry : std::filesystem::directory_iterator(inImportFolder))
+        const auto &asset = it->second;
+        if (asset.Pak != nullptr)
         {
-            auto path = dirEntry.path();
-            if (std::filesystem::is_directory(path))
-            {
-                BuildAssetDatabaseFrom(path);
-                continue;
-            }
-            for (auto &loader : AssetLoader::GetAllLoaders())
-            {
-                if (loader->CanLoad(path))
-                {
-                    auto [id, className] = loader->GetAssetIdAssetClass(path);
-                    AssetInfo asset;
-                    asset.ClassName = className;
-                    asset.Id = id;
-                    asset.Filepath = path;
-                    if (mAssetDatabase.contains(asset.Id))
-                    {
-                        ZE_CORE_WARN("An asset with the same id already exists. Is it being imported twice?");
-                    }
-                    mAssetDatabase[id] = asset;
-                    ZE_CORE_TRACE("Loaded {} asset {} into database", asset.ClassName, (uint64_t)asset.Id);
-                }
-            }
+            ZE_CORE_ERROR("{} is read from a pak, it can not be saved", asset.GetName());
+            return false;
         }
+        auto &loader = mAssetLoaders[inAssetInstance->GetAssetClassName()];
+        return loader->Overwrite(inAssetInstance, asset.Filepath);
+    }
+
+    std::optional<UUID> AssetManager::CreateAsset(const std::shared_ptr<Asset> &inAssetInstance, const std::filesystem::path &inFilepath)
+    {
+        std::filesystem::path filepath = std::filesystem::path(sAssetDirectory) / inFilepath;
+        if (filepath.has_parent_path() && !std::filesystem::exists(filepath.parent_path()))
+            std::filesystem::create_directories(filepath.parent_path());
+        if (!SaveAsset(inAssetInstance, filepath)) return std::nullopt;
+
+        AssetInfo asset;
+        asset.Id = inAssetInstance->GetAssetId();
+        asset.Filepath = filepath;
+        asset.ClassName = inAssetInstance->GetAssetClassName();
+        AddToDatabase(asset);
+        mAssetCache[asset.Id] = inAssetInstance;
+        return asset.Id;
     }
 
     void AssetManager::ImportDefaultAssets()
@@ -210,9 +432,108 @@ namespace ZenEngine
     }
     
     void AssetManager::BuildAssetDatabase()
+    {
+        ClearDatabase();
+        AssetIndex index;
+        index.Load(sAssetIndexFile);
+        index.Update(sAssetDirectory);
+        for (const auto &[filepath, file] : index.GetFiles())
+        {
+            if (!mAssetClasses.contains(file.ClassName))
+            {
+                ZE_CORE_WARN("{} is a {}, which is not a registered asset class", filepath, file.ClassName);
+                continue;
+            }
+            AssetInfo asset;
+            asset.ClassName = GetAssetClassByName(file.ClassName);
+            asset.Id = file.Id;
+            asset.Filepath = filepath;
+            if (mAssetDatabase.contains(asset.Id))
+            {
+                ZE_CORE_WARN("An asset with the same id already exists. Is it being imported twice?");
+            }
+            AddToDatabase(asset);
+            ZE_CORE_TRACE("Loaded {} asset {} into database", asset.ClassName, (uint64_t)asset.Id);
+        }
+        index.Save(sAssetIndexFile);
+        for (const auto &pak : mPaks)
+            AddPakToDatabase(pak);
+    }
+
+    bool AssetManager::MountPak(const std::filesystem::path &inFilepath)
+    {
+        auto pak = std::make_shared<PakArchive>();
+        if (!pak->Open(inFilepath)) return false;
+        mPaks.push_back(pak);
+        AddPakToDatabase(pak);
+        return true;
+    }
+
+    void AssetManager::AddPakToDatabase(const std::shared_ptr<const PakArchive> &inPak)
+    {
+        for (uint32_t i = 0; i < inPak->GetEntryCount(); ++i)
+        {
+            const auto &entry = inPak->GetEntry(i);
+            // a loose file is what was edited last
+            if (Exists(entry.Id)) continue;
+            if (!mAssetClasses.contains(inPak->GetClassName(entry)))
+            {
+                ZE_CORE_WARN("{} is a {}, which is not a registered asset class", inPak->GetPath(entry), inPak->GetClassName(entry));
+                continue;
+            }
+            AssetInfo asset;
+            asset.Id = entry.Id;
+            asset.Filepath = inPak->GetPath(entry);
+            asset.ClassName = GetAssetClassByName(inPak->GetClassName(entry));
+            asset.Pak = inPak;
+            AddToDatabase(asset);
+        }
+    }
+
+    bool AssetManager::WritePak(const std::filesystem::path &inFilepath, bool inCompress) const
+    {
+        if (!mPaks.empty())
+        {
+            ZE_CORE_ERROR("A pak is mounted, the assets only in it would be missing from {}", inFilepath.string());
+            return false;
+        }
+        PakWriter writer;
+        for (const auto &[id, asset] : mAssetDatabase)
+            if (asset.Pak == nullptr) writer.Add(id, asset.ClassName, asset.Filepath);
+        return writer.Write(inFilepath, inCompress);
+    }
+
+    void AssetManager::AddToDatabase(const AssetInfo &inAsset)
+    {
+        // an id that is already there, e.g. an asset imported again, leaves no stale lookups behind
+        if (mAssetDatabase.contains(inAsset.Id)) RemoveFromDatabase(inAsset.Id);
+        mAssetDatabase[inAsset.Id] = inAsset;
+        mAssetPaths[NormalizePath(inAsset.Filepath)] = inAsset.Id;
+        mAssetsByClass[inAsset.ClassName].insert(inAsset.Id);
+    }
+
+    void AssetManager::RemoveFromDatabase(UUID inUUID)
+    {
+        auto it = mAssetDatabase.find(inUUID);
+        if (it == mAssetDatabase.end()) return;
+        auto path = mAssetPaths.find(NormalizePath(it->second.Filepath));
+        if (path != mAssetPaths.end() && path->second == inUUID) mAssetPaths.erase(path);
+        mAssetsByClass[it->second.ClassName].erase(inUUID);
+        mAssetDatabase.erase(it);
+    }
+
+    void AssetManager::ClearDatabase()
     {
         mAssetDatabase.clear();
-        BuildAssetDatabaseFrom(sAssetDirectory);
+        mAssetPaths.clear();
+        mAssetsByClass.clear();
     }
 
+    std::string AssetManager::NormalizePath(const std::filesystem::path &inFilepath)
+    {
+        std::string path = inFilepath.lexically_normal().generic_string();
+        // directories compare the same with and without the trailing separator
+        if (path.size() > 1 && path.back() == '/') path.pop_back();
+        return path;
+    }
 }
\ No newline at end of file
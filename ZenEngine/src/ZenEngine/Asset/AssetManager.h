@@ -1,10 +1,17 @@
 #pragma once
 
+#include <array>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
 #include <optional>
+#include <thread>
 #include <vector>
 #include <string>
 #include <memory>
 #include <unordered_map>
+#include <unordered_set>
 #include <fstream>
 
 #include "Asset.h"
@@ -16,6 +23,7 @@
 
 namespace ZenEngine
 {
+    class PakArchive;
 
     struct ImportedAsset
     {
@@ -29,6 +37,8 @@ namespace ZenEngine
         UUID Id;
         std::filesystem::path Filepath;
         const char *ClassName;
+        // set when the asset is read from a pak, the path is then where it was packed from
+        std::shared_ptr<const PakArchive> Pak;
        
         AssetInfo() = default;
         AssetInfo(UUID inId, const ImportedAsset &inImportedAsset, const std::filesystem::path &inDestinationPath)
@@ -38,6 +48,46 @@ namespace ZenEngine
         std::string GetName() const { return Filepath.stem().string(); }
     };
 
+    /// @brief An asset being read on the loader threads, see AssetManager::LoadAssetAsync.
+    /// Everyone asking for the same asset while it loads shares the same request
+    class AssetRequest
+    {
+    public:
+        enum class Priority
+        {
+            Low = 0,
+            Normal,
+            // what is on screen
+            High
+        };
+        /// @brief Gets the asset, or null if it could not be loaded
+        using Callback = std::function<void(const std::shared_ptr<Asset> &)>;
+
+        UUID GetAssetId() const { return mId; }
+        /// @brief Set on the main thread once the asset is loaded and its callbacks have run, or the load failed
+        bool IsDone() const { return mDone; }
+        /// @brief The placeholder of the asset class until done, e.g. the default texture. Null if the load failed
+        std::shared_ptr<Asset> GetAsset() const { return mDone ? mAsset : mPlaceholder; }
+        template <IsAsset T>
+        std::shared_ptr<T> GetAssetAs() const { return std::static_pointer_cast<T>(GetAsset()); }
+    private:
+        UUID mId = 0;
+        // copied from the database when queued, the loader threads do not read it
+        std::filesystem::path mFilepath;
+        std::shared_ptr<const PakArchive> mPak;
+        AssetLoader *mLoader = nullptr;
+        Priority mPriority = Priority::Normal;
+        // guarded by the queue mutex
+        bool mStarted = false;
+
+        std::shared_ptr<Asset> mAsset;
+        std::shared_ptr<Asset> mPlaceholder;
+        bool mDone = false;
+        std::vector<Callback> mCallbacks;
+
+        friend class AssetManager;
+    };
+
     class AssetImporter
     {
     public:
@@ -56,9 +106,23 @@ namespace ZenEngine
             return *sAssetManagerInstance;
         }
 
+        ~AssetManager();
+
         void Init();
+        /// @brief Registers the asset classes and builds the database of the loose files, all that tools working on
+        /// the files need. Init does this too, then mounts the pak and starts the loader threads
+        void InitDatabase();
+        void Shutdown();
+        /// @brief Finishes the asynchronous loads that are done, once per frame on the main thread
+        void Update();
 
         std::shared_ptr<Asset> LoadAsset(UUID inUUID);
+        /// @brief Starts reading the asset on the loader threads and returns right away. The callback runs on the main
+        /// thread once the asset is loaded, right away if it already is. Asking again while it loads can raise the priority
+        std::shared_ptr<AssetRequest> LoadAssetAsync(UUID inUUID, AssetRequest::Priority inPriority = AssetRequest::Priority::Normal, AssetRequest::Callback inCallback = {});
+        /// @brief Asset shown instead of the ones of a class while they load
+        void SetPlaceholder(const char *inAssetClassName, UUID inPlaceholderId);
+        uint32_t GetPendingLoadCount() const { return static_cast<uint32_t>(mPendingLoads.size()); }
         bool IsLoaded(UUID inAssetId);
         
         template <IsAsset AssetClass>
@@ -78,7 +142,14 @@ namespace ZenEngine
         void Import(const std::filesystem::path &inFilepath, const std::filesystem::path &inDestinationFolder);
         void Import(const std::filesystem::path &inFilepath, const std::filesystem::path &inDestinationFolder, UUID inUUID);
 
+        /// @brief Reads the saved asset index and scans only the files that changed since it was written
         void BuildAssetDatabase();
+        /// @brief Adds the assets of a pak to the database, loose files with the same id take precedence.
+        /// The pak stays mapped as long as the database refers to it
+        bool MountPak(const std::filesystem::path &inFilepath);
+        /// @brief Packs every loose asset of the database into a single file, see PakArchive.
+        /// Refused while a pak is mounted, the assets only in it would be left out
+        bool WritePak(const std::filesystem::path &inFilepath, bool inCompress) const;
         const std::unordered_map<UUID, AssetInfo> &GetAssetDatabase() const;
         const AssetInfo &GetAsset(UUID inUUID) const { return mAssetDatabase.at(inUUID); }
         const char *GetAssetClassName(UUID inUUID) const { return mAssetDatabase.at(inUUID).ClassName; }
@@ -86,6 +157,10 @@ namespace ZenEngine
 
         const char *QueryFilepathAssetClassName(const std::filesystem::path &inFilepath) const;
         std::optional<UUID> QueryFilepathAssetId(const std::filesystem::path &inFilepath) const;
+        /// @brief Ids of all the assets of a class, e.g. to list them in a picker
+        const std::unordered_set<UUID> &GetAssetsOfClass(const std::string &inClassName) const;
+        /// @brief Follows a file or a directory that was moved or renamed on disk, the assets in it keep their ids
+        void MovePath(const std::filesystem::path &inOldPath, const std::filesystem::path &inNewPath);
 
         template <IsAsset T>
         std::shared_ptr<T> LoadAssetAs(UUID inUUID)
@@ -95,19 +170,48 @@ namespace ZenEngine
 
         const char *GetAssetClassByName(const std::string &inName) const { return mAssetClasses.at(inName); }
         bool SaveAsset(const std::shared_ptr<Asset> &inAssetInstance, const std::filesystem::path &inFilepath);
+        /// @brief Saves a changed asset over its file, see AssetLoader::Overwrite. Assets read from a pak can not be saved
+        bool OverwriteAsset(const std::shared_ptr<Asset> &inAssetInstance);
+        /// @brief Saves an asset made at runtime, e.g. baked data, and adds it to the database.
+        /// The path is relative to the asset directory, returns the id of the asset or nothing if it could not be saved
+        std::optional<UUID> CreateAsset(const std::shared_ptr<Asset> &inAssetInstance, const std::filesystem::path &inFilepath);
     private:
         std::unordered_map<std::string, const char *> mAssetClasses;
         std::unordered_map<const char *, AssetLoader *> mAssetLoaders;
         std::vector<std::unique_ptr<AssetImporter>> mImporters;
 
         std::unordered_map<UUID, AssetInfo> mAssetDatabase;
+        // lookups into the database, by normalized path and by class
+        std::unordered_map<std::string, UUID> mAssetPaths;
+        std::unordered_map<std::string, std::unordered_set<UUID>> mAssetsByClass;
         std::unordered_map<UUID, std::weak_ptr<Asset>> mAssetCache;
+        std::vector<std::shared_ptr<const PakArchive>> mPaks;
 
         static std::unique_ptr<AssetManager> sAssetManagerInstance;
+
+        static constexpr uint32_t LoaderThreadCount = 2;
+        // main thread only, the requests that are queued or being read
+        std::unordered_map<UUID, std::shared_ptr<AssetRequest>> mPendingLoads;
+        std::unordered_map<std::string, UUID> mPlaceholderIds;
+        std::unordered_map<std::string, std::shared_ptr<Asset>> mPlaceholders;
+
+        std::vector<std::thread> mLoaderThreads;
+        std::mutex mLoadMutex;
+        std::condition_variable mLoadCondition;
+        // one queue per priority, a request whose priority is raised is queued again and skipped the second time
+        std::array<std::deque<std::shared_ptr<AssetRequest>>, 3> mLoadQueues;
+        std::vector<std::shared_ptr<AssetRequest>> mFinishedLoads;
+        bool mStopLoading = false;
     
         void RegisterCoreAssets();
         void ImportDefaultAssets();
-
-        void BuildAssetDatabaseFrom(const std::filesystem::path &inImportFolder);
+        void RunLoaderThread();
+        std::shared_ptr<Asset> GetPlaceholder(const char *inAssetClassName);
+
+        void AddToDatabase(const AssetInfo &inAsset);
+        void AddPakToDatabase(const std::shared_ptr<const PakArchive> &inPak);
+        void RemoveFromDatabase(UUID inUUID);
+        void ClearDatabase();
+        static std::string NormalizePath(const std::filesystem::path &inFilepath);
     };
 }
\ No newline at end of file
@@ -0,0 +1,126 @@
+#include "BlobLoader.h"
+
+#include <cstring>
+#include <fstream>
+
+#include "ZenEngine/Core/Filesystem.h"
+#include "ZenEngine/Core/Macros.h"
+
+namespace ZenEngine
+{
+    static uint64_t AlignOffset(uint64_t inOffset)
+    {
+        return (inOffset + BlobFile::Alignment - 1) & ~(BlobFile::Alignment - 1);
+    }
+
+    static bool IsHeaderValid(const BlobFile::Header &inHeader)
+    {
+        return inHeader.Magic == BlobFile::Magic && inHeader.Version == BlobFile::Version
+            && inHeader.ClassName[BlobFile::MaxClassNameLength] == '\0';
+    }
+
+    std::optional<BlobFile::Header> BlobFile::ReadHeader(const std::filesystem::path &inFilepath)
+    {
+        std::ifstream ifs(inFilepath, std::ios::binary);
+        Header header;
+        if (!ifs.read(reinterpret_cast<char*>(&header), sizeof(Header))) return std::nullopt;
+        if (!IsHeaderValid(header)) return std::nullopt;
+        return header;
+    }
+
+    bool BlobFile::IsBlobFile(std::span<const uint8_t> inData)
+    {
+        if (inData.size() < sizeof(Header)) return false;
+        Header header;
+        std::memcpy(&header, inData.data(), sizeof(Header));
+        return IsHeaderValid(header);
+    }
+
+    bool BlobFile::Open(const std::filesystem::path &inFilepath)
+    {
+        auto file = std::make_shared<Filesystem::MappedFile>();
+        if (!file->Open(inFilepath)) return false;
+        if (!Open({ file->GetData(), static_cast<size_t>(file->GetSize()) }, file))
+        {
+            ZE_CORE_ERROR("{} is not a valid blob file of version {}", inFilepath.string(), Version);
+            return false;
+        }
+        return true;
+    }
+
+    bool BlobFile::Open(std::span<const uint8_t> inData, std::shared_ptr<const void> inOwner)
+    {
+        mData = {};
+        mOwner = nullptr;
+        mHeader = nullptr;
+        mBlobs = nullptr;
+        if (!IsBlobFile(inData)) return false;
+
+        const auto *header = reinterpret_cast<const Header*>(inData.data());
+        const auto *blobs = reinterpret_cast<const BlobEntry*>(inData.data() + sizeof(Header));
+        uint64_t size = inData.size();
+        uint64_t tableEnd = sizeof(Header) + static_cast<uint64_t>(header->BlobCount) * sizeof(BlobEntry);
+        bool valid = header->BlobCount > 0 && tableEnd <= size;
+        for (uint32_t i = 0; valid && i < header->BlobCount; ++i)
+        {
+            const auto &blob = blobs[i];
+            valid = blob.Offset % Alignment == 0 && blob.Offset >= tableEnd && blob.Offset <= size && blob.Size <= size - blob.Offset;
+        }
+        if (!valid) return false;
+
+        mData = inData;
+        mOwner = std::move(inOwner);
+        mHeader = header;
+        mBlobs = blobs;
+        return true;
+    }
+
+    std::span<const uint8_t> BlobFile::GetBlob(uint32_t inIndex) const
+    {
+        ZE_ASSERT_CORE_MSG(inIndex < GetBlobCount(), "Blob index out of range!");
+        const auto &blob = mBlobs[inIndex];
+        return mData.subspan(static_cast<size_t>(blob.Offset), static_cast<size_t>(blob.Size));
+    }
+
+    void BlobWriter::Add(const void *inData, uint64_t inSize)
+    {
+        const auto *bytes = static_cast<const uint8_t*>(inData);
+        mBlobs.emplace_back(bytes, bytes + inSize);
+    }
+
+    bool BlobWriter::Write(const std::filesystem::path &inFilepath, UUID inId, const char *inClassName) const
+    {
+        BlobFile::Header header;
+        std::memset(&header, 0, sizeof(BlobFile::Header));
+        header.Magic = BlobFile::Magic;
+        header.Version = BlobFile::Version;
+        header.Id = inId;
+        ZE_ASSERT_CORE_MSG(std::strlen(inClassName) <= BlobFile::MaxClassNameLength, "Asset class name too long for a blob file!");
+        std::strncpy(header.ClassName, inClassName, BlobFile::MaxClassNameLength);
+        header.BlobCount = static_cast<uint32_t>(mBlobs.size());
+
+        std::vector<BlobFile::BlobEntry> table(mBlobs.size());
+        uint64_t offset = AlignOffset(sizeof(BlobFile::Header) + table.size() * sizeof(BlobFile::BlobEntry));
+        for (size_t i = 0; i < mBlobs.size(); ++i)
+        {
+            table[i] = { offset, mBlobs[i].size() };
+            offset = AlignOffset(offset + mBlobs[i].size());
+        }
+
+        std::ofstream ofs(inFilepath, std::ios::binary);
+        if (!ofs.is_open())
+        {
+            ZE_CORE_ERROR("Cannot write {}", inFilepath.string());
+            return false;
+        }
+        ofs.write(reinterpret_cast<const char*>(&header), sizeof(BlobFile::Header));
+        ofs.write(reinterpret_cast<const char*>(table.data()), table.size() * sizeof(BlobFile::BlobEntry));
+        const char padding[BlobFile::Alignment] = {};
+        for (size_t i = 0; i < mBlobs.size(); ++i)
+        {
+            ofs.write(padding, table[i].Offset - static_cast<uint64_t>(ofs.tellp()));
+            ofs.write(reinterpret_cast<const char*>(mBlobs[i].data()), mBlobs[i].size());
+        }
+        return ofs.good();
+    }
+}
@@ -0,0 +1,218 @@
+#pragma once
+
+#include <filesystem>
+#include <istream>
+#include <optional>
+#include <span>
+#include <sstream>
+#include <stdexcept>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+#include "AssetLoader.h"
+#include "Serialization.h"
+#include "UUID.h"
+#include "ZenEngine/Core/Log.h"
+
+namespace ZenEngine
+{
+    /// @brief Runtime layout of the assets whose bulk data is uploaded as it is stored: a fixed header, a table of
+    /// blobs and the blobs, each aligned so it can be used in place from the mapped file. The first blob is a cereal
+    /// archive of the rest of the asset, the properties and settings the editor works with
+    class BlobFile
+    {
+    public:
+        // "ZEBL" read as a little endian integer
+        static constexpr uint32_t Magic = 0x4c42455a;
+        static constexpr uint32_t Version = 1;
+        static constexpr uint64_t Alignment = 64;
+        static constexpr uint32_t MaxClassNameLength = 63;
+
+        struct Header
+        {
+            uint32_t Magic;
+            uint32_t Version;
+            uint64_t Id;
+            char ClassName[MaxClassNameLength + 1];
+            uint32_t BlobCount;
+            uint32_t Reserved;
+        };
+
+        // the offset is from the start of the file
+        struct BlobEntry
+        {
+            uint64_t Offset;
+            uint64_t Size;
+        };
+
+        /// @brief Reads only the header, nothing if the file is not a blob file of this version
+        static std::optional<Header> ReadHeader(const std::filesystem::path &inFilepath);
+
+        /// @brief Maps the file and checks that every blob is within it
+        bool Open(const std::filesystem::path &inFilepath);
+        /// @brief Reads the blobs where the file already is in memory, inOwner keeps it there
+        bool Open(std::span<const uint8_t> inData, std::shared_ptr<const void> inOwner);
+        static bool IsBlobFile(std::span<const uint8_t> inData);
+
+        UUID GetId() const { return mHeader->Id; }
+        const char *GetClassName() const { return mHeader->ClassName; }
+        uint32_t GetBlobCount() const { return mHeader->BlobCount; }
+        std::span<const uint8_t> GetBlob(uint32_t inIndex) const;
+
+        /// @brief The blob as an array of T, bytes past the last whole element are left out
+        template <typename T>
+        std::span<const T> GetBlobAs(uint32_t inIndex) const
+        {
+            auto blob = GetBlob(inIndex);
+            return { reinterpret_cast<const T*>(blob.data()), blob.size() / sizeof(T) };
+        }
+    private:
+        std::span<const uint8_t> mData;
+        std::shared_ptr<const void> mOwner;
+        const Header *mHeader = nullptr;
+        const BlobEntry *mBlobs = nullptr;
+    };
+
+    class BlobWriter
+    {
+    public:
+        void Add(const void *inData, uint64_t inSize);
+        void Add(std::span<const uint8_t> inData) { Add(inData.data(), inData.size()); }
+
+        template <typename T>
+        void Add(const std::vector<T> &inData)
+        {
+            Add(inData.data(), inData.size() * sizeof(T));
+        }
+
+        bool Write(const std::filesystem::path &inFilepath, UUID inId, const char *inClassName) const;
+    private:
+        std::vector<std::vector<uint8_t>> mBlobs;
+    };
+
+    // lets cereal read in place from memory, e.g. the metadata blob where it is mapped
+    class BlobStreamBuffer : public std::streambuf
+    {
+    public:
+        BlobStreamBuffer(std::span<const uint8_t> inData)
+        {
+            char *data = reinterpret_cast<char*>(const_cast<uint8_t*>(inData.data()));
+            setg(data, data, data + inData.size());
+        }
+    };
+
+    /// @brief Saves and loads an asset class as a BlobFile. The class provides SaveMetadata and LoadMetadata for its
+    /// cereal part, SaveBlobs to add the rest to a BlobWriter and LoadBlobs to take it from the mapped file.
+    /// Detach copies what it uses in place out of the file, before the file is replaced.
+    /// Files saved by the BinaryLoader before the class moved to blobs are still loaded by it.
+    /// Not constrained to IsAsset, the classes name it while they are still incomplete
+    template <typename AssetClass>
+    class BlobLoader : public AssetLoader
+    {
+    public:
+        static const char *GetStaticName() { return "ZenEngine::BlobLoader"; }
+        virtual const char *GetName() const override { return GetStaticName(); }
+        static AssetLoader *Get()
+        {
+            static std::unique_ptr<AssetLoader> instance;
+            if (instance == nullptr) { instance = std::make_unique<BlobLoader<AssetClass>>(); sAllLoaders.push_back(instance.get()); }
+            return instance.get();
+        }
+
+        virtual bool Save(const std::shared_ptr<Asset> &inAssetInstance, const std::filesystem::path &inFilepath) const override
+        {
+            if (std::filesystem::exists(inFilepath))
+            {
+                ZE_CORE_ERROR("{} already exists!", inFilepath);
+                return false;
+            }
+            auto &asset = static_cast<AssetClass&>(*inAssetInstance);
+            std::ostringstream metadata(std::ios::binary);
+            {
+                cereal::BinaryOutputArchive archive(metadata);
+                asset.SaveMetadata(archive);
+            }
+            BlobWriter writer;
+            std::string bytes = metadata.str();
+            writer.Add(bytes.data(), bytes.size());
+            asset.SaveBlobs(writer);
+            return writer.Write(inFilepath, asset.GetAssetId(), AssetClass::GetStaticAssetClassName());
+        }
+
+        virtual std::shared_ptr<Asset> Load(const std::filesystem::path &inFilepath) const override
+        {
+            if (!BlobFile::ReadHeader(inFilepath).has_value()) return BinaryLoader::Get()->Load(inFilepath);
+
+            auto file = std::make_shared<BlobFile>();
+            if (!file->Open(inFilepath)) return nullptr;
+            return LoadFrom(file, inFilepath);
+        }
+
+        virtual std::shared_ptr<Asset> LoadPacked(const PackedAsset &inPacked) const override
+        {
+            if (!BlobFile::IsBlobFile(inPacked.Data)) return BinaryLoader::Get()->LoadPacked(inPacked);
+
+            auto file = std::make_shared<BlobFile>();
+            if (!file->Open(inPacked.Data, inPacked.Owner)) return nullptr;
+            return LoadFrom(file, inPacked.Filepath);
+        }
+
+        virtual bool CanLoad(const std::filesystem::path &inFilepath) const override
+        {
+            if (inFilepath.extension().string() != ".zasset") return false;
+            auto header = BlobFile::ReadHeader(inFilepath);
+            return header.has_value() && std::string(header->ClassName) == AssetClass::GetStaticAssetClassName();
+        }
+
+        virtual std::pair<UUID, const char*> GetAssetIdAssetClass(const std::filesystem::path &inFilepath) const override
+        {
+            auto header = BlobFile::ReadHeader(inFilepath);
+            if (!header.has_value()) throw std::runtime_error("Not a blob file");
+            return { header->Id, AssetManager::Get().GetAssetClassByName(header->ClassName) };
+        }
+    protected:
+        virtual void Release(Asset &ioAssetInstance) const override
+        {
+            static_cast<AssetClass&>(ioAssetInstance).Detach();
+        }
+
+        virtual bool Reload(Asset &ioAssetInstance, const std::filesystem::path &inFilepath) const override
+        {
+            // the same instance reads from the new file, whoever holds it keeps it
+            auto file = std::make_shared<BlobFile>();
+            if (!file->Open(inFilepath) || !static_cast<AssetClass&>(ioAssetInstance).LoadBlobs(file))
+            {
+                ZE_CORE_ERROR("Could not read {} back after saving it", inFilepath.string());
+                return false;
+            }
+            return true;
+        }
+    private:
+        std::shared_ptr<Asset> LoadFrom(const std::shared_ptr<BlobFile> &inFile, const std::filesystem::path &inFilepath) const
+        {
+            auto asset = std::make_shared<AssetClass>();
+            try
+            {
+                BlobStreamBuffer buffer(inFile->GetBlob(0));
+                std::istream stream(&buffer);
+                cereal::BinaryInputArchive archive(stream);
+                asset->LoadMetadata(archive);
+            }
+            catch (const std::exception &e)
+            {
+                // a misread size throws something else than cereal's own exception
+                ZE_CORE_ERROR("Could not load {}: {}", inFilepath.string(), e.what());
+                return nullptr;
+            }
+            if (!asset->LoadBlobs(inFile))
+            {
+                ZE_CORE_ERROR("The blobs of {} do not match what a {} needs", inFilepath.string(), AssetClass::GetStaticAssetClassName());
+                return nullptr;
+            }
+            std::shared_ptr<Asset> assetInstance = asset;
+            SetId(assetInstance, inFile->GetId());
+            return assetInstance;
+        }
+    };
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include "Asset.h"
+
+#include "Serialization.h"
+#include "StaticMesh.h"
+#include "ZenEngine/Core/Math.h"
+
+namespace ZenEngine
+{
+    /// @brief Output of HLODBuilder: one simplified proxy mesh per cell and material of static meshes, already in world
+    /// space. The members of a proxy are found again at load time from the cell their bounds fall in and the key of
+    /// their material, so the asset does not depend on entity identities
+    class HLODAsset : public Asset
+    {
+    public:
+        IMPLEMENT_ASSET_CLASS(ZenEngine::HLODAsset)
+        using Loader = BinaryLoader;
+
+        // "ZEHL" read as a little endian integer, in front of the saved bake
+        static constexpr uint32_t Magic = 0x4c48455a;
+        // bumped whenever the saved layout changes, older bakes are rejected rather than misread
+        static constexpr uint32_t Version = 1;
+
+        struct Cluster
+        {
+            glm::ivec3 Cell;
+            // see HLODBuilder::GetMaterialKey, the members all draw with the same material
+            uint64_t MaterialKey = 0;
+            Math::BoundingBox Bounds;
+            std::vector<Vertex> Vertices;
+            std::vector<uint32_t> Indices;
+            // triangles of the meshes the proxy replaces
+            uint32_t SourceTriangles = 0;
+
+            template<typename Archive>
+            void Serialize(Archive &inArchive)
+            {
+                inArchive(Cell.x, Cell.y, Cell.z, MaterialKey, Bounds.Min, Bounds.Max, Vertices, Indices, SourceTriangles);
+            }
+        };
+
+        // side of the cubic cells the meshes are grouped by
+        float CellSize = 64.0f;
+        // distance from the eye to a cell beyond which the proxy is drawn in place of its members
+        float SwitchDistance = 150.0f;
+        std::vector<Cluster> Clusters;
+
+        /// @brief Cell holding the center of a world space box
+        glm::ivec3 GetCell(const Math::BoundingBox &inBounds) const { return glm::ivec3(glm::floor(inBounds.GetCenter() / CellSize)); }
+    private:
+        template<typename Archive>
+        void Save(Archive &outArchive) const
+        {
+            outArchive(Magic, Version, CellSize, SwitchDistance, Clusters);
+        }
+
+        template<typename Archive>
+        void Load(Archive &inArchive)
+        {
+            uint32_t magic = 0;
+            uint32_t version = 0;
+            inArchive(magic, version);
+            if (magic != Magic || version != Version)
+                throw cereal::Exception("The HLOD was baked by an older version of the engine, bake it again");
+            inArchive(CellSize, SwitchDistance, Clusters);
+        }
+
+        friend class cereal::access;
+    };
+}
+
+CEREAL_REGISTER_TYPE(ZenEngine::HLODAsset);
+CEREAL_REGISTER_POLYMORPHIC_RELATION(ZenEngine::Asset, ZenEngine::HLODAsset)
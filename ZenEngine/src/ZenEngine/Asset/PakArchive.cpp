@@ -0,0 +1,284 @@
+#include "PakArchive.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <unordered_map>
+
+#include "ZenEngine/Core/JobSystem.h"
+#include "ZenEngine/Core/LZCompression.h"
+#include "ZenEngine/Core/Log.h"
+
+namespace ZenEngine
+{
+    // a file is only compressed when that saves at least an eighth of it, otherwise it is cheaper to map it as it is
+    static constexpr uint64_t MinSavingsDivisor = 8;
+
+    static uint64_t AlignOffset(uint64_t inOffset)
+    {
+        return (inOffset + PakArchive::Alignment - 1) & ~(PakArchive::Alignment - 1);
+    }
+
+    static uint32_t GetBlockCount(uint64_t inSize)
+    {
+        return static_cast<uint32_t>((inSize + PakArchive::BlockSize - 1) / PakArchive::BlockSize);
+    }
+
+    bool PakArchive::Open(const std::filesystem::path &inFilepath)
+    {
+        mFile = std::make_shared<Filesystem::MappedFile>();
+        if (!mFile->Open(inFilepath)) return false;
+        const uint8_t *data = mFile->GetData();
+        uint64_t size = mFile->GetSize();
+
+        mHeader = reinterpret_cast<const Header*>(data);
+        bool valid = size >= sizeof(Header) && mHeader->Magic == Magic && mHeader->Version == Version;
+        valid = valid && mHeader->EntriesOffset % Alignment == 0 && mHeader->EntriesOffset <= size
+            && static_cast<uint64_t>(mHeader->EntryCount) * sizeof(Entry) <= size - mHeader->EntriesOffset;
+        valid = valid && mHeader->BlocksOffset % Alignment == 0 && mHeader->BlocksOffset <= size
+            && static_cast<uint64_t>(mHeader->BlockCount) * sizeof(Block) <= size - mHeader->BlocksOffset;
+        valid = valid && mHeader->StringsOffset <= size && mHeader->StringsSize <= size - mHeader->StringsOffset
+            && mHeader->StringsSize > 0 && data[mHeader->StringsOffset + mHeader->StringsSize - 1] == '\0';
+        if (!valid)
+        {
+            ZE_CORE_ERROR("{} is not a pak of version {}", inFilepath.string(), Version);
+            mFile = nullptr;
+            return false;
+        }
+        mEntries = reinterpret_cast<const Entry*>(data + mHeader->EntriesOffset);
+        mBlocks = reinterpret_cast<const Block*>(data + mHeader->BlocksOffset);
+        mStrings = reinterpret_cast<const char*>(data + mHeader->StringsOffset);
+
+        for (uint32_t i = 0; valid && i < mHeader->BlockCount; ++i)
+        {
+            const auto &block = mBlocks[i];
+            valid = block.Offset <= size && block.StoredSize <= size - block.Offset;
+        }
+        for (uint32_t i = 0; valid && i < mHeader->EntryCount; ++i)
+        {
+            const auto &entry = mEntries[i];
+            valid = (i == 0 || mEntries[i - 1].Id < entry.Id)
+                && entry.BlockCount == GetBlockCount(entry.Size)
+                && entry.FirstBlock <= mHeader->BlockCount && entry.BlockCount <= mHeader->BlockCount - entry.FirstBlock
+                && entry.ClassNameOffset < mHeader->StringsSize && entry.PathOffset < mHeader->StringsSize;
+            // read in place, all of it must be in the pak
+            if (valid && entry.BlockCount > 0 && !IsCompressed(entry))
+                valid = entry.Size <= size - mBlocks[entry.FirstBlock].Offset;
+        }
+        if (!valid)
+        {
+            ZE_CORE_ERROR("The table of contents of {} is corrupted", inFilepath.string());
+            mFile = nullptr;
+            return false;
+        }
+        ZE_CORE_INFO("Mounted {} with {} assets", inFilepath.string(), mHeader->EntryCount);
+        return true;
+    }
+
+    const PakArchive::Entry *PakArchive::Find(UUID inId) const
+    {
+        const Entry *end = mEntries + mHeader->EntryCount;
+        const Entry *entry = std::lower_bound(mEntries, end, static_cast<uint64_t>(inId), [](const Entry &inEntry, uint64_t inValue) { return inEntry.Id < inValue; });
+        return entry != end && entry->Id == static_cast<uint64_t>(inId) ? entry : nullptr;
+    }
+
+    uint64_t PakArchive::GetStoredSize(const Entry &inEntry) const
+    {
+        uint64_t size = 0;
+        for (uint32_t i = 0; i < inEntry.BlockCount; ++i)
+            size += mBlocks[inEntry.FirstBlock + i].StoredSize;
+        return size;
+    }
+
+    bool PakArchive::IsCompressed(const Entry &inEntry) const
+    {
+        for (uint32_t i = 0; i < inEntry.BlockCount; ++i)
+            if (mBlocks[inEntry.FirstBlock + i].Compressed != 0) return true;
+        return false;
+    }
+
+    PackedAsset PakArchive::Read(const Entry &inEntry) const
+    {
+        PackedAsset packed;
+        packed.Id = inEntry.Id;
+        packed.Filepath = GetPath(inEntry);
+
+        // the blocks of a file stored as it is follow each other, it is all in place
+        if (!IsCompressed(inEntry))
+        {
+            const uint8_t *data = inEntry.BlockCount > 0 ? mFile->GetData() + mBlocks[inEntry.FirstBlock].Offset : mFile->GetData();
+            packed.Data = { data, static_cast<size_t>(inEntry.Size) };
+            packed.Owner = mFile;
+            return packed;
+        }
+
+        auto buffer = std::make_shared<std::vector<uint8_t>>(static_cast<size_t>(inEntry.Size));
+        for (uint32_t i = 0; i < inEntry.BlockCount; ++i)
+        {
+            const auto &block = mBlocks[inEntry.FirstBlock + i];
+            std::span<const uint8_t> stored(mFile->GetData() + block.Offset, block.StoredSize);
+            uint64_t offset = static_cast<uint64_t>(i) * BlockSize;
+            std::span<uint8_t> destination(buffer->data() + offset, static_cast<size_t>(std::min<uint64_t>(BlockSize, inEntry.Size - offset)));
+            if (block.Compressed == 0)
+            {
+                if (stored.size() != destination.size()) return packed;
+                std::memcpy(destination.data(), stored.data(), stored.size());
+            }
+            else if (!LZCompression::Decompress(stored, destination))
+            {
+                return packed;
+            }
+        }
+        packed.Data = *buffer;
+        packed.Owner = buffer;
+        return packed;
+    }
+
+    void PakWriter::Add(UUID inId, const std::string &inClassName, const std::filesystem::path &inFilepath)
+    {
+        mSources.push_back({ inId, inClassName, inFilepath });
+    }
+
+    bool PakWriter::Write(const std::filesystem::path &inFilepath, bool inCompress) const
+    {
+        std::vector<Source> sources = mSources;
+        std::sort(sources.begin(), sources.end(), [](const Source &inA, const Source &inB) { return static_cast<uint64_t>(inA.Id) < static_cast<uint64_t>(inB.Id); });
+        auto duplicate = std::unique(sources.begin(), sources.end(), [](const Source &inA, const Source &inB) { return static_cast<uint64_t>(inA.Id) == static_cast<uint64_t>(inB.Id); });
+        if (duplicate != sources.end())
+        {
+            ZE_CORE_WARN("{} assets share their id with another, only one of each is packed", sources.end() - duplicate);
+            sources.erase(duplicate, sources.end());
+        }
+
+        struct Packed
+        {
+            bool Valid = false;
+            uint64_t Size = 0;
+            std::vector<std::vector<uint8_t>> Blocks;
+            std::vector<bool> Compressed;
+        };
+        std::vector<Packed> packed(sources.size());
+        JobSystem::Get().ParallelFor(static_cast<uint32_t>(sources.size()), 1, [&](uint32_t inBegin, uint32_t inEnd)
+        {
+            for (uint32_t i = inBegin; i < inEnd; ++i)
+            {
+                auto &result = packed[i];
+                Filesystem::MappedFile file;
+                if (!file.Open(sources[i].Filepath)) continue;
+                result.Valid = true;
+                result.Size = file.GetSize();
+                uint32_t blockCount = GetBlockCount(result.Size);
+
+                uint64_t compressedSize = 0;
+                for (uint32_t block = 0; block < blockCount; ++block)
+                {
+                    uint64_t offset = static_cast<uint64_t>(block) * PakArchive::BlockSize;
+                    std::span<const uint8_t> data(file.GetData() + offset, static_cast<size_t>(std::min<uint64_t>(PakArchive::BlockSize, result.Size - offset)));
+                    auto compressed = inCompress ? LZCompression::Compress(data) : std::vector<uint8_t>();
+                    bool smaller = inCompress && compressed.size() < data.size();
+                    result.Blocks.push_back(smaller ? std::move(compressed) : std::vector<uint8_t>(data.begin(), data.end()));
+                    result.Compressed.push_back(smaller);
+                    compressedSize += result.Blocks.back().size();
+                }
+
+                if (compressedSize + result.Size / MinSavingsDivisor > result.Size)
+                {
+                    for (uint32_t block = 0; block < blockCount; ++block)
+                    {
+                        if (!result.Compressed[block]) continue;
+                        uint64_t offset = static_cast<uint64_t>(block) * PakArchive::BlockSize;
+                        result.Blocks[block].assign(file.GetData() + offset, file.GetData() + offset + std::min<uint64_t>(PakArchive::BlockSize, result.Size - offset));
+                        result.Compressed[block] = false;
+                    }
+                }
+            }
+        });
+
+        // written next to it and then moved over it, the pak being replaced may still be mounted
+        std::filesystem::path temporary = inFilepath;
+        temporary += ".tmp";
+        std::ofstream ofs(temporary, std::ios::binary);
+        if (!ofs.is_open())
+        {
+            ZE_CORE_ERROR("Cannot write {}", temporary.string());
+            return false;
+        }
+        const char padding[PakArchive::Alignment] = {};
+        auto pad = [&]()
+        {
+            uint64_t position = static_cast<uint64_t>(ofs.tellp());
+            ofs.write(padding, AlignOffset(position) - position);
+        };
+
+        PakArchive::Header header;
+        std::memset(&header, 0, sizeof(PakArchive::Header));
+        ofs.write(reinterpret_cast<const char*>(&header), sizeof(PakArchive::Header));
+
+        std::vector<PakArchive::Entry> entries;
+        std::vector<PakArchive::Block> blocks;
+        std::string strings;
+        std::unordered_map<std::string, uint32_t> classNames;
+        uint64_t originalSize = 0;
+        for (size_t i = 0; i < sources.size(); ++i)
+        {
+            if (!packed[i].Valid)
+            {
+                ZE_CORE_WARN("Could not read {}, it is left out of the pak", sources[i].Filepath.string());
+                continue;
+            }
+            PakArchive::Entry entry;
+            std::memset(&entry, 0, sizeof(PakArchive::Entry));
+            entry.Id = sources[i].Id;
+            entry.Size = packed[i].Size;
+            entry.FirstBlock = static_cast<uint32_t>(blocks.size());
+            entry.BlockCount = static_cast<uint32_t>(packed[i].Blocks.size());
+
+            auto [className, inserted] = classNames.try_emplace(sources[i].ClassName, static_cast<uint32_t>(strings.size()));
+            if (inserted) strings.append(sources[i].ClassName).push_back('\0');
+            entry.ClassNameOffset = className->second;
+            entry.PathOffset = static_cast<uint32_t>(strings.size());
+            strings.append(sources[i].Filepath.generic_string()).push_back('\0');
+
+            // the start of every file is aligned, the blocks follow each other
+            pad();
+            for (size_t block = 0; block < packed[i].Blocks.size(); ++block)
+            {
+                const auto &data = packed[i].Blocks[block];
+                blocks.push_back({ static_cast<uint64_t>(ofs.tellp()), static_cast<uint32_t>(data.size()), packed[i].Compressed[block] ? 1u : 0u });
+                ofs.write(reinterpret_cast<const char*>(data.data()), data.size());
+            }
+            entries.push_back(entry);
+            originalSize += entry.Size;
+        }
+
+        pad();
+        header.EntriesOffset = static_cast<uint64_t>(ofs.tellp());
+        ofs.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(PakArchive::Entry));
+        pad();
+        header.BlocksOffset = static_cast<uint64_t>(ofs.tellp());
+        ofs.write(reinterpret_cast<const char*>(blocks.data()), blocks.size() * sizeof(PakArchive::Block));
+        // never empty, so the table always ends with a zero
+        strings.push_back('\0');
+        header.StringsOffset = static_cast<uint64_t>(ofs.tellp());
+        header.StringsSize = strings.size();
+        ofs.write(strings.data(), strings.size());
+        uint64_t pakSize = static_cast<uint64_t>(ofs.tellp());
+
+        header.Magic = PakArchive::Magic;
+        header.Version = PakArchive::Version;
+        header.EntryCount = static_cast<uint32_t>(entries.size());
+        header.BlockCount = static_cast<uint32_t>(blocks.size());
+        ofs.seekp(0);
+        ofs.write(reinterpret_cast<const char*>(&header), sizeof(PakArchive::Header));
+        ofs.close();
+        std::error_code error;
+        if (ofs.fail() || (std::filesystem::rename(temporary, inFilepath, error), error))
+        {
+            ZE_CORE_ERROR("Could not write {}", inFilepath.string());
+            std::filesystem::remove(temporary, error);
+            return false;
+        }
+        ZE_CORE_INFO("Packed {} assets, {} bytes into {} bytes", entries.size(), originalSize, pakSize);
+        return true;
+    }
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "AssetLoader.h"
+#include "UUID.h"
+#include "ZenEngine/Core/Filesystem.h"
+
+namespace ZenEngine
+{
+    /// @brief Many asset files in one, so that a shipping build opens a single file rather than one or two per asset.
+    /// The table of contents is sorted by id and searched where the pak is mapped. Each file is split in blocks that are
+    /// compressed on their own with LZCompression, a file that does not compress well is stored as it is and aligned,
+    /// so it is used in place like a file of its own
+    class PakArchive
+    {
+    public:
+        // "ZPAK" read as a little endian integer
+        static constexpr uint32_t Magic = 0x4b41505a;
+        static constexpr uint32_t Version = 1;
+        static constexpr uint32_t BlockSize = 64 * 1024;
+        static constexpr uint64_t Alignment = 64;
+
+        struct Header
+        {
+            uint32_t Magic;
+            uint32_t Version;
+            uint32_t EntryCount;
+            uint32_t BlockCount;
+            uint64_t EntriesOffset;
+            uint64_t BlocksOffset;
+            uint64_t StringsOffset;
+            uint64_t StringsSize;
+        };
+
+        struct Entry
+        {
+            uint64_t Id;
+            // bytes of the file once it is decompressed
+            uint64_t Size;
+            uint32_t FirstBlock;
+            uint32_t BlockCount;
+            // into the string table, both end with a zero
+            uint32_t ClassNameOffset;
+            uint32_t PathOffset;
+        };
+
+        struct Block
+        {
+            uint64_t Offset;
+            uint32_t StoredSize;
+            // zero when the block is stored as it is
+            uint32_t Compressed;
+        };
+
+        /// @brief Maps the pak and checks that the tables are within it
+        bool Open(const std::filesystem::path &inFilepath);
+
+        uint32_t GetEntryCount() const { return mHeader->EntryCount; }
+        const Entry &GetEntry(uint32_t inIndex) const { return mEntries[inIndex]; }
+        /// @brief Binary search of the table of contents, nullptr if the asset is not in the pak
+        const Entry *Find(UUID inId) const;
+        const char *GetClassName(const Entry &inEntry) const { return mStrings + inEntry.ClassNameOffset; }
+        const char *GetPath(const Entry &inEntry) const { return mStrings + inEntry.PathOffset; }
+
+        /// @brief Bytes the file takes in the pak
+        uint64_t GetStoredSize(const Entry &inEntry) const;
+        bool IsCompressed(const Entry &inEntry) const;
+        /// @brief The file, in place when it is stored as it is and decompressed otherwise. Without an owner if a block is corrupted
+        PackedAsset Read(const Entry &inEntry) const;
+    private:
+        std::shared_ptr<Filesystem::MappedFile> mFile;
+        const Header *mHeader = nullptr;
+        const Entry *mEntries = nullptr;
+        const Block *mBlocks = nullptr;
+        const char *mStrings = nullptr;
+    };
+
+    class PakWriter
+    {
+    public:
+        /// @brief The file is only read when the pak is written
+        void Add(UUID inId, const std::string &inClassName, const std::filesystem::path &inFilepath);
+        /// @brief The files are compressed in parallel on the job system, without inCompress they are all stored as they are
+        bool Write(const std::filesystem::path &inFilepath, bool inCompress) const;
+    private:
+        struct Source
+        {
+            UUID Id;
+            std::string ClassName;
+            std::filesystem::path Filepath;
+        };
+        std::vector<Source> mSources;
+    };
+}
@@ -2,14 +2,27 @@
 
 #include "ZenEngine/Core/Filesystem.h"
 #include "ZenEngine/ShaderCompiler/ShaderCompiler.h"
+#include "ZenEngine/Renderer/ResourceRegistry.h"
 
 namespace ZenEngine
 {
-    std::shared_ptr<Shader> ShaderAsset::CreateOrGetShaderProgram()
+    ShaderAsset::~ShaderAsset()
     {
-        if (mShaderProgram == nullptr || mTainted) 
+        ResourceRegistry::Get().Destroy(mShaderProgram);
+    }
+
+    ShaderHandle ShaderAsset::CreateOrGetShaderProgram()
+    {
+        if (mShaderProgram.IsNull())
+        {
+            mShaderProgram = ResourceRegistry::Get().Register(Shader::Create(mName, mSourceCode));
+            mTainted = false;
+        }
+        else if (mTainted)
         {
-            mShaderProgram = Shader::Create(mName, mSourceCode);
+            // materials holding the handle pick up the recompiled program, the revision tells them to reflect it again
+            ResourceRegistry::Get().Replace(mShaderProgram, Shader::Create(mName, mSourceCode));
+            ++mProgramRevision;
             mTainted = false;
         }
         return mShaderProgram;
@@ -17,7 +30,7 @@ namespace ZenEngine
 
     Shader::ShaderUniformInfo ShaderAsset::GetShaderUniforms()
     {
-        auto shader = CreateOrGetShaderProgram();
+        auto *shader = ResourceRegistry::Get().Resolve(CreateOrGetShaderProgram());
         return shader->GetShaderUniformInfo();
     }
     
@@ -41,6 +54,16 @@ namespace ZenEngine
         return asset;
     }
 
+    std::shared_ptr<Asset> ShaderLoader::LoadPacked(const PackedAsset &inPacked) const
+    {
+        std::shared_ptr<ShaderAsset> shader = std::make_unique<ShaderAsset>();
+        shader->SetName(inPacked.Filepath.stem().string());
+        shader->SetSourceCode(std::string(inPacked.Data.begin(), inPacked.Data.end()));
+        auto asset = std::static_pointer_cast<Asset>(shader);
+        SetId(asset, inPacked.Id);
+        return asset;
+    }
+
     bool ShaderLoader::CanLoad(const std::filesystem::path &inFilepath) const
     {
         return (inFilepath.extension().string() == ".zshader" || inFilepath.extension().string() == ".hlsl");
@@ -4,6 +4,7 @@
 #include "ZenEngine/Renderer/Shader.h"
 #include "ZenEngine/ShaderCompiler/ShaderReflector.h"
 #include "ZenEngine/Renderer/RendererAPI.h"
+#include "ZenEngine/Renderer/ResourceHandle.h"
 
 namespace ZenEngine
 {
@@ -15,9 +16,12 @@ namespace ZenEngine
         IMPLEMENT_ASSET_CLASS(ZenEngine::ShaderAsset)
         using Loader = ShaderLoader;
         ShaderAsset() = default;
+        virtual ~ShaderAsset();
 
-        std::shared_ptr<Shader> CreateOrGetShaderProgram();
+        ShaderHandle CreateOrGetShaderProgram();
         Shader::ShaderUniformInfo GetShaderUniforms();
+        /// @brief Changes every time a recompiled program is put behind the handle, whatever reflected the old one is stale
+        uint32_t GetProgramRevision() const { return mProgramRevision; }
     
         void SetName(const std::string &inName) { mName = inName; }
         void SetSourceCode(const std::string &inSource) { mSourceCode = inSource; mTainted = true; }
@@ -29,7 +33,8 @@ namespace ZenEngine
         std::string mSourceCode;
 
         bool mTainted = false;
-        std::shared_ptr<Shader> mShaderProgram;
+        ShaderHandle mShaderProgram;
+        uint32_t mProgramRevision = 0;
     };
 
     class ShaderLoader : public MetaLoader
@@ -39,6 +44,8 @@ namespace ZenEngine
 
         virtual bool Save(const std::shared_ptr<Asset> &inAssetInstance, const std::filesystem::path &inFilepath) const override;
         virtual std::shared_ptr<Asset> Load(const std::filesystem::path &inFilepath) const override;
+        /// @brief The source as it was in the file, the id comes from the pak rather than the meta file
+        virtual std::shared_ptr<Asset> LoadPacked(const PackedAsset &inPacked) const override;
         virtual bool CanLoad(const std::filesystem::path &inFilepath) const override;
     };
 }
\ No newline at end of file
@@ -1,36 +1,366 @@
 #include "StaticMesh.h"
 
+#include <algorithm>
+#include <functional>
+#include <numeric>
+
 #include "ZenEngine/Renderer/VertexBuffer.h"
 #include "ZenEngine/Renderer/IndexBuffer.h"
+#include "ZenEngine/Renderer/Renderer.h"
+#include "ZenEngine/Renderer/ResourceRegistry.h"
 
 #include "OBJ_Loader.h"
 
 namespace ZenEngine
 {
+    // normal and texture coordinate, the rest of a Vertex
+    static constexpr uint32_t AttributeFloats = 5;
 
-    std::shared_ptr<VertexArray> StaticMesh::CreateOrGetVertexArray()
+    static void SplitVertices(const std::vector<Vertex> &inVertices, std::vector<glm::vec3> &outPositions, std::vector<float> &outAttributes)
     {
-        if (mVertexArray == nullptr || mTainted)
+        outPositions.resize(inVertices.size());
+        outAttributes.resize(inVertices.size() * AttributeFloats);
+        for (size_t i = 0; i < inVertices.size(); ++i)
         {
-            BufferLayout layout{
-                { ShaderDataType::Float3, "Position" },
-                { ShaderDataType::Float3, "Normal" },
-                { ShaderDataType::Float2, "TexCoord" }
-            };
-            auto vb = VertexBuffer::Create((float*)mVertices.data(), mVertices.size() * sizeof(Vertex));
-            vb->SetLayout(layout);
+            outPositions[i] = inVertices[i].Position;
+            float *attribute = outAttributes.data() + i * AttributeFloats;
+            attribute[0] = inVertices[i].Normal.x;
+            attribute[1] = inVertices[i].Normal.y;
+            attribute[2] = inVertices[i].Normal.z;
+            attribute[3] = inVertices[i].TexCoord.x;
+            attribute[4] = inVertices[i].TexCoord.y;
+        }
+    }
 
-            auto ib = IndexBuffer::Create(mIndices.data(), mIndices.size());
+    VertexStreams VertexStreams::Create(const std::vector<Vertex> &inVertices)
+    {
+        std::vector<glm::vec3> positions;
+        std::vector<float> attributes;
+        SplitVertices(inVertices, positions, attributes);
+        return Create(positions, attributes);
+    }
 
-            mVertexArray = VertexArray::Create();
-            mVertexArray->AddVertexBuffer(vb);
-            mVertexArray->SetIndexBuffer(ib);
-            mTainted = false;
+    VertexStreams VertexStreams::Create(std::span<const glm::vec3> inPositions, std::span<const float> inAttributes)
+    {
+        VertexStreams streams;
+        streams.Positions = VertexBuffer::Create(reinterpret_cast<const float*>(inPositions.data()), static_cast<uint32_t>(inPositions.size_bytes()));
+        streams.Positions->SetLayout({ { ShaderDataType::Float3, "Position" } });
+        streams.Attributes = VertexBuffer::Create(inAttributes.data(), static_cast<uint32_t>(inAttributes.size_bytes()));
+        streams.Attributes->SetLayout({
+            { ShaderDataType::Float3, "Normal" },
+            { ShaderDataType::Float2, "TexCoord" }
+        });
+        return streams;
+    }
+
+    void VertexStreams::AddTo(VertexArray &ioVertexArray) const
+    {
+        ioVertexArray.AddPositionBuffer(Positions);
+        ioVertexArray.AddVertexBuffer(Attributes);
+    }
+
+    StaticMesh::~StaticMesh()
+    {
+        ResourceRegistry::Get().Destroy(mVertexArray);
+    }
+
+    VertexArrayHandle StaticMesh::CreateOrGetVertexArray()
+    {
+        if ((!mVertexArray.IsNull() || mUploading) && !mTainted) return mVertexArray;
+        mTainted = false;
+        mUploading = true;
+
+        struct Buffers
+        {
+            VertexStreams Vertices;
+            std::shared_ptr<IndexBuffer> Indices;
+        };
+        auto buffers = std::make_shared<Buffers>();
+        std::function<void()> load;
+        if (mBlobFile != nullptr)
+        {
+            // straight from the mapped file, which the loader keeps open until it is done
+            load = [buffers, file = mBlobFile, positions = mBlobPositions, attributes = mBlobAttributes, indices = mBlobIndices]()
+            {
+                buffers->Vertices = VertexStreams::Create(positions, attributes);
+                buffers->Indices = IndexBuffer::Create(indices.data(), static_cast<uint32_t>(indices.size()));
+            };
         }
+        else
+        {
+            // the data is copied, the asset may change or go away while the loader works on it
+            load = [buffers, vertices = mVertices, indices = mIndices]() mutable
+            {
+                buffers->Vertices = VertexStreams::Create(vertices);
+                buffers->Indices = IndexBuffer::Create(indices.data(), indices.size());
+            };
+        }
+        // vertex arrays are not shared between contexts, the main thread puts the buffers together
+        auto ready = [this, buffers, generation = std::weak_ptr<uint32_t>(mUploadGeneration), expected = ++*mUploadGeneration]()
+        {
+            auto current = generation.lock();
+            if (current == nullptr || *current != expected) return;
+            auto vertexArray = VertexArray::Create();
+            buffers->Vertices.AddTo(*vertexArray);
+            vertexArray->SetIndexBuffer(buffers->Indices);
+            if (mVertexArray.IsNull())
+                mVertexArray = ResourceRegistry::Get().Register(vertexArray);
+            else
+                ResourceRegistry::Get().Replace(mVertexArray, vertexArray);
+            mReady = true;
+            mUploading = false;
+        };
+        Renderer::Get().GetResourceLoader().Enqueue(std::move(load), std::move(ready));
 
         return mVertexArray;
     }
 
+    const std::vector<Vertex> &StaticMesh::GetVertices()
+    {
+        if (mBlobFile != nullptr && mVertices.size() != mBlobPositions.size())
+        {
+            mVertices.resize(mBlobPositions.size());
+            for (size_t i = 0; i < mVertices.size(); ++i)
+            {
+                const float *attribute = mBlobAttributes.data() + i * AttributeFloats;
+                mVertices[i] = { mBlobPositions[i], { attribute[0], attribute[1], attribute[2] }, { attribute[3], attribute[4] } };
+            }
+        }
+        return mVertices;
+    }
+
+    const Math::BoundingBox &StaticMesh::GetBounds()
+    {
+        if (!mBoundsValid)
+        {
+            mBounds = Math::BoundingBox();
+            for (const auto &vertex : GetVertices())
+                mBounds.Extend(vertex.Position);
+            mBoundsValid = true;
+        }
+        return mBounds;
+    }
+
+    const std::vector<Meshlet> &StaticMesh::GetMeshlets()
+    {
+        if (!mMeshletsValid)
+        {
+            BuildMeshlets();
+            mMeshletsValid = true;
+        }
+        return mMeshlets;
+    }
+
+    void StaticMesh::BuildMeshlets()
+    {
+        Detach();
+        mMeshlets.clear();
+        uint32_t vertexCount = static_cast<uint32_t>(mVertices.size());
+        uint32_t triangleCount = static_cast<uint32_t>(mIndices.size() / 3);
+        if (triangleCount == 0) return;
+
+        // OBJ meshes often have a vertex per face corner, triangles are adjacent when they share a position
+        std::vector<uint32_t> order(vertexCount);
+        std::iota(order.begin(), order.end(), 0u);
+        auto lessPosition = [this](uint32_t inA, uint32_t inB)
+        {
+            const glm::vec3 &a = mVertices[inA].Position;
+            const glm::vec3 &b = mVertices[inB].Position;
+            if (a.x != b.x) return a.x < b.x;
+            if (a.y != b.y) return a.y < b.y;
+            return a.z < b.z;
+        };
+        std::sort(order.begin(), order.end(), lessPosition);
+        std::vector<uint32_t> positionIds(vertexCount);
+        uint32_t positionCount = 0;
+        for (uint32_t i = 0; i < vertexCount; ++i)
+        {
+            if (i > 0 && lessPosition(order[i - 1], order[i])) ++positionCount;
+            positionIds[order[i]] = positionCount;
+        }
+        ++positionCount;
+
+        // triangles around each position, packed one list after the other
+        std::vector<uint32_t> adjacencyOffsets(positionCount + 1, 0);
+        for (uint32_t index : mIndices)
+            ++adjacencyOffsets[positionIds[index] + 1];
+        std::partial_sum(adjacencyOffsets.begin(), adjacencyOffsets.end(), adjacencyOffsets.begin());
+        std::vector<uint32_t> adjacency(adjacencyOffsets.back());
+        std::vector<uint32_t> adjacencyFill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+        for (uint32_t i = 0; i < triangleCount * 3; ++i)
+            adjacency[adjacencyFill[positionIds[mIndices[i]]]++] = i / 3;
+
+        // meshlets are grown from a seed triangle, always adding the neighbour that brings the fewest new vertices
+        constexpr uint32_t None = std::numeric_limits<uint32_t>::max();
+        std::vector<bool> emitted(triangleCount, false);
+        std::vector<uint32_t> vertexMeshlet(vertexCount, None);
+        std::vector<uint32_t> candidateMeshlet(triangleCount, None);
+        std::vector<uint32_t> candidates;
+        std::vector<uint32_t> indices;
+        indices.reserve(mIndices.size());
+        uint32_t cursor = 0;
+
+        auto newVertices = [&](uint32_t inTriangle, uint32_t inMeshlet)
+        {
+            uint32_t count = 0;
+            for (uint32_t k = 0; k < 3; ++k)
+                count += vertexMeshlet[mIndices[inTriangle * 3 + k]] != inMeshlet;
+            return count;
+        };
+
+        while (true)
+        {
+            while (cursor < triangleCount && emitted[cursor]) ++cursor;
+            if (cursor == triangleCount) break;
+
+            uint32_t meshletIndex = static_cast<uint32_t>(mMeshlets.size());
+            Meshlet meshlet{ static_cast<uint32_t>(indices.size()), 0, Math::BoundingBox(), glm::vec3(0.0f), 1.0f };
+            uint32_t meshletVertices = 0;
+            candidates.clear();
+
+            uint32_t triangle = cursor;
+            while (true)
+            {
+                emitted[triangle] = true;
+                for (uint32_t k = 0; k < 3; ++k)
+                {
+                    uint32_t index = mIndices[triangle * 3 + k];
+                    if (vertexMeshlet[index] != meshletIndex)
+                    {
+                        vertexMeshlet[index] = meshletIndex;
+                        ++meshletVertices;
+                    }
+                    indices.push_back(index);
+                    meshlet.Bounds.Extend(mVertices[index].Position);
+
+                    uint32_t position = positionIds[index];
+                    for (uint32_t a = adjacencyOffsets[position]; a < adjacencyOffsets[position + 1]; ++a)
+                    {
+                        uint32_t neighbour = adjacency[a];
+                        if (emitted[neighbour] || candidateMeshlet[neighbour] == meshletIndex) continue;
+                        candidateMeshlet[neighbour] = meshletIndex;
+                        candidates.push_back(neighbour);
+                    }
+                }
+                meshlet.IndexCount += 3;
+                if (meshlet.IndexCount == MaxMeshletTriangles * 3) break;
+
+                uint32_t best = None;
+                uint32_t bestCost = 4;
+                for (size_t c = 0; c < candidates.size();)
+                {
+                    if (emitted[candidates[c]])
+                    {
+                        candidates[c] = candidates.back();
+                        candidates.pop_back();
+                        continue;
+                    }
+                    uint32_t cost = newVertices(candidates[c], meshletIndex);
+                    if (cost < bestCost)
+                    {
+                        best = candidates[c];
+                        bestCost = cost;
+                    }
+                    ++c;
+                }
+                // nothing connected is left, carry on with the next triangle in index order which is usually close by
+                if (best == None)
+                {
+                    while (cursor < triangleCount && emitted[cursor]) ++cursor;
+                    if (cursor == triangleCount) break;
+                    best = cursor;
+                    bestCost = newVertices(best, meshletIndex);
+                }
+                if (meshletVertices + bestCost > MaxMeshletVertices) break;
+                triangle = best;
+            }
+
+            // normal cone, the smallest one around the average normal that contains all the triangle normals
+            glm::vec3 normalSum(0.0f);
+            std::vector<glm::vec3> normals;
+            normals.reserve(meshlet.IndexCount / 3);
+            for (uint32_t i = meshlet.FirstIndex; i < meshlet.FirstIndex + meshlet.IndexCount; i += 3)
+            {
+                const glm::vec3 &a = mVertices[indices[i]].Position;
+                glm::vec3 normal = glm::cross(mVertices[indices[i + 1]].Position - a, mVertices[indices[i + 2]].Position - a);
+                float length = glm::length(normal);
+                if (length == 0.0f) continue;
+                normals.push_back(normal / length);
+                normalSum += normals.back();
+            }
+            if (glm::length(normalSum) > 1e-6f)
+            {
+                glm::vec3 axis = glm::normalize(normalSum);
+                float minDot = 1.0f;
+                for (const auto &normal : normals)
+                    minDot = std::min(minDot, glm::dot(normal, axis));
+                // a cone this wide would only cull from a tiny range of directions, not worth the test
+                if (minDot > 0.1f)
+                {
+                    meshlet.ConeAxis = axis;
+                    meshlet.ConeCutoff = std::sqrt(1.0f - minDot * minDot);
+                }
+            }
+            mMeshlets.push_back(meshlet);
+        }
+
+        mIndices = std::move(indices);
+        mTainted = true;
+        ZE_CORE_TRACE("Partitioned {} triangles into {} meshlets", triangleCount, mMeshlets.size());
+    }
+
+    void StaticMesh::Detach()
+    {
+        if (mBlobFile == nullptr) return;
+        GetVertices();
+        mIndices.assign(mBlobIndices.begin(), mBlobIndices.end());
+        mBlobFile = nullptr;
+        mBlobPositions = {};
+        mBlobAttributes = {};
+        mBlobIndices = {};
+    }
+
+    void StaticMesh::SaveBlobs(BlobWriter &ioWriter)
+    {
+        // the indices are stored in meshlet order, next to the meshlets
+        GetMeshlets();
+        if (mBlobFile != nullptr)
+        {
+            ioWriter.Add(mBlobPositions.data(), mBlobPositions.size_bytes());
+            ioWriter.Add(mBlobAttributes.data(), mBlobAttributes.size_bytes());
+        }
+        else
+        {
+            std::vector<glm::vec3> positions;
+            std::vector<float> attributes;
+            SplitVertices(mVertices, positions, attributes);
+            ioWriter.Add(positions);
+            ioWriter.Add(attributes);
+        }
+        auto indices = GetIndices();
+        ioWriter.Add(indices.data(), indices.size_bytes());
+        ioWriter.Add(mMeshlets);
+    }
+
+    bool StaticMesh::LoadBlobs(const std::shared_ptr<const BlobFile> &inFile)
+    {
+        if (inFile->GetBlobCount() != 5) return false;
+        auto positions = inFile->GetBlobAs<glm::vec3>(1);
+        auto attributes = inFile->GetBlobAs<float>(2);
+        auto indices = inFile->GetBlobAs<uint32_t>(3);
+        auto meshlets = inFile->GetBlobAs<Meshlet>(4);
+        if (attributes.size() != positions.size() * AttributeFloats) return false;
+
+        mBlobFile = inFile;
+        mBlobPositions = positions;
+        mBlobAttributes = attributes;
+        mBlobIndices = indices;
+        // small next to the rest, they are copied so the culling code keeps its vector
+        mMeshlets.assign(meshlets.begin(), meshlets.end());
+        mMeshletsValid = true;
+        return true;
+    }
+
     std::vector<ImportedAsset> OBJImporter::Import(const std::filesystem::path &inFilepath)
     {
         objl::Loader loader;
@@ -57,6 +387,8 @@ namespace ZenEngine
             }
 
             mesh->SetIndices(curMesh.Indices);
+            // reorders the indices, so the asset is saved in meshlet order
+            mesh->GetMeshlets();
 
             auto importedFilename = inFilepath.filename().replace_extension(".zasset");
             ImportedAsset importedAsset;
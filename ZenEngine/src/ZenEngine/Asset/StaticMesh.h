@@ -1,10 +1,15 @@
 #pragma once
 
+#include <span>
+#include <type_traits>
 #include <glm/glm.hpp>
 #include "Asset.h"
 
+#include "BlobLoader.h"
 #include "Serialization.h"
+#include "ZenEngine/Core/Math.h"
 #include "ZenEngine/Renderer/VertexArray.h"
+#include "ZenEngine/Renderer/ResourceHandle.h"
 
 namespace ZenEngine
 {
@@ -22,36 +27,122 @@ namespace ZenEngine
     };
     static_assert(sizeof(Vertex) == 8 * sizeof(float));
 
+    /// @brief Vertices uploaded as two buffers, the positions tightly packed for the passes that only write depth
+    /// and the normals and texture coordinates interleaved in the other. The attribute locations are the same as
+    /// with a single buffer of Vertex, so the shaders do not tell the difference
+    struct VertexStreams
+    {
+        std::shared_ptr<class VertexBuffer> Positions;
+        std::shared_ptr<class VertexBuffer> Attributes;
+
+        static VertexStreams Create(const std::vector<Vertex> &inVertices);
+        /// @brief From the streams as they are laid out in the buffers, five floats of attributes per position
+        static VertexStreams Create(std::span<const glm::vec3> inPositions, std::span<const float> inAttributes);
+        void AddTo(VertexArray &ioVertexArray) const;
+    };
+
+    /// @brief A cluster of nearby triangles, stored as consecutive indices of the mesh
+    struct Meshlet
+    {
+        uint32_t FirstIndex;
+        uint32_t IndexCount;
+        Math::BoundingBox Bounds;
+        // the normals of the triangles are within the cone, a zero axis means they spread too much to ever cull
+        glm::vec3 ConeAxis;
+        float ConeCutoff;
+    };
+    // stored as it is in blob files
+    static_assert(std::is_trivially_copyable_v<Meshlet>);
+
     class StaticMesh : public Asset
     {
     public:
         IMPLEMENT_ASSET_CLASS(ZenEngine::StaticMesh)
-        using Loader = BinaryLoader;
+        using Loader = BlobLoader<StaticMesh>;
+
+        static constexpr uint32_t MaxMeshletTriangles = 124;
+        static constexpr uint32_t MaxMeshletVertices = 64;
+
+        virtual ~StaticMesh();
 
-        void SetVertices(const std::vector<Vertex> &inVertices) { mVertices = inVertices; mTainted = true; }
-        void SetIndices(const std::vector<uint32_t> &inIndices) { mIndices = inIndices; mTainted = true; }
-        const std::vector<Vertex> &GetVertices() { return mVertices; }
-        const std::vector<uint32_t> &GetIndices() { return mIndices; }
+        void SetVertices(const std::vector<Vertex> &inVertices) { Detach(); mVertices = inVertices; mTainted = true; mBoundsValid = false; mMeshletsValid = false; }
+        void SetIndices(const std::vector<uint32_t> &inIndices) { Detach(); mIndices = inIndices; mTainted = true; mMeshletsValid = false; }
+        /// @brief A mesh loaded from a blob file only has the streams, the vertices are put together on first use
+        const std::vector<Vertex> &GetVertices();
+        std::span<const uint32_t> GetIndices() const { return mBlobFile != nullptr ? mBlobIndices : std::span<const uint32_t>(mIndices); }
         
-        void PushVertex(Vertex inVertex) { mVertices.push_back(inVertex); mTainted = true; }
+        void PushVertex(Vertex inVertex) { Detach(); mVertices.push_back(inVertex); mTainted = true; mBoundsValid = false; mMeshletsValid = false; }
         void PushTriangle(uint32_t inIndices[3]) { for (int i = 0; i < 3; ++i) PushIndex(inIndices[i]); mTainted = true; }
-        void PushIndex(uint32_t inIndex) {  mIndices.push_back(inIndex); mTainted = true; }
+        void PushIndex(uint32_t inIndex) { Detach(); mIndices.push_back(inIndex); mTainted = true; mMeshletsValid = false; }
 
-        std::shared_ptr<VertexArray> CreateOrGetVertexArray();
+        /// @brief Starts the upload on first use and returns a null handle until the loader is done with it.
+        /// Once there the handle stays the same, uploading changed data again swaps what is behind it
+        VertexArrayHandle CreateOrGetVertexArray();
+        bool IsVertexArrayReady() const { return mReady; }
+
+        /// @brief Object space bounds of the vertices
+        const Math::BoundingBox &GetBounds();
+        /// @brief Partitions the triangles into meshlets on first use.
+        /// The indices are reordered so that each meshlet is a contiguous range of them
+        const std::vector<Meshlet> &GetMeshlets();
     private:
         std::vector<Vertex> mVertices;
         std::vector<uint32_t> mIndices;
         bool mTainted = false;
 
-        std::shared_ptr<VertexArray> mVertexArray;
+        // set when loaded from a blob file, the streams are uploaded from the mapped file until something changes them
+        std::shared_ptr<const BlobFile> mBlobFile;
+        std::span<const glm::vec3> mBlobPositions;
+        std::span<const float> mBlobAttributes;
+        std::span<const uint32_t> mBlobIndices;
+
+        Math::BoundingBox mBounds;
+        bool mBoundsValid = false;
+
+        // not serialized by cereal, the index order is, so rebuilding them after loading gives the same meshlets.
+        // Blob files store them along with the indices
+        std::vector<Meshlet> mMeshlets;
+        bool mMeshletsValid = false;
+
+        VertexArrayHandle mVertexArray;
+        bool mReady = false;
+        bool mUploading = false;
+        // bumped by every upload, the result of an older one is dropped. The loader only holds it weakly
+        std::shared_ptr<uint32_t> mUploadGeneration = std::make_shared<uint32_t>(0);
+
+        void BuildMeshlets();
+        /// @brief Copies the data out of the blob file before it is changed
+        void Detach();
+
+        // the meshlets reorder the indices, so they are built before the upload
+        virtual void OnLoad() override { GetMeshlets(); }
+        virtual void OnLoadFinished() override { CreateOrGetVertexArray(); }
 
         template<typename Archive>
         void Serialize(Archive &inArchive)
         {
             inArchive(mVertices, mIndices); 
         }
+
+        template <typename Archive>
+        void SaveMetadata(Archive &outArchive)
+        {
+            const auto &bounds = GetBounds();
+            outArchive(bounds.Min, bounds.Max);
+        }
+
+        template <typename Archive>
+        void LoadMetadata(Archive &inArchive)
+        {
+            inArchive(mBounds.Min, mBounds.Max);
+            mBoundsValid = true;
+        }
+
+        void SaveBlobs(BlobWriter &ioWriter);
+        bool LoadBlobs(const std::shared_ptr<const BlobFile> &inFile);
         
         friend class cereal::access;
+        template <typename> friend class BlobLoader;
     };
 
     class OBJImporter : public AssetImporter
@@ -2,24 +2,226 @@
 
 #include <stb_image.h>
 
+#include "ZenEngine/Renderer/Renderer.h"
+#include "ZenEngine/Renderer/ResourceRegistry.h"
+#include "ZenEngine/Renderer/TextureStreamer.h"
+
 namespace ZenEngine
 {
-    std::shared_ptr<Texture2D> Texture2DAsset::CreateOrGetTexture2D()
+    Texture2DAsset::~Texture2DAsset()
     {
-        if (mTexture2D != nullptr && !mTainted) return mTexture2D;
-        mTexture2D = Texture2D::Create(mTextureProperties);
-        mTexture2D->SetData(mData.data());
+        ResourceRegistry::Get().Destroy(mTexture2D);
+    }
+
+    Texture2DHandle Texture2DAsset::CreateOrGetTexture2D()
+    {
+        if (!mTexture2D.IsNull() && !mTainted) return mTexture2D;
+        if (GetMipCount() == 0) return mTexture2D;
         mTainted = false;
+
+        // lowest levels first, the streamer raises them once something on screen asks for more
+        Upload(GetInitialMip());
+        TextureStreamer::Get().Register(this);
+
+        // still null when the loader runs asynchronously, a single texel stands in
+        if (mTexture2D.IsNull())
+        {
+            Texture2D::Properties properties = mTextureProperties;
+            properties.Width = 1;
+            properties.Height = 1;
+            properties.GenerateMips = false;
+            properties.MipLevels = 1;
+            auto placeholder = Texture2D::Create(properties);
+            // large enough for a texel of any format
+            std::vector<uint8_t> texel(16, 0);
+            placeholder->SetData(texel.data());
+            mTexture2D = ResourceRegistry::Get().Register(placeholder);
+        }
         return mTexture2D;
     }
 
+    void Texture2DAsset::SetTextureProperties(const Texture2D::Properties &inTextureProperties)
+    {
+        mTextureProperties = inTextureProperties;
+        // the chain depends on the size and format
+        if (GetMipCount() > 0) CookMips(GetSource());
+        mTainted = true;
+    }
+
+    void Texture2DAsset::SetMipSettings(const MipSettings &inMipSettings)
+    {
+        SetCookSettings(inMipSettings, mCompression);
+    }
+
+    void Texture2DAsset::SetCompression(const Compression &inCompression)
+    {
+        SetCookSettings(mMipSettings, inCompression);
+    }
+
+    void Texture2DAsset::SetCookSettings(const MipSettings &inMipSettings, const Compression &inCompression)
+    {
+        mMipSettings = inMipSettings;
+        mCompression = inCompression;
+        if (mCompression.Format != Texture2D::Format::None && !IsCompressed())
+            ZE_CORE_WARN("Only 8 bit textures can be compressed, the texels are kept as they are");
+        if (GetMipCount() > 0) CookMips(GetSource());
+        mTainted = true;
+    }
+
+    void Texture2DAsset::SetData(std::vector<uint8_t> inData)
+    {
+        CookMips(std::move(inData));
+        mTainted = true;
+    }
+
+    uint64_t Texture2DAsset::GetMipChainBytes(uint32_t inTopMip) const
+    {
+        uint64_t bytes = 0;
+        for (uint32_t level = inTopMip; level < GetMipCount(); ++level)
+            bytes += mLevels->Levels[level].size();
+        return bytes;
+    }
+
+    uint32_t Texture2DAsset::GetInitialMip() const
+    {
+        uint32_t level = 0;
+        while (level + 1 < GetMipCount() && std::max(GetMipWidth(level), GetMipHeight(level)) > InitialMipSize)
+            ++level;
+        return level;
+    }
+
+    void Texture2DAsset::StreamMips(uint32_t inTopMip)
+    {
+        if (mStreaming || inTopMip >= GetMipCount() || inTopMip == GetResidentMip()) return;
+        Upload(inTopMip);
+    }
+
+    bool Texture2DAsset::IsCompressed() const
+    {
+        auto format = mTextureProperties.Format;
+        return mCompression.Format != Texture2D::Format::None
+            && (format == Texture2D::Format::R8 || format == Texture2D::Format::RGB8 || format == Texture2D::Format::RGBA8);
+    }
+
+    std::vector<uint8_t> Texture2DAsset::GetSource() const
+    {
+        auto source = mLevels->Source.empty() ? mLevels->Levels[0] : mLevels->Source;
+        return { source.begin(), source.end() };
+    }
+
+    void Texture2DAsset::CookMips(std::vector<uint8_t> inTopLevel)
+    {
+        auto chain = std::make_shared<MipChain>();
+        auto &levels = chain->OwnedLevels;
+        levels.push_back(std::move(inTopLevel));
+
+        // RGBA32F data is sized with four bytes per texel, it is left to the backend to build its chain
+        auto format = mTextureProperties.Format;
+        if (mTextureProperties.GenerateMips && format != Texture2D::Format::RGBA32F)
+        {
+            auto lower = MipGenerator::Generate(levels[0], format, mTextureProperties.Width, mTextureProperties.Height, mMipSettings.Filter, mMipSettings.SRGB);
+            for (auto &level : lower)
+                levels.push_back(std::move(level));
+        }
+
+        // the chain is built from the texels, then every level is encoded on its own
+        if (IsCompressed())
+        {
+            chain->OwnedSource = levels[0];
+            for (uint32_t level = 0; level < levels.size(); ++level)
+                levels[level] = TextureCompression::Encode(mCompression.Format, mCompression.Quality, levels[level].data(), format, GetMipWidth(level), GetMipHeight(level));
+        }
+        chain->Own();
+        mLevels = std::move(chain);
+    }
+
+    void Texture2DAsset::SaveBlobs(BlobWriter &ioWriter) const
+    {
+        ioWriter.Add(mLevels->Source);
+        for (auto level : mLevels->Levels)
+            ioWriter.Add(level);
+    }
+
+    bool Texture2DAsset::LoadBlobs(const std::shared_ptr<const BlobFile> &inFile)
+    {
+        // the metadata, the source and at least the top level
+        if (inFile->GetBlobCount() < 3) return false;
+        auto chain = std::make_shared<MipChain>();
+        chain->File = inFile;
+        chain->Source = inFile->GetBlob(1);
+        for (uint32_t blob = 2; blob < inFile->GetBlobCount(); ++blob)
+            chain->Levels.push_back(inFile->GetBlob(blob));
+        mLevels = std::move(chain);
+        return true;
+    }
+
+    void Texture2DAsset::Detach()
+    {
+        if (mLevels->File == nullptr) return;
+        auto chain = std::make_shared<MipChain>();
+        chain->OwnedSource.assign(mLevels->Source.begin(), mLevels->Source.end());
+        for (auto level : mLevels->Levels)
+            chain->OwnedLevels.emplace_back(level.begin(), level.end());
+        chain->Own();
+        mLevels = std::move(chain);
+    }
+
+    void Texture2DAsset::Upload(uint32_t inTopMip)
+    {
+        mStreaming = true;
+        mTargetMip = inTopMip;
+
+        Texture2D::Properties properties = mTextureProperties;
+        properties.Width = GetMipWidth(inTopMip);
+        properties.Height = GetMipHeight(inTopMip);
+        properties.Format = GetLevelFormat();
+        properties.MipLevels = GetMipCount() - inTopMip;
+        // without a cooked chain the backend builds one, as textures always did. It can not for compressed levels
+        properties.GenerateMips = mTextureProperties.GenerateMips && GetMipCount() == 1 && !IsCompressed();
+
+        // the levels are shared, the asset may change or go away while the loader works on them
+        auto texture = std::make_shared<std::shared_ptr<Texture2D>>();
+        auto load = [texture, properties, levels = mLevels, inTopMip]()
+        {
+            *texture = Texture2D::Create(properties);
+            if (properties.GenerateMips)
+            {
+                (*texture)->SetData(const_cast<uint8_t*>(levels->Levels[0].data()));
+                return;
+            }
+            // the levels of a texture loaded from a blob file are read from where they are mapped
+            for (uint32_t level = inTopMip; level < levels->Levels.size(); ++level)
+            {
+                auto data = levels->Levels[level];
+                (*texture)->SetMipData(level - inTopMip, const_cast<uint8_t*>(data.data()), static_cast<uint32_t>(data.size()));
+            }
+        };
+        auto ready = [this, texture, inTopMip, generation = std::weak_ptr<uint32_t>(mUploadGeneration), expected = ++*mUploadGeneration]()
+        {
+            auto current = generation.lock();
+            if (current == nullptr || *current != expected) return;
+            if (mTexture2D.IsNull())
+                mTexture2D = ResourceRegistry::Get().Register(*texture);
+            else
+                ResourceRegistry::Get().Replace(mTexture2D, *texture);
+            mResidentMip = inTopMip;
+            mReady = true;
+            mStreaming = false;
+        };
+        Renderer::Get().GetResourceLoader().Enqueue(std::move(load), std::move(ready));
+    }
+
     std::vector<ImportedAsset> STBImageImporter::Import(const std::filesystem::path &inFilepath)
     {
         int width;
         int height;
         int channels;
         stbi_set_flip_vertically_on_load(1);
-        uint8_t *imageData = stbi_load(inFilepath.string().c_str(), &width, &height, &channels, 4);
+        // the texels are kept with the channels of the file, grey with alpha is expanded to RGBA
+        stbi_info(inFilepath.string().c_str(), &width, &height, &channels);
+        int desiredChannels = channels == 2 ? 4 : channels;
+        uint8_t *imageData = stbi_load(inFilepath.string().c_str(), &width, &height, &channels, desiredChannels);
+        channels = desiredChannels;
         ZE_CORE_INFO("Image\n\twidth: {}\n\theight: {}\n\tchannels: {}", width, height, channels);
         Texture2D::Properties props;
         props.Width = width;
@@ -35,8 +237,29 @@ namespace ZenEngine
         }
         std::vector<uint8_t> data(width * height * channels);
         memcpy(data.data(), imageData, width * height * channels);
+        // color images are stored as sRGB, single channel ones are usually data
+        Texture2DAsset::MipSettings mipSettings;
+        mipSettings.SRGB = props.Format != Texture2D::Format::R8;
+
+        // compressed by default with the format that fits the channels, opaque textures take half the memory with BC1
+        Texture2DAsset::Compression compression;
+        switch (props.Format)
+        {
+        case Texture2D::Format::R8: compression.Format = Texture2D::Format::BC4; break;
+        case Texture2D::Format::RGB8: compression.Format = Texture2D::Format::BC1; break;
+        default:
+        {
+            bool opaque = true;
+            for (size_t i = 3; i < data.size() && opaque; i += 4)
+                opaque = data[i] == 255;
+            compression.Format = opaque ? Texture2D::Format::BC1 : Texture2D::Format::BC7;
+        }
+        }
+
         std::shared_ptr<Texture2DAsset> textureAsset = std::make_shared<Texture2DAsset>();
         textureAsset->SetTextureProperties(props);
+        textureAsset->SetMipSettings(mipSettings);
+        textureAsset->SetCompression(compression);
         textureAsset->SetData(std::move(data));
 
         ImportedAsset imported;
@@ -1,7 +1,14 @@
 #pragma once
 
+#include <algorithm>
+#include <span>
+
 #include "Asset.h"
+#include "BlobLoader.h"
 #include "ZenEngine/Renderer/Texture2D.h"
+#include "ZenEngine/Renderer/MipGenerator.h"
+#include "ZenEngine/Renderer/TextureCompression.h"
+#include "ZenEngine/Renderer/ResourceHandle.h"
 
 namespace cereal
 {
@@ -18,29 +25,166 @@ namespace ZenEngine
     {
     public:
         IMPLEMENT_ASSET_CLASS(ZenEngine::Texture2DAsset)
-        using Loader = BinaryLoader;
+        using Loader = BlobLoader<Texture2DAsset>;
+
+        // the levels up to this size are uploaded first, before anything asked for more detail
+        static constexpr uint32_t InitialMipSize = 64;
+        // "ZETX" read as a little endian integer, in front of the saved texture. Files from before it start with the width
+        static constexpr uint32_t Magic = 0x5854455a;
+        // bumped whenever the saved layout changes, older files are rejected rather than misread
+        static constexpr uint32_t Version = 1;
 
-        std::shared_ptr<Texture2D> CreateOrGetTexture2D();
+        struct Compression
+        {
+            // None keeps the texels as they are, only the 8 bit formats can be compressed
+            Texture2D::Format Format = Texture2D::Format::None;
+            TextureCompression::Quality Quality = TextureCompression::Quality::Normal;
+        };
+
+        struct MipSettings
+        {
+            MipGenerator::Filter Filter = MipGenerator::Filter::Kaiser;
+            // the texels are colors encoded as sRGB, they are filtered in linear space
+            bool SRGB = false;
+        };
+
+        virtual ~Texture2DAsset();
+
+        /// @brief The handle is usable right away, it shows a placeholder until the loader has uploaded the
+        /// smallest levels. The texture streamer raises or drops the resident levels from there
+        Texture2DHandle CreateOrGetTexture2D();
+        bool IsTexture2DReady() const { return mReady; }
 
         const Texture2D::Properties &GetTextureProperties() const { return mTextureProperties; }
 
-        void SetTextureProperties(const Texture2D::Properties &inTextureProperties) { mTextureProperties = inTextureProperties; mTainted = true; }
-        void SetData(std::vector<uint8_t> inData) { mData = std::move(inData); mTainted = true; }
+        void SetTextureProperties(const Texture2D::Properties &inTextureProperties);
+        /// @brief Sets the top level and cooks the mip chain below it when the properties ask for mips
+        void SetData(std::vector<uint8_t> inData);
+
+        const MipSettings &GetMipSettings() const { return mMipSettings; }
+        /// @brief Cooks the chain again with the new settings
+        void SetMipSettings(const MipSettings &inMipSettings);
+
+        const Compression &GetCompression() const { return mCompression; }
+        /// @brief Encodes the levels again from the texels they were made of
+        void SetCompression(const Compression &inCompression);
+        /// @brief Sets both and cooks the chain once, rather than once for each
+        void SetCookSettings(const MipSettings &inMipSettings, const Compression &inCompression);
+        /// @brief Format of the levels that are uploaded, the one of the properties when they are not compressed
+        Texture2D::Format GetLevelFormat() const { return IsCompressed() ? mCompression.Format : mTextureProperties.Format; }
+
+        uint32_t GetMipCount() const { return static_cast<uint32_t>(mLevels->Levels.size()); }
+        uint32_t GetMipWidth(uint32_t inLevel) const { return std::max(mTextureProperties.Width >> inLevel, 1u); }
+        uint32_t GetMipHeight(uint32_t inLevel) const { return std::max(mTextureProperties.Height >> inLevel, 1u); }
+        /// @brief Bytes of the levels from inTopMip down
+        uint64_t GetMipChainBytes(uint32_t inTopMip) const;
+        /// @brief The largest level that is not bigger than InitialMipSize
+        uint32_t GetInitialMip() const;
+
+        /// @brief First level on the GPU, GetMipCount() while none is
+        uint32_t GetResidentMip() const { return mReady ? mResidentMip : GetMipCount(); }
+        /// @brief First level of the upload in flight, the resident one when there is none
+        uint32_t GetTargetMip() const { return mStreaming ? mTargetMip : GetResidentMip(); }
+        bool IsStreaming() const { return mStreaming; }
+        /// @brief Uploads the levels from inTopMip down in the background and swaps them in behind the same handle
+        void StreamMips(uint32_t inTopMip);
+        /// @brief Expires with the asset, so holders of a plain pointer to it can tell it is gone
+        std::weak_ptr<const void> GetLifetimeToken() const { return mUploadGeneration; }
 
     private:
+        struct MipChain
+        {
+            // the top level first
+            std::vector<std::span<const uint8_t>> Levels;
+            // the top level as it was set, only kept when the levels are compressed
+            std::span<const uint8_t> Source;
+            // what the spans point into, the cooked data or the file the asset was loaded from
+            std::vector<std::vector<uint8_t>> OwnedLevels;
+            std::vector<uint8_t> OwnedSource;
+            std::shared_ptr<const BlobFile> File;
+
+            /// @brief Points the spans at the owned data once it is filled in
+            void Own()
+            {
+                Levels.assign(OwnedLevels.begin(), OwnedLevels.end());
+                Source = OwnedSource;
+            }
+        };
+
         Texture2D::Properties mTextureProperties;
-        std::vector<uint8_t> mData;
+        MipSettings mMipSettings;
+        Compression mCompression;
+        // shared with the uploads in flight so it is replaced rather than modified
+        std::shared_ptr<const MipChain> mLevels = std::make_shared<MipChain>();
 
         bool mTainted = false;
-        std::shared_ptr<Texture2D> mTexture2D;
+        Texture2DHandle mTexture2D;
+        bool mReady = false;
+        uint32_t mResidentMip = 0;
+        uint32_t mTargetMip = 0;
+        bool mStreaming = false;
+        // bumped by every upload, the result of an older one is dropped. The loader and the streamer only hold it weakly
+        std::shared_ptr<uint32_t> mUploadGeneration = std::make_shared<uint32_t>(0);
+
+        bool IsCompressed() const;
+        std::vector<uint8_t> GetSource() const;
+        void CookMips(std::vector<uint8_t> inTopLevel);
+        void Upload(uint32_t inTopMip);
+
+        virtual void OnLoadFinished() override { CreateOrGetTexture2D(); }
 
         template <typename Archive>
-        void Serialize(Archive &inArchive)
+        static void CheckVersion(Archive &inArchive)
         {
-            inArchive(mTextureProperties, mData);
+            uint32_t magic = 0;
+            uint32_t version = 0;
+            inArchive(magic, version);
+            if (magic != Magic || version != Version)
+                throw cereal::Exception("The texture was saved by an older version of the engine, reimport it from its image");
         }
 
+        template <typename Archive>
+        void Save(Archive &inArchive) const
+        {
+            inArchive(Magic, Version);
+            std::vector<uint8_t> source(mLevels->Source.begin(), mLevels->Source.end());
+            std::vector<std::vector<uint8_t>> levels;
+            for (auto level : mLevels->Levels)
+                levels.emplace_back(level.begin(), level.end());
+            inArchive(mTextureProperties, mMipSettings.Filter, mMipSettings.SRGB, mCompression.Format, mCompression.Quality, source, levels);
+        }
+
+        template <typename Archive>
+        void Load(Archive &inArchive)
+        {
+            CheckVersion(inArchive);
+            auto levels = std::make_shared<MipChain>();
+            inArchive(mTextureProperties, mMipSettings.Filter, mMipSettings.SRGB, mCompression.Format, mCompression.Quality, levels->OwnedSource, levels->OwnedLevels);
+            levels->Own();
+            mLevels = std::move(levels);
+        }
+
+        template <typename Archive>
+        void SaveMetadata(Archive &outArchive) const
+        {
+            outArchive(Magic, Version);
+            outArchive(mTextureProperties, mMipSettings.Filter, mMipSettings.SRGB, mCompression.Format, mCompression.Quality);
+        }
+
+        template <typename Archive>
+        void LoadMetadata(Archive &inArchive)
+        {
+            CheckVersion(inArchive);
+            inArchive(mTextureProperties, mMipSettings.Filter, mMipSettings.SRGB, mCompression.Format, mCompression.Quality);
+        }
+
+        void SaveBlobs(BlobWriter &ioWriter) const;
+        bool LoadBlobs(const std::shared_ptr<const BlobFile> &inFile);
+        /// @brief Copies the levels out of the blob file they are read from
+        void Detach();
+
         friend class cereal::access;
+        template <typename> friend class BlobLoader;
     };
 
     class STBImageImporter : public AssetImporter
@@ -57,4 +201,4 @@ namespace ZenEngine
 }
 
 CEREAL_REGISTER_TYPE(ZenEngine::Texture2DAsset);
-CEREAL_REGISTER_POLYMORPHIC_RELATION(ZenEngine::Asset, ZenEngine::Texture2DAsset)
\ No newline at end of file
+CEREAL_REGISTER_POLYMORPHIC_RELATION(ZenEngine::Asset, ZenEngine::Texture2DAsset)
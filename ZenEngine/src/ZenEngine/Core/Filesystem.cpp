@@ -2,6 +2,21 @@
 
 #include <fstream>
 #include <filesystem>
+#include <utility>
+
+#include "Platform.h"
+#include "Log.h"
+
+#if defined(ZE_PLATFORM_WINDOWS)
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <windows.h>
+#elif defined(ZE_PLATFORM_LINUX)
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
 
 namespace ZenEngine
 {
@@ -21,4 +36,97 @@ namespace ZenEngine
             out.write((const char *)inBytes, inSize);
         }
     }
+
+    Filesystem::MappedFile::~MappedFile()
+    {
+        Close();
+    }
+
+    Filesystem::MappedFile::MappedFile(MappedFile &&inOther) noexcept
+        : mData(std::exchange(inOther.mData, nullptr)), mSize(std::exchange(inOther.mSize, 0))
+    {
+    }
+
+    Filesystem::MappedFile &Filesystem::MappedFile::operator =(MappedFile &&inOther) noexcept
+    {
+        if (this != &inOther)
+        {
+            Close();
+            mData = std::exchange(inOther.mData, nullptr);
+            mSize = std::exchange(inOther.mSize, 0);
+        }
+        return *this;
+    }
+
+    bool Filesystem::MappedFile::Open(const std::filesystem::path &inFilepath)
+    {
+        Close();
+#if defined(ZE_PLATFORM_WINDOWS)
+        HANDLE file = CreateFileW(inFilepath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            ZE_CORE_ERROR("Cannot open {} for mapping", inFilepath.string());
+            return false;
+        }
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+        {
+            CloseHandle(file);
+            return false;
+        }
+        // the view keeps the mapping and the file alive, both handles can go right away
+        HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        CloseHandle(file);
+        if (mapping == nullptr)
+        {
+            ZE_CORE_ERROR("Cannot map {}", inFilepath.string());
+            return false;
+        }
+        void *data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        CloseHandle(mapping);
+        if (data == nullptr)
+        {
+            ZE_CORE_ERROR("Cannot map {}", inFilepath.string());
+            return false;
+        }
+        mData = static_cast<const uint8_t*>(data);
+        mSize = static_cast<uint64_t>(size.QuadPart);
+#elif defined(ZE_PLATFORM_LINUX)
+        int file = open(inFilepath.c_str(), O_RDONLY);
+        if (file < 0)
+        {
+            ZE_CORE_ERROR("Cannot open {} for mapping", inFilepath.string());
+            return false;
+        }
+        struct stat status;
+        if (fstat(file, &status) != 0 || status.st_size == 0)
+        {
+            close(file);
+            return false;
+        }
+        // the mapping stays valid after the descriptor is closed
+        void *data = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+        close(file);
+        if (data == MAP_FAILED)
+        {
+            ZE_CORE_ERROR("Cannot map {}", inFilepath.string());
+            return false;
+        }
+        mData = static_cast<const uint8_t*>(data);
+        mSize = static_cast<uint64_t>(status.st_size);
+#endif
+        return true;
+    }
+
+    void Filesystem::MappedFile::Close()
+    {
+        if (mData == nullptr) return;
+#if defined(ZE_PLATFORM_WINDOWS)
+        UnmapViewOfFile(mData);
+#elif defined(ZE_PLATFORM_LINUX)
+        munmap(const_cast<uint8_t*>(mData), static_cast<size_t>(mSize));
+#endif
+        mData = nullptr;
+        mSize = 0;
+    }
 }
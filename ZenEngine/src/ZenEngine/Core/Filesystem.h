@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <cstdint>
 #include <filesystem>
 
 namespace ZenEngine
@@ -11,6 +12,32 @@ namespace ZenEngine
         std::string ReadFileToString(const std::filesystem::path &inFilepath);
 
         void WriteBytes(const std::filesystem::path &inFilepath, const uint8_t *inBytes, uint64_t inSize);
+
+        /// @brief Read only view of a whole file through the virtual memory system.
+        /// Pages are loaded by the OS on first access and can be evicted under memory pressure, so files larger than
+        /// what fits in RAM can be read at random without loading them
+        class MappedFile
+        {
+        public:
+            MappedFile() = default;
+            ~MappedFile();
+
+            MappedFile(const MappedFile &) = delete;
+            MappedFile &operator =(const MappedFile &) = delete;
+            MappedFile(MappedFile &&inOther) noexcept;
+            MappedFile &operator =(MappedFile &&inOther) noexcept;
+
+            /// @brief Returns false if the file cannot be opened or is empty
+            bool Open(const std::filesystem::path &inFilepath);
+            void Close();
+
+            bool IsOpen() const { return mData != nullptr; }
+            const uint8_t *GetData() const { return mData; }
+            uint64_t GetSize() const { return mSize; }
+        private:
+            const uint8_t *mData = nullptr;
+            uint64_t mSize = 0;
+        };
     }
 
 }
\ No newline at end of file
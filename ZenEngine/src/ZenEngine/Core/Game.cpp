@@ -2,6 +2,7 @@
 #include "ZenEngine/Event/WindowEvents.h"
 
 #include "Time.h"
+#include "JobSystem.h"
 #include "ZenEngine/Renderer/Renderer.h"
 #include "ZenEngine/Editor/Editor.h"
 #include "ZenEngine/Asset/AssetManager.h"
@@ -22,7 +23,9 @@ namespace ZenEngine
 
     Game::~Game()
     {
+        AssetManager::Get().Shutdown();
         Renderer::Get().Shutdown();
+        JobSystem::Get().Shutdown();
     }
 
     void Game::Init()
@@ -34,7 +37,8 @@ namespace ZenEngine
         windowInfo.Width = 1920;
         windowInfo.Height = 1280;
         mWindow = Window::Create(windowInfo);
-        
+
+        JobSystem::Get().Init();
         Renderer::Get().Init(mWindow);
 
         RenderCommand::SetClearColor({ 0.0f, 0.0f, 0.0f, 0.0f });
@@ -107,6 +111,7 @@ namespace ZenEngine
                 HandleEvent(event);
             }
 
+            AssetManager::Get().Update();
             GameUpdate(ellapsed);
         
             Renderer::Get().SwapBuffers();
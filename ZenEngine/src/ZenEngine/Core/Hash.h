@@ -0,0 +1,31 @@
+#pragma once
+
+#include <stdint.h>
+#include <cstddef>
+#include <functional>
+
+namespace ZenEngine
+{
+    namespace Hash
+    {
+        /// @brief Mixes the hash of inValue into ioSeed
+        template <typename T>
+        void Combine(uint64_t &ioSeed, const T &inValue)
+        {
+            ioSeed ^= static_cast<uint64_t>(std::hash<T>()(inValue)) + 0x9e3779b97f4a7c15ull + (ioSeed << 6) + (ioSeed >> 2);
+        }
+
+        /// @brief 64 bit FNV-1a hash of a block of memory
+        inline uint64_t Bytes(const void *inData, size_t inSize, uint64_t inSeed = 0xcbf29ce484222325ull)
+        {
+            const uint8_t *bytes = static_cast<const uint8_t*>(inData);
+            uint64_t hash = inSeed;
+            for (size_t i = 0; i < inSize; ++i)
+            {
+                hash ^= bytes[i];
+                hash *= 0x100000001b3ull;
+            }
+            return hash;
+        }
+    }
+}
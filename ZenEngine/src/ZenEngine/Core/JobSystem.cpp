@@ -0,0 +1,126 @@
+#include "JobSystem.h"
+
+#include <algorithm>
+
+#include "Log.h"
+
+namespace ZenEngine
+{
+    static thread_local uint32_t sThreadIndex = 0;
+
+    void JobSystem::Init(uint32_t inWorkerCount)
+    {
+        if (mRunning) return;
+
+        if (inWorkerCount == 0)
+            inWorkerCount = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+
+        ZE_CORE_INFO("Starting job system with {} workers", inWorkerCount);
+        mRunning = true;
+        for (uint32_t i = 0; i < inWorkerCount; ++i)
+            mWorkers.emplace_back(&JobSystem::WorkerLoop, this, i + 1);
+    }
+
+    void JobSystem::Shutdown()
+    {
+        {
+            std::scoped_lock lock(mMutex);
+            if (!mRunning) return;
+            mRunning = false;
+        }
+        mCondition.notify_all();
+        for (auto &worker : mWorkers)
+            worker.join();
+        mWorkers.clear();
+
+        // whatever is left still has to run, someone may be waiting on it
+        while (TryRunOne()) {}
+    }
+
+    void JobSystem::Submit(Job inJob, Counter *inCounter)
+    {
+        QueuedJob job{ std::move(inJob), inCounter };
+        if (inCounter != nullptr)
+            inCounter->mPending.fetch_add(1, std::memory_order_relaxed);
+
+        if (mWorkers.empty())
+        {
+            Run(job);
+            return;
+        }
+
+        {
+            std::scoped_lock lock(mMutex);
+            mQueue.push_back(std::move(job));
+        }
+        mCondition.notify_one();
+    }
+
+    void JobSystem::Wait(const Counter &inCounter)
+    {
+        while (!inCounter.IsDone())
+        {
+            if (!TryRunOne())
+                std::this_thread::yield();
+        }
+    }
+
+    void JobSystem::ParallelFor(uint32_t inCount, uint32_t inBatchSize, const std::function<void(uint32_t inBegin, uint32_t inEnd)> &inFunction)
+    {
+        if (inCount == 0) return;
+        inBatchSize = std::max(inBatchSize, 1u);
+
+        // the last batch always runs on the calling thread, so a single batch never touches the queue
+        Counter counter;
+        uint32_t begin = 0;
+        for (; begin + inBatchSize < inCount; begin += inBatchSize)
+        {
+            uint32_t end = begin + inBatchSize;
+            Submit([&inFunction, begin, end]() { inFunction(begin, end); }, &counter);
+        }
+        inFunction(begin, inCount);
+        Wait(counter);
+    }
+
+    uint32_t JobSystem::GetThreadIndex()
+    {
+        return sThreadIndex;
+    }
+
+    void JobSystem::WorkerLoop(uint32_t inThreadIndex)
+    {
+        sThreadIndex = inThreadIndex;
+        while (true)
+        {
+            QueuedJob job;
+            {
+                std::unique_lock lock(mMutex);
+                mCondition.wait(lock, [this]() { return !mQueue.empty() || !mRunning; });
+                if (mQueue.empty()) return;
+                job = std::move(mQueue.front());
+                mQueue.pop_front();
+            }
+            Run(job);
+        }
+    }
+
+    bool JobSystem::TryRunOne()
+    {
+        QueuedJob job;
+        {
+            std::scoped_lock lock(mMutex);
+            if (mQueue.empty()) return false;
+            job = std::move(mQueue.front());
+            mQueue.pop_front();
+        }
+        Run(job);
+        return true;
+    }
+
+    void JobSystem::Run(QueuedJob &inJob)
+    {
+        inJob.Function();
+        if (inJob.JobCounter != nullptr)
+            inJob.JobCounter->mPending.fetch_sub(1, std::memory_order_acq_rel);
+    }
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ZenEngine
+{
+    /// @brief Fixed pool of worker threads running small jobs.
+    /// Before Init is called, or with zero workers, every job simply runs on the submitting thread.
+    class JobSystem
+    {
+    public:
+        using Job = std::function<void()>;
+
+        /// @brief Tracks a group of submitted jobs
+        class Counter
+        {
+        public:
+            bool IsDone() const { return mPending.load(std::memory_order_acquire) == 0; }
+        private:
+            std::atomic<uint32_t> mPending = 0;
+            friend class JobSystem;
+        };
+
+        static JobSystem &Get()
+        {
+            static JobSystem instance;
+            return instance;
+        }
+
+        /// @brief Starts the workers, by default one per hardware thread except the calling one
+        void Init(uint32_t inWorkerCount = 0);
+        void Shutdown();
+
+        void Submit(Job inJob, Counter *inCounter = nullptr);
+
+        /// @brief Blocks until every job of the counter has run. The calling thread executes queued jobs
+        /// in the meantime, so waiting from inside a job cannot deadlock the pool
+        void Wait(const Counter &inCounter);
+
+        /// @brief Splits [0, inCount) in batches of inBatchSize and runs them on the pool, the calling thread included
+        void ParallelFor(uint32_t inCount, uint32_t inBatchSize, const std::function<void(uint32_t inBegin, uint32_t inEnd)> &inFunction);
+
+        /// @brief Number of threads that may run jobs, workers plus the thread that owns the pool
+        uint32_t GetThreadCount() const { return static_cast<uint32_t>(mWorkers.size()) + 1; }
+
+        /// @brief Index of the calling thread in [0, GetThreadCount()). Workers get 1 and up,
+        /// any other thread gets 0, so per thread data indexed by it is only safe for the owning thread and the workers
+        static uint32_t GetThreadIndex();
+
+    private:
+        struct QueuedJob
+        {
+            Job Function;
+            Counter *JobCounter;
+        };
+
+        std::vector<std::thread> mWorkers;
+        std::deque<QueuedJob> mQueue;
+        std::mutex mMutex;
+        std::condition_variable mCondition;
+        bool mRunning = false;
+
+        void WorkerLoop(uint32_t inThreadIndex);
+        bool TryRunOne();
+        static void Run(QueuedJob &inJob);
+
+        JobSystem() = default;
+        ~JobSystem() { Shutdown(); }
+        JobSystem(const JobSystem &) = delete;
+        JobSystem &operator =(const JobSystem &) = delete;
+    };
+}
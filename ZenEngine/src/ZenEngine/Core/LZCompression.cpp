@@ -0,0 +1,123 @@
+#include "LZCompression.h"
+
+#include <cstring>
+
+namespace ZenEngine
+{
+    static constexpr uint32_t HashBits = 14;
+    // the last bytes are always literals, so a match never reads past the end while it is extended
+    static constexpr size_t LastLiterals = 5;
+
+    static uint32_t Read32(const uint8_t *inData)
+    {
+        uint32_t value;
+        std::memcpy(&value, inData, sizeof(uint32_t));
+        return value;
+    }
+
+    static uint32_t HashSequence(uint32_t inSequence)
+    {
+        return (inSequence * 2654435761u) >> (32 - HashBits);
+    }
+
+    static void WriteCount(std::vector<uint8_t> &outBlock, size_t inCount)
+    {
+        for (; inCount >= 255; inCount -= 255)
+            outBlock.push_back(255);
+        outBlock.push_back(static_cast<uint8_t>(inCount));
+    }
+
+    static bool ReadCount(const uint8_t *&ioCursor, const uint8_t *inEnd, size_t &ioCount)
+    {
+        uint8_t byte;
+        do
+        {
+            if (ioCursor == inEnd) return false;
+            byte = *ioCursor++;
+            ioCount += byte;
+        } while (byte == 255);
+        return true;
+    }
+
+    static void WriteSequence(std::vector<uint8_t> &outBlock, const uint8_t *inLiterals, size_t inLiteralCount, uint32_t inDistance, size_t inMatchLength)
+    {
+        size_t matchCount = inMatchLength > 0 ? inMatchLength - LZCompression::MinMatch : 0;
+        uint8_t token = static_cast<uint8_t>((inLiteralCount < 15 ? inLiteralCount : 15) << 4) | static_cast<uint8_t>(matchCount < 15 ? matchCount : 15);
+        outBlock.push_back(token);
+        if (inLiteralCount >= 15) WriteCount(outBlock, inLiteralCount - 15);
+        outBlock.insert(outBlock.end(), inLiterals, inLiterals + inLiteralCount);
+        if (inMatchLength == 0) return;
+
+        outBlock.push_back(static_cast<uint8_t>(inDistance & 0xff));
+        outBlock.push_back(static_cast<uint8_t>(inDistance >> 8));
+        if (matchCount >= 15) WriteCount(outBlock, matchCount - 15);
+    }
+
+    std::vector<uint8_t> LZCompression::Compress(std::span<const uint8_t> inData)
+    {
+        std::vector<uint8_t> block;
+        block.reserve(inData.size() / 2 + 16);
+        const uint8_t *data = inData.data();
+        size_t size = inData.size();
+
+        // positions plus one of the last sequence seen with each hash, zero is none
+        std::vector<uint32_t> table(size_t(1) << HashBits, 0);
+        size_t literalStart = 0;
+        size_t position = 0;
+        while (size > MinMatch + LastLiterals && position + MinMatch + LastLiterals <= size)
+        {
+            uint32_t sequence = Read32(data + position);
+            uint32_t &entry = table[HashSequence(sequence)];
+            size_t candidate = entry;
+            entry = static_cast<uint32_t>(position + 1);
+            if (candidate == 0 || position - (candidate - 1) > MaxDistance || Read32(data + candidate - 1) != sequence)
+            {
+                ++position;
+                continue;
+            }
+
+            size_t match = candidate - 1;
+            size_t length = MinMatch;
+            while (position + length + LastLiterals < size && data[match + length] == data[position + length])
+                ++length;
+            WriteSequence(block, data + literalStart, position - literalStart, static_cast<uint32_t>(position - match), length);
+            position += length;
+            literalStart = position;
+        }
+        WriteSequence(block, data + literalStart, size - literalStart, 0, 0);
+        return block;
+    }
+
+    bool LZCompression::Decompress(std::span<const uint8_t> inBlock, std::span<uint8_t> outData)
+    {
+        const uint8_t *cursor = inBlock.data();
+        const uint8_t *end = cursor + inBlock.size();
+        uint8_t *output = outData.data();
+        size_t written = 0;
+        while (cursor < end)
+        {
+            uint8_t token = *cursor++;
+            size_t literals = token >> 4;
+            if (literals == 15 && !ReadCount(cursor, end, literals)) return false;
+            if (literals > static_cast<size_t>(end - cursor) || literals > outData.size() - written) return false;
+            if (literals > 0) std::memcpy(output + written, cursor, literals);
+            cursor += literals;
+            written += literals;
+            if (cursor == end) break;
+
+            if (end - cursor < 2) return false;
+            size_t distance = cursor[0] | (static_cast<size_t>(cursor[1]) << 8);
+            cursor += 2;
+            size_t length = token & 15;
+            if (length == 15 && !ReadCount(cursor, end, length)) return false;
+            length += MinMatch;
+            if (distance == 0 || distance > written || length > outData.size() - written) return false;
+            // the copy may overlap what it writes, a short distance repeats a pattern
+            const uint8_t *source = output + written - distance;
+            for (size_t i = 0; i < length; ++i)
+                output[written + i] = source[i];
+            written += length;
+        }
+        return written == outData.size();
+    }
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <stdint.h>
+#include <span>
+#include <vector>
+
+namespace ZenEngine
+{
+    /// @brief A byte oriented LZ77 codec in the manner of LZ4, fast to decode and with nothing to configure.
+    /// A block is a list of sequences, each a token byte with the counts of literals and of bytes to copy, the literals,
+    /// then unless the block ends there two bytes of distance back to the copy. Counts of 15 and more go on in extra bytes
+    class LZCompression
+    {
+    public:
+        // shortest copy worth a sequence, the length in the token starts from it
+        static constexpr uint32_t MinMatch = 4;
+        // the distance is stored in two bytes
+        static constexpr uint32_t MaxDistance = 65535;
+
+        /// @brief Compressed bytes of inData, may be larger than it when it does not compress
+        static std::vector<uint8_t> Compress(std::span<const uint8_t> inData);
+        /// @brief Returns false if the block is corrupted or does not decode to exactly outData.size() bytes
+        static bool Decompress(std::span<const uint8_t> inBlock, std::span<uint8_t> outData);
+    };
+}
@@ -72,4 +72,43 @@ namespace ZenEngine
         outRotation = glm::quat(rotation);
         return ret;
     }
-}
\ No newline at end of file
+
+    Math::BoundingBox Math::BoundingBox::Transform(const glm::mat4 &inTransform) const
+    {
+        // the extents of the transformed box are the absolute rotated extents (Arvo's method)
+        glm::vec3 center = glm::vec3(inTransform * glm::vec4(GetCenter(), 1.0f));
+        glm::mat3 absolute = glm::mat3(glm::abs(glm::vec3(inTransform[0])), glm::abs(glm::vec3(inTransform[1])), glm::abs(glm::vec3(inTransform[2])));
+        glm::vec3 extents = absolute * GetExtents();
+        return { center - extents, center + extents };
+    }
+
+    Math::Frustum Math::Frustum::FromMatrix(const glm::mat4 &inMatrix)
+    {
+        // Gribb and Hartmann, rows of the matrix combined for the OpenGL clip volume -w <= x, y, z <= w
+        glm::mat4 m = glm::transpose(inMatrix);
+        Frustum frustum;
+        frustum.Planes[0] = m[3] + m[0];
+        frustum.Planes[1] = m[3] - m[0];
+        frustum.Planes[2] = m[3] + m[1];
+        frustum.Planes[3] = m[3] - m[1];
+        frustum.Planes[4] = m[3] + m[2];
+        frustum.Planes[5] = m[3] - m[2];
+        return frustum;
+    }
+
+    Math::Frustum::Result Math::Frustum::Test(const BoundingBox &inBox) const
+    {
+        glm::vec3 center = inBox.GetCenter();
+        glm::vec3 extents = inBox.GetExtents();
+        Result result = Result::Inside;
+        for (const auto &plane : Planes)
+        {
+            glm::vec3 normal(plane);
+            float distance = glm::dot(normal, center) + plane.w;
+            float radius = glm::dot(glm::abs(normal), extents);
+            if (distance < -radius) return Result::Outside;
+            if (distance < radius) result = Result::Intersects;
+        }
+        return result;
+    }
+}
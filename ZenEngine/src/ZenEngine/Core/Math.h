@@ -1,5 +1,6 @@
 #pragma once
 
+#include <limits>
 #include <glm/glm.hpp>
 
 namespace ZenEngine
@@ -8,5 +9,34 @@ namespace ZenEngine
     {
         bool DecomposeMatrix(const glm::mat4 &inMatrix, glm::vec3 &outTranslation, glm::vec3 &outRotation, glm::vec3 &outScale);
         bool DecomposeMatrix(const glm::mat4 &inMatrix, glm::vec3 &outTranslation, glm::quat &outRotation, glm::vec3 &outScale);
+
+        struct BoundingBox
+        {
+            glm::vec3 Min = glm::vec3(std::numeric_limits<float>::max());
+            glm::vec3 Max = glm::vec3(std::numeric_limits<float>::lowest());
+
+            bool IsValid() const { return Min.x <= Max.x && Min.y <= Max.y && Min.z <= Max.z; }
+            glm::vec3 GetCenter() const { return (Min + Max) * 0.5f; }
+            glm::vec3 GetExtents() const { return (Max - Min) * 0.5f; }
+
+            void Extend(const glm::vec3 &inPoint) { Min = glm::min(Min, inPoint); Max = glm::max(Max, inPoint); }
+            void Extend(const BoundingBox &inBox) { Min = glm::min(Min, inBox.Min); Max = glm::max(Max, inBox.Max); }
+
+            /// @brief Box enclosing this one after the transform
+            BoundingBox Transform(const glm::mat4 &inTransform) const;
+        };
+
+        /// @brief Planes point inwards and are not normalized, which is enough to tell on which side a box is
+        struct Frustum
+        {
+            enum class Result { Outside, Intersects, Inside };
+
+            glm::vec4 Planes[6];
+
+            /// @brief Planes of the clip volume of the matrix, in the space the matrix transforms from
+            static Frustum FromMatrix(const glm::mat4 &inMatrix);
+
+            Result Test(const BoundingBox &inBox) const;
+        };
     }
-}
\ No newline at end of file
+}
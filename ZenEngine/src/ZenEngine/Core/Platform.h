@@ -34,13 +34,17 @@
     #error "Android is not supported!"
 #elif defined(__linux__)
     #define ZE_PLATFORM_LINUX
-    #error "Linux is not supported!"
 #else
     /* Unknown compiler/platform */
     #error "Unknown platform!"
 #endif 
 
-#ifdef ZE_PLATFORM_WINDOWS
+#if defined(ZE_PLATFORM_WINDOWS) || defined(ZE_PLATFORM_LINUX)
     #define ZE_WINDOW_PLATFORM_GLFW
-    #define ZE_RENDERER_PLATFORM_OPENGL
+    // the renderer is picked at configure time, OpenGL unless ZE_RENDERER_SOFTWARE is set
+    #if defined(ZE_RENDERER_SOFTWARE)
+        #define ZE_RENDERER_PLATFORM_SOFTWARE
+    #else
+        #define ZE_RENDERER_PLATFORM_OPENGL
+    #endif
 #endif
\ No newline at end of file
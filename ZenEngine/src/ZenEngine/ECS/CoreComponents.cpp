@@ -3,6 +3,7 @@
 #include "ZenEngine/Core/Math.h"
 #include "ZenEngine/Editor/EditorGUI.h"
 #include "ZenEngine/Asset/Texture2DAsset.h"
+#include "ZenEngine/Editor/FileDialog.h"
 
 namespace ZenEngine
 {
@@ -49,25 +50,16 @@ namespace ZenEngine
             inMaterial->Set<Type>(inName, newValue);
     }
 
-    void StaticMeshComponentRenderer::RenderProperties(Entity inSelectedEntity, StaticMeshComponent &inStaticMeshComponent)
+    static void RenderMaterialProperties(const std::shared_ptr<Material> &inMaterial, std::unordered_map<std::string, UUID> &ioTextureUUID)
     {
-        if (EditorGUI::InputAssetUUID<StaticMesh>("Mesh", inStaticMeshComponent.MeshId))
-        {
-            inStaticMeshComponent.MeshVertexArray = AssetManager::Get().LoadAssetAs<StaticMesh>(inStaticMeshComponent.MeshId)->CreateOrGetVertexArray();
-        }
-        if (EditorGUI::InputAssetUUID<ShaderAsset>("Shader", inStaticMeshComponent.ShaderId))
+        if (inMaterial != nullptr)
         {
-            auto shader = AssetManager::Get().LoadAssetAs<ShaderAsset>(inStaticMeshComponent.ShaderId);
-            inStaticMeshComponent.Mat = Material::Create(shader->CreateOrGetShaderProgram());
-        }
-        if (inStaticMeshComponent.Mat != nullptr)
-        {
-            auto params = inStaticMeshComponent.Mat->GetParameters();
+            auto params = inMaterial->GetParameters();
             for (auto &[name, parameter] : params)
             {
 
             #define RENDER_PARAM(type, uifunc)\
-                case type: RenderShaderParam<type>(name, parameter, inStaticMeshComponent.Mat, [](const std::string &displayName, typename MaterialDataTypeCppType<type>::Type &value){uifunc});\
+                case type: RenderShaderParam<type>(name, parameter, inMaterial, [](const std::string &displayName, typename MaterialDataTypeCppType<type>::Type &value){uifunc});\
                 break;
 
                 switch (parameter.Info.Type)
@@ -85,18 +77,193 @@ namespace ZenEngine
             #undef RENDER_PARAM
             }
 
-            auto textures = inStaticMeshComponent.Mat->GetTextures();
+            auto textures = inMaterial->GetTextures();
             for (auto &[name, texture] : textures)
             {
-                if (!inStaticMeshComponent.TextureUUID.contains(name)) inStaticMeshComponent.TextureUUID[name] = 0;
+                if (!ioTextureUUID.contains(name)) ioTextureUUID[name] = 0;
                 
-                if (EditorGUI::InputAssetUUID<Texture2DAsset>(name, inStaticMeshComponent.TextureUUID[name]))
+                if (EditorGUI::InputAssetUUID<Texture2DAsset>(name, ioTextureUUID[name]))
+                    inMaterial->SetTextureAsync(name, ioTextureUUID[name]);
+                
+            }
+        }
+    }
+
+    void StaticMeshComponentRenderer::RenderProperties(Entity inSelectedEntity, StaticMeshComponent &inStaticMeshComponent)
+    {
+        // the renderer system loads the new mesh in the background
+        if (EditorGUI::InputAssetUUID<StaticMesh>("Mesh", inStaticMeshComponent.MeshId))
+        {
+            inStaticMeshComponent.Mesh = nullptr;
+            inStaticMeshComponent.MeshRequest = nullptr;
+            inStaticMeshComponent.MeshVertexArray = VertexArrayHandle::Null;
+        }
+        if (EditorGUI::InputAssetUUID<ShaderAsset>("Shader", inStaticMeshComponent.ShaderId))
+        {
+            auto shader = AssetManager::Get().LoadAssetAs<ShaderAsset>(inStaticMeshComponent.ShaderId);
+            inStaticMeshComponent.Mat = Material::Create(shader);
+        }
+        RenderMaterialProperties(inStaticMeshComponent.Mat, inStaticMeshComponent.TextureUUID);
+
+        ImGui::Checkbox("Static", &inStaticMeshComponent.Static);
+        if (inStaticMeshComponent.Batched)
+            ImGui::TextDisabled("Drawn by the static batch, rebuild it to apply changes");
+    }
+
+    void InstancedStaticMeshComponentRenderer::RenderProperties(Entity inSelectedEntity, InstancedStaticMeshComponent &inComponent)
+    {
+        if (EditorGUI::InputAssetUUID<StaticMesh>("Mesh", inComponent.MeshId))
+        {
+            inComponent.Mesh = nullptr;
+            inComponent.MeshRequest = nullptr;
+            inComponent.Dirty = true;
+        }
+        if (EditorGUI::InputAssetUUID<ShaderAsset>("Shader", inComponent.ShaderId))
+        {
+            auto shader = AssetManager::Get().LoadAssetAs<ShaderAsset>(inComponent.ShaderId);
+            inComponent.Mat = Material::Create(shader);
+        }
+        RenderMaterialProperties(inComponent.Mat, inComponent.TextureUUID);
+
+        ImGui::Text("Instances: %zu", inComponent.Instances.size());
+        if (ImGui::Button("Add Instance"))
+        {
+            inComponent.Instances.push_back(inComponent.Instances.empty() ? InstanceTransform() : inComponent.Instances.back());
+            mSelectedInstance = static_cast<int32_t>(inComponent.Instances.size()) - 1;
+            inComponent.Dirty = true;
+        }
+
+        // there can be a lot of them, only the rows on screen are built
+        if (ImGui::BeginListBox("##Instances"))
+        {
+            ImGuiListClipper clipper;
+            clipper.Begin(static_cast<int>(inComponent.Instances.size()));
+            while (clipper.Step())
+            {
+                for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i)
                 {
-                    auto tex = AssetManager::Get().LoadAssetAs<Texture2DAsset>(inStaticMeshComponent.TextureUUID[name]);
-                    inStaticMeshComponent.Mat->SetTexture(name, tex->CreateOrGetTexture2D());
+                    std::string label = "Instance " + std::to_string(i);
+                    if (ImGui::Selectable(label.c_str(), mSelectedInstance == i))
+                        mSelectedInstance = i;
                 }
-                
             }
+            ImGui::EndListBox();
+        }
+
+        if (mSelectedInstance < 0 || mSelectedInstance >= static_cast<int32_t>(inComponent.Instances.size())) return;
+
+        auto &instance = inComponent.Instances[mSelectedInstance];
+        InstanceTransform old = instance;
+        EditorGUI::InputVec3("Position", instance.Position);
+        glm::vec3 oldRotation = glm::degrees(glm::eulerAngles(instance.Rotation));
+        glm::vec3 rotation = oldRotation;
+        EditorGUI::InputVec3("Rotation", rotation);
+        // only rebuild the quaternion on edits, the euler round trip is not exact
+        if (rotation != oldRotation)
+            instance.Rotation = glm::quat(glm::radians(rotation));
+        EditorGUI::InputVec3("Scale", instance.Scale, 1.0f);
+        if (old.Position != instance.Position || old.Rotation != instance.Rotation || old.Scale != instance.Scale)
+            inComponent.Dirty = true;
+
+        if (ImGui::Button("Remove Instance"))
+        {
+            inComponent.Instances.erase(inComponent.Instances.begin() + mSelectedInstance);
+            mSelectedInstance = -1;
+            inComponent.Dirty = true;
+        }
+    }
+
+    void ParticleSystemComponentRenderer::RenderProperties(Entity inSelectedEntity, ParticleSystemComponent &inComponent)
+    {
+        if (EditorGUI::InputAssetUUID<Texture2DAsset>("Texture", inComponent.TextureId))
+        {
+            inComponent.Texture = nullptr;
+            inComponent.TextureRequest = nullptr;
+        }
+
+        auto &settings = inComponent.Settings;
+        bool changed = false;
+        int maxParticles = static_cast<int>(settings.MaxParticles);
+        if (ImGui::DragInt("Max Particles", &maxParticles, 100.0f, 1, 1000000))
+        {
+            settings.MaxParticles = static_cast<uint32_t>(std::max(maxParticles, 1));
+            changed = true;
+        }
+        changed |= ImGui::DragFloat("Emission Rate", &settings.EmissionRate, 10.0f, 0.0f, 1000000.0f);
+        changed |= ImGui::DragFloatRange2("Lifetime", &settings.MinLifetime, &settings.MaxLifetime, 0.05f, 0.0f, 1000.0f);
+        changed |= ImGui::DragFloatRange2("Speed", &settings.MinSpeed, &settings.MaxSpeed, 0.05f, 0.0f, 1000.0f);
+        changed |= ImGui::SliderFloat("Spread Angle", &settings.SpreadAngle, 0.0f, 180.0f);
+        changed |= ImGui::DragFloat3("Gravity", &settings.Gravity[0], 0.1f);
+        changed |= ImGui::DragFloat("Drag", &settings.Drag, 0.01f, 0.0f, 100.0f);
+        changed |= ImGui::DragFloat("Start Size", &settings.StartSize, 0.01f, 0.0f, 1000.0f);
+        changed |= ImGui::DragFloat("End Size", &settings.EndSize, 0.01f, 0.0f, 1000.0f);
+        changed |= ImGui::ColorEdit4("Start Color", &settings.StartColor[0]);
+        changed |= ImGui::ColorEdit4("End Color", &settings.EndColor[0]);
+
+        const char *blendModes[] = { "Alpha", "Additive" };
+        int blend = static_cast<int>(settings.Blend);
+        if (ImGui::Combo("Blend", &blend, blendModes, IM_ARRAYSIZE(blendModes)))
+        {
+            settings.Blend = static_cast<ParticleEmitter::BlendMode>(blend);
+            changed = true;
+        }
+        if (changed)
+            inComponent.Dirty = true;
+
+        if (inComponent.Emitter != nullptr)
+        {
+            ImGui::Text("Particles: %u", inComponent.Emitter->GetParticleCount());
+            if (ImGui::Button("Restart"))
+                inComponent.Emitter->Clear();
+        }
+    }
+
+    void TerrainComponentRenderer::RenderProperties(Entity inSelectedEntity, TerrainComponent &inComponent)
+    {
+        EditorGUI::SelectableText("Height Map", inComponent.HeightMapPath.empty() ? "None" : inComponent.HeightMapPath);
+        if (ImGui::Button("Open Height Map"))
+        {
+            std::string path = FileDialog::OpenFile("Terrain Height Map (*.zthf)\0*.zthf\0");
+            if (!path.empty())
+            {
+                inComponent.HeightMapPath = path;
+                inComponent.Dirty = true;
+            }
+        }
+        ImGui::SameLine();
+        if (ImGui::Button("Import Image"))
+        {
+            // the image is converted once, the terrain then only maps the tiled file
+            std::string imagePath = FileDialog::OpenFile("Image (*.png)\0*.png\0");
+            if (!imagePath.empty())
+            {
+                std::filesystem::path path = std::filesystem::path(imagePath).replace_extension(".zthf");
+                if (TerrainHeightMap::CreateFromImage(imagePath, path, 1.0f, 100.0f, 0.0f))
+                {
+                    inComponent.HeightMapPath = path.string();
+                    inComponent.Dirty = true;
+                }
+            }
+        }
+
+        if (EditorGUI::InputAssetUUID<Texture2DAsset>("Texture", inComponent.TextureId))
+        {
+            inComponent.Texture = nullptr;
+            inComponent.TextureRequest = nullptr;
+        }
+
+        auto &surface = inComponent.Surface;
+        ImGui::ColorEdit3("Base Color", &surface.BaseColor[0]);
+        ImGui::DragFloat("Specular", &surface.Specular, 0.01f, 0.0f, 1.0f);
+        ImGui::DragFloat("Shininess", &surface.Shininess, 1.0f, 1.0f, 256.0f);
+        ImGui::DragFloat("Texture Scale", &surface.TextureScale, 0.001f, 0.0f, 100.0f);
+        ImGui::DragFloat("Detail Distance", &inComponent.DetailDistance, 1.0f, 1.0f, 100000.0f);
+
+        if (inComponent.TerrainInstance != nullptr && inComponent.TerrainInstance->IsLoaded())
+        {
+            const auto &stats = inComponent.TerrainInstance->GetStatistics();
+            ImGui::Text("Patches: %u", stats.Patches);
+            ImGui::Text("Clipmap updates: %u", stats.ClipmapUpdates);
         }
     }
 
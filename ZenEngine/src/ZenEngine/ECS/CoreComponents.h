@@ -13,6 +13,9 @@
 #include "ZenEngine/Editor/PropertiesWindow.h"
 #include "ZenEngine/Asset/ShaderAsset.h"
 #include "ZenEngine/Renderer/Material.h"
+#include "ZenEngine/Renderer/InstancedMesh.h"
+#include "ZenEngine/Renderer/ParticleEmitter.h"
+#include "ZenEngine/Renderer/Terrain.h"
 
 namespace ZenEngine
 {
@@ -84,9 +87,20 @@ namespace ZenEngine
 
         std::unordered_map<std::string, UUID> TextureUUID;
     
-        std::shared_ptr<VertexArray> MeshVertexArray;
+        // the mesh asset owns the vertex array, keep it alive as long as the handle is used
+        std::shared_ptr<StaticMesh> Mesh;
+        // set while the mesh is loaded in the background
+        std::shared_ptr<AssetRequest> MeshRequest;
+        VertexArrayHandle MeshVertexArray;
         std::shared_ptr<Material> Mat;
 
+        // static meshes are merged into the scene static batch by Scene::BuildStaticBatch and must not move afterwards
+        bool Static = false;
+        // set while the mesh is drawn as part of the static batch instead of on its own
+        bool Batched = false;
+        // HLOD proxy standing for the mesh from afar, -1 if there is none, see Scene::ApplyHLOD
+        int32_t HLODCluster = -1;
+
         StaticMeshComponent() = default;
         StaticMeshComponent(const StaticMeshComponent&) = default;
     };
@@ -98,6 +112,129 @@ namespace ZenEngine
         virtual void RenderProperties(Entity inSelectedEntity, StaticMeshComponent &inStaticMeshComponent) override;
     };
 
+    /// @brief Placement of one instance, relative to the entity
+    struct InstanceTransform
+    {
+        glm::vec3 Position = glm::vec3(0.0f);
+        glm::quat Rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+        glm::vec3 Scale = glm::vec3(1.0f);
+
+        glm::mat4 GetTransform() const
+        {
+            return glm::translate(glm::mat4(1.0f), Position) * glm::toMat4(Rotation) * glm::scale(glm::mat4(1.0f), Scale);
+        }
+
+        template<typename Archive>
+        void Serialize(Archive &outArchive)
+        {
+            outArchive(Position, Rotation, Scale);
+        }
+    };
+
+    /// @brief One mesh and material repeated many times by a single entity, drawn with one instanced draw.
+    /// The material shader has to apply the instance transforms, see InstanceToClipPosition in ZenShaderLib
+    struct InstancedStaticMeshComponent
+    {
+        UUID ShaderId = 0;
+        UUID MeshId = 0;
+
+        std::unordered_map<std::string, UUID> TextureUUID;
+        std::vector<InstanceTransform> Instances;
+
+        std::shared_ptr<StaticMesh> Mesh;
+        std::shared_ptr<AssetRequest> MeshRequest;
+        std::shared_ptr<Material> Mat;
+        // built by the renderer system from the mesh and the instances, set Dirty after changing either
+        std::shared_ptr<InstancedMesh> Batch;
+        bool Dirty = true;
+
+        InstancedStaticMeshComponent() = default;
+        InstancedStaticMeshComponent(const InstancedStaticMeshComponent&) = default;
+
+        template<typename Archive>
+        void Serialize(Archive &outArchive)
+        {
+            outArchive(cereal::make_nvp("shader", ShaderId), cereal::make_nvp("mesh", MeshId),
+                cereal::make_nvp("textures", TextureUUID), cereal::make_nvp("instances", Instances));
+            Dirty = true;
+        }
+    };
+
+    class InstancedStaticMeshComponentRenderer : public PropertyRendererFor<InstancedStaticMeshComponent>
+    {
+    public:
+        InstancedStaticMeshComponentRenderer() : PropertyRendererFor("Instanced Static Mesh Component") {}
+        virtual void RenderProperties(Entity inSelectedEntity, InstancedStaticMeshComponent &inComponent) override;
+    private:
+        int32_t mSelectedInstance = -1;
+    };
+
+    /// @brief Particles emitted from the entity origin and simulated in world space
+    struct ParticleSystemComponent
+    {
+        ParticleEmitter::Settings Settings;
+        UUID TextureId = 0;
+
+        std::shared_ptr<Texture2DAsset> Texture;
+        std::shared_ptr<AssetRequest> TextureRequest;
+        // created by the particle system, set Dirty after changing the settings
+        std::shared_ptr<ParticleEmitter> Emitter;
+        bool Dirty = true;
+
+        ParticleSystemComponent() = default;
+        ParticleSystemComponent(const ParticleSystemComponent&) = default;
+
+        template<typename Archive>
+        void Serialize(Archive &outArchive)
+        {
+            outArchive(cereal::make_nvp("settings", Settings), cereal::make_nvp("texture", TextureId));
+            Dirty = true;
+        }
+    };
+
+    class ParticleSystemComponentRenderer : public PropertyRendererFor<ParticleSystemComponent>
+    {
+    public:
+        ParticleSystemComponentRenderer() : PropertyRendererFor("Particle System Component") {}
+        virtual void RenderProperties(Entity inSelectedEntity, ParticleSystemComponent &inComponent) override;
+    };
+
+    /// @brief Heightfield terrain placed at the entity position, rotation and scale are ignored
+    struct TerrainComponent
+    {
+        // a height map file written by TerrainHeightMap
+        std::string HeightMapPath;
+        UUID TextureId = 0;
+        Terrain::Surface Surface;
+        float DetailDistance = 64.0f;
+
+        std::shared_ptr<Texture2DAsset> Texture;
+        std::shared_ptr<AssetRequest> TextureRequest;
+        // created by the terrain system, set Dirty after changing the height map
+        std::shared_ptr<Terrain> TerrainInstance;
+        bool Dirty = true;
+
+        TerrainComponent() = default;
+        TerrainComponent(const TerrainComponent&) = default;
+
+        template<typename Archive>
+        void Serialize(Archive &outArchive)
+        {
+            outArchive(cereal::make_nvp("heightMap", HeightMapPath), cereal::make_nvp("texture", TextureId),
+                cereal::make_nvp("baseColor", Surface.BaseColor), cereal::make_nvp("specular", Surface.Specular),
+                cereal::make_nvp("shininess", Surface.Shininess), cereal::make_nvp("textureScale", Surface.TextureScale),
+                cereal::make_nvp("detailDistance", DetailDistance));
+            Dirty = true;
+        }
+    };
+
+    class TerrainComponentRenderer : public PropertyRendererFor<TerrainComponent>
+    {
+    public:
+        TerrainComponentRenderer() : PropertyRendererFor("Terrain Component") {}
+        virtual void RenderProperties(Entity inSelectedEntity, TerrainComponent &inComponent) override;
+    };
+
     struct AmbientLightComponent
     {
         Renderer::AmbientLightInfo Info;
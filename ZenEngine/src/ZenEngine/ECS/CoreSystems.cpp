@@ -1,21 +1,206 @@
 #include "CoreSystems.h"
 #include "Scene.h"
 
+#include <limits>
+
 #include "CoreComponents.h"
 #include "ZenEngine/Renderer/Renderer.h"
+#include "ZenEngine/Renderer/TextureStreamer.h"
+#include "ZenEngine/Asset/AssetManager.h"
+#include "ZenEngine/Asset/Texture2DAsset.h"
 
 namespace ZenEngine
 {
+    // starts loading the asset once it is missing, the placeholder of its class stands in until the load is done
+    template <IsAsset T>
+    static void ResolveAsync(UUID inAssetId, AssetRequest::Priority inPriority, std::shared_ptr<T> &ioAsset, std::shared_ptr<AssetRequest> &ioRequest)
+    {
+        if (ioAsset == nullptr && ioRequest == nullptr && inAssetId != 0)
+            ioRequest = AssetManager::Get().LoadAssetAsync(inAssetId, inPriority);
+        if (ioRequest == nullptr) return;
+        ioAsset = ioRequest->GetAssetAs<T>();
+        if (ioRequest->IsDone()) ioRequest = nullptr;
+    }
+
     void StaticMeshRendererSystem::OnRender(float inDeltaTime)
     {
+        auto &hlod = mScene->GetHLOD();
+        hlod.Update(Renderer::Get().GetEyePosition());
+        auto &occlusionCuller = mScene->GetOcclusionCuller();
+        occlusionCuller.BeginFrame();
+        auto &textureStreamer = TextureStreamer::Get();
+
         auto view = mScene->View<TransformComponent, StaticMeshComponent>();
         for (auto entt : view)
         {
             Entity entity(entt, mScene);
             auto &smc = view.get<StaticMeshComponent>(entt);
             auto &tc = view.get<TransformComponent>(entt);
-            if (smc.MeshVertexArray == nullptr || smc.Mat == nullptr) continue;
-            Renderer::Get().Submit(smc.MeshVertexArray, entity.GetWorldTransform(), smc.Mat);
+            ResolveAsync(smc.MeshId, AssetRequest::Priority::Normal, smc.Mesh, smc.MeshRequest);
+            if (smc.Mat == nullptr) continue;
+            glm::mat4 world = entity.GetWorldTransform();
+            Math::BoundingBox bounds = smc.Mesh != nullptr ? smc.Mesh->GetBounds().Transform(world) : Math::BoundingBox();
+            // batched meshes and the members of proxies show their textures too, they ask for them before being skipped
+            if (bounds.IsValid()) textureStreamer.Request(*smc.Mat, Renderer::Get().GetProjectedSize(bounds));
+            if (smc.Batched) continue;
+            // the mesh is uploaded by the loader, the entity shows up once it is done
+            if (smc.MeshVertexArray.IsNull() && smc.Mesh != nullptr)
+            {
+                // built first, so the indices are uploaded in meshlet order right away
+                smc.Mesh->GetMeshlets();
+                smc.MeshVertexArray = smc.Mesh->CreateOrGetVertexArray();
+            }
+            if (smc.MeshVertexArray.IsNull()) continue;
+            if (hlod.IsProxyActive(smc.HLODCluster)) continue;
+            // building the meshlets reorders the indices, this uploads them again when it happened
+            if (smc.Mesh != nullptr && smc.Mesh->GetMeshlets().size() > 1)
+            {
+                smc.MeshVertexArray = smc.Mesh->CreateOrGetVertexArray();
+                mMeshletCuller.Add(*smc.Mesh, smc.MeshVertexArray, world, *smc.Mat);
+                continue;
+            }
+            occlusionCuller.Submit(static_cast<uint64_t>(entt::to_integral(entt)), smc.MeshVertexArray, world, bounds, *smc.Mat);
+        }
+        occlusionCuller.EndFrame();
+        mMeshletCuller.Submit(Renderer::Get().GetViewFrustum(), Renderer::Get().GetEyePosition());
+
+        mScene->GetStaticBatch().Submit(Renderer::Get().GetViewFrustum());
+        hlod.Submit(Renderer::Get().GetViewFrustum());
+    }
+
+    void InstancedStaticMeshRendererSystem::OnRender(float inDeltaTime)
+    {
+        auto view = mScene->View<TransformComponent, InstancedStaticMeshComponent>();
+        for (auto entt : view)
+        {
+            Entity entity(entt, mScene);
+            auto &ismc = view.get<InstancedStaticMeshComponent>(entt);
+
+            // deserialized components only carry the asset ids
+            auto mesh = ismc.Mesh;
+            ResolveAsync(ismc.MeshId, AssetRequest::Priority::Normal, ismc.Mesh, ismc.MeshRequest);
+            if (ismc.Mesh != mesh) ismc.Dirty = true;
+            if (ismc.Mat == nullptr && ismc.ShaderId != 0)
+            {
+                ismc.Mat = Material::Create(AssetManager::Get().LoadAssetAs<ShaderAsset>(ismc.ShaderId));
+                // the material shows its default texture until they are loaded
+                for (auto &[name, textureId] : ismc.TextureUUID)
+                    if (textureId != 0) ismc.Mat->SetTextureAsync(name, textureId);
+            }
+            if (ismc.Mesh == nullptr || ismc.Mat == nullptr || ismc.Instances.empty()) continue;
+
+            if (ismc.Batch == nullptr) ismc.Batch = std::make_shared<InstancedMesh>();
+            if (ismc.Dirty)
+            {
+                // the batch shares the mesh buffers, it has to wait for them to be uploaded
+                if (ismc.Mesh->CreateOrGetVertexArray().IsNull()) continue;
+                std::vector<glm::mat4> transforms;
+                transforms.reserve(ismc.Instances.size());
+                for (const auto &instance : ismc.Instances)
+                    transforms.push_back(instance.GetTransform());
+                ismc.Batch->SetMesh(ismc.Mesh->CreateOrGetVertexArray(), ismc.Mesh->GetBounds());
+                ismc.Batch->SetInstances(std::move(transforms));
+                ismc.Dirty = false;
+            }
+
+            // bring the view frustum into the entity space, where the instance bounds live
+            glm::mat4 world = entity.GetWorldTransform();
+            Math::Frustum frustum = Renderer::Get().GetViewFrustum();
+            for (auto &plane : frustum.Planes)
+                plane = plane * world;
+
+            // the instances are all the same mesh, the closest one decides how much detail its textures need
+            float meshRadius = glm::length(ismc.Mesh->GetBounds().GetExtents());
+            Math::BoundingBox worldBounds = ismc.Batch->GetBounds().Transform(world);
+            glm::vec3 eye = Renderer::Get().GetEyePosition();
+            float distance = glm::distance(glm::clamp(eye, worldBounds.Min, worldBounds.Max), eye);
+            TextureStreamer::Get().Request(*ismc.Mat, Renderer::Get().GetProjectedSize(meshRadius, distance));
+
+            uint32_t visible = ismc.Batch->CullAndUpload(frustum);
+            if (visible > 0)
+                Renderer::Get().SubmitInstanced(ismc.Batch->GetVertexArray(), visible, world, *ismc.Mat);
+        }
+    }
+
+    void ParticleSystemRendererSystem::OnUpdate(float inDeltaTime)
+    {
+        auto view = mScene->View<TransformComponent, ParticleSystemComponent>();
+        for (auto entt : view)
+        {
+            Entity entity(entt, mScene);
+            auto &psc = view.get<ParticleSystemComponent>(entt);
+            if (psc.Emitter == nullptr)
+            {
+                psc.Emitter = std::make_shared<ParticleEmitter>();
+                psc.Dirty = true;
+            }
+            if (psc.Dirty)
+            {
+                psc.Emitter->SetSettings(psc.Settings);
+                psc.Dirty = false;
+            }
+            psc.Emitter->Update(inDeltaTime, entity.GetWorldTransform());
+        }
+    }
+
+    void ParticleSystemRendererSystem::OnRender(float inDeltaTime)
+    {
+        const auto &frustum = Renderer::Get().GetViewFrustum();
+        auto view = mScene->View<TransformComponent, ParticleSystemComponent>();
+        for (auto entt : view)
+        {
+            auto &psc = view.get<ParticleSystemComponent>(entt);
+            if (psc.Emitter == nullptr || psc.Emitter->GetParticleCount() == 0) continue;
+
+            // the bounds are of the particle centers, grown by the largest quad
+            Math::BoundingBox bounds = psc.Emitter->GetBounds();
+            float margin = std::max(psc.Settings.StartSize, psc.Settings.EndSize) * 0.5f;
+            bounds.Min -= glm::vec3(margin);
+            bounds.Max += glm::vec3(margin);
+            if (!bounds.IsValid() || frustum.Test(bounds) == Math::Frustum::Result::Outside) continue;
+
+            ResolveAsync(psc.TextureId, AssetRequest::Priority::High, psc.Texture, psc.TextureRequest);
+            Texture2DHandle texture = psc.Texture != nullptr ? psc.Texture->CreateOrGetTexture2D() : Texture2DHandle::Null;
+            // each quad shows the whole texture, the closest one is at most as far as the edge of the bounds
+            if (psc.Texture != nullptr)
+            {
+                float distance = glm::distance(bounds.GetCenter(), Renderer::Get().GetEyePosition()) - glm::length(bounds.GetExtents());
+                TextureStreamer::Get().Request(*psc.Texture, Renderer::Get().GetProjectedSize(margin, distance));
+            }
+            Renderer::Get().SubmitParticles(*psc.Emitter, texture);
+        }
+    }
+
+    void TerrainRendererSystem::OnRender(float inDeltaTime)
+    {
+        auto view = mScene->View<TransformComponent, TerrainComponent>();
+        for (auto entt : view)
+        {
+            Entity entity(entt, mScene);
+            auto &tc = view.get<TerrainComponent>(entt);
+            if (tc.TerrainInstance == nullptr)
+            {
+                tc.TerrainInstance = std::make_shared<Terrain>();
+                tc.Dirty = true;
+            }
+            if (tc.Dirty)
+            {
+                // a missing file leaves the terrain unloaded, it is tried again when the path changes
+                if (!tc.HeightMapPath.empty())
+                    tc.TerrainInstance->Load(tc.HeightMapPath);
+                else
+                    tc.TerrainInstance->Unload();
+                tc.Dirty = false;
+            }
+            if (!tc.TerrainInstance->IsLoaded()) continue;
+
+            tc.TerrainInstance->SetDetailDistance(tc.DetailDistance);
+            tc.TerrainInstance->SetSurface(tc.Surface);
+            ResolveAsync(tc.TextureId, AssetRequest::Priority::High, tc.Texture, tc.TextureRequest);
+            Texture2DHandle texture = tc.Texture != nullptr ? tc.Texture->CreateOrGetTexture2D() : Texture2DHandle::Null;
+            // the patches under the eye are always close, the texture is kept at full detail
+            if (tc.Texture != nullptr) TextureStreamer::Get().Request(*tc.Texture, std::numeric_limits<float>::max());
+            Renderer::Get().SubmitTerrain(*tc.TerrainInstance, glm::vec3(entity.GetWorldTransform()[3]), texture);
         }
     }
-}
\ No newline at end of file
+}
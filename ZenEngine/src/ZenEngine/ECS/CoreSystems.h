@@ -1,6 +1,7 @@
 #pragma once
 
 #include "System.h"
+#include "ZenEngine/Renderer/MeshletCuller.h"
 
 namespace ZenEngine
 {
@@ -10,6 +11,33 @@ namespace ZenEngine
     public:
         IMPLEMENT_SYSTEM_CLASS(StaticMeshRendererSystem)
 
+        virtual void OnRender(float inDeltaTime) override;
+    private:
+        MeshletCuller mMeshletCuller;
+    };
+
+    class ParticleSystemRendererSystem : public System
+    {
+    public:
+        IMPLEMENT_SYSTEM_CLASS(ParticleSystemRendererSystem)
+
+        virtual void OnUpdate(float inDeltaTime) override;
+        virtual void OnRender(float inDeltaTime) override;
+    };
+
+    class TerrainRendererSystem : public System
+    {
+    public:
+        IMPLEMENT_SYSTEM_CLASS(TerrainRendererSystem)
+
+        virtual void OnRender(float inDeltaTime) override;
+    };
+
+    class InstancedStaticMeshRendererSystem : public System
+    {
+    public:
+        IMPLEMENT_SYSTEM_CLASS(InstancedStaticMeshRendererSystem)
+
         virtual void OnRender(float inDeltaTime) override;
     };
 
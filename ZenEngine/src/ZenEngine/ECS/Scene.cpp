@@ -4,12 +4,17 @@
 
 #include "CoreComponents.h"
 #include "CoreSystems.h"
+#include "ZenEngine/Asset/AssetManager.h"
+#include "ZenEngine/Asset/HLODAsset.h"
 
 namespace ZenEngine
 {
     Scene::Scene()
     {
         RegisterSystem<StaticMeshRendererSystem>();
+        RegisterSystem<InstancedStaticMeshRendererSystem>();
+        RegisterSystem<ParticleSystemRendererSystem>();
+        RegisterSystem<TerrainRendererSystem>();
     }
 
     Entity Scene::CreateEntity()
@@ -59,6 +64,90 @@ namespace ZenEngine
             system->OnUpdate(inDeltaTime);
         }
     }
+    void Scene::BuildStaticBatch()
+    {
+        mStaticBatch.Clear();
+        auto view = mRegistry.view<TransformComponent, StaticMeshComponent>();
+        for (auto entt : view)
+        {
+            Entity entity(entt, this);
+            auto &smc = view.get<StaticMeshComponent>(entt);
+            smc.Batched = smc.Static && smc.Mesh != nullptr && smc.Mat != nullptr;
+            if (smc.Batched)
+                mStaticBatch.Add(smc.Mesh, entity.GetWorldTransform(), smc.Mat);
+        }
+        mStaticBatch.Build();
+        // the meshes that went into the batch can no longer be swapped for their proxy
+        if (!mHLOD.IsEmpty()) ApplyHLOD(mHLOD.GetAsset());
+    }
+
+    void Scene::ClearStaticBatch()
+    {
+        mStaticBatch.Clear();
+        auto view = mRegistry.view<StaticMeshComponent>();
+        for (auto entt : view)
+            view.get<StaticMeshComponent>(entt).Batched = false;
+        if (!mHLOD.IsEmpty()) ApplyHLOD(mHLOD.GetAsset());
+    }
+
+    std::optional<UUID> Scene::BakeHLOD(const HLODBuilder::Settings &inSettings)
+    {
+        std::vector<HLODBuilder::Input> inputs;
+        auto view = mRegistry.view<TransformComponent, StaticMeshComponent>();
+        for (auto entt : view)
+        {
+            Entity entity(entt, this);
+            auto &smc = view.get<StaticMeshComponent>(entt);
+            if (smc.Static && smc.Mesh != nullptr && smc.Mat != nullptr)
+                inputs.push_back({ smc.Mesh, entity.GetWorldTransform(), smc.Mat });
+        }
+
+        auto asset = HLODBuilder::Bake(inputs, inSettings);
+        if (asset->Clusters.empty())
+        {
+            ZE_CORE_WARN("No cell holds enough static meshes to bake an HLOD proxy");
+            return std::nullopt;
+        }
+        // every bake gets its own file, saving never overwrites an asset
+        auto id = AssetManager::Get().CreateAsset(asset, std::filesystem::path("HLOD") / (std::to_string(static_cast<uint64_t>(asset->GetAssetId())) + ".zasset"));
+        ApplyHLOD(asset);
+        return id;
+    }
+
+    void Scene::ApplyHLOD(std::shared_ptr<HLODAsset> inAsset)
+    {
+        // taken by value, the asset may be the one held by the set that is cleared here
+        ClearHLOD();
+        mHLOD.Load(inAsset);
+        if (mHLOD.IsEmpty()) return;
+
+        auto view = mRegistry.view<TransformComponent, StaticMeshComponent>();
+        for (auto entt : view)
+        {
+            Entity entity(entt, this);
+            auto &smc = view.get<StaticMeshComponent>(entt);
+            if (!smc.Static || smc.Mesh == nullptr || smc.Mat == nullptr) continue;
+            int32_t cluster = mHLOD.FindCluster(smc.Mesh->GetBounds().Transform(entity.GetWorldTransform()), *smc.Mat);
+            if (cluster < 0) continue;
+            // the static batch draws its meshes regardless, the proxy would only be drawn over them
+            if (smc.Batched)
+            {
+                mHLOD.Disable(cluster);
+                continue;
+            }
+            smc.HLODCluster = cluster;
+            mHLOD.AddMember(cluster, smc.Mat);
+        }
+    }
+
+    void Scene::ClearHLOD()
+    {
+        mHLOD.Clear();
+        auto view = mRegistry.view<StaticMeshComponent>();
+        for (auto entt : view)
+            view.get<StaticMeshComponent>(entt).HLODCluster = -1;
+    }
+
     Renderer::LightInfo Scene::GetLights()
     {
         Renderer::LightInfo lightInfo{};
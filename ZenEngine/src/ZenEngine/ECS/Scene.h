@@ -1,8 +1,13 @@
 #pragma once
 
+#include <optional>
 #include <entt/entt.hpp>
 #include "System.h"
 #include "ZenEngine/Renderer/Renderer.h"
+#include "ZenEngine/Renderer/StaticBatch.h"
+#include "ZenEngine/Renderer/HLOD.h"
+#include "ZenEngine/Renderer/OcclusionCuller.h"
+#include "ZenEngine/Asset/UUID.h"
 
 namespace ZenEngine
 {
@@ -30,6 +35,22 @@ namespace ZenEngine
 
         Renderer::LightInfo GetLights();
 
+        /// @brief Merges the meshes of the entities flagged as static, call it once the scene is loaded
+        /// and again whenever a static entity changed. The other entities keep being drawn one by one
+        void BuildStaticBatch();
+        void ClearStaticBatch();
+        StaticBatch &GetStaticBatch() { return mStaticBatch; }
+
+        /// @brief Bakes the static meshes into HLOD proxies, saves them as an asset under HLOD and applies them
+        /// @return the id of the new asset, nothing if no cell got a proxy
+        std::optional<UUID> BakeHLOD(const HLODBuilder::Settings &inSettings = {});
+        /// @brief Draws the proxies of a bake in place of the static meshes of their cells when seen from afar
+        void ApplyHLOD(std::shared_ptr<HLODAsset> inAsset);
+        void ClearHLOD();
+        HLODSet &GetHLOD() { return mHLOD; }
+
+        OcclusionCuller &GetOcclusionCuller() { return mOcclusionCuller; }
+
         template <typename ... T>
         auto View()
         {
@@ -45,6 +66,9 @@ namespace ZenEngine
     private:
         entt::registry mRegistry;
         std::vector<std::unique_ptr<System>> mSystems;
+        StaticBatch mStaticBatch;
+        HLODSet mHLOD;
+        OcclusionCuller mOcclusionCuller;
 
         friend class Entity;
     };
@@ -259,16 +259,20 @@ namespace ZenEngine
     void AssetBrowser::DoneRenaming()
     {
         if (std::filesystem::is_directory(mCurrentlyRenaming.value()))
-            std::filesystem::rename(mCurrentlyRenaming.value(), mCurrentlyRenaming->parent_path() / mNewFilename);
+        {
+            std::filesystem::path destination = mCurrentlyRenaming->parent_path() / mNewFilename;
+            std::filesystem::rename(mCurrentlyRenaming.value(), destination);
+            AssetManager::Get().MovePath(mCurrentlyRenaming.value(), destination);
+        }
         else
         {
             std::filesystem::path destination = fmt::format("{}{}", mNewFilename, mCurrentlyRenaming->extension().string());
             std::filesystem::rename(mCurrentlyRenaming.value(), mCurrentlyRenaming->parent_path() / destination);
+            AssetManager::Get().MovePath(mCurrentlyRenaming.value(), mCurrentlyRenaming->parent_path() / destination);
             // check for meta files
             auto metaPath = mCurrentlyRenaming->replace_extension(".zmeta");
             if (std::filesystem::exists(metaPath))
                 std::filesystem::rename(mCurrentlyRenaming.value(), mCurrentlyRenaming->parent_path() / destination.replace_extension(".zmeta"));
-            AssetManager::Get().BuildAssetDatabase();
         }
         mNewFilename = "";
         mCurrentlyRenaming.reset();
@@ -287,12 +291,12 @@ namespace ZenEngine
     {
         std::filesystem::path targetPath = inOld;
         std::filesystem::rename(targetPath, inDirectory / targetPath.filename());
+        AssetManager::Get().MovePath(targetPath, inDirectory / targetPath.filename());
         // check if meta file exists and move it too
         auto metaFile = targetPath.replace_extension(".zmeta");
         if (std::filesystem::exists(metaFile))
         {
             std::filesystem::rename(metaFile, inDirectory / metaFile.filename());
         }
-        AssetManager::Get().BuildAssetDatabase();
     }
 }
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include "ZenEngine/Renderer/Renderer.h"
 #include "ZenEngine/Asset/AssetManager.h"
 #include "ZenEngine/Asset/ShaderAsset.h"
+#include "ZenEngine/Asset/HLODAsset.h"
 
 #include "FileDialog.h"
 
@@ -15,6 +16,7 @@
 #include "AssetBrowser.h"
 #include "MeshEditor.h"
 #include "Texture2DEditor.h"
+#include "RendererStatistics.h"
 
 namespace ZenEngine
 {
@@ -33,6 +35,7 @@ namespace ZenEngine
         RegisterEditorWindow(std::make_unique<SceneHierarchy>());
         RegisterEditorWindow(std::make_unique<PropertiesWindow>());
         RegisterEditorWindow(std::make_unique<AssetBrowser>());
+        RegisterEditorWindow(std::make_unique<RendererStatistics>());
         RegisterAssetEditor<MeshEditor>();
         RegisterAssetEditor<Texture2DEditor>();
     }
@@ -114,6 +117,32 @@ namespace ZenEngine
                 ImGui::EndMenu();
             }
 
+            if (ImGui::BeginMenu("Scene"))
+            {
+                if (ImGui::MenuItem("Build Static Batch", nullptr, false, mActiveScene != nullptr)) mActiveScene->BuildStaticBatch();
+                if (ImGui::MenuItem("Clear Static Batch", nullptr, false, mActiveScene != nullptr)) mActiveScene->ClearStaticBatch();
+                ImGui::Separator();
+                if (ImGui::MenuItem("Bake HLOD", nullptr, false, mActiveScene != nullptr)) mActiveScene->BakeHLOD();
+                // a bake saved earlier, the scene does not keep which one it had
+                if (ImGui::BeginMenu("Apply HLOD", mActiveScene != nullptr))
+                {
+                    const auto &bakes = AssetManager::Get().GetAssetsOfClass(HLODAsset::GetStaticAssetClassName());
+                    if (bakes.empty()) ImGui::MenuItem("No HLOD asset", nullptr, false, false);
+                    const auto &applied = mActiveScene->GetHLOD().GetAsset();
+                    for (UUID id : bakes)
+                    {
+                        ImGui::PushID(fmt::format("{}", (uint64_t)id).c_str());
+                        bool selected = applied != nullptr && applied->GetAssetId() == id;
+                        if (ImGui::MenuItem(AssetManager::Get().GetAsset(id).GetName().c_str(), nullptr, selected))
+                            mActiveScene->ApplyHLOD(AssetManager::Get().LoadAssetAs<HLODAsset>(id));
+                        ImGui::PopID();
+                    }
+                    ImGui::EndMenu();
+                }
+                if (ImGui::MenuItem("Clear HLOD", nullptr, false, mActiveScene != nullptr)) mActiveScene->ClearHLOD();
+                ImGui::EndMenu();
+            }
+
             if (ImGui::BeginMenu("View"))
             {
                 for (const auto &window : mEditorWindows)
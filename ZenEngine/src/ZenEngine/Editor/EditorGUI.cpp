@@ -12,7 +12,7 @@
 #endif
 #ifdef ZE_RENDERER_PLATFORM_OPENGL
     #include <backends/imgui_impl_opengl3.h>
-#else
+#elif !defined(ZE_RENDERER_PLATFORM_SOFTWARE)
     #error "Editor only supports OpenGL as renderer at the moment!"
 #endif
 
@@ -70,7 +70,9 @@ namespace ZenEngine
         io.ConfigFlags |= ImGuiConfigFlags_NavEnableKeyboard;       // Enable Keyboard Controls
         //io.ConfigFlags |= ImGuiConfigFlags_NavEnableGamepad;      // Enable Gamepad Controls
         io.ConfigFlags |= ImGuiConfigFlags_DockingEnable;           // Enable Docking
+    #ifndef ZE_RENDERER_PLATFORM_SOFTWARE
         io.ConfigFlags |= ImGuiConfigFlags_ViewportsEnable;         // Enable Multi-Viewport / Platform Windows
+    #endif
         //io.ConfigFlags |= ImGuiConfigFlags_ViewportsNoTaskBarIcons;
         //io.ConfigFlags |= ImGuiConfigFlags_ViewportsNoMerge;
         io.ConfigWindowsMoveFromTitleBarOnly = true;
@@ -87,6 +89,12 @@ namespace ZenEngine
         ImGui_ImplGlfw_InitForOpenGL((GLFWwindow *)nativeWindow, true);
         #endif
         ImGui_ImplOpenGL3_Init("#version 410");
+    #elif defined(ZE_RENDERER_PLATFORM_SOFTWARE)
+        ImGui_ImplGlfw_InitForVulkan((GLFWwindow *)nativeWindow, true);
+        // the software renderer has no GUI backend, the atlas is still built so frames can be started
+        unsigned char *pixels;
+        int width, height;
+        io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
     #endif
     }
 
@@ -117,6 +125,8 @@ namespace ZenEngine
         #ifdef ZE_WINDOW_PLATFORM_GLFW
         ImGui_ImplGlfw_NewFrame();
         #endif
+    #elif defined(ZE_RENDERER_PLATFORM_SOFTWARE)
+        ImGui_ImplGlfw_NewFrame();
     #endif
         ImGui::NewFrame();
         ImGuizmo::BeginFrame();
@@ -132,6 +142,13 @@ namespace ZenEngine
 
         #ifdef ZE_RENDERER_PLATFORM_OPENGL
         ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+        #elif defined(ZE_RENDERER_PLATFORM_SOFTWARE)
+        static bool sWarned = false;
+        if (!sWarned)
+        {
+            ZE_CORE_WARN("The editor GUI is only drawn with the OpenGL renderer");
+            sWarned = true;
+        }
          #else
             #error "Renderer platform not supported by ImGui!"
         #endif
@@ -212,6 +229,28 @@ namespace ZenEngine
         ImGui::PopID();
     }
 
+    // clicking the field lists the assets of the class, an alternative to dragging one from the browser
+    static bool PickAsset(const char *inAssetClassName, UUID &outAssetId)
+    {
+        if (ImGui::IsItemClicked()) ImGui::OpenPopup("AssetPicker");
+        bool picked = false;
+        if (ImGui::BeginPopup("AssetPicker"))
+        {
+            for (UUID id : AssetManager::Get().GetAssetsOfClass(inAssetClassName))
+            {
+                ImGui::PushID(fmt::format("{}", (uint64_t)id).c_str());
+                if (ImGui::Selectable(AssetManager::Get().GetAsset(id).GetName().c_str()))
+                {
+                    outAssetId = id;
+                    picked = true;
+                }
+                ImGui::PopID();
+            }
+            ImGui::EndPopup();
+        }
+        return picked;
+    }
+
     bool EditorGUI::InputAsset(const std::string &inLabel, const char *inAssetClassName, std::shared_ptr<Asset> &outAsset, float inColumnWidth)
     {
         bool ret = false;
@@ -234,6 +273,12 @@ namespace ZenEngine
             }
             ImGui::EndDragDropTarget();
         }
+        UUID pickedId = 0;
+        if (PickAsset(inAssetClassName, pickedId))
+        {
+            outAsset = AssetManager::Get().LoadAsset(pickedId);
+            ret = true;
+        }
 
         ImGui::Columns(1);
         
@@ -262,6 +307,7 @@ namespace ZenEngine
             }
             ImGui::EndDragDropTarget();
         }
+        if (PickAsset(inAssetClassName, outAssetId)) ret = true;
 
         ImGui::Columns(1);
         
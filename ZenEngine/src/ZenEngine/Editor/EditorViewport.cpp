@@ -18,7 +18,7 @@ namespace ZenEngine
         props.AttachmentProps = { Framebuffer::TextureFormat::RGBA8, Framebuffer::TextureFormat::Depth };
         props.Width = 1280;
         props.Height = 720;
-        mViewportFramebuffer = Framebuffer::Create(props);
+        mViewportFramebuffer = ResourceRegistry::Get().Register(Framebuffer::Create(props));
     }
 
     void EditorViewport::OnInitializeStyle()
@@ -33,12 +33,13 @@ namespace ZenEngine
 
     void EditorViewport::OnRenderWindow()
     {
-        Framebuffer::Properties props = mViewportFramebuffer->GetProperties();
+        auto *viewportFramebuffer = ResourceRegistry::Get().Resolve(mViewportFramebuffer);
+        Framebuffer::Properties props = viewportFramebuffer->GetProperties();
         if (mViewportDimensions.x > 0.0f && mViewportDimensions.y > 0.0f && // zero sized framebuffer is invalid
             (props.Width != mViewportDimensions.x || props.Height != mViewportDimensions.y))
         {
             ZE_CORE_TRACE("EditorViewport: FB resized to {} {}", mViewportDimensions.x, mViewportDimensions.y);
-            mViewportFramebuffer->Resize((uint32_t)mViewportDimensions.x, (uint32_t)mViewportDimensions.y);
+            viewportFramebuffer->Resize((uint32_t)mViewportDimensions.x, (uint32_t)mViewportDimensions.y);
             mCamera.Resize(mViewportDimensions);
             Renderer::Get().SetViewport(0.0f, 0.0f, (uint32_t)mViewportDimensions.x, (uint32_t)mViewportDimensions.y);
         }
@@ -50,7 +51,7 @@ namespace ZenEngine
         ImVec2 viewportPanelSize = ImGui::GetContentRegionAvail();
         mViewportDimensions = { viewportPanelSize.x, viewportPanelSize.y };
 
-        uint64_t textureID = mViewportFramebuffer->GetColorAttachmentRendererId();
+        uint64_t textureID = viewportFramebuffer->GetColorAttachmentRendererId();
         ImGui::Image(reinterpret_cast<void*>(textureID), ImVec2{ mViewportDimensions.x, mViewportDimensions.y }, { 0, 1 }, { 1, 0 });
 
         auto selectedEntity = Editor::Get().CurrentlySelectedEntity;
@@ -36,11 +36,11 @@ namespace ZenEngine
             return view;
         }
 
-        const std::shared_ptr<Framebuffer> &GetFramebuffer() { return mViewportFramebuffer; }
+        FramebufferHandle GetFramebuffer() { return mViewportFramebuffer; }
 
         static EditorViewport &Get() { ZE_ASSERT_CORE_MSG(sViewportInstance != nullptr, "Viewport does not exist!"); return *sViewportInstance; }
     private:
-        std::shared_ptr<Framebuffer> mViewportFramebuffer;
+        FramebufferHandle mViewportFramebuffer;
         EditorCamera mCamera;
         glm::vec2 mViewportDimensions;
         bool mViewportFocused;
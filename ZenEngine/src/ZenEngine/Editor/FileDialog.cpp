@@ -5,9 +5,15 @@
 
 #ifdef ZE_PLATFORM_WINDOWS
     #include <windows.h>
+#elif defined(ZE_PLATFORM_LINUX)
+    #include <algorithm>
+    #include <cstdio>
+    #include <cstring>
+    #include <filesystem>
+    #include <sys/wait.h>
 #endif
 
-#ifdef ZE_WINDOW_PLATFORM_GLFW
+#if defined(ZE_PLATFORM_WINDOWS) && defined(ZE_WINDOW_PLATFORM_GLFW)
     #include <glfw/glfw3.h>
     #define GLFW_EXPOSE_NATIVE_WIN32
     #include <glfw/glfw3native.h>
@@ -64,6 +70,74 @@ namespace ZenEngine
         
         return std::string();
     }
+#elif defined(ZE_PLATFORM_LINUX)
+    static std::string QuoteArgument(const std::string &inArgument)
+    {
+        std::string quoted = "'";
+        for (char c : inArgument)
+        {
+            if (c == '\'') quoted += "'\\''";
+            else quoted += c;
+        }
+        return quoted + "'";
+    }
+
+    // the filter is in the Windows format, pairs of a description and patterns split by ';', each ended by a zero
+    // and the list by an empty string. The pairs become zenity file filters
+    static std::string RunZenity(const char *inFilter, const char *inArguments, std::string *outDefaultExtension)
+    {
+        std::string command = std::string("zenity --file-selection ") + inArguments;
+        for (const char *description = inFilter; *description != '\0';)
+        {
+            const char *patterns = description + std::strlen(description) + 1;
+            if (*patterns == '\0') break;
+            std::string zenityPatterns = patterns;
+            std::replace(zenityPatterns.begin(), zenityPatterns.end(), ';', ' ');
+            command += " --file-filter=" + QuoteArgument(std::string(description) + " | " + zenityPatterns);
+            if (outDefaultExtension != nullptr && outDefaultExtension->empty() && std::strncmp(patterns, "*.", 2) == 0)
+                *outDefaultExtension = std::string(patterns + 1, std::strcspn(patterns + 1, ";"));
+            description = patterns + std::strlen(patterns) + 1;
+        }
+        command += " 2>/dev/null";
+
+        FILE *pipe = popen(command.c_str(), "r");
+        if (pipe == nullptr)
+        {
+            ZE_CORE_ERROR("Cannot start zenity for a file dialog");
+            return std::string();
+        }
+        std::string path;
+        char buffer[256];
+        while (std::fgets(buffer, sizeof(buffer), pipe) != nullptr)
+            path += buffer;
+        int status = pclose(pipe);
+
+        // zenity exits with 1 when the dialog is cancelled, the shell with 127 when there is no zenity
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+        {
+            if (WIFEXITED(status) && WEXITSTATUS(status) == 127)
+                ZE_CORE_ERROR("File dialogs on Linux need zenity to be installed");
+            return std::string();
+        }
+        while (!path.empty() && path.back() == '\n')
+            path.pop_back();
+        return path;
+    }
+
+    std::string FileDialog::OpenFile(const char* filter)
+    {
+        return RunZenity(filter, "", nullptr);
+    }
+
+    std::string FileDialog::SaveFile(const char* filter)
+    {
+        std::string extension;
+        std::string path = RunZenity(filter, "--save --confirm-overwrite", &extension);
+        // like the Windows dialog, the extension of the first filter is added to a name without one
+        if (!path.empty() && !extension.empty() && !std::filesystem::path(path).has_extension())
+            path += extension;
+        return path;
+    }
 #else
     #error "FileDialogs are only supported on windows with GLFW currently!" 
 #endif
@@ -6,7 +6,7 @@
 #ifdef ZE_RENDERER_PLATFORM_OPENGL
     #define IMGUI_IMPL_OPENGL_LOADER_GLAD
     #include <backends/imgui_impl_opengl3.cpp>
-#else
+#elif !defined(ZE_RENDERER_PLATFORM_SOFTWARE)
     #error "Render platform not supported by ImGui!"
 #endif
 
@@ -10,6 +10,9 @@ namespace ZenEngine
         RegisterPropertyRenderer(std::make_unique<NameComponentRenderer>());
         RegisterPropertyRenderer(std::make_unique<TransformComponentRenderer>());
         RegisterPropertyRenderer(std::make_unique<StaticMeshComponentRenderer>());
+        RegisterPropertyRenderer(std::make_unique<InstancedStaticMeshComponentRenderer>());
+        RegisterPropertyRenderer(std::make_unique<ParticleSystemComponentRenderer>());
+        RegisterPropertyRenderer(std::make_unique<TerrainComponentRenderer>());
         RegisterPropertyRenderer(std::make_unique<DirectionalLightComponentRenderer>());
         RegisterPropertyRenderer(std::make_unique<AmbientLightComponentRenderer>());
     }
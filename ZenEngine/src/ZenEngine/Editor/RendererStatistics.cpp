@@ -0,0 +1,100 @@
+#include "RendererStatistics.h"
+
+#include <imgui.h>
+#include "ZenEngine/Renderer/Renderer.h"
+#include "ZenEngine/Renderer/SpriteRenderer.h"
+#include "ZenEngine/Renderer/TextureStreamer.h"
+#include "ZenEngine/Asset/AssetManager.h"
+#include "ZenEngine/Asset/Texture2DAsset.h"
+
+namespace ZenEngine
+{
+    void RendererStatistics::OnRenderWindow()
+    {
+        auto &renderer = Renderer::Get();
+        const auto &stats = renderer.GetStatistics();
+
+        bool depthPrePass = renderer.IsDepthPrePassEnabled();
+        if (ImGui::Checkbox("Depth pre-pass", &depthPrePass))
+            renderer.SetDepthPrePassEnabled(depthPrePass);
+
+        ImGui::Separator();
+        ImGui::Text("Draw calls: %u", stats.DrawCalls);
+        ImGui::Text("Instances: %u", stats.Instances);
+        ImGui::Text("Particles: %u", stats.Particles);
+        ImGui::Text("Terrain patches: %u", stats.TerrainPatches);
+        ImGui::Text("Pipeline state changes: %u", stats.PipelineStateChanges);
+        ImGui::Text("Pipeline states: %u", stats.PipelineStateCount);
+        ImGui::Text("Occlusion queries: %u", stats.OcclusionQueries);
+        ImGui::Text("Conditional draws: %u", stats.ConditionalDraws);
+        ImGui::Text("Uploads: %u, %.2f MB, %u stalls", stats.Uploads, static_cast<float>(stats.UploadBytes) / (1024.0f * 1024.0f), stats.UploadStalls);
+        ImGui::Text("Pending uploads: %.2f MB", static_cast<float>(stats.PendingUploadBytes) / (1024.0f * 1024.0f));
+        ImGui::Text("Pending loads: %u", stats.PendingLoads);
+        ImGui::Text("Depth pre-pass: %.3f ms", stats.DepthPrePassTime);
+        ImGui::Text("Geometry pass: %.3f ms", stats.GeometryPassTime);
+        ImGui::Text("Lighting pass: %.3f ms", stats.LightingPassTime);
+
+        if (auto &scene = Editor::Get().GetActiveScene(); scene != nullptr && !scene->GetStaticBatch().IsEmpty())
+        {
+            const auto &batchStats = scene->GetStaticBatch().GetStatistics();
+            ImGui::Text("Static meshes: %u", batchStats.Meshes);
+            ImGui::Text("Static clusters: %u / %u", batchStats.VisibleClusters, batchStats.Clusters);
+        }
+        if (auto &scene = Editor::Get().GetActiveScene(); scene != nullptr)
+        {
+            auto &occlusionCuller = scene->GetOcclusionCuller();
+            bool occlusionCulling = occlusionCuller.IsEnabled();
+            if (ImGui::Checkbox("Occlusion culling", &occlusionCulling))
+                occlusionCuller.SetEnabled(occlusionCulling);
+            const auto &occlusionStats = occlusionCuller.GetStatistics();
+            ImGui::Text("Occlusion objects: %u, %u predicated, %u skipped", occlusionStats.Objects, occlusionStats.Predicated, occlusionStats.Skipped);
+            ImGui::Text("Occlusion queries: %u issued, %u read, %u in pool", occlusionStats.QueriesIssued, occlusionStats.ResultsRead, occlusionStats.QueryPoolSize);
+            ImGui::Text("Occlusion hit rate: %.1f%%", occlusionStats.GetHitRate() * 100.0f);
+        }
+        if (auto &scene = Editor::Get().GetActiveScene(); scene != nullptr && !scene->GetHLOD().IsEmpty())
+        {
+            const auto &hlodStats = scene->GetHLOD().GetStatistics();
+            ImGui::Text("HLOD proxies: %u / %u active, %u visible", hlodStats.ActiveProxies, hlodStats.Clusters, hlodStats.VisibleProxies);
+            ImGui::Text("HLOD triangles: %u replaced by %u", hlodStats.ReplacedTriangles, hlodStats.ProxyTriangles);
+        }
+        const auto &spriteStats = SpriteRenderer::Get().GetStatistics();
+        ImGui::Text("Sprites: %u", spriteStats.Sprites);
+        ImGui::Text("Sprite batches: %u", spriteStats.Batches);
+
+        ImGui::Separator();
+        auto &textureStreamer = TextureStreamer::Get();
+        const auto &streamingStats = textureStreamer.GetStatistics();
+        constexpr float megabyte = 1024.0f * 1024.0f;
+        int budget = static_cast<int>(textureStreamer.GetBudget() / (1024 * 1024));
+        if (ImGui::DragInt("Texture budget (MB)", &budget, 1.0f, 16, 16384))
+            textureStreamer.SetBudget(static_cast<uint64_t>(budget) * 1024 * 1024);
+        float usage = static_cast<float>(streamingStats.ResidentBytes) / static_cast<float>(textureStreamer.GetBudget());
+        ImGui::ProgressBar(usage, { -1.0f, 0.0f }, fmt::format("{:.1f} / {} MB", static_cast<float>(streamingStats.ResidentBytes) / megabyte, budget).c_str());
+        ImGui::Text("Textures: %u, %u streaming", streamingStats.Textures, streamingStats.Streaming);
+        ImGui::Text("Texture detail wanted: %.1f MB, %u mips dropped to fit", static_cast<float>(streamingStats.WantedBytes) / megabyte, streamingStats.MipBias);
+        if (ImGui::TreeNode("Resident mips"))
+        {
+            const auto &database = AssetManager::Get().GetAssetDatabase();
+            for (auto &[texture, entry] : textureStreamer.GetEntries())
+            {
+                if (entry.Lifetime.expired()) continue;
+                auto it = database.find(texture->GetAssetId());
+                std::string name = it != database.end() ? it->second.Filepath.stem().string() : fmt::format("{}", static_cast<uint64_t>(texture->GetAssetId()));
+                uint32_t count = texture->GetMipCount();
+                uint32_t resident = texture->GetResidentMip();
+                if (resident >= count)
+                {
+                    ImGui::Text("%s: loading", name.c_str());
+                    continue;
+                }
+                ImGui::Text("%s: mips %u-%u of %u, %ux%u, wants %u%s", name.c_str(), resident, count - 1, count,
+                    texture->GetMipWidth(resident), texture->GetMipHeight(resident), entry.WantedMip, texture->IsStreaming() ? ", streaming" : "");
+            }
+            ImGui::TreePop();
+        }
+
+        ImGui::Separator();
+        ImGui::Text("Opaque time with pre-pass: %.3f ms", stats.OpaqueTimeWithPrePass);
+        ImGui::Text("Opaque time without pre-pass: %.3f ms", stats.OpaqueTimeWithoutPrePass);
+    }
+}
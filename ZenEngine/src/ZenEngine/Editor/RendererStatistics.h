@@ -0,0 +1,14 @@
+#pragma once
+
+#include "Editor.h"
+
+namespace ZenEngine
+{
+
+    class RendererStatistics : public EditorWindow
+    {
+    public:
+        RendererStatistics() : EditorWindow("Renderer Statistics", false) {}
+        virtual void OnRenderWindow() override;
+    };
+}
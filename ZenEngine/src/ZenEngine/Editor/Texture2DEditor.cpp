@@ -1,25 +1,80 @@
 #include "Texture2DEditor.h"
 
 #include "EditorGUI.h"
+#include "ZenEngine/Renderer/ResourceRegistry.h"
+#include "ZenEngine/Renderer/TextureStreamer.h"
+
+#include <limits>
 
 namespace ZenEngine
 {
+    static const char *FormatName(Texture2D::Format inFormat)
+    {
+        switch (inFormat)
+        {
+        case Texture2D::Format::None: return "None";
+        case Texture2D::Format::R8: return "R8";
+        case Texture2D::Format::RGB8: return "RGB";
+        case Texture2D::Format::RGBA8: return "RGBA8";
+        case Texture2D::Format::RGBA32F: return "RGBA32F";
+        case Texture2D::Format::R32F: return "R32F";
+        case Texture2D::Format::BC1: return "BC1";
+        case Texture2D::Format::BC3: return "BC3";
+        case Texture2D::Format::BC4: return "BC4";
+        case Texture2D::Format::BC5: return "BC5";
+        case Texture2D::Format::BC7: return "BC7";
+        default: return "Unknown";
+        }
+    }
 
     void Texture2DEditor::OnRenderWindow()
     {
-        auto id = mAssetInstance->CreateOrGetTexture2D()->GetRendererID();
+        auto id = ResourceRegistry::Get().Resolve(mAssetInstance->CreateOrGetTexture2D())->GetRendererID();
+        // shown at its full size
+        TextureStreamer::Get().Request(*mAssetInstance, std::numeric_limits<float>::max());
         auto props = mAssetInstance->GetTextureProperties();
         ImGui::Image(reinterpret_cast<void*>(id), { (float)props.Width, (float)props.Height }, { 0 , 1 }, { 1, 0 });
 
         EditorGUI::SelectableText("Width", fmt::format("{}", props.Width).c_str());
         EditorGUI::SelectableText("Height", fmt::format("{}", props.Height).c_str());
-        switch (props.Format)
+        EditorGUI::SelectableText("Format", FormatName(props.Format));
+        EditorGUI::SelectableText("Level format", FormatName(mAssetInstance->GetLevelFormat()));
+        EditorGUI::SelectableText("Size", fmt::format("{:.2f} MB", static_cast<double>(mAssetInstance->GetMipChainBytes(0)) / (1024.0 * 1024.0)));
+
+        ImGui::Separator();
+        static const char *filterNames[] = { "Box", "Kaiser", "Lanczos" };
+        int filter = static_cast<int>(mMipSettings.Filter);
+        if (ImGui::Combo("Mip filter", &filter, filterNames, IM_ARRAYSIZE(filterNames)))
+            mMipSettings.Filter = static_cast<MipGenerator::Filter>(filter);
+        ImGui::Checkbox("sRGB", &mMipSettings.SRGB);
+
+        static constexpr Texture2D::Format compressionFormats[] = { Texture2D::Format::None, Texture2D::Format::BC1, Texture2D::Format::BC3, Texture2D::Format::BC4, Texture2D::Format::BC5, Texture2D::Format::BC7 };
+        if (ImGui::BeginCombo("Compression", FormatName(mCompression.Format)))
+        {
+            for (auto format : compressionFormats)
+                if (ImGui::Selectable(FormatName(format), format == mCompression.Format)) mCompression.Format = format;
+            ImGui::EndCombo();
+        }
+        static const char *qualityNames[] = { "Fast", "Normal", "High" };
+        int quality = static_cast<int>(mCompression.Quality);
+        if (ImGui::Combo("Quality", &quality, qualityNames, IM_ARRAYSIZE(qualityNames)))
+            mCompression.Quality = static_cast<TextureCompression::Quality>(quality);
+
+        // cooking takes a while on large textures, it only runs when asked to
+        const auto &mips = mAssetInstance->GetMipSettings();
+        const auto &compression = mAssetInstance->GetCompression();
+        bool mipsChanged = mips.Filter != mMipSettings.Filter || mips.SRGB != mMipSettings.SRGB;
+        bool compressionChanged = compression.Format != mCompression.Format || compression.Quality != mCompression.Quality;
+        if ((mipsChanged || compressionChanged) && ImGui::Button("Apply"))
+        {
+            mAssetInstance->SetCookSettings(mMipSettings, mCompression);
+            mSaveFailed = !AssetManager::Get().OverwriteAsset(mAssetInstance);
+        }
+        if (mSaveFailed)
         {
-        case Texture2D::Format::R8: EditorGUI::SelectableText("Format", "R8"); break;
-        case Texture2D::Format::RGB8: EditorGUI::SelectableText("Format", "RGB"); break;
-        case Texture2D::Format::RGBA8: EditorGUI::SelectableText("Format", "RGBA8"); break;
-        case Texture2D::Format::RGBA32F: EditorGUI::SelectableText("Format", "RGBA32F"); break;
-        default: EditorGUI::SelectableText("Format", "Unknown");
+            ImGui::TextColored({ 1.0f, 0.4f, 0.4f, 1.0f }, "The cooked levels could not be saved, see the log");
+            if (ImGui::Button("Save again"))
+                mSaveFailed = !AssetManager::Get().OverwriteAsset(mAssetInstance);
         }
     }
 }
\ No newline at end of file
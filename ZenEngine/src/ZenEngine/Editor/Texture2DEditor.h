@@ -8,7 +8,17 @@ namespace ZenEngine
     class Texture2DEditor : public AssetEditorFor<Texture2DAsset>
     {
     public:
-        Texture2DEditor(UUID inUUID) : AssetEditorFor(inUUID) {}
+        Texture2DEditor(UUID inUUID) : AssetEditorFor(inUUID)
+        {
+            mMipSettings = mAssetInstance->GetMipSettings();
+            mCompression = mAssetInstance->GetCompression();
+        }
         virtual void OnRenderWindow() override;
+    private:
+        // edited here, the levels are only cooked again when they are applied
+        Texture2DAsset::MipSettings mMipSettings;
+        Texture2DAsset::Compression mCompression;
+        // the levels were cooked but could not be written over the asset file
+        bool mSaveFailed = false;
     };
 }
\ No newline at end of file
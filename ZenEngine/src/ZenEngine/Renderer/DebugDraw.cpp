@@ -0,0 +1,199 @@
+#include "DebugDraw.h"
+
+#include <algorithm>
+#include <iterator>
+#include <glm/gtc/constants.hpp>
+
+#include "ZenEngine/Core/JobSystem.h"
+#include "ResourceRegistry.h"
+#include "Shader.h"
+#include "VertexArray.h"
+#include "VertexBuffer.h"
+
+namespace ZenEngine
+{
+    // the vertex buffer layout below has no padding
+    static_assert(sizeof(DebugDraw::Vertex) == 8 * sizeof(float));
+
+    // corner i of a box takes the max x when bit 0 is set, max y for bit 1 and max z for bit 2
+    static constexpr uint32_t sBoxEdges[] = {
+        0, 1, 2, 3, 4, 5, 6, 7,
+        0, 2, 1, 3, 4, 6, 5, 7,
+        0, 4, 1, 5, 2, 6, 3, 7
+    };
+
+    static glm::vec3 GetBoxCorner(const glm::vec3 &inMin, const glm::vec3 &inMax, uint32_t inCorner)
+    {
+        return {
+            (inCorner & 1) ? inMax.x : inMin.x,
+            (inCorner & 2) ? inMax.y : inMin.y,
+            (inCorner & 4) ? inMax.z : inMin.z
+        };
+    }
+
+    void DebugDraw::Init()
+    {
+        mThreadBuffers.clear();
+        for (uint32_t i = 0; i < JobSystem::Get().GetThreadCount(); ++i)
+            mThreadBuffers.push_back(std::make_unique<ThreadBuffer>());
+
+        mShader = ResourceRegistry::Get().Register(Shader::Create("resources/Shaders/DebugDraw.hlsl"));
+        RebuildVertexArray(1024);
+    }
+
+    void DebugDraw::Shutdown()
+    {
+        auto &registry = ResourceRegistry::Get();
+        registry.Destroy(mVertexArray);
+        registry.Destroy(mShader);
+        mVertexArray = VertexArrayHandle::Null;
+        mShader = ShaderHandle::Null;
+        mVertexBuffer.reset();
+        mVertexCapacity = 0;
+        mThreadBuffers.clear();
+    }
+
+    void DebugDraw::Line(const glm::vec3 &inFrom, const glm::vec3 &inTo, const glm::vec4 &inColor, bool inDepthTest)
+    {
+        const glm::vec3 points[] = { inFrom, inTo };
+        const uint32_t indices[] = { 0, 1 };
+        AddLines(points, indices, 2, inColor, inDepthTest);
+    }
+
+    void DebugDraw::Box(const Math::BoundingBox &inBox, const glm::vec4 &inColor, bool inDepthTest)
+    {
+        if (!inBox.IsValid()) return;
+        glm::vec3 corners[8];
+        for (uint32_t i = 0; i < 8; ++i)
+            corners[i] = GetBoxCorner(inBox.Min, inBox.Max, i);
+        AddLines(corners, sBoxEdges, 24, inColor, inDepthTest);
+    }
+
+    void DebugDraw::Box(const Math::BoundingBox &inBox, const glm::mat4 &inTransform, const glm::vec4 &inColor, bool inDepthTest)
+    {
+        if (!inBox.IsValid()) return;
+        glm::vec3 corners[8];
+        for (uint32_t i = 0; i < 8; ++i)
+            corners[i] = glm::vec3(inTransform * glm::vec4(GetBoxCorner(inBox.Min, inBox.Max, i), 1.0f));
+        AddLines(corners, sBoxEdges, 24, inColor, inDepthTest);
+    }
+
+    void DebugDraw::Sphere(const glm::vec3 &inCenter, float inRadius, const glm::vec4 &inColor, bool inDepthTest)
+    {
+        // one circle around each axis
+        glm::vec3 points[SphereSegments * 3];
+        uint32_t indices[SphereSegments * 6];
+        for (uint32_t i = 0; i < SphereSegments; ++i)
+        {
+            float angle = glm::two_pi<float>() * i / SphereSegments;
+            float c = inRadius * glm::cos(angle);
+            float s = inRadius * glm::sin(angle);
+            points[i] = inCenter + glm::vec3(c, s, 0.0f);
+            points[SphereSegments + i] = inCenter + glm::vec3(0.0f, c, s);
+            points[2 * SphereSegments + i] = inCenter + glm::vec3(s, 0.0f, c);
+        }
+        for (uint32_t circle = 0; circle < 3; ++circle)
+        {
+            uint32_t first = circle * SphereSegments;
+            for (uint32_t i = 0; i < SphereSegments; ++i)
+            {
+                indices[2 * (first + i)] = first + i;
+                indices[2 * (first + i) + 1] = first + (i + 1) % SphereSegments;
+            }
+        }
+        AddLines(points, indices, SphereSegments * 6, inColor, inDepthTest);
+    }
+
+    void DebugDraw::Frustum(const glm::mat4 &inViewProjection, const glm::vec4 &inColor, bool inDepthTest)
+    {
+        glm::mat4 inverse = glm::inverse(inViewProjection);
+        glm::vec3 corners[8];
+        for (uint32_t i = 0; i < 8; ++i)
+        {
+            glm::vec4 corner = inverse * glm::vec4(GetBoxCorner(glm::vec3(-1.0f), glm::vec3(1.0f), i), 1.0f);
+            corners[i] = glm::vec3(corner) / corner.w;
+        }
+        AddLines(corners, sBoxEdges, 24, inColor, inDepthTest);
+    }
+
+    void DebugDraw::Axes(const glm::mat4 &inTransform, float inSize, bool inDepthTest)
+    {
+        glm::vec3 origin(inTransform[3]);
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            glm::vec4 color(0.0f, 0.0f, 0.0f, 1.0f);
+            color[axis] = 1.0f;
+            Line(origin, origin + glm::vec3(inTransform[axis]) * inSize, color, inDepthTest);
+        }
+    }
+
+    void DebugDraw::HierarchyNode(const Math::BoundingBox &inBox, uint32_t inDepth, bool inDepthTest)
+    {
+        static const glm::vec4 sLevelColors[] = {
+            { 1.0f, 0.2f, 0.2f, 1.0f },
+            { 1.0f, 0.6f, 0.1f, 1.0f },
+            { 1.0f, 1.0f, 0.2f, 1.0f },
+            { 0.2f, 1.0f, 0.2f, 1.0f },
+            { 0.2f, 1.0f, 1.0f, 1.0f },
+            { 0.3f, 0.4f, 1.0f, 1.0f },
+            { 1.0f, 0.3f, 1.0f, 1.0f }
+        };
+        Box(inBox, sLevelColors[inDepth % std::size(sLevelColors)], inDepthTest);
+    }
+
+    uint32_t DebugDraw::Upload()
+    {
+        mUploadData.clear();
+        for (auto &threadBuffer : mThreadBuffers)
+        {
+            std::lock_guard lock(threadBuffer->Mutex);
+            mUploadData.insert(mUploadData.end(), threadBuffer->Vertices.begin(), threadBuffer->Vertices.end());
+            threadBuffer->Vertices.clear();
+        }
+
+        uint32_t vertexCount = static_cast<uint32_t>(mUploadData.size());
+        if (vertexCount == 0) return 0;
+
+        if (vertexCount > mVertexCapacity)
+            RebuildVertexArray(std::max(vertexCount, mVertexCapacity * 2));
+        mVertexBuffer->SetData(mUploadData.data(), vertexCount * sizeof(Vertex));
+        return vertexCount;
+    }
+
+    DebugDraw::ThreadBuffer &DebugDraw::GetThreadBuffer()
+    {
+        uint32_t index = JobSystem::GetThreadIndex();
+        return *mThreadBuffers[index < mThreadBuffers.size() ? index : 0];
+    }
+
+    void DebugDraw::AddLines(const glm::vec3 *inPoints, const uint32_t *inIndices, uint32_t inIndexCount, const glm::vec4 &inColor, bool inDepthTest)
+    {
+        if (mThreadBuffers.empty()) return;
+        float depthTest = inDepthTest ? 1.0f : 0.0f;
+
+        auto &threadBuffer = GetThreadBuffer();
+        std::lock_guard lock(threadBuffer.Mutex);
+        for (uint32_t i = 0; i < inIndexCount; ++i)
+            threadBuffer.Vertices.push_back({ inPoints[inIndices[i]], inColor, depthTest });
+    }
+
+    void DebugDraw::RebuildVertexArray(uint32_t inCapacity)
+    {
+        mVertexBuffer = VertexBuffer::Create(inCapacity * sizeof(Vertex));
+        mVertexBuffer->SetLayout({
+            { ShaderDataType::Float3, "Position" },
+            { ShaderDataType::Float4, "Color" },
+            { ShaderDataType::Float, "DepthTest" }
+        });
+        mVertexCapacity = inCapacity;
+
+        auto vertexArray = VertexArray::Create();
+        vertexArray->AddVertexBuffer(mVertexBuffer);
+
+        auto &registry = ResourceRegistry::Get();
+        if (mVertexArray.IsNull())
+            mVertexArray = registry.Register(vertexArray);
+        else
+            registry.Replace(mVertexArray, vertexArray);
+    }
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "ResourceHandle.h"
+#include "ZenEngine/Core/Math.h"
+
+namespace ZenEngine
+{
+    class VertexBuffer;
+
+    /// @brief Immediate mode lines for debugging, e.g. bounds, frustums or the nodes of a spatial structure.
+    /// Primitives can be added from any thread at any time, they are drawn over the final image by the next
+    /// Renderer::Flush in a single draw and then dropped, so they have to be added again every frame.
+    /// Depth tested primitives are hidden behind the scene geometry, the others are always visible
+    class DebugDraw
+    {
+    public:
+        struct Vertex
+        {
+            glm::vec3 Position;
+            glm::vec4 Color;
+            float DepthTest;
+        };
+
+        static DebugDraw &Get()
+        {
+            static DebugDraw instance;
+            return instance;
+        }
+
+        void Init();
+        void Shutdown();
+
+        void Line(const glm::vec3 &inFrom, const glm::vec3 &inTo, const glm::vec4 &inColor, bool inDepthTest = true);
+        void Box(const Math::BoundingBox &inBox, const glm::vec4 &inColor, bool inDepthTest = true);
+        /// @brief Oriented box, the box is in the space inTransform transforms from
+        void Box(const Math::BoundingBox &inBox, const glm::mat4 &inTransform, const glm::vec4 &inColor, bool inDepthTest = true);
+        void Sphere(const glm::vec3 &inCenter, float inRadius, const glm::vec4 &inColor, bool inDepthTest = true);
+        /// @brief Edges of the clip volume of a view projection matrix
+        void Frustum(const glm::mat4 &inViewProjection, const glm::vec4 &inColor, bool inDepthTest = true);
+        /// @brief Red, green and blue lines along the x, y and z axes of the transform
+        void Axes(const glm::mat4 &inTransform, float inSize = 1.0f, bool inDepthTest = true);
+        /// @brief Box colored by its depth in a hierarchy, so the levels of a tree can be told apart
+        void HierarchyNode(const Math::BoundingBox &inBox, uint32_t inDepth, bool inDepthTest = true);
+
+        /// @brief Moves everything added so far to the GPU, returns the number of line vertices to draw
+        uint32_t Upload();
+
+        VertexArrayHandle GetVertexArray() const { return mVertexArray; }
+        ShaderHandle GetShader() const { return mShader; }
+    private:
+        // one per job system thread so the workers rarely contend, threads outside the pool share the first one
+        struct alignas(64) ThreadBuffer
+        {
+            std::mutex Mutex;
+            std::vector<Vertex> Vertices;
+        };
+
+        static constexpr uint32_t SphereSegments = 32;
+
+        std::vector<std::unique_ptr<ThreadBuffer>> mThreadBuffers;
+        std::vector<Vertex> mUploadData;
+
+        ShaderHandle mShader;
+        std::shared_ptr<VertexBuffer> mVertexBuffer;
+        uint32_t mVertexCapacity = 0;
+        VertexArrayHandle mVertexArray;
+
+        ThreadBuffer &GetThreadBuffer();
+        void AddLines(const glm::vec3 *inPoints, const uint32_t *inIndices, uint32_t inIndexCount, const glm::vec4 &inColor, bool inDepthTest);
+        void RebuildVertexArray(uint32_t inCapacity);
+
+        DebugDraw() = default;
+        DebugDraw(const DebugDraw &) = delete;
+        DebugDraw &operator =(const DebugDraw &) = delete;
+    };
+}
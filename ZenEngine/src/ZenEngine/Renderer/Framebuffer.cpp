@@ -4,6 +4,7 @@
 
 #include "ZenEngine/Core/Macros.h"
 #include "Platform/OpenGL/OpenGLFramebuffer.h"
+#include "Platform/Software/SoftwareFramebuffer.h"
 
 namespace ZenEngine
 {
@@ -14,6 +15,7 @@ namespace ZenEngine
         {
         case RendererAPI::API::None: ZE_ASSERT_CORE_MSG(false, "RendererAPI::None is not supported!"); return nullptr;
         case RendererAPI::API::OpenGL: return std::make_unique<OpenGLFramebuffer>(inProperties);
+        case RendererAPI::API::Software: return std::make_unique<SoftwareFramebuffer>(inProperties);
         }
         ZE_ASSERT_CORE_MSG(false, "Unknown renderer API!")
     }
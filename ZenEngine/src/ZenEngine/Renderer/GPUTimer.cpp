@@ -0,0 +1,23 @@
+#include "GPUTimer.h"
+
+#include "RendererAPI.h"
+
+#include "ZenEngine/Core/Macros.h"
+
+#include "Platform/OpenGL/OpenGLGPUTimer.h"
+#include "Platform/Software/SoftwareGPUTimer.h"
+
+namespace ZenEngine
+{
+    std::unique_ptr<GPUTimer> GPUTimer::Create()
+    {
+        switch (RendererAPI::GetAPI())
+        {
+        case RendererAPI::API::None: ZE_ASSERT_CORE_MSG(false, "RendererAPI::None is not supported!"); return nullptr;
+        case RendererAPI::API::OpenGL: return std::make_unique<OpenGLGPUTimer>();
+        case RendererAPI::API::Software: return std::make_unique<SoftwareGPUTimer>();
+        }
+        ZE_ASSERT_CORE_MSG(false, "Unknown Renderer API!");
+        return nullptr;
+    }
+}
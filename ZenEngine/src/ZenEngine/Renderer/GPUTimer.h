@@ -0,0 +1,23 @@
+#pragma once
+
+#include <memory>
+
+namespace ZenEngine
+{
+    /// @brief Measures the GPU time spent between Begin and End.
+    /// Results are read back a few frames late so measuring never stalls the pipeline.
+    class GPUTimer
+    {
+    public:
+        virtual ~GPUTimer() = default;
+
+        virtual void Begin() = 0;
+        virtual void End() = 0;
+
+        /// @brief Returns the most recent available measurement
+        /// @return the elapsed GPU time in milliseconds
+        virtual float GetElapsedMilliseconds() const = 0;
+
+        static std::unique_ptr<GPUTimer> Create();
+    };
+}
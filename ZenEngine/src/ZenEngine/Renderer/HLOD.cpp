@@ -0,0 +1,300 @@
+#include "HLOD.h"
+
+#include <algorithm>
+#include <map>
+#include <set>
+#include <tuple>
+#include <variant>
+
+#include "ZenEngine/Asset/HLODAsset.h"
+#include "ZenEngine/Asset/ShaderAsset.h"
+#include "ZenEngine/Asset/StaticMesh.h"
+#include "ZenEngine/Asset/Texture2DAsset.h"
+#include "ZenEngine/Core/Hash.h"
+#include "ZenEngine/Core/JobSystem.h"
+#include "ZenEngine/Core/Log.h"
+#include "Material.h"
+#include "Renderer.h"
+#include "ResourceRegistry.h"
+#include "VertexArray.h"
+#include "VertexBuffer.h"
+#include "IndexBuffer.h"
+
+namespace ZenEngine
+{
+    namespace
+    {
+        // 21 bits per axis, enough for a million cells either side of the origin
+        uint64_t PackCell(const glm::ivec3 &inCell)
+        {
+            auto pack = [](int32_t inValue) { return static_cast<uint64_t>(inValue + (1 << 20)) & 0x1FFFFFu; };
+            return (pack(inCell.x) << 42) | (pack(inCell.y) << 21) | pack(inCell.z);
+        }
+
+        uint64_t GetClusterKey(const glm::ivec3 &inCell, uint64_t inMaterialKey)
+        {
+            uint64_t key = PackCell(inCell);
+            Hash::Combine(key, inMaterialKey);
+            return key;
+        }
+
+        // the dominant axis of the normal and its sign, so opposite faces of a thin wall never share a vertex
+        uint64_t GetNormalBucket(const glm::vec3 &inNormal)
+        {
+            glm::vec3 absolute = glm::abs(inNormal);
+            int32_t axis = absolute.x >= absolute.y && absolute.x >= absolute.z ? 0 : (absolute.y >= absolute.z ? 1 : 2);
+            return static_cast<uint64_t>(axis * 2 + (inNormal[axis] < 0.0f ? 1 : 0));
+        }
+
+        /// @brief Vertex clustering: the vertices of the members are snapped to a grid of voxels, all the vertices
+        /// of a voxel become their average and the triangles that collapse are dropped. The texture coordinate is
+        /// the one of the first vertex, an average across meshes or a seam lands on texels none of them used
+        void SimplifyCluster(const std::vector<const HLODBuilder::Input*> &inMembers, const glm::vec3 &inOrigin, float inVoxelSize, HLODAsset::Cluster &outCluster)
+        {
+            struct Accumulator
+            {
+                glm::vec3 Position = glm::vec3(0.0f);
+                glm::vec3 Normal = glm::vec3(0.0f);
+                glm::vec2 TexCoord = glm::vec2(0.0f);
+                uint32_t Count = 0;
+            };
+
+            constexpr int32_t maxVoxel = (1 << 20) - 1;
+            std::unordered_map<uint64_t, uint32_t> voxels;
+            std::vector<Accumulator> accumulators;
+            std::set<std::tuple<uint32_t, uint32_t, uint32_t>> triangles;
+            std::vector<uint32_t> remap;
+
+            for (const auto *member : inMembers)
+            {
+                const auto &vertices = member->Mesh->GetVertices();
+                const auto &indices = member->Mesh->GetIndices();
+                glm::mat3 normalMatrix = glm::transpose(glm::inverse(glm::mat3(member->Transform)));
+
+                remap.resize(vertices.size());
+                for (size_t i = 0; i < vertices.size(); ++i)
+                {
+                    glm::vec3 position = glm::vec3(member->Transform * glm::vec4(vertices[i].Position, 1.0f));
+                    glm::vec3 normal = glm::normalize(normalMatrix * vertices[i].Normal);
+                    glm::ivec3 voxel = glm::clamp(glm::ivec3(glm::floor((position - inOrigin) / inVoxelSize)), glm::ivec3(0), glm::ivec3(maxVoxel));
+                    uint64_t key = (static_cast<uint64_t>(voxel.x) << 43) | (static_cast<uint64_t>(voxel.y) << 23) | (static_cast<uint64_t>(voxel.z) << 3) | GetNormalBucket(normal);
+
+                    auto [it, inserted] = voxels.try_emplace(key, static_cast<uint32_t>(accumulators.size()));
+                    if (inserted) accumulators.emplace_back();
+                    auto &accumulator = accumulators[it->second];
+                    accumulator.Position += position;
+                    accumulator.Normal += normal;
+                    if (accumulator.Count == 0) accumulator.TexCoord = vertices[i].TexCoord;
+                    ++accumulator.Count;
+                    remap[i] = it->second;
+                }
+
+                outCluster.SourceTriangles += static_cast<uint32_t>(indices.size() / 3);
+                for (size_t i = 0; i + 2 < indices.size(); i += 3)
+                {
+                    uint32_t a = remap[indices[i]];
+                    uint32_t b = remap[indices[i + 1]];
+                    uint32_t c = remap[indices[i + 2]];
+                    if (a == b || b == c || a == c) continue;
+                    // rotate the smallest index first, which keeps the winding, so duplicates compare equal
+                    if (b < a && b < c) std::tie(a, b, c) = std::make_tuple(b, c, a);
+                    else if (c < a && c < b) std::tie(a, b, c) = std::make_tuple(c, a, b);
+                    if (!triangles.insert({ a, b, c }).second) continue;
+                    outCluster.Indices.insert(outCluster.Indices.end(), { a, b, c });
+                }
+            }
+
+            outCluster.Vertices.reserve(accumulators.size());
+            for (const auto &accumulator : accumulators)
+            {
+                float weight = 1.0f / static_cast<float>(accumulator.Count);
+                float length = glm::length(accumulator.Normal);
+                glm::vec3 normal = length > 1e-6f ? accumulator.Normal / length : glm::vec3(0.0f, 1.0f, 0.0f);
+                outCluster.Vertices.push_back({ accumulator.Position * weight, normal, accumulator.TexCoord });
+            }
+        }
+    }
+
+    std::shared_ptr<HLODAsset> HLODBuilder::Bake(const std::vector<Input> &inInputs, const Settings &inSettings)
+    {
+        auto asset = std::make_shared<HLODAsset>();
+        asset->CellSize = std::max(inSettings.CellSize, 1e-3f);
+        asset->SwitchDistance = inSettings.SwitchDistance;
+        float voxelSize = std::max(inSettings.VoxelSize, 1e-3f);
+
+        // the meshes cache their bounds the first time they are asked for, so the grouping stays on this thread.
+        // Each material gets its own proxy, a proxy is drawn with a single one
+        struct Group
+        {
+            glm::ivec3 Cell;
+            uint64_t MaterialKey;
+            Math::BoundingBox Bounds;
+            std::vector<const Input*> Members;
+        };
+        std::unordered_map<uint64_t, size_t> cellGroups;
+        std::vector<Group> groups;
+        for (const auto &input : inInputs)
+        {
+            if (input.Mesh == nullptr || input.Mat == nullptr || input.Mesh->GetIndices().empty()) continue;
+            Math::BoundingBox bounds = input.Mesh->GetBounds().Transform(input.Transform);
+            glm::ivec3 cell = asset->GetCell(bounds);
+            uint64_t materialKey = GetMaterialKey(*input.Mat);
+            auto [it, inserted] = cellGroups.try_emplace(GetClusterKey(cell, materialKey), groups.size());
+            if (inserted) groups.push_back({ cell, materialKey, {}, {} });
+            groups[it->second].Bounds.Extend(bounds);
+            groups[it->second].Members.push_back(&input);
+        }
+        std::erase_if(groups, [&inSettings](const Group &inGroup) { return inGroup.Members.size() < std::max(inSettings.MinMeshes, 1u); });
+
+        asset->Clusters.resize(groups.size());
+        JobSystem::Get().ParallelFor(static_cast<uint32_t>(groups.size()), 1, [&](uint32_t inBegin, uint32_t inEnd)
+        {
+            for (uint32_t i = inBegin; i < inEnd; ++i)
+            {
+                auto &cluster = asset->Clusters[i];
+                cluster.Cell = groups[i].Cell;
+                cluster.MaterialKey = groups[i].MaterialKey;
+                // the switch distance is measured to the meshes the proxy stands for
+                cluster.Bounds = groups[i].Bounds;
+                SimplifyCluster(groups[i].Members, groups[i].Bounds.Min, voxelSize, cluster);
+            }
+        });
+        // a voxel larger than the meshes collapses every triangle, such a cell keeps its meshes
+        std::erase_if(asset->Clusters, [](const HLODAsset::Cluster &inCluster) { return inCluster.Indices.empty(); });
+
+        uint32_t sourceTriangles = 0;
+        uint32_t proxyTriangles = 0;
+        for (const auto &cluster : asset->Clusters)
+        {
+            sourceTriangles += cluster.SourceTriangles;
+            proxyTriangles += static_cast<uint32_t>(cluster.Indices.size() / 3);
+        }
+        ZE_CORE_INFO("HLOD bake: {} meshes, {} proxies, {} triangles simplified to {}", inInputs.size(), asset->Clusters.size(), sourceTriangles, proxyTriangles);
+        return asset;
+    }
+
+    uint64_t HLODBuilder::GetMaterialKey(const Material &inMaterial)
+    {
+        // FNV-1a rather than std::hash, the key is saved with the bake. The maps are walked by name so their order does not matter
+        uint64_t key = Hash::Bytes(nullptr, 0);
+        auto add = [&key](const void *inData, size_t inSize) { key = Hash::Bytes(inData, inSize, key); };
+        auto addId = [&add](UUID inId) { uint64_t id = static_cast<uint64_t>(inId); add(&id, sizeof(id)); };
+
+        addId(inMaterial.GetShader() != nullptr ? inMaterial.GetShader()->GetAssetId() : UUID(0));
+        std::map<std::string, const MaterialParameter*> parameters;
+        for (const auto &[name, parameter] : inMaterial.GetParameters())
+            parameters[name] = &parameter;
+        for (const auto &[name, parameter] : parameters)
+        {
+            add(name.data(), name.size());
+            std::visit([&add](const auto &inValue) { add(&inValue, sizeof(inValue)); }, parameter->Value);
+        }
+        // a texture that is still loading counts as none
+        std::map<std::string, UUID> textures;
+        for (const auto &[name, texture] : inMaterial.GetTextures())
+            textures[name] = texture.Asset != nullptr ? texture.Asset->GetAssetId() : UUID(0);
+        for (const auto &[name, id] : textures)
+        {
+            add(name.data(), name.size());
+            addId(id);
+        }
+        return key;
+    }
+
+    HLODSet::~HLODSet()
+    {
+        Clear();
+    }
+
+    void HLODSet::Load(const std::shared_ptr<HLODAsset> &inAsset)
+    {
+        Clear();
+        if (inAsset == nullptr) return;
+        mAsset = inAsset;
+
+        for (auto &cluster : mAsset->Clusters)
+        {
+            if (cluster.Indices.empty()) continue;
+            auto vertexArray = VertexArray::Create();
+            VertexStreams::Create(cluster.Vertices).AddTo(*vertexArray);
+            vertexArray->SetIndexBuffer(IndexBuffer::Create(cluster.Indices));
+
+            Proxy proxy;
+            proxy.VertexArray = ResourceRegistry::Get().Register(vertexArray);
+            proxy.Bounds = cluster.Bounds;
+            proxy.Triangles = static_cast<uint32_t>(cluster.Indices.size() / 3);
+            proxy.SourceTriangles = cluster.SourceTriangles;
+            mCellClusters[GetClusterKey(cluster.Cell, cluster.MaterialKey)] = static_cast<int32_t>(mProxies.size());
+            mProxies.push_back(std::move(proxy));
+        }
+        mStatistics.Clusters = static_cast<uint32_t>(mProxies.size());
+    }
+
+    void HLODSet::Clear()
+    {
+        auto &registry = ResourceRegistry::Get();
+        for (auto &proxy : mProxies)
+            registry.Destroy(proxy.VertexArray);
+        mProxies.clear();
+        mCellClusters.clear();
+        mAsset = nullptr;
+        mStatistics = {};
+    }
+
+    int32_t HLODSet::FindCluster(const Math::BoundingBox &inBounds, const Material &inMaterial) const
+    {
+        if (mAsset == nullptr) return -1;
+        auto it = mCellClusters.find(GetClusterKey(mAsset->GetCell(inBounds), HLODBuilder::GetMaterialKey(inMaterial)));
+        return it != mCellClusters.end() ? it->second : -1;
+    }
+
+    void HLODSet::AddMember(int32_t inCluster, const std::shared_ptr<Material> &inMaterial)
+    {
+        if (inCluster < 0 || inCluster >= static_cast<int32_t>(mProxies.size())) return;
+        // the members share the material key, any of them draws the same
+        auto &proxy = mProxies[inCluster];
+        if (proxy.Mat == nullptr) proxy.Mat = inMaterial;
+    }
+
+    void HLODSet::Disable(int32_t inCluster)
+    {
+        if (inCluster < 0 || inCluster >= static_cast<int32_t>(mProxies.size())) return;
+        mProxies[inCluster].Disabled = true;
+        mProxies[inCluster].Active = false;
+    }
+
+    void HLODSet::Update(const glm::vec3 &inEyePosition)
+    {
+        mStatistics.ActiveProxies = 0;
+        mStatistics.ReplacedTriangles = 0;
+        mStatistics.ProxyTriangles = 0;
+        for (auto &proxy : mProxies)
+        {
+            if (proxy.Disabled || proxy.Mat == nullptr)
+            {
+                proxy.Active = false;
+                continue;
+            }
+            float distance = glm::distance(inEyePosition, glm::clamp(inEyePosition, proxy.Bounds.Min, proxy.Bounds.Max));
+            float switchDistance = proxy.Active ? mAsset->SwitchDistance * Hysteresis : mAsset->SwitchDistance;
+            proxy.Active = distance > switchDistance;
+            if (!proxy.Active) continue;
+
+            ++mStatistics.ActiveProxies;
+            mStatistics.ReplacedTriangles += proxy.SourceTriangles;
+            mStatistics.ProxyTriangles += proxy.Triangles;
+        }
+    }
+
+    void HLODSet::Submit(const Math::Frustum &inFrustum)
+    {
+        mStatistics.VisibleProxies = 0;
+        for (const auto &proxy : mProxies)
+        {
+            if (!proxy.Active || inFrustum.Test(proxy.Bounds) == Math::Frustum::Result::Outside) continue;
+            // the proxies are baked in world space
+            Renderer::Get().Submit(proxy.VertexArray, glm::mat4(1.0f), proxy.Bounds.GetCenter(), *proxy.Mat);
+            ++mStatistics.VisibleProxies;
+        }
+    }
+}
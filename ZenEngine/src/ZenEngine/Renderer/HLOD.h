@@ -0,0 +1,106 @@
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "ResourceHandle.h"
+#include "ZenEngine/Core/Math.h"
+
+namespace ZenEngine
+{
+    class StaticMesh;
+    class Material;
+    class HLODAsset;
+
+    /// @brief Offline step of the hierarchical LOD: static meshes are grouped by the cell of a uniform grid their
+    /// center falls in and by material, the meshes of each group are merged and simplified into one proxy mesh.
+    /// It only reads the meshes on the CPU, so it can run without a window or a renderer
+    class HLODBuilder
+    {
+    public:
+        struct Settings
+        {
+            float CellSize = 64.0f;
+            float SwitchDistance = 150.0f;
+            // vertices closer than this are collapsed into one, the larger the coarser the proxy
+            float VoxelSize = 1.0f;
+            // a cell with fewer meshes gains nothing from a proxy
+            uint32_t MinMeshes = 2;
+        };
+
+        struct Input
+        {
+            std::shared_ptr<StaticMesh> Mesh;
+            glm::mat4 Transform;
+            std::shared_ptr<Material> Mat;
+        };
+
+        /// @brief Builds the proxies of the meshes, the cells are simplified in parallel
+        static std::shared_ptr<HLODAsset> Bake(const std::vector<Input> &inInputs, const Settings &inSettings);
+        /// @brief The same for materials that draw the same: shader, textures and parameters. Stable across runs
+        static uint64_t GetMaterialKey(const Material &inMaterial);
+    };
+
+    /// @brief Proxies of a baked HLODAsset, drawn in place of the meshes of their cell and material once the eye is far enough
+    class HLODSet
+    {
+    public:
+        // a proxy gives way to its meshes again only this much closer than the switch distance, so it does not flicker
+        static constexpr float Hysteresis = 0.9f;
+
+        struct Statistics
+        {
+            uint32_t Clusters = 0;
+            uint32_t ActiveProxies = 0;
+            uint32_t VisibleProxies = 0;
+            // triangles of the meshes replaced by the active proxies and of the proxies themselves
+            uint32_t ReplacedTriangles = 0;
+            uint32_t ProxyTriangles = 0;
+        };
+
+        HLODSet() = default;
+        ~HLODSet();
+
+        HLODSet(const HLODSet &) = delete;
+        HLODSet &operator =(const HLODSet &) = delete;
+
+        void Load(const std::shared_ptr<HLODAsset> &inAsset);
+        void Clear();
+        bool IsEmpty() const { return mProxies.empty(); }
+        const std::shared_ptr<HLODAsset> &GetAsset() const { return mAsset; }
+
+        /// @brief Cluster replacing a mesh with these world space bounds drawn with this material, -1 if there is none
+        int32_t FindCluster(const Math::BoundingBox &inBounds, const Material &inMaterial) const;
+        /// @brief Registers a mesh of the cluster, the proxy is drawn with the material of its members
+        void AddMember(int32_t inCluster, const std::shared_ptr<Material> &inMaterial);
+        /// @brief Keeps the cluster on its meshes, for members that are drawn by something else
+        void Disable(int32_t inCluster);
+
+        /// @brief Picks the proxies to draw from the eye position, call it before querying IsProxyActive
+        void Update(const glm::vec3 &inEyePosition);
+        bool IsProxyActive(int32_t inCluster) const { return inCluster >= 0 && inCluster < static_cast<int32_t>(mProxies.size()) && mProxies[inCluster].Active; }
+        /// @brief Submits the active proxies intersecting the world space frustum to the renderer
+        void Submit(const Math::Frustum &inFrustum);
+
+        const Statistics &GetStatistics() const { return mStatistics; }
+    private:
+        struct Proxy
+        {
+            VertexArrayHandle VertexArray;
+            Math::BoundingBox Bounds;
+            uint32_t Triangles = 0;
+            uint32_t SourceTriangles = 0;
+            std::shared_ptr<Material> Mat;
+            bool Disabled = false;
+            bool Active = false;
+        };
+
+        std::shared_ptr<HLODAsset> mAsset;
+        std::vector<Proxy> mProxies;
+        // by cell and material key
+        std::unordered_map<uint64_t, int32_t> mCellClusters;
+        Statistics mStatistics;
+    };
+}
@@ -0,0 +1,197 @@
+#include "InstancedMesh.h"
+
+#include <algorithm>
+#include <xmmintrin.h>
+
+#include "ResourceRegistry.h"
+#include "VertexArray.h"
+#include "VertexBuffer.h"
+#include "IndexBuffer.h"
+
+namespace ZenEngine
+{
+    InstancedMesh::~InstancedMesh()
+    {
+        ResourceRegistry::Get().Destroy(mVertexArray);
+    }
+
+    void InstancedMesh::BoxArray::Resize(uint32_t inCount)
+    {
+        // the padding is never reported, zeros keep the math on it harmless
+        uint32_t padded = (inCount + 3) & ~3u;
+        for (auto *values : { &CenterX, &CenterY, &CenterZ, &ExtentX, &ExtentY, &ExtentZ })
+            values->assign(padded, 0.0f);
+    }
+
+    void InstancedMesh::BoxArray::Set(uint32_t inIndex, const Math::BoundingBox &inBox)
+    {
+        glm::vec3 center = inBox.GetCenter();
+        glm::vec3 extents = inBox.GetExtents();
+        CenterX[inIndex] = center.x;
+        CenterY[inIndex] = center.y;
+        CenterZ[inIndex] = center.z;
+        ExtentX[inIndex] = extents.x;
+        ExtentY[inIndex] = extents.y;
+        ExtentZ[inIndex] = extents.z;
+    }
+
+    void InstancedMesh::SetMesh(VertexArrayHandle inMeshVertexArray, const Math::BoundingBox &inMeshBounds)
+    {
+        mMeshVertexArray = inMeshVertexArray;
+        mMeshBounds = inMeshBounds;
+        RebuildBounds();
+        RebuildVertexArray(std::max(mInstanceCapacity, 1u));
+    }
+
+    void InstancedMesh::SetInstances(std::vector<glm::mat4> inTransforms)
+    {
+        mTransforms = std::move(inTransforms);
+        RebuildBounds();
+    }
+
+    void InstancedMesh::RebuildBounds()
+    {
+        uint32_t count = GetInstanceCount();
+        uint32_t chunkCount = (count + InstancesPerChunk - 1) / InstancesPerChunk;
+        mInstanceBounds.Resize(count);
+        mChunkBounds.Resize(chunkCount);
+        mChunkResults.resize(chunkCount);
+        mInstanceResults.resize(InstancesPerChunk);
+        mBounds = Math::BoundingBox();
+        mUploadValid = false;
+        if (!mMeshBounds.IsValid()) return;
+
+        for (uint32_t chunk = 0; chunk < chunkCount; ++chunk)
+        {
+            Math::BoundingBox chunkBounds;
+            uint32_t end = std::min((chunk + 1) * InstancesPerChunk, count);
+            for (uint32_t i = chunk * InstancesPerChunk; i < end; ++i)
+            {
+                Math::BoundingBox instanceBounds = mMeshBounds.Transform(mTransforms[i]);
+                mInstanceBounds.Set(i, instanceBounds);
+                chunkBounds.Extend(instanceBounds);
+            }
+            mChunkBounds.Set(chunk, chunkBounds);
+            mBounds.Extend(chunkBounds);
+        }
+    }
+
+    void InstancedMesh::RebuildVertexArray(uint32_t inCapacity)
+    {
+        auto &registry = ResourceRegistry::Get();
+        auto *meshVertexArray = registry.Resolve(mMeshVertexArray);
+        if (meshVertexArray == nullptr) return;
+
+        mInstanceBuffer = VertexBuffer::Create(inCapacity * sizeof(glm::mat4));
+        mInstanceBuffer->SetLayout({
+            { ShaderDataType::Mat4, "InstanceTransform" }
+        });
+        mInstanceCapacity = inCapacity;
+
+        auto vertexArray = VertexArray::Create();
+        // the packed positions stay apart, the depth only passes draw the instances from them too
+        for (const auto &vertexBuffer : meshVertexArray->GetVertexBuffers())
+        {
+            if (vertexBuffer == meshVertexArray->GetPositionBuffer())
+                vertexArray->AddPositionBuffer(vertexBuffer);
+            else
+                vertexArray->AddVertexBuffer(vertexBuffer);
+        }
+        vertexArray->AddVertexBuffer(mInstanceBuffer);
+        vertexArray->SetIndexBuffer(meshVertexArray->GetIndexBuffer());
+
+        if (mVertexArray.IsNull())
+            mVertexArray = registry.Register(vertexArray);
+        else
+            registry.Replace(mVertexArray, vertexArray);
+        mUploadValid = false;
+    }
+
+    void InstancedMesh::TestBoxes(const Math::Frustum &inFrustum, const BoxArray &inBoxes, uint32_t inFirst, uint32_t inCount, Math::Frustum::Result *outResults)
+    {
+        const __m128 signMask = _mm_set1_ps(-0.0f);
+        for (uint32_t i = 0; i < inCount; i += 4)
+        {
+            uint32_t index = inFirst + i;
+            __m128 centerX = _mm_loadu_ps(&inBoxes.CenterX[index]);
+            __m128 centerY = _mm_loadu_ps(&inBoxes.CenterY[index]);
+            __m128 centerZ = _mm_loadu_ps(&inBoxes.CenterZ[index]);
+            __m128 extentX = _mm_loadu_ps(&inBoxes.ExtentX[index]);
+            __m128 extentY = _mm_loadu_ps(&inBoxes.ExtentY[index]);
+            __m128 extentZ = _mm_loadu_ps(&inBoxes.ExtentZ[index]);
+
+            __m128 outside = _mm_setzero_ps();
+            __m128 intersects = _mm_setzero_ps();
+            for (const auto &plane : inFrustum.Planes)
+            {
+                __m128 normalX = _mm_set1_ps(plane.x);
+                __m128 normalY = _mm_set1_ps(plane.y);
+                __m128 normalZ = _mm_set1_ps(plane.z);
+
+                __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(normalX, centerX), _mm_mul_ps(normalY, centerY)),
+                    _mm_add_ps(_mm_mul_ps(normalZ, centerZ), _mm_set1_ps(plane.w)));
+                __m128 radius = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_andnot_ps(signMask, normalX), extentX), _mm_mul_ps(_mm_andnot_ps(signMask, normalY), extentY)),
+                    _mm_mul_ps(_mm_andnot_ps(signMask, normalZ), extentZ));
+
+                outside = _mm_or_ps(outside, _mm_cmplt_ps(distance, _mm_xor_ps(radius, signMask)));
+                intersects = _mm_or_ps(intersects, _mm_cmplt_ps(distance, radius));
+            }
+
+            int outsideMask = _mm_movemask_ps(outside);
+            int intersectsMask = _mm_movemask_ps(intersects);
+            for (uint32_t lane = 0; lane < 4 && i + lane < inCount; ++lane)
+            {
+                if (outsideMask & (1 << lane)) outResults[i + lane] = Math::Frustum::Result::Outside;
+                else if (intersectsMask & (1 << lane)) outResults[i + lane] = Math::Frustum::Result::Intersects;
+                else outResults[i + lane] = Math::Frustum::Result::Inside;
+            }
+        }
+    }
+
+    uint32_t InstancedMesh::CullAndUpload(const Math::Frustum &inFrustum)
+    {
+        if (mVertexArray.IsNull()) return 0;
+
+        uint32_t count = GetInstanceCount();
+        uint32_t chunkCount = static_cast<uint32_t>(mChunkResults.size());
+        TestBoxes(inFrustum, mChunkBounds, 0, chunkCount, mChunkResults.data());
+
+        mVisible.clear();
+        for (uint32_t chunk = 0; chunk < chunkCount; ++chunk)
+        {
+            if (mChunkResults[chunk] == Math::Frustum::Result::Outside) continue;
+
+            uint32_t begin = chunk * InstancesPerChunk;
+            uint32_t end = std::min(begin + InstancesPerChunk, count);
+            if (mChunkResults[chunk] == Math::Frustum::Result::Inside)
+            {
+                for (uint32_t i = begin; i < end; ++i)
+                    mVisible.push_back(i);
+                continue;
+            }
+
+            TestBoxes(inFrustum, mInstanceBounds, begin, end - begin, mInstanceResults.data());
+            for (uint32_t i = begin; i < end; ++i)
+            {
+                if (mInstanceResults[i - begin] != Math::Frustum::Result::Outside)
+                    mVisible.push_back(i);
+            }
+        }
+
+        uint32_t visibleCount = static_cast<uint32_t>(mVisible.size());
+        if (visibleCount == 0) return 0;
+        if (mUploadValid && mVisible == mUploaded) return visibleCount;
+
+        if (visibleCount > mInstanceCapacity)
+            RebuildVertexArray(std::max(visibleCount, mInstanceCapacity * 2));
+
+        mUploadData.resize(visibleCount);
+        for (uint32_t i = 0; i < visibleCount; ++i)
+            mUploadData[i] = mTransforms[mVisible[i]];
+        mInstanceBuffer->SetData(mUploadData.data(), visibleCount * sizeof(glm::mat4));
+
+        mUploaded.swap(mVisible);
+        mUploadValid = true;
+        return visibleCount;
+    }
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "ResourceHandle.h"
+#include "ZenEngine/Core/Math.h"
+
+namespace ZenEngine
+{
+    class VertexBuffer;
+
+    /// @brief Many copies of one mesh drawn with a single instanced draw.
+    /// Instances are grouped in chunks of consecutive instances: culling accepts or rejects whole chunks first
+    /// and only tests the instances of the chunks crossing the frustum. Bounds are stored as structures of arrays
+    /// so four boxes are tested against a plane at once. The visible transforms are packed into a per instance buffer
+    class InstancedMesh
+    {
+    public:
+        static constexpr uint32_t InstancesPerChunk = 64;
+
+        InstancedMesh() = default;
+        ~InstancedMesh();
+
+        InstancedMesh(const InstancedMesh &) = delete;
+        InstancedMesh &operator =(const InstancedMesh &) = delete;
+
+        /// @brief The vertex and index buffers of the mesh are shared, only the instance buffer is added to them
+        void SetMesh(VertexArrayHandle inMeshVertexArray, const Math::BoundingBox &inMeshBounds);
+        /// @brief Transforms are relative to the model matrix the instances are drawn with
+        void SetInstances(std::vector<glm::mat4> inTransforms);
+
+        /// @brief Culls against a frustum in the space of the model matrix and uploads the visible instances.
+        /// Returns the number of instances to draw
+        uint32_t CullAndUpload(const Math::Frustum &inFrustum);
+
+        VertexArrayHandle GetVertexArray() const { return mVertexArray; }
+        uint32_t GetInstanceCount() const { return static_cast<uint32_t>(mTransforms.size()); }
+        /// @brief Bounds of all the instances, in the space of the model matrix
+        const Math::BoundingBox &GetBounds() const { return mBounds; }
+    private:
+        // padded to a multiple of 4 so the last boxes can be loaded as a whole SIMD lane
+        struct BoxArray
+        {
+            std::vector<float> CenterX, CenterY, CenterZ;
+            std::vector<float> ExtentX, ExtentY, ExtentZ;
+
+            void Resize(uint32_t inCount);
+            void Set(uint32_t inIndex, const Math::BoundingBox &inBox);
+        };
+
+        VertexArrayHandle mMeshVertexArray;
+        Math::BoundingBox mMeshBounds;
+
+        std::vector<glm::mat4> mTransforms;
+        BoxArray mInstanceBounds;
+        BoxArray mChunkBounds;
+        Math::BoundingBox mBounds;
+
+        std::vector<Math::Frustum::Result> mChunkResults;
+        std::vector<Math::Frustum::Result> mInstanceResults;
+        std::vector<uint32_t> mVisible;
+        // what the instance buffer holds, the upload is skipped while the visible set does not change
+        std::vector<uint32_t> mUploaded;
+        std::vector<glm::mat4> mUploadData;
+        bool mUploadValid = false;
+
+        std::shared_ptr<VertexBuffer> mInstanceBuffer;
+        uint32_t mInstanceCapacity = 0;
+        VertexArrayHandle mVertexArray;
+
+        void RebuildBounds();
+        void RebuildVertexArray(uint32_t inCapacity);
+
+        static void TestBoxes(const Math::Frustum &inFrustum, const BoxArray &inBoxes, uint32_t inFirst, uint32_t inCount, Math::Frustum::Result *outResults);
+    };
+}
@@ -1,57 +1,126 @@
 #include "Material.h"
 
+#include "ResourceRegistry.h"
+#include "Renderer.h"
 #include "ZenEngine/Asset/AssetManager.h"
+#include "ZenEngine/Asset/ShaderAsset.h"
 #include "ZenEngine/Asset/Texture2DAsset.h"
 
 namespace ZenEngine
 {
-    std::shared_ptr<Material> Material::Create(const std::shared_ptr<Shader> &inShaderProgram)
+    std::shared_ptr<Material> Material::Create(const std::shared_ptr<ShaderAsset> &inShader)
     {
-        return std::make_shared<Material>(inShaderProgram);
+        return std::make_shared<Material>(inShader);
     }
 
-    void Material::SetTexture(const std::string &inName, const std::shared_ptr<Texture2D> &inTexture)
+    void Material::SetTexture(const std::string &inName, const std::shared_ptr<Texture2DAsset> &inTexture)
     {
+        mPendingTextures.erase(inName);
         if (mTextures.contains(inName))
         {
-            mTextures[inName].Texture = inTexture;
+            mTextures[inName].Asset = inTexture;
+            mTextures[inName].Texture = inTexture->CreateOrGetTexture2D();
         }
     }
 
-    void Material::Bind()
+    void Material::SetTextureAsync(const std::string &inName, UUID inTextureId)
     {
+        mPendingTextures[inName] = inTextureId;
+        auto callback = [this, inName, inTextureId, lifetime = std::weak_ptr<bool>(mLifetime)](const std::shared_ptr<Asset> &inAsset)
+        {
+            if (lifetime.expired()) return;
+            auto pending = mPendingTextures.find(inName);
+            if (pending == mPendingTextures.end() || pending->second != inTextureId) return;
+            mPendingTextures.erase(pending);
+            if (inAsset != nullptr) SetTexture(inName, std::static_pointer_cast<Texture2DAsset>(inAsset));
+        };
+        AssetManager::Get().LoadAssetAsync(inTextureId, AssetRequest::Priority::Normal, std::move(callback));
+    }
+
+    bool Material::Bind()
+    {
+        auto &registry = ResourceRegistry::Get();
+        auto *shaderProgram = registry.Resolve(mShaderProgram);
+        if (shaderProgram == nullptr) return false;
+        // the shader was recompiled, the offsets and bindings of the old layout no longer apply
+        if (mShader->GetProgramRevision() != mReflectedRevision)
+            Reflect();
+
         for (auto &[name, param] : mParameters)
         {
             switch (param.Info.Type)
             {
-            case MaterialDataType::Float: mShaderProgram->SetFloat(param.Info.Name, std::get<float>(param.Value)); break;
-            case MaterialDataType::Float2: mShaderProgram->SetFloat2(param.Info.Name, std::get<glm::vec2>(param.Value)); break;
-            case MaterialDataType::Float3: mShaderProgram->SetFloat3(param.Info.Name, std::get<glm::vec3>(param.Value)); break;
-            case MaterialDataType::Float4: mShaderProgram->SetFloat4(param.Info.Name, std::get<glm::vec4>(param.Value)); break;
-            case MaterialDataType::Int: mShaderProgram->SetInt(param.Info.Name, std::get<int32_t>(param.Value)); break;
-            case MaterialDataType::Mat4: mShaderProgram->SetMat4(param.Info.Name, std::get<glm::mat4>(param.Value)); break;
+            case MaterialDataType::Float: shaderProgram->SetFloat(param.Info.Name, std::get<float>(param.Value)); break;
+            case MaterialDataType::Float2: shaderProgram->SetFloat2(param.Info.Name, std::get<glm::vec2>(param.Value)); break;
+            case MaterialDataType::Float3: shaderProgram->SetFloat3(param.Info.Name, std::get<glm::vec3>(param.Value)); break;
+            case MaterialDataType::Float4: shaderProgram->SetFloat4(param.Info.Name, std::get<glm::vec4>(param.Value)); break;
+            case MaterialDataType::Int: shaderProgram->SetInt(param.Info.Name, std::get<int32_t>(param.Value)); break;
+            case MaterialDataType::Mat4: shaderProgram->SetMat4(param.Info.Name, std::get<glm::mat4>(param.Value)); break;
             default: ZE_ASSERT_CORE_MSG(false, "The parameter type is not currently supported!");
             }
         }
 
         for (auto &[_, texture]: mTextures)
         {
-            ZE_ASSERT_CORE_MSG(texture.Texture != nullptr, "Texture is null!");
-            texture.Texture->Bind(texture.Info.Binding);
+            auto *texture2D = registry.Resolve(texture.Texture);
+            ZE_ASSERT_CORE_MSG(texture2D != nullptr, "Texture is null!");
+            texture2D->Bind(texture.Info.Binding);
+        }
+        return true;
+    }
+
+    bool Material::IsReady() const
+    {
+        return ResourceRegistry::Get().Resolve(mShaderProgram) != nullptr;
+    }
+
+    void Material::SetPipelineDescription(const PipelineState &inDescription)
+    {
+        mPipelineDescription = inDescription;
+        mPipelineDescription.Shader = mShaderProgram;
+        mPipelineState = InvalidPipelineState;
+    }
+
+    PipelineStateId Material::GetPipelineState(uint64_t inVertexLayout)
+    {
+        auto &cache = Renderer::Get().GetPipelineStateCache();
+        if (mPipelineState == InvalidPipelineState || cache.Get(mPipelineState).VertexLayout != inVertexLayout)
+        {
+            mPipelineDescription.VertexLayout = inVertexLayout;
+            mPipelineState = cache.CreateOrGet(mPipelineDescription);
         }
-        mShaderProgram->Bind();
+        return mPipelineState;
     }
 
     void Material::Unbind()
     {
-        mShaderProgram->Unbind();
+        if (auto *shaderProgram = ResourceRegistry::Get().Resolve(mShaderProgram))
+            shaderProgram->Unbind();
+    }
+
+    Material::Material(const std::shared_ptr<ShaderAsset> &inShader)
+        : mShader(inShader), mShaderProgram(inShader->CreateOrGetShaderProgram())
+    {
+        mPipelineDescription.Shader = mShaderProgram;
+        Reflect();
     }
 
-    Material::Material(const std::shared_ptr<Shader> &inShaderProgram)
-        : mShaderProgram(inShaderProgram)
+    void Material::Reflect()
     {
-        for (auto &[name, info] : inShaderProgram->GetShaderUniformInfo())
+        mReflectedRevision = mShader->GetProgramRevision();
+        auto *shaderProgram = ResourceRegistry::Get().Resolve(mShaderProgram);
+        if (shaderProgram == nullptr) return;
+
+        auto oldParameters = std::move(mParameters);
+        mParameters.clear();
+        for (auto &[name, info] : shaderProgram->GetShaderUniformInfo())
         {
+            auto old = oldParameters.find(name);
+            if (old != oldParameters.end() && old->second.Info.Type == info.Type)
+            {
+                mParameters[name] = { info, old->second.Value };
+                continue;
+            }
             mParameters[name] = { info };
             switch (info.Type)
             {
@@ -70,11 +139,23 @@ namespace ZenEngine
             }
         }
 
-        for (auto &[name, info] : inShaderProgram->GetShaderTextureInfo())
+        auto oldTextures = std::move(mTextures);
+        mTextures.clear();
+        std::shared_ptr<Texture2DAsset> defaultTexture;
+        for (auto &[name, info] : shaderProgram->GetShaderTextureInfo())
         {
+            auto old = oldTextures.find(name);
+            if (old != oldTextures.end())
+            {
+                mTextures[name] = { info, old->second.Asset, old->second.Texture };
+                continue;
+            }
+            if (defaultTexture == nullptr)
+                defaultTexture = AssetManager::Get().LoadAssetAs<Texture2DAsset>(1);
             mTextures[name].Info = info;
-            mTextures[name].Texture = AssetManager::Get().LoadAssetAs<Texture2DAsset>(1)->CreateOrGetTexture2D();
+            mTextures[name].Asset = defaultTexture;
+            mTextures[name].Texture = defaultTexture->CreateOrGetTexture2D();
         }
     }
 
-}
\ No newline at end of file
+}
@@ -5,6 +5,9 @@
 
 #include "Shader.h"
 #include "Texture2D.h"
+#include "ResourceHandle.h"
+#include "PipelineState.h"
+#include "ZenEngine/Asset/UUID.h"
 #include "ZenEngine/ShaderCompiler/ShaderReflector.h"
 #include "ZenEngine/Core/Macros.h" 
 
@@ -26,10 +29,15 @@ namespace ZenEngine
         ValueType Value;
     };
 
+    class ShaderAsset;
+    class Texture2DAsset;
+
     struct MaterialTexture
     {
         MaterialTextureInfo Info;
-        std::shared_ptr<Texture2D> Texture;
+        // keeps the asset that owns the texture alive
+        std::shared_ptr<Texture2DAsset> Asset;
+        Texture2DHandle Texture;
     };
 
 #pragma region "Type conversions"
@@ -110,8 +118,8 @@ namespace ZenEngine
     class Material
     {
     public:
-        Material(const std::shared_ptr<Shader> &inShaderProgram);
-        static std::shared_ptr<Material> Create(const std::shared_ptr<Shader> &inShaderProgram);
+        Material(const std::shared_ptr<ShaderAsset> &inShader);
+        static std::shared_ptr<Material> Create(const std::shared_ptr<ShaderAsset> &inShader);
 
         template <MaterialDataType DataType>
         void Set(const std::string &inName, const typename MaterialDataTypeCppType<DataType>::Type &inValue)
@@ -127,18 +135,49 @@ namespace ZenEngine
             return std::get<typename MaterialDataTypeCppType<DataType>::Type>(mParameters[inName].Value);
         }
 
-        void SetTexture(const std::string &inName, const std::shared_ptr<Texture2D> &inTexture);
+        void SetTexture(const std::string &inName, const std::shared_ptr<Texture2DAsset> &inTexture);
+        /// @brief Loads the texture in the background, the one set before stays until it is done.
+        /// Setting the texture again in the meantime wins over the load
+        void SetTextureAsync(const std::string &inName, UUID inTextureId);
 
         const std::unordered_map<std::string, MaterialParameter> &GetParameters() const { return mParameters; }
         const std::unordered_map<std::string, MaterialTexture> &GetTextures() const { return mTextures; } 
 
-        void Bind();
+        // binds parameters and textures, the shader itself is bound through the pipeline state.
+        // returns false if the shader is gone, in which case nothing should be drawn with this material
+        bool Bind();
         void Unbind();
+        // false while the shader has no program, e.g. it is still compiling. Bind fails then
+        bool IsReady() const;
+
+        const std::shared_ptr<ShaderAsset> &GetShader() const { return mShader; }
+        ShaderHandle GetShaderProgram() const { return mShaderProgram; }
+
+        const PipelineState &GetPipelineDescription() const { return mPipelineDescription; }
+        // the shader in the description is ignored, a material always renders with its own shader
+        void SetPipelineDescription(const PipelineState &inDescription);
+
+        // returns the cached pipeline state for drawing geometry with the given vertex layout
+        PipelineStateId GetPipelineState(uint64_t inVertexLayout);
 
     private:
+        /// @brief Builds the parameters and texture slots from the program behind the handle.
+        /// Values and textures whose name and type are still there are kept
+        void Reflect();
+
         std::unordered_map<std::string, MaterialParameter> mParameters;
         std::unordered_map<std::string, MaterialTexture> mTextures;
+        // the textures being loaded for each name, only the last one asked for is applied
+        std::unordered_map<std::string, UUID> mPendingTextures;
+        // expires with the material, the load callbacks only hold it weakly
+        std::shared_ptr<bool> mLifetime = std::make_shared<bool>(true);
     
-        std::shared_ptr<Shader> mShaderProgram;
+        std::shared_ptr<ShaderAsset> mShader;
+        ShaderHandle mShaderProgram;
+        // program revision of the shader asset the parameters were reflected from
+        uint32_t mReflectedRevision = 0;
+
+        PipelineState mPipelineDescription;
+        PipelineStateId mPipelineState = InvalidPipelineState;
     };
 }
\ No newline at end of file
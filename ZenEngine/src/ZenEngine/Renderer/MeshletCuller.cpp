@@ -0,0 +1,73 @@
+#include "MeshletCuller.h"
+
+#include "ZenEngine/Asset/StaticMesh.h"
+#include "ZenEngine/Core/JobSystem.h"
+#include "Material.h"
+#include "Renderer.h"
+
+namespace ZenEngine
+{
+    void MeshletCuller::Add(StaticMesh &inMesh, VertexArrayHandle inVertexArray, const glm::mat4 &inTransform, Material &inMaterial)
+    {
+        if (mItemCount == mItems.size())
+            mItems.emplace_back();
+        Item &item = mItems[mItemCount++];
+        item.Mesh = &inMesh;
+        item.VertexArray = inVertexArray;
+        item.Transform = inTransform;
+        item.Mat = &inMaterial;
+        // the meshlets are built here if needed, the jobs only read them
+        inMesh.GetMeshlets();
+    }
+
+    void MeshletCuller::Submit(const Math::Frustum &inViewFrustum, const glm::vec3 &inEyePosition)
+    {
+        JobSystem::Get().ParallelFor(mItemCount, 1, [&](uint32_t inBegin, uint32_t inEnd)
+        {
+            for (uint32_t i = inBegin; i < inEnd; ++i)
+                Cull(mItems[i], inViewFrustum, inEyePosition);
+        });
+
+        mStatistics = {};
+        for (uint32_t i = 0; i < mItemCount; ++i)
+        {
+            Item &item = mItems[i];
+            mStatistics.Meshlets += static_cast<uint32_t>(item.Mesh->GetMeshlets().size());
+            mStatistics.VisibleMeshlets += item.VisibleMeshlets;
+            if (!item.Ranges.empty())
+                Renderer::Get().SubmitRanges(item.VertexArray, item.Ranges.data(), static_cast<uint32_t>(item.Ranges.size()), item.Transform, *item.Mat);
+        }
+        mItemCount = 0;
+    }
+
+    void MeshletCuller::Cull(Item &ioItem, const Math::Frustum &inViewFrustum, const glm::vec3 &inEyePosition)
+    {
+        ioItem.Ranges.clear();
+        ioItem.VisibleMeshlets = 0;
+
+        // the tests run in the space of the mesh, where the meshlet bounds and cones are
+        Math::Frustum frustum = inViewFrustum;
+        for (auto &plane : frustum.Planes)
+            plane = plane * ioItem.Transform;
+        glm::vec3 eye = glm::vec3(glm::inverse(ioItem.Transform) * glm::vec4(inEyePosition, 1.0f));
+        bool cullBackFaces = ioItem.Mat->GetPipelineDescription().Cull == RendererAPI::CullMode::Back;
+
+        for (const auto &meshlet : ioItem.Mesh->GetMeshlets())
+        {
+            if (frustum.Test(meshlet.Bounds) == Math::Frustum::Result::Outside) continue;
+            if (cullBackFaces)
+            {
+                // the whole bounding sphere sees only the back of the triangles
+                glm::vec3 toCenter = meshlet.Bounds.GetCenter() - eye;
+                float radius = glm::length(meshlet.Bounds.GetExtents());
+                if (glm::dot(toCenter, meshlet.ConeAxis) >= meshlet.ConeCutoff * glm::length(toCenter) + radius) continue;
+            }
+
+            ++ioItem.VisibleMeshlets;
+            if (!ioItem.Ranges.empty() && ioItem.Ranges.back().First + ioItem.Ranges.back().Count == meshlet.FirstIndex)
+                ioItem.Ranges.back().Count += meshlet.IndexCount;
+            else
+                ioItem.Ranges.push_back({ meshlet.FirstIndex, meshlet.IndexCount });
+        }
+    }
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "RendererAPI.h"
+#include "ResourceHandle.h"
+#include "ZenEngine/Core/Math.h"
+
+namespace ZenEngine
+{
+    class StaticMesh;
+    class Material;
+
+    /// @brief Culls the meshlets of static meshes and submits only the visible index ranges.
+    /// Meshes are added for the frame and culled on the job system, a mesh per job. Meshlets are tested against
+    /// the frustum and, for materials that cull back faces, against their normal cone. Consecutive visible
+    /// meshlets are merged, so a mesh costs one draw with as many ranges as there are gaps between them
+    class MeshletCuller
+    {
+    public:
+        struct Statistics
+        {
+            uint32_t Meshlets = 0;
+            uint32_t VisibleMeshlets = 0;
+        };
+
+        /// @brief The mesh and the material must stay alive until Submit
+        void Add(StaticMesh &inMesh, VertexArrayHandle inVertexArray, const glm::mat4 &inTransform, Material &inMaterial);
+        /// @brief Culls everything added since the last call against the world space camera and submits it to the renderer
+        void Submit(const Math::Frustum &inViewFrustum, const glm::vec3 &inEyePosition);
+
+        const Statistics &GetStatistics() const { return mStatistics; }
+    private:
+        struct Item
+        {
+            StaticMesh *Mesh;
+            VertexArrayHandle VertexArray;
+            glm::mat4 Transform;
+            Material *Mat;
+            std::vector<RendererAPI::IndexRange> Ranges;
+            uint32_t VisibleMeshlets;
+        };
+
+        // kept across frames so the range vectors keep their capacity
+        std::vector<Item> mItems;
+        uint32_t mItemCount = 0;
+        Statistics mStatistics;
+
+        static void Cull(Item &ioItem, const Math::Frustum &inViewFrustum, const glm::vec3 &inEyePosition);
+    };
+}
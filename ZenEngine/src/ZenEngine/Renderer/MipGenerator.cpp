@@ -0,0 +1,248 @@
+#include "MipGenerator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numbers>
+#include <xmmintrin.h>
+
+#include "ZenEngine/Core/JobSystem.h"
+#include "ZenEngine/Core/Macros.h"
+
+namespace ZenEngine
+{
+    // rows of the smaller level filtered by a single job
+    static constexpr uint32_t RowsPerJob = 16;
+    // half the width of the sinc filters, in texels of the smaller level
+    static constexpr float SincRadius = 3.0f;
+    static constexpr float KaiserAlpha = 4.0f;
+
+    struct MipImage
+    {
+        uint32_t Width;
+        uint32_t Height;
+        uint32_t Channels;
+        std::vector<float> Texels;
+    };
+
+    // the texels of the larger level that make one of the smaller, the ones past the edge fold onto the last
+    struct MipTaps
+    {
+        std::vector<uint32_t> Indices;
+        std::vector<float> Weights;
+    };
+
+    static float Sinc(float inX)
+    {
+        if (std::abs(inX) < 1e-5f) return 1.0f;
+        float x = std::numbers::pi_v<float> * inX;
+        return std::sin(x) / x;
+    }
+
+    // zeroth order modified Bessel function of the first kind, by its power series
+    static float BesselI0(float inX)
+    {
+        float sum = 1.0f;
+        float term = 1.0f;
+        float half = inX * 0.5f;
+        for (uint32_t k = 1; k < 32 && term > sum * 1e-8f; ++k)
+        {
+            term *= (half / static_cast<float>(k)) * (half / static_cast<float>(k));
+            sum += term;
+        }
+        return sum;
+    }
+
+    static float GetFilterRadius(MipGenerator::Filter inFilter)
+    {
+        return inFilter == MipGenerator::Filter::Box ? 0.5f : SincRadius;
+    }
+
+    static float EvaluateFilter(MipGenerator::Filter inFilter, float inX)
+    {
+        float x = std::abs(inX);
+        switch (inFilter)
+        {
+        case MipGenerator::Filter::Box: return x <= 0.5f ? 1.0f : 0.0f;
+        case MipGenerator::Filter::Kaiser:
+        {
+            if (x >= SincRadius) return 0.0f;
+            float ratio = x / SincRadius;
+            return Sinc(x) * BesselI0(KaiserAlpha * std::sqrt(1.0f - ratio * ratio)) / BesselI0(KaiserAlpha);
+        }
+        case MipGenerator::Filter::Lanczos: return x < SincRadius ? Sinc(x) * Sinc(x / SincRadius) : 0.0f;
+        default: ZE_ASSERT_CORE_MSG(false, "Unknown mip filter!"); return 0.0f;
+        }
+    }
+
+    static std::vector<MipTaps> ComputeTaps(MipGenerator::Filter inFilter, uint32_t inSourceSize, uint32_t inDestinationSize)
+    {
+        // odd sizes do not halve exactly, the filter is stretched over whatever the ratio is
+        float scale = static_cast<float>(inSourceSize) / static_cast<float>(inDestinationSize);
+        float support = GetFilterRadius(inFilter) * scale;
+        std::vector<MipTaps> taps(inDestinationSize);
+        for (uint32_t destination = 0; destination < inDestinationSize; ++destination)
+        {
+            auto &tap = taps[destination];
+            float center = (static_cast<float>(destination) + 0.5f) * scale;
+            int32_t first = static_cast<int32_t>(std::floor(center - support));
+            int32_t last = static_cast<int32_t>(std::ceil(center + support));
+            float total = 0.0f;
+            for (int32_t source = first; source <= last; ++source)
+            {
+                float weight = EvaluateFilter(inFilter, (static_cast<float>(source) + 0.5f - center) / scale);
+                if (weight == 0.0f) continue;
+                uint32_t index = static_cast<uint32_t>(std::clamp(source, 0, static_cast<int32_t>(inSourceSize) - 1));
+                auto it = std::find(tap.Indices.begin(), tap.Indices.end(), index);
+                if (it != tap.Indices.end())
+                {
+                    tap.Weights[it - tap.Indices.begin()] += weight;
+                }
+                else
+                {
+                    tap.Indices.push_back(index);
+                    tap.Weights.push_back(weight);
+                }
+                total += weight;
+            }
+            for (auto &weight : tap.Weights)
+                weight /= total;
+        }
+        return taps;
+    }
+
+    // each row of the result is a weighted sum of whole rows of the source, four floats at a time
+    static MipImage FilterRows(const MipImage &inSource, uint32_t inHeight, MipGenerator::Filter inFilter)
+    {
+        if (inHeight == inSource.Height) return inSource;
+        auto taps = ComputeTaps(inFilter, inSource.Height, inHeight);
+        size_t rowSize = static_cast<size_t>(inSource.Width) * inSource.Channels;
+        MipImage result{ inSource.Width, inHeight, inSource.Channels, std::vector<float>(rowSize * inHeight, 0.0f) };
+
+        JobSystem::Get().ParallelFor(inHeight, RowsPerJob, [&](uint32_t inBegin, uint32_t inEnd)
+        {
+            for (uint32_t y = inBegin; y < inEnd; ++y)
+            {
+                float *destination = result.Texels.data() + y * rowSize;
+                const auto &tap = taps[y];
+                for (size_t i = 0; i < tap.Indices.size(); ++i)
+                {
+                    const float *source = inSource.Texels.data() + tap.Indices[i] * rowSize;
+                    float weight = tap.Weights[i];
+                    __m128 weights = _mm_set1_ps(weight);
+                    size_t x = 0;
+                    for (; x + 4 <= rowSize; x += 4)
+                        _mm_storeu_ps(destination + x, _mm_add_ps(_mm_loadu_ps(destination + x), _mm_mul_ps(_mm_loadu_ps(source + x), weights)));
+                    for (; x < rowSize; ++x)
+                        destination[x] += source[x] * weight;
+                }
+            }
+        });
+        return result;
+    }
+
+    static MipImage FilterColumns(const MipImage &inSource, uint32_t inWidth, MipGenerator::Filter inFilter)
+    {
+        if (inWidth == inSource.Width) return inSource;
+        auto taps = ComputeTaps(inFilter, inSource.Width, inWidth);
+        uint32_t channels = inSource.Channels;
+        MipImage result{ inWidth, inSource.Height, channels, std::vector<float>(static_cast<size_t>(inWidth) * inSource.Height * channels, 0.0f) };
+
+        JobSystem::Get().ParallelFor(inSource.Height, RowsPerJob, [&](uint32_t inBegin, uint32_t inEnd)
+        {
+            for (uint32_t y = inBegin; y < inEnd; ++y)
+            {
+                const float *source = inSource.Texels.data() + static_cast<size_t>(y) * inSource.Width * channels;
+                float *destination = result.Texels.data() + static_cast<size_t>(y) * inWidth * channels;
+                for (uint32_t x = 0; x < inWidth; ++x)
+                {
+                    const auto &tap = taps[x];
+                    // an RGBA texel fills a register
+                    if (channels == 4)
+                    {
+                        __m128 sum = _mm_setzero_ps();
+                        for (size_t i = 0; i < tap.Indices.size(); ++i)
+                            sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(source + tap.Indices[i] * 4), _mm_set1_ps(tap.Weights[i])));
+                        _mm_storeu_ps(destination + x * 4, sum);
+                        continue;
+                    }
+                    for (size_t i = 0; i < tap.Indices.size(); ++i)
+                        for (uint32_t c = 0; c < channels; ++c)
+                            destination[x * channels + c] += source[tap.Indices[i] * channels + c] * tap.Weights[i];
+                }
+            }
+        });
+        return result;
+    }
+
+    static float SRGBToLinear(float inValue)
+    {
+        return inValue <= 0.04045f ? inValue / 12.92f : std::pow((inValue + 0.055f) / 1.055f, 2.4f);
+    }
+
+    static float LinearToSRGB(float inValue)
+    {
+        return inValue <= 0.0031308f ? inValue * 12.92f : 1.055f * std::pow(inValue, 1.0f / 2.4f) - 0.055f;
+    }
+
+    static std::vector<uint8_t> EncodeLevel(const MipImage &inImage, bool inFloats, bool inSRGB)
+    {
+        if (inFloats)
+        {
+            std::vector<uint8_t> level(inImage.Texels.size() * sizeof(float));
+            std::memcpy(level.data(), inImage.Texels.data(), level.size());
+            return level;
+        }
+
+        std::vector<uint8_t> level(inImage.Texels.size());
+        JobSystem::Get().ParallelFor(inImage.Height, RowsPerJob, [&](uint32_t inBegin, uint32_t inEnd)
+        {
+            size_t rowSize = static_cast<size_t>(inImage.Width) * inImage.Channels;
+            for (size_t i = inBegin * rowSize; i < inEnd * rowSize; ++i)
+            {
+                // the negative lobes of the sinc filters can overshoot
+                float value = std::clamp(inImage.Texels[i], 0.0f, 1.0f);
+                if (inSRGB && i % inImage.Channels < 3) value = LinearToSRGB(value);
+                level[i] = static_cast<uint8_t>(value * 255.0f + 0.5f);
+            }
+        });
+        return level;
+    }
+
+    std::vector<std::vector<uint8_t>> MipGenerator::Generate(const std::vector<uint8_t> &inTopLevel, Texture2D::Format inFormat, uint32_t inWidth, uint32_t inHeight, Filter inFilter, bool inSRGB)
+    {
+        bool floats = inFormat == Texture2D::Format::R32F;
+        ZE_ASSERT_CORE_MSG(floats || inFormat == Texture2D::Format::R8 || inFormat == Texture2D::Format::RGB8 || inFormat == Texture2D::Format::RGBA8, "Mips can not be generated for this format!");
+        bool srgb = inSRGB && !floats;
+        uint32_t channels = floats ? 1 : Texture2D::Texture2DFormatBytes(inFormat);
+
+        MipImage image{ inWidth, inHeight, channels, std::vector<float>(static_cast<size_t>(inWidth) * inHeight * channels) };
+        if (floats)
+        {
+            std::memcpy(image.Texels.data(), inTopLevel.data(), image.Texels.size() * sizeof(float));
+        }
+        else
+        {
+            float decode[256];
+            for (uint32_t i = 0; i < 256; ++i)
+                decode[i] = static_cast<float>(i) / 255.0f;
+            float decodeSRGB[256];
+            for (uint32_t i = 0; i < 256; ++i)
+                decodeSRGB[i] = SRGBToLinear(decode[i]);
+            for (size_t i = 0; i < image.Texels.size(); ++i)
+                image.Texels[i] = srgb && i % channels < 3 ? decodeSRGB[inTopLevel[i]] : decode[inTopLevel[i]];
+        }
+
+        std::vector<std::vector<uint8_t>> levels;
+        uint32_t count = Texture2D::GetFullMipCount(inWidth, inHeight);
+        for (uint32_t level = 1; level < count; ++level)
+        {
+            uint32_t width = std::max(image.Width / 2, 1u);
+            uint32_t height = std::max(image.Height / 2, 1u);
+            // the rows first, the columns are then filtered on half as many of them
+            image = FilterColumns(FilterRows(image, height, inFilter), width, inFilter);
+            levels.push_back(EncodeLevel(image, floats, srgb));
+        }
+        return levels;
+    }
+}
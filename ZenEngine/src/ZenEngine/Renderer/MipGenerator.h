@@ -0,0 +1,30 @@
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+
+#include "Texture2D.h"
+
+namespace ZenEngine
+{
+    /// @brief Builds mip chains on the CPU with a windowed sinc filter, rather than the box the drivers use.
+    /// Each level is made from the one above it, kept in floats so the error does not add up level after level.
+    /// The filter is separable, the rows and then the columns are spread over the job system
+    class MipGenerator
+    {
+    public:
+        enum class Filter
+        {
+            // the average of the texels under the new one, what glGenerateMipmap does
+            Box = 0,
+            // sinc windowed by a Kaiser window three texels wide, sharp with little ringing
+            Kaiser,
+            // sinc windowed by a wider sinc, sharper and rings a little more
+            Lanczos
+        };
+
+        /// @brief Levels below the top one, down to a single texel. Takes R8, RGB8, RGBA8 or R32F texels.
+        /// With inSRGB the color channels of 8 bit data are filtered in linear space and encoded back, alpha is always linear
+        static std::vector<std::vector<uint8_t>> Generate(const std::vector<uint8_t> &inTopLevel, Texture2D::Format inFormat, uint32_t inWidth, uint32_t inHeight, Filter inFilter, bool inSRGB);
+    };
+}
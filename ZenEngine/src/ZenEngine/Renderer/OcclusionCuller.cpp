@@ -0,0 +1,136 @@
+#include "OcclusionCuller.h"
+
+#include <algorithm>
+
+#include "Renderer.h"
+
+namespace ZenEngine
+{
+    void OcclusionCuller::SetEnabled(bool inEnabled)
+    {
+        if (inEnabled == mEnabled) return;
+        mEnabled = inEnabled;
+        // the queries stay in the pool, the indices are handed out from the start again
+        mObjects.clear();
+        mFreeQueries.clear();
+        mQueryCount = 0;
+    }
+
+    void OcclusionCuller::BeginFrame()
+    {
+        ++mFrame;
+        mStatistics = {};
+        mStatistics.QueryPoolSize = mQueryCount;
+    }
+
+    void OcclusionCuller::Submit(uint64_t inId, VertexArrayHandle inVertexArray, const glm::mat4 &inTransform, const Math::BoundingBox &inWorldBounds, Material &inMaterial)
+    {
+        auto &renderer = Renderer::Get();
+        ++mStatistics.Objects;
+        if (!mEnabled || !inWorldBounds.IsValid())
+        {
+            renderer.Submit(inVertexArray, inTransform, inMaterial);
+            return;
+        }
+        // objects outside the view are forgotten, they come back visible so they never pop in late
+        if (renderer.GetViewFrustum().Test(inWorldBounds) == Math::Frustum::Result::Outside) return;
+
+        Object &object = mObjects[inId];
+        object.LastSubmitFrame = mFrame;
+
+        auto &queries = renderer.GetOcclusionQueries();
+        if (object.Pending)
+        {
+            auto result = queries.GetResult(static_cast<uint32_t>(object.Query));
+            if (result != OcclusionQueryPool::Result::Pending)
+            {
+                object.Pending = false;
+                object.Visible = result == OcclusionQueryPool::Result::Visible;
+                ++mStatistics.ResultsRead;
+                if (!object.Visible) ++mStatistics.OccludedResults;
+            }
+        }
+
+        // the near plane clips a box around the eye, its query would find nothing even though the object fills the view
+        const glm::vec3 &eye = renderer.GetEyePosition();
+        glm::vec3 margin = inWorldBounds.GetExtents() * 0.01f + glm::vec3(renderer.GetNearPlane() * 2.0f);
+        if (glm::all(glm::greaterThanEqual(eye, inWorldBounds.Min - margin)) && glm::all(glm::lessThanEqual(eye, inWorldBounds.Max + margin)))
+        {
+            object.Visible = true;
+            renderer.Submit(inVertexArray, inTransform, inMaterial);
+            return;
+        }
+
+        Renderer::OcclusionTest test;
+        if (object.Visible)
+        {
+            // the id picks the frame, so the visible objects take turns instead of all querying at once
+            if (!object.Pending && (mFrame + static_cast<uint32_t>(inId)) % VisibleQueryInterval == 0)
+            {
+                test.Query = static_cast<int32_t>(AcquireQuery(object));
+                object.Pending = true;
+                ++mStatistics.QueriesIssued;
+            }
+            renderer.Submit(inVertexArray, inTransform, inMaterial, test);
+            return;
+        }
+
+        // hidden at the last result: its own draw would not tell when it shows up again, its box does
+        if (!object.Pending)
+        {
+            renderer.SubmitOcclusionQuery(AcquireQuery(object), inWorldBounds);
+            object.Pending = true;
+            ++mStatistics.QueriesIssued;
+        }
+        if (queries.SupportsConditionalRender())
+        {
+            test.Predicate = object.Query;
+            renderer.Submit(inVertexArray, inTransform, inMaterial, test);
+            ++mStatistics.Predicated;
+        }
+        else
+        {
+            // shows up a frame late once its box is seen again
+            ++mStatistics.Skipped;
+        }
+    }
+
+    void OcclusionCuller::EndFrame()
+    {
+        for (auto it = mObjects.begin(); it != mObjects.end();)
+        {
+            if (it->second.LastSubmitFrame == mFrame)
+            {
+                ++it;
+                continue;
+            }
+            if (it->second.Query >= 0) mFreeQueries.push_back(static_cast<uint32_t>(it->second.Query));
+            it = mObjects.erase(it);
+        }
+        mStatistics.QueryPoolSize = mQueryCount;
+    }
+
+    uint32_t OcclusionCuller::AcquireQuery(Object &ioObject)
+    {
+        if (ioObject.Query >= 0) return static_cast<uint32_t>(ioObject.Query);
+
+        auto &queries = Renderer::Get().GetOcclusionQueries();
+        uint32_t query;
+        if (!mFreeQueries.empty())
+        {
+            query = mFreeQueries.back();
+            mFreeQueries.pop_back();
+        }
+        else
+        {
+            query = mQueryCount++;
+            // grown by half so the pool is not extended every time an object shows up
+            if (mQueryCount > queries.GetSize())
+                queries.Reserve(std::max(64u, queries.GetSize() + queries.GetSize() / 2));
+        }
+        // a query given back, or one from before the culler was last enabled, still holds the result of another object
+        queries.Reset(query);
+        ioObject.Query = static_cast<int32_t>(query);
+        return query;
+    }
+}
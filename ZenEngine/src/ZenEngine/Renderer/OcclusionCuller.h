@@ -0,0 +1,71 @@
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "ResourceHandle.h"
+#include "ZenEngine/Core/Math.h"
+
+namespace ZenEngine
+{
+    class Material;
+
+    /// @brief Culls objects hidden behind others with GPU occlusion queries, for scenes without authored occluders.
+    /// Visibility is assumed to change little from one frame to the next: an object found visible is drawn and
+    /// only checked again every few frames, with a query around its own draw. An object found hidden gets its
+    /// bounding box tested against the depth of the frame instead, and where the API has conditional rendering
+    /// its draw is predicated on that box so the GPU drops it without the CPU ever waiting for the result.
+    /// Results are only read back when they are ready, usually the frame after, and decide what the next frame does
+    class OcclusionCuller
+    {
+    public:
+        // frames between two queries of a visible object, objects are spread over them so the queries are too
+        static constexpr uint32_t VisibleQueryInterval = 8;
+
+        struct Statistics
+        {
+            uint32_t Objects = 0;
+            // objects drawn predicated on their box, and objects not drawn at all when predicates are not available
+            uint32_t Predicated = 0;
+            uint32_t Skipped = 0;
+            uint32_t QueriesIssued = 0;
+            uint32_t ResultsRead = 0;
+            uint32_t OccludedResults = 0;
+            uint32_t QueryPoolSize = 0;
+
+            /// @brief Fraction of the queries read back that found their object hidden
+            float GetHitRate() const { return ResultsRead > 0 ? static_cast<float>(OccludedResults) / static_cast<float>(ResultsRead) : 0.0f; }
+        };
+
+        void SetEnabled(bool inEnabled);
+        bool IsEnabled() const { return mEnabled; }
+
+        void BeginFrame();
+        /// @brief Submits the object to the renderer unless it is outside the view or known to be hidden.
+        /// The id tells the object apart from one frame to the next, the material must stay alive until the next Flush
+        void Submit(uint64_t inId, VertexArrayHandle inVertexArray, const glm::mat4 &inTransform, const Math::BoundingBox &inWorldBounds, Material &inMaterial);
+        /// @brief Forgets the objects that were not submitted this frame and gives their queries back
+        void EndFrame();
+
+        const Statistics &GetStatistics() const { return mStatistics; }
+    private:
+        struct Object
+        {
+            int32_t Query = -1;
+            bool Visible = true;
+            // a query was issued and its result not read yet
+            bool Pending = false;
+            uint32_t LastSubmitFrame = 0;
+        };
+
+        bool mEnabled = true;
+        uint32_t mFrame = 0;
+        std::unordered_map<uint64_t, Object> mObjects;
+        std::vector<uint32_t> mFreeQueries;
+        uint32_t mQueryCount = 0;
+        Statistics mStatistics;
+
+        uint32_t AcquireQuery(Object &ioObject);
+    };
+}
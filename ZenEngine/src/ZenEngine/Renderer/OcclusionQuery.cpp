@@ -0,0 +1,23 @@
+#include "OcclusionQuery.h"
+
+#include "RendererAPI.h"
+
+#include "ZenEngine/Core/Macros.h"
+
+#include "Platform/OpenGL/OpenGLOcclusionQuery.h"
+#include "Platform/Software/SoftwareOcclusionQuery.h"
+
+namespace ZenEngine
+{
+    std::unique_ptr<OcclusionQueryPool> OcclusionQueryPool::Create()
+    {
+        switch (RendererAPI::GetAPI())
+        {
+        case RendererAPI::API::None: ZE_ASSERT_CORE_MSG(false, "RendererAPI::None is not supported!"); return nullptr;
+        case RendererAPI::API::OpenGL: return std::make_unique<OpenGLOcclusionQueryPool>();
+        case RendererAPI::API::Software: return std::make_unique<SoftwareOcclusionQueryPool>();
+        }
+        ZE_ASSERT_CORE_MSG(false, "Unknown Renderer API!");
+        return nullptr;
+    }
+}
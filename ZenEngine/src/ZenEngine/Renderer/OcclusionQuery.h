@@ -0,0 +1,37 @@
+#pragma once
+
+#include <memory>
+#include <stdint.h>
+
+namespace ZenEngine
+{
+    /// @brief Occlusion queries addressed by index, each tells whether any sample of the draws between its Begin and End
+    /// passed the depth test. Results are polled without waiting, so they are usually read a frame after being issued.
+    class OcclusionQueryPool
+    {
+    public:
+        enum class Result { Pending, Visible, Occluded };
+
+        virtual ~OcclusionQueryPool() = default;
+
+        /// @brief Grows the pool to at least inCount queries, the existing ones keep their results
+        virtual void Reserve(uint32_t inCount) = 0;
+        virtual uint32_t GetSize() const = 0;
+
+        virtual void Begin(uint32_t inQuery) = 0;
+        virtual void End(uint32_t inQuery) = 0;
+        /// @brief Never waits for the GPU, a query that was never issued stays pending
+        virtual Result GetResult(uint32_t inQuery) = 0;
+        /// @brief Forgets the last result, e.g. when the query is handed to another object.
+        /// It is pending and does not predicate draws until it is issued again
+        virtual void Reset(uint32_t inQuery) = 0;
+
+        /// @brief Draws until EndConditionalRender are dropped by the GPU if the query saw no samples.
+        /// While its result is not ready they are drawn, so the predicate never stalls
+        virtual void BeginConditionalRender(uint32_t inQuery) = 0;
+        virtual void EndConditionalRender() = 0;
+        virtual bool SupportsConditionalRender() const = 0;
+
+        static std::unique_ptr<OcclusionQueryPool> Create();
+    };
+}
@@ -0,0 +1,307 @@
+#include "ParticleEmitter.h"
+
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <xmmintrin.h>
+#include <glm/gtc/constants.hpp>
+
+#include "ZenEngine/Core/JobSystem.h"
+#include "ResourceRegistry.h"
+#include "VertexArray.h"
+#include "VertexBuffer.h"
+#include "IndexBuffer.h"
+
+namespace ZenEngine
+{
+    static float HorizontalMin(__m128 inValues)
+    {
+        inValues = _mm_min_ps(inValues, _mm_shuffle_ps(inValues, inValues, _MM_SHUFFLE(2, 3, 0, 1)));
+        inValues = _mm_min_ps(inValues, _mm_shuffle_ps(inValues, inValues, _MM_SHUFFLE(1, 0, 3, 2)));
+        return _mm_cvtss_f32(inValues);
+    }
+
+    static float HorizontalMax(__m128 inValues)
+    {
+        inValues = _mm_max_ps(inValues, _mm_shuffle_ps(inValues, inValues, _MM_SHUFFLE(2, 3, 0, 1)));
+        inValues = _mm_max_ps(inValues, _mm_shuffle_ps(inValues, inValues, _MM_SHUFFLE(1, 0, 3, 2)));
+        return _mm_cvtss_f32(inValues);
+    }
+
+    void ParticleEmitter::Pool::Resize(uint32_t inCapacity)
+    {
+        for (auto *values : { &PositionX, &PositionY, &PositionZ, &VelocityX, &VelocityY, &VelocityZ, &Age, &Lifetime })
+            values->resize(inCapacity, 0.0f);
+    }
+
+    void ParticleEmitter::Pool::Move(uint32_t inFrom, uint32_t inTo)
+    {
+        for (auto *values : { &PositionX, &PositionY, &PositionZ, &VelocityX, &VelocityY, &VelocityZ, &Age, &Lifetime })
+            (*values)[inTo] = (*values)[inFrom];
+    }
+
+    void ParticleEmitter::Pool::Gather(const Pool &inSource, const uint32_t *inOrder, uint32_t inBegin, uint32_t inEnd)
+    {
+        auto gather = [&](std::vector<float> &outValues, const std::vector<float> &inValues)
+        {
+            for (uint32_t i = inBegin; i < inEnd; ++i)
+                outValues[i] = inValues[inOrder[i]];
+        };
+        gather(PositionX, inSource.PositionX);
+        gather(PositionY, inSource.PositionY);
+        gather(PositionZ, inSource.PositionZ);
+        gather(VelocityX, inSource.VelocityX);
+        gather(VelocityY, inSource.VelocityY);
+        gather(VelocityZ, inSource.VelocityZ);
+        gather(Age, inSource.Age);
+        gather(Lifetime, inSource.Lifetime);
+    }
+
+    ParticleEmitter::ParticleEmitter()
+        : mRandom(std::random_device()())
+    {
+        mPool.Resize(mSettings.MaxParticles);
+    }
+
+    ParticleEmitter::~ParticleEmitter()
+    {
+        ResourceRegistry::Get().Destroy(mVertexArray);
+    }
+
+    void ParticleEmitter::SetSettings(const Settings &inSettings)
+    {
+        mSettings = inSettings;
+        mCount = std::min(mCount, mSettings.MaxParticles);
+        mPool.Resize(mSettings.MaxParticles);
+    }
+
+    void ParticleEmitter::Update(float inDeltaTime, const glm::mat4 &inTransform)
+    {
+        if (inDeltaTime <= 0.0f) return;
+
+        uint32_t jobCount = (mCount + ParticlesPerJob - 1) / ParticlesPerJob;
+        mJobBounds.assign(jobCount, Math::BoundingBox());
+        JobSystem::Get().ParallelFor(mCount, ParticlesPerJob, [&](uint32_t inBegin, uint32_t inEnd)
+        {
+            Simulate(inBegin, inEnd, inDeltaTime, mJobBounds[inBegin / ParticlesPerJob]);
+        });
+
+        mBounds = Math::BoundingBox();
+        for (const auto &bounds : mJobBounds)
+            mBounds.Extend(bounds);
+
+        RemoveDead();
+
+        mEmissionAccumulator += std::max(mSettings.EmissionRate, 0.0f) * inDeltaTime;
+        uint32_t emitted = static_cast<uint32_t>(mEmissionAccumulator);
+        mEmissionAccumulator -= static_cast<float>(emitted);
+        emitted = std::min(emitted, mSettings.MaxParticles - mCount);
+        if (emitted > 0)
+        {
+            Emit(emitted, inTransform);
+            mBounds.Extend(glm::vec3(inTransform[3]));
+        }
+    }
+
+    uint32_t ParticleEmitter::Upload(const glm::vec3 &inEyePosition)
+    {
+        if (mCount == 0) return 0;
+
+        // additive blending gives the same result in any order
+        if (mSettings.Blend == BlendMode::Alpha)
+            SortBackToFront(inEyePosition);
+
+        if (mVertexArray.IsNull() || mCount > mInstanceCapacity)
+            RebuildVertexArray(std::max(mCount, mInstanceCapacity * 2));
+
+        mInstanceData.resize(mCount);
+        JobSystem::Get().ParallelFor(mCount, ParticlesPerJob, [&](uint32_t inBegin, uint32_t inEnd)
+        {
+            for (uint32_t i = inBegin; i < inEnd; ++i)
+            {
+                float t = std::clamp(mPool.Age[i] / mPool.Lifetime[i], 0.0f, 1.0f);
+                float size = glm::mix(mSettings.StartSize, mSettings.EndSize, t);
+                glm::vec4 color = glm::mix(mSettings.StartColor, mSettings.EndColor, t);
+                // the layout of the ParticleData matrix read by Particle.hlsl
+                mInstanceData[i] = glm::mat4(
+                    glm::vec4(mPool.PositionX[i], mPool.PositionY[i], mPool.PositionZ[i], size),
+                    color,
+                    glm::vec4(0.0f),
+                    glm::vec4(0.0f));
+            }
+        });
+        mInstanceBuffer->SetData(mInstanceData.data(), mCount * sizeof(glm::mat4));
+        return mCount;
+    }
+
+    void ParticleEmitter::Clear()
+    {
+        mCount = 0;
+        mEmissionAccumulator = 0.0f;
+        mBounds = Math::BoundingBox();
+    }
+
+    void ParticleEmitter::Emit(uint32_t inCount, const glm::mat4 &inTransform)
+    {
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+        glm::vec3 origin(inTransform[3]);
+        glm::mat3 orientation(inTransform);
+        float cosSpread = std::cos(glm::radians(std::clamp(mSettings.SpreadAngle, 0.0f, 180.0f)));
+
+        for (uint32_t n = 0; n < inCount; ++n)
+        {
+            // uniform over the cap of the unit sphere cut by the cone
+            float cosTheta = glm::mix(1.0f, cosSpread, unit(mRandom));
+            float sinTheta = std::sqrt(std::max(0.0f, 1.0f - cosTheta * cosTheta));
+            float phi = glm::two_pi<float>() * unit(mRandom);
+            glm::vec3 direction = orientation * glm::vec3(sinTheta * std::cos(phi), cosTheta, sinTheta * std::sin(phi));
+            float length = glm::length(direction);
+            if (length > 0.0f) direction /= length;
+            glm::vec3 velocity = direction * glm::mix(mSettings.MinSpeed, mSettings.MaxSpeed, unit(mRandom));
+
+            uint32_t i = mCount++;
+            mPool.PositionX[i] = origin.x;
+            mPool.PositionY[i] = origin.y;
+            mPool.PositionZ[i] = origin.z;
+            mPool.VelocityX[i] = velocity.x;
+            mPool.VelocityY[i] = velocity.y;
+            mPool.VelocityZ[i] = velocity.z;
+            mPool.Age[i] = 0.0f;
+            mPool.Lifetime[i] = std::max(glm::mix(mSettings.MinLifetime, mSettings.MaxLifetime, unit(mRandom)), 1e-3f);
+        }
+    }
+
+    void ParticleEmitter::Simulate(uint32_t inBegin, uint32_t inEnd, float inDeltaTime, Math::BoundingBox &outBounds)
+    {
+        float damping = std::max(0.0f, 1.0f - mSettings.Drag * inDeltaTime);
+        glm::vec3 gravity = mSettings.Gravity * inDeltaTime;
+
+        const __m128 deltaTime = _mm_set1_ps(inDeltaTime);
+        const __m128 damp = _mm_set1_ps(damping);
+        const __m128 gravityX = _mm_set1_ps(gravity.x);
+        const __m128 gravityY = _mm_set1_ps(gravity.y);
+        const __m128 gravityZ = _mm_set1_ps(gravity.z);
+        __m128 minX = _mm_set1_ps(std::numeric_limits<float>::max()), maxX = _mm_set1_ps(std::numeric_limits<float>::lowest());
+        __m128 minY = minX, maxY = maxX;
+        __m128 minZ = minX, maxZ = maxX;
+
+        uint32_t i = inBegin;
+        for (; i + 4 <= inEnd; i += 4)
+        {
+            __m128 velocityX = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&mPool.VelocityX[i]), damp), gravityX);
+            __m128 velocityY = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&mPool.VelocityY[i]), damp), gravityY);
+            __m128 velocityZ = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&mPool.VelocityZ[i]), damp), gravityZ);
+            __m128 positionX = _mm_add_ps(_mm_loadu_ps(&mPool.PositionX[i]), _mm_mul_ps(velocityX, deltaTime));
+            __m128 positionY = _mm_add_ps(_mm_loadu_ps(&mPool.PositionY[i]), _mm_mul_ps(velocityY, deltaTime));
+            __m128 positionZ = _mm_add_ps(_mm_loadu_ps(&mPool.PositionZ[i]), _mm_mul_ps(velocityZ, deltaTime));
+
+            _mm_storeu_ps(&mPool.VelocityX[i], velocityX);
+            _mm_storeu_ps(&mPool.VelocityY[i], velocityY);
+            _mm_storeu_ps(&mPool.VelocityZ[i], velocityZ);
+            _mm_storeu_ps(&mPool.PositionX[i], positionX);
+            _mm_storeu_ps(&mPool.PositionY[i], positionY);
+            _mm_storeu_ps(&mPool.PositionZ[i], positionZ);
+            _mm_storeu_ps(&mPool.Age[i], _mm_add_ps(_mm_loadu_ps(&mPool.Age[i]), deltaTime));
+
+            minX = _mm_min_ps(minX, positionX);
+            minY = _mm_min_ps(minY, positionY);
+            minZ = _mm_min_ps(minZ, positionZ);
+            maxX = _mm_max_ps(maxX, positionX);
+            maxY = _mm_max_ps(maxY, positionY);
+            maxZ = _mm_max_ps(maxZ, positionZ);
+        }
+
+        Math::BoundingBox bounds;
+        bounds.Min = { HorizontalMin(minX), HorizontalMin(minY), HorizontalMin(minZ) };
+        bounds.Max = { HorizontalMax(maxX), HorizontalMax(maxY), HorizontalMax(maxZ) };
+
+        // the particles past the last group of four
+        for (; i < inEnd; ++i)
+        {
+            glm::vec3 velocity = glm::vec3(mPool.VelocityX[i], mPool.VelocityY[i], mPool.VelocityZ[i]) * damping + gravity;
+            glm::vec3 position = glm::vec3(mPool.PositionX[i], mPool.PositionY[i], mPool.PositionZ[i]) + velocity * inDeltaTime;
+            mPool.VelocityX[i] = velocity.x;
+            mPool.VelocityY[i] = velocity.y;
+            mPool.VelocityZ[i] = velocity.z;
+            mPool.PositionX[i] = position.x;
+            mPool.PositionY[i] = position.y;
+            mPool.PositionZ[i] = position.z;
+            mPool.Age[i] += inDeltaTime;
+            bounds.Extend(position);
+        }
+        outBounds = bounds;
+    }
+
+    void ParticleEmitter::RemoveDead()
+    {
+        // keeps the order of the survivors, so an alpha blended pool stays close to sorted between frames
+        uint32_t alive = 0;
+        for (uint32_t i = 0; i < mCount; ++i)
+        {
+            if (mPool.Age[i] >= mPool.Lifetime[i]) continue;
+            if (alive != i) mPool.Move(i, alive);
+            ++alive;
+        }
+        mCount = alive;
+    }
+
+    void ParticleEmitter::SortBackToFront(const glm::vec3 &inEyePosition)
+    {
+        mSortKeys.resize(mCount);
+        JobSystem::Get().ParallelFor(mCount, ParticlesPerJob, [&](uint32_t inBegin, uint32_t inEnd)
+        {
+            for (uint32_t i = inBegin; i < inEnd; ++i)
+            {
+                glm::vec3 offset = glm::vec3(mPool.PositionX[i], mPool.PositionY[i], mPool.PositionZ[i]) - inEyePosition;
+                mSortKeys[i] = glm::dot(offset, offset);
+            }
+        });
+        if (std::is_sorted(mSortKeys.begin(), mSortKeys.end(), std::greater<float>())) return;
+
+        mOrder.resize(mCount);
+        std::iota(mOrder.begin(), mOrder.end(), 0u);
+        std::sort(mOrder.begin(), mOrder.end(), [this](uint32_t inA, uint32_t inB) { return mSortKeys[inA] > mSortKeys[inB]; });
+
+        // the pool itself is reordered, the next frame then usually finds it sorted already
+        mSorted.Resize(static_cast<uint32_t>(mPool.Age.size()));
+        JobSystem::Get().ParallelFor(mCount, ParticlesPerJob, [&](uint32_t inBegin, uint32_t inEnd)
+        {
+            mSorted.Gather(mPool, mOrder.data(), inBegin, inEnd);
+        });
+        std::swap(mPool, mSorted);
+    }
+
+    void ParticleEmitter::RebuildVertexArray(uint32_t inCapacity)
+    {
+        if (mQuadVertices == nullptr)
+        {
+            mQuadVertices = VertexBuffer::Create({
+                -0.5f, -0.5f,
+                 0.5f, -0.5f,
+                 0.5f,  0.5f,
+                -0.5f,  0.5f
+            });
+            mQuadVertices->SetLayout({
+                { ShaderDataType::Float2, "Corner" }
+            });
+            mQuadIndices = IndexBuffer::Create({ 0, 1, 2, 2, 3, 0 });
+        }
+
+        mInstanceBuffer = VertexBuffer::Create(inCapacity * sizeof(glm::mat4));
+        mInstanceBuffer->SetLayout({
+            { ShaderDataType::Mat4, "ParticleData" }
+        });
+        mInstanceCapacity = inCapacity;
+
+        auto vertexArray = VertexArray::Create();
+        vertexArray->AddVertexBuffer(mQuadVertices);
+        vertexArray->AddVertexBuffer(mInstanceBuffer);
+        vertexArray->SetIndexBuffer(mQuadIndices);
+
+        auto &registry = ResourceRegistry::Get();
+        if (mVertexArray.IsNull())
+            mVertexArray = registry.Register(vertexArray);
+        else
+            registry.Replace(mVertexArray, vertexArray);
+    }
+}
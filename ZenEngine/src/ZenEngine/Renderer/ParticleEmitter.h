@@ -0,0 +1,124 @@
+#pragma once
+
+#include <memory>
+#include <random>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "ResourceHandle.h"
+#include "ZenEngine/Core/Math.h"
+#include "ZenEngine/Asset/Serialization.h"
+
+namespace ZenEngine
+{
+    class VertexBuffer;
+    class IndexBuffer;
+
+    /// @brief CPU simulated particles drawn as camera facing quads.
+    /// Particles live in world space in a structure of arrays pool, so the update streams through each attribute
+    /// four particles at a time, split across the job system. Alpha blended emitters are sorted back to front before
+    /// the upload, additive ones do not need it. Each particle becomes one instance of a quad
+    class ParticleEmitter
+    {
+    public:
+        static constexpr uint32_t ParticlesPerJob = 4096;
+
+        enum class BlendMode
+        {
+            Alpha,
+            Additive
+        };
+
+        struct Settings
+        {
+            uint32_t MaxParticles = 10000;
+            // particles per second
+            float EmissionRate = 500.0f;
+            float MinLifetime = 1.0f;
+            float MaxLifetime = 2.0f;
+            float MinSpeed = 1.0f;
+            float MaxSpeed = 2.0f;
+            // half angle in degrees of the cone around the emitter +Y axis the particles are shot in
+            float SpreadAngle = 30.0f;
+            glm::vec3 Gravity = glm::vec3(0.0f, -9.81f, 0.0f);
+            // fraction of the velocity lost per second
+            float Drag = 0.0f;
+            float StartSize = 0.2f;
+            float EndSize = 0.0f;
+            glm::vec4 StartColor = glm::vec4(1.0f);
+            glm::vec4 EndColor = glm::vec4(1.0f, 1.0f, 1.0f, 0.0f);
+            BlendMode Blend = BlendMode::Alpha;
+
+            template<typename Archive>
+            void Serialize(Archive &outArchive)
+            {
+                outArchive(cereal::make_nvp("maxParticles", MaxParticles), cereal::make_nvp("emissionRate", EmissionRate),
+                    cereal::make_nvp("minLifetime", MinLifetime), cereal::make_nvp("maxLifetime", MaxLifetime),
+                    cereal::make_nvp("minSpeed", MinSpeed), cereal::make_nvp("maxSpeed", MaxSpeed),
+                    cereal::make_nvp("spreadAngle", SpreadAngle), cereal::make_nvp("gravity", Gravity), cereal::make_nvp("drag", Drag),
+                    cereal::make_nvp("startSize", StartSize), cereal::make_nvp("endSize", EndSize),
+                    cereal::make_nvp("startColor", StartColor), cereal::make_nvp("endColor", EndColor), cereal::make_nvp("blend", Blend));
+            }
+        };
+
+        ParticleEmitter();
+        ~ParticleEmitter();
+
+        ParticleEmitter(const ParticleEmitter &) = delete;
+        ParticleEmitter &operator =(const ParticleEmitter &) = delete;
+
+        /// @brief Live particles are kept, the ones past a lower MaxParticles are dropped
+        void SetSettings(const Settings &inSettings);
+        const Settings &GetSettings() const { return mSettings; }
+
+        /// @brief Advances the simulation and emits new particles from the origin of inTransform
+        void Update(float inDeltaTime, const glm::mat4 &inTransform);
+        /// @brief Writes the instance data of the live particles to the GPU and returns how many to draw
+        uint32_t Upload(const glm::vec3 &inEyePosition);
+        void Clear();
+
+        uint32_t GetParticleCount() const { return mCount; }
+        /// @brief World space bounds of the particle centers after the last Update
+        const Math::BoundingBox &GetBounds() const { return mBounds; }
+        VertexArrayHandle GetVertexArray() const { return mVertexArray; }
+    private:
+        // a particle is at the same index in every array
+        struct Pool
+        {
+            std::vector<float> PositionX, PositionY, PositionZ;
+            std::vector<float> VelocityX, VelocityY, VelocityZ;
+            std::vector<float> Age, Lifetime;
+
+            void Resize(uint32_t inCapacity);
+            void Move(uint32_t inFrom, uint32_t inTo);
+            // copies the particles of inSource in the order given, into [inBegin, inEnd)
+            void Gather(const Pool &inSource, const uint32_t *inOrder, uint32_t inBegin, uint32_t inEnd);
+        };
+
+        Settings mSettings;
+        Pool mPool;
+        uint32_t mCount = 0;
+        float mEmissionAccumulator = 0.0f;
+        std::mt19937 mRandom;
+        Math::BoundingBox mBounds;
+        // one bounds per job, merged after the update
+        std::vector<Math::BoundingBox> mJobBounds;
+
+        std::vector<float> mSortKeys;
+        std::vector<uint32_t> mOrder;
+        Pool mSorted;
+        std::vector<glm::mat4> mInstanceData;
+
+        std::shared_ptr<VertexBuffer> mQuadVertices;
+        std::shared_ptr<IndexBuffer> mQuadIndices;
+        std::shared_ptr<VertexBuffer> mInstanceBuffer;
+        uint32_t mInstanceCapacity = 0;
+        VertexArrayHandle mVertexArray;
+
+        void Emit(uint32_t inCount, const glm::mat4 &inTransform);
+        void Simulate(uint32_t inBegin, uint32_t inEnd, float inDeltaTime, Math::BoundingBox &outBounds);
+        void RemoveDead();
+        void SortBackToFront(const glm::vec3 &inEyePosition);
+        void RebuildVertexArray(uint32_t inCapacity);
+    };
+}
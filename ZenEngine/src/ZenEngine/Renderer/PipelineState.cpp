@@ -0,0 +1,35 @@
+#include "PipelineState.h"
+
+#include "ZenEngine/Core/Hash.h"
+
+namespace ZenEngine
+{
+    uint64_t PipelineState::GetHash() const
+    {
+        uint64_t hash = Shader.GetValue();
+        Hash::Combine(hash, VertexLayout);
+        Hash::Combine(hash, static_cast<uint32_t>(Streams));
+        Hash::Combine(hash, static_cast<uint32_t>(Topology));
+        Hash::Combine(hash, static_cast<uint32_t>(Cull));
+        Hash::Combine(hash, DepthTest);
+        Hash::Combine(hash, DepthWrite);
+        Hash::Combine(hash, static_cast<uint32_t>(DepthFunction));
+        Hash::Combine(hash, ColorWrite);
+        Hash::Combine(hash, Blend);
+        Hash::Combine(hash, static_cast<uint32_t>(BlendMode));
+        Hash::Combine(hash, static_cast<uint32_t>(SourceBlend));
+        Hash::Combine(hash, static_cast<uint32_t>(DestinationBlend));
+        return hash;
+    }
+
+    PipelineStateId PipelineStateCache::CreateOrGet(const PipelineState &inState)
+    {
+        auto it = mLookup.find(inState);
+        if (it != mLookup.end()) return it->second;
+
+        PipelineStateId id = static_cast<PipelineStateId>(mStates.size());
+        mStates.push_back(inState);
+        mLookup[inState] = id;
+        return id;
+    }
+}
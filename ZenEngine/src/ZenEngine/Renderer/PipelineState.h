@@ -0,0 +1,62 @@
+#pragma once
+
+#include <deque>
+#include <limits>
+#include <unordered_map>
+
+#include "RendererAPI.h"
+#include "ResourceHandle.h"
+#include "VertexArray.h"
+
+namespace ZenEngine
+{
+    /// @brief Immutable description of the fixed function state and shader used by a draw
+    struct PipelineState
+    {
+        ShaderHandle Shader;
+        // hash of the vertex layout the shader is fed with, see VertexArray::GetLayoutHash
+        uint64_t VertexLayout = 0;
+        // depth only passes read the packed positions of the meshes that have them, see VertexArray::AddPositionBuffer
+        VertexArray::Streams Streams = VertexArray::Streams::All;
+        RendererAPI::PrimitiveTopology Topology = RendererAPI::PrimitiveTopology::Triangles;
+        RendererAPI::CullMode Cull = RendererAPI::CullMode::None;
+
+        bool DepthTest = true;
+        bool DepthWrite = true;
+        RendererAPI::DepthFunction DepthFunction = RendererAPI::DepthFunction::Less;
+        bool ColorWrite = true;
+
+        bool Blend = false;
+        RendererAPI::BlendMode BlendMode = RendererAPI::BlendMode::Add;
+        RendererAPI::BlendFunction SourceBlend = RendererAPI::BlendFunction::SourceAlpha;
+        RendererAPI::BlendFunction DestinationBlend = RendererAPI::BlendFunction::OneMinusSourceAlpha;
+
+        bool operator==(const PipelineState &inOther) const = default;
+
+        uint64_t GetHash() const;
+    };
+
+    using PipelineStateId = uint32_t;
+    constexpr PipelineStateId InvalidPipelineState = std::numeric_limits<PipelineStateId>::max();
+
+    /// @brief Deduplicates pipeline states and gives each distinct one a small stable id.
+    /// Ids are handed out in creation order, so they are cheap to compare and to sort by.
+    class PipelineStateCache
+    {
+    public:
+        PipelineStateId CreateOrGet(const PipelineState &inState);
+        const PipelineState &Get(PipelineStateId inId) const { return mStates[inId]; }
+
+        uint32_t GetSize() const { return static_cast<uint32_t>(mStates.size()); }
+
+    private:
+        struct Hasher
+        {
+            size_t operator()(const PipelineState &inState) const { return static_cast<size_t>(inState.GetHash()); }
+        };
+
+        // deque so references returned by Get stay valid while the cache grows
+        std::deque<PipelineState> mStates;
+        std::unordered_map<PipelineState, PipelineStateId, Hasher> mLookup;
+    };
+}
@@ -6,6 +6,7 @@
 #include "ZenEngine/Core/Window.h"
 
 #include "Platform/OpenGL/OpenGLGLFWRenderContext.h"
+#include "Platform/Software/SoftwareGLFWRenderContext.h"
 
 #include <GLFW/glfw3.h>
 
@@ -26,6 +27,14 @@ namespace ZenEngine
             default:                   ZE_ASSERT_CORE_MSG(false, "The window platform is currently not supported by OpenGL!"); return nullptr;
             }
         }
+        case RendererAPI::API::Software:
+        {
+            switch (Window::GetWindowPlatform())
+            {
+            case WindowPlatform::GLFW: return std::make_unique<SoftwareGLFWRenderContext>(static_cast<GLFWwindow*>(inNativeWindow));
+            default:                   ZE_ASSERT_CORE_MSG(false, "The window platform is currently not supported by the software renderer!"); return nullptr;
+            }
+        }
         }
 
         ZE_ASSERT_CORE_MSG(false, "Unknown RendererAPI!");
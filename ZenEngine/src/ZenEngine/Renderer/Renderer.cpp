@@ -4,6 +4,11 @@
 #include "Material.h"
 #include "VertexBuffer.h"
 #include "IndexBuffer.h"
+#include "SpriteRenderer.h"
+#include "TextureStreamer.h"
+
+#include <algorithm>
+#include <glm/gtc/matrix_transform.hpp>
 
 namespace ZenEngine
 {
@@ -14,14 +19,19 @@ namespace ZenEngine
         mRenderContext = RenderContext::Create(inWindow->GetNativeWindow());
         mRenderContext->Init();
         mRendererAPI->Init();
+        // before any resource is created, so every upload goes through it
+        mUploadManager = UploadManager::Create();
+        mResourceLoader = ResourceLoader::Create(inWindow->GetNativeWindow());
         mEditorGUI = std::make_unique<EditorGUI>();
         mEditorGUI->Init();
 
-        mShaderGlobalsBuffer = UniformBuffer::Create(sizeof(ShaderGlobals), 1);
+        auto &registry = ResourceRegistry::Get();
+        mShaderGlobalsBuffer = registry.Register(UniformBuffer::Create(sizeof(ShaderGlobals), 1));
 
         Framebuffer::Properties props;
         props.Width = inWindow->GetWidth();
         props.Height = inWindow->GetHeight();
+        mViewportHeight = props.Height;
         props.AttachmentProps = { 
             Framebuffer::TextureFormat::RGBA8,   // base color buffer and specular
             Framebuffer::TextureFormat::RGBA8,   // normal buffer
@@ -29,7 +39,7 @@ namespace ZenEngine
                                                  // will contain roughness, metallic, AO
             Framebuffer::TextureFormat::Depth24Stencil8 // depth stencil buffer
         };
-        mGBuffer = Framebuffer::Create(props);
+        mGBuffer = registry.Register(Framebuffer::Create(props));
 
         auto vbo = VertexBuffer::Create({
             1.0f, 1.0f,
@@ -45,20 +55,106 @@ namespace ZenEngine
             { ShaderDataType::Float2, "Position", 0 }
         };
         vbo->SetLayout(layout);
-        mFullScreenQuad = VertexArray::Create();
-        mFullScreenQuad->AddVertexBuffer(vbo);
-        mFullScreenQuad->SetIndexBuffer(ibo);
+        auto fullScreenQuad = VertexArray::Create();
+        fullScreenQuad->AddVertexBuffer(vbo);
+        fullScreenQuad->SetIndexBuffer(ibo);
+        mFullScreenQuad = registry.Register(fullScreenQuad);
+
+        auto cubeVertices = VertexBuffer::Create({
+            -1.0f, -1.0f, -1.0f,
+             1.0f, -1.0f, -1.0f,
+             1.0f,  1.0f, -1.0f,
+            -1.0f,  1.0f, -1.0f,
+            -1.0f, -1.0f,  1.0f,
+             1.0f, -1.0f,  1.0f,
+             1.0f,  1.0f,  1.0f,
+            -1.0f,  1.0f,  1.0f
+        });
+        cubeVertices->SetLayout({ { ShaderDataType::Float3, "Position" } });
+        auto cube = VertexArray::Create();
+        cube->AddVertexBuffer(cubeVertices);
+        cube->SetIndexBuffer(IndexBuffer::Create({
+            0, 2, 1, 0, 3, 2,
+            4, 5, 6, 4, 6, 7,
+            0, 1, 5, 0, 5, 4,
+            3, 6, 2, 3, 7, 6,
+            0, 4, 7, 0, 7, 3,
+            1, 2, 6, 1, 6, 5
+        }));
+        mBoundingBoxCube = registry.Register(cube);
 
         RecompileLightingModelShader();
-        mBlitRGBShader = Shader::Create("resources/Shaders/BlitRGB.hlsl");
-        mBlitAlphaShader = Shader::Create("resources/Shaders/BlitAlpha.hlsl");
-        mBlitDepth = Shader::Create("resources/Shaders/BlitDepth.hlsl");
-        mBlitWorldPositionShader = Shader::Create("resources/Shaders/BlitWorldPosition.hlsl");
+        mBlitRGBShader = registry.Register(Shader::Create("resources/Shaders/BlitRGB.hlsl"));
+        mBlitAlphaShader = registry.Register(Shader::Create("resources/Shaders/BlitAlpha.hlsl"));
+        mBlitDepth = registry.Register(Shader::Create("resources/Shaders/BlitDepth.hlsl"));
+        mBlitWorldPositionShader = registry.Register(Shader::Create("resources/Shaders/BlitWorldPosition.hlsl"));
+        mDepthPrePassShader = registry.Register(Shader::Create("resources/Shaders/DepthPrePass.hlsl"));
+        mDepthPrePassInstancedShader = registry.Register(Shader::Create("resources/Shaders/DepthPrePassInstanced.hlsl"));
+        mParticleShader = registry.Register(Shader::Create("resources/Shaders/Particle.hlsl"));
+        mTerrainShader = registry.Register(Shader::Create("resources/Shaders/Terrain.hlsl"));
+
+        Texture2D::Properties whiteProps;
+        whiteProps.GenerateMips = false;
+        uint32_t white = 0xffffffff;
+        mWhiteTexture = registry.Register(Texture2D::Create(whiteProps, &white, sizeof(white)));
+
+        PipelineState depthPrePass;
+        depthPrePass.Shader = mDepthPrePassShader;
+        depthPrePass.ColorWrite = false;
+        depthPrePass.Streams = VertexArray::Streams::Position;
+        mDepthPrePassState = mPipelineStateCache.CreateOrGet(depthPrePass);
+        depthPrePass.Shader = mDepthPrePassInstancedShader;
+        mDepthPrePassInstancedState = mPipelineStateCache.CreateOrGet(depthPrePass);
+
+        // the boxes only count the samples in front of the depth buffer, they must not change it
+        PipelineState occlusionQuery;
+        occlusionQuery.Shader = mDepthPrePassShader;
+        occlusionQuery.VertexLayout = registry.Resolve(mBoundingBoxCube)->GetLayoutHash();
+        occlusionQuery.DepthWrite = false;
+        occlusionQuery.ColorWrite = false;
+        mOcclusionQueryState = mPipelineStateCache.CreateOrGet(occlusionQuery);
+
+        mLightingModelState = CreateFullScreenPassState(mLightingModelShader);
+        mBlitRGBState = CreateFullScreenPassState(mBlitRGBShader);
+        mBlitAlphaState = CreateFullScreenPassState(mBlitAlphaShader);
+        mBlitDepthState = CreateFullScreenPassState(mBlitDepth);
+        mBlitWorldPositionState = CreateFullScreenPassState(mBlitWorldPositionShader);
+
+        DebugDraw::Get().Init();
+        PipelineState debugDraw;
+        debugDraw.Shader = DebugDraw::Get().GetShader();
+        debugDraw.VertexLayout = registry.Resolve(DebugDraw::Get().GetVertexArray())->GetLayoutHash();
+        debugDraw.Topology = RendererAPI::PrimitiveTopology::Lines;
+        // the target has no scene depth, the shader tests against the G-buffer one
+        debugDraw.DepthTest = false;
+        debugDraw.DepthWrite = false;
+        debugDraw.Blend = true;
+        mDebugDrawState = mPipelineStateCache.CreateOrGet(debugDraw);
+
+        SpriteRenderer::Get().Init();
+
+        mDepthPrePassTimer = GPUTimer::Create();
+        mGeometryPassTimer = GPUTimer::Create();
+        mLightingPassTimer = GPUTimer::Create();
+        mOcclusionQueries = OcclusionQueryPool::Create();
     }
 
     void Renderer::Shutdown()
     {
+        // stopped first, a load in flight may still be creating resources
+        mResourceLoader.reset();
         mEditorGUI->Shutdown();
+        DebugDraw::Get().Shutdown();
+        SpriteRenderer::Get().Shutdown();
+        mDepthPrePassTimer.reset();
+        mGeometryPassTimer.reset();
+        mLightingPassTimer.reset();
+        mOcclusionQueries.reset();
+        ResourceRegistry::Get().Shutdown();
+        mUploadManager.reset();
+        // the API has to go before the context it records into
+        mRendererAPI.reset();
+        mRenderContext.reset();
     }
 
     void Renderer::BeginScene(const CameraView &inCameraView, const LightInfo &inLightInfo)
@@ -74,89 +170,460 @@ namespace ZenEngine
         mShaderGlobals.DirectionalLightColor = inLightInfo.Directional.DirectionalLightColor;
         mShaderGlobals.DirectionalLightIntensity = inLightInfo.Directional.DirectionalLightIntensity;
         mShaderGlobals.DirectionalLightDirection = inLightInfo.Directional.DirectionalLightDirection;
-        mShaderGlobalsBuffer->SetData(&mShaderGlobals, sizeof(ShaderGlobals));
+        ResourceRegistry::Get().Resolve(mShaderGlobalsBuffer)->SetData(&mShaderGlobals, sizeof(ShaderGlobals));
+        mViewFrustum = Math::Frustum::FromMatrix(mShaderGlobals.ViewProjectionMatrix);
+        mProjectionScale = inCameraView.ProjectionMatrix[1][1];
+        mIsPerspective = inCameraView.IsPerspective;
     }
 
-    void Renderer::Flush(std::shared_ptr<Framebuffer> inTargetFramebuffer, BufferType inBufferType)
+    void Renderer::Flush(FramebufferHandle inTargetFramebuffer, BufferType inBufferType)
     {
+        auto &registry = ResourceRegistry::Get();
+        auto *gBuffer = registry.Resolve(mGBuffer);
+        auto *targetFramebuffer = registry.Resolve(inTargetFramebuffer);
+
+        // the queued uploads land before anything that could sample them is drawn
+        mUploadManager->Flush();
         RenderCommand::SetClearColor({ 0.0f, 0.0f, 0.0f, 0.0f });
         // geometry pass
-        mShaderGlobalsBuffer->Bind();
-        mGBuffer->Bind();
-        RenderCommand::Clear();
-        mRendererAPI->EnableDepthTest();
-        mRendererAPI->DisableBlend();
+        registry.Resolve(mShaderGlobalsBuffer)->Bind();
+        gBuffer->Bind();
+        // anything outside the renderer (e.g. the editor GUI) may have touched the state since the last flush
+        mRendererAPI->InvalidatePipelineState();
         mRendererAPI->SetDepthMask(true);
-        while (!mGeometryQueue.empty())
+        mRendererAPI->SetColorMask(true);
+        RenderCommand::Clear();
+        mStatistics.DrawCalls = 0;
+        mStatistics.Instances = 0;
+        mStatistics.TerrainPatches = 0;
+        mStatistics.PipelineStateChanges = 0;
+        mStatistics.OcclusionQueries = 0;
+        mStatistics.ConditionalDraws = 0;
+
+        // a material that cannot bind draws nothing, not even its depth in the pre-pass, where it would hide what is behind it
+        std::erase_if(mGeometryQueue, [](const GeometryInfo &inGeometry) { return !inGeometry.Mat->IsReady(); });
+
+        PipelineStateId currentState = InvalidPipelineState;
+        if (mDepthPrePassEnabled)
+        {
+            // front to back so that most occluded fragments fail the depth test already during the pre-pass
+            std::sort(mGeometryQueue.begin(), mGeometryQueue.end(), [](const GeometryInfo &inA, const GeometryInfo &inB)
+            {
+                return inA.DistanceFromEye < inB.DistanceFromEye;
+            });
+
+            mDepthPrePassTimer->Begin();
+            DrawTerrains(true, currentState);
+            for (const auto &geometry : mGeometryQueue)
+            {
+                if (geometry.Predicate >= 0) continue;
+                SetPipelineState(geometry.InstanceCount > 0 ? mDepthPrePassInstancedState : mDepthPrePassState, currentState);
+                SetModelMatrix(geometry.Transform);
+                DrawGeometry(geometry);
+                ++mStatistics.DrawCalls;
+            }
+            mDepthPrePassTimer->End();
+            DrawOcclusionQueries(currentState);
+
+            // the depth buffer is final now, overdraw no longer matters so group by state instead
+            std::stable_sort(mGeometryQueue.begin(), mGeometryQueue.end(), [](const GeometryInfo &inA, const GeometryInfo &inB)
+            {
+                return inA.PipelineState < inB.PipelineState;
+            });
+        }
+        else
+        {
+            // the predicated draws go last, the box queries they wait for are tested against the depth of all the others
+            std::sort(mGeometryQueue.begin(), mGeometryQueue.end(), [](const GeometryInfo &inA, const GeometryInfo &inB)
+            {
+                if ((inA.Predicate >= 0) != (inB.Predicate >= 0)) return inB.Predicate >= 0;
+                if (inA.PipelineState != inB.PipelineState) return inA.PipelineState < inB.PipelineState;
+                return inA.DistanceFromEye < inB.DistanceFromEye;
+            });
+        }
+
+        mGeometryPassTimer->Begin();
+        DrawTerrains(false, currentState);
+        // the pre-pass has issued the box queries already, without it they are issued once the depth is complete but
+        // for the predicated draws, so a draw is always predicated on the box tested in the same frame
+        bool occlusionQueriesDrawn = mDepthPrePassEnabled;
+        for (const auto &geometry : mGeometryQueue)
         {
-            auto &geometry = mGeometryQueue.front();
-            mGeometryQueue.pop();
-            mShaderGlobals.ModelMatrix = geometry.Transform;
-            mShaderGlobalsBuffer->SetData(&mShaderGlobals.ModelMatrix, sizeof(glm::mat4), offsetof(ShaderGlobals, ModelMatrix));
-            geometry.Mat->Bind();
-            mRendererAPI->DrawIndexed(geometry.VertexArray);
+            if (!occlusionQueriesDrawn && geometry.Predicate >= 0)
+            {
+                DrawOcclusionQueries(currentState);
+                occlusionQueriesDrawn = true;
+            }
+
+            // after the pre-pass shade only the fragments that survived, with a LESS_EQUAL test and no depth writes.
+            // Predicated draws missed the pre-pass, they still have to test and write their depth
+            bool prePassDepth = mDepthPrePassEnabled && geometry.Predicate < 0;
+            SetPipelineState(prePassDepth ? GetPrePassDepthState(geometry.PipelineState) : geometry.PipelineState, currentState);
+            SetModelMatrix(geometry.Transform);
+            if (!geometry.Mat->Bind()) continue;
+
+            if (geometry.Predicate >= 0)
+            {
+                mOcclusionQueries->BeginConditionalRender(static_cast<uint32_t>(geometry.Predicate));
+                ++mStatistics.ConditionalDraws;
+            }
+            if (geometry.Query >= 0)
+            {
+                mOcclusionQueries->Begin(static_cast<uint32_t>(geometry.Query));
+                ++mStatistics.OcclusionQueries;
+            }
+            DrawGeometry(geometry);
+            if (geometry.Query >= 0) mOcclusionQueries->End(static_cast<uint32_t>(geometry.Query));
+            if (geometry.Predicate >= 0) mOcclusionQueries->EndConditionalRender();
+
+            ++mStatistics.DrawCalls;
+            mStatistics.Instances += std::max(geometry.InstanceCount, 1u);
         }
+        mGeometryPassTimer->End();
+        // nothing was predicated, the boxes still tell the culler when a hidden object shows up again
+        if (!occlusionQueriesDrawn) DrawOcclusionQueries(currentState);
+        mGeometryQueue.clear();
+        mIndexRanges.clear();
+        mTerrainQueue.clear();
 
-        mGBuffer->Unbind();
+        gBuffer->Unbind();
 
-        if (inTargetFramebuffer != nullptr) 
-            inTargetFramebuffer->Bind();
+        if (targetFramebuffer != nullptr) 
+            targetFramebuffer->Bind();
     
-        mRendererAPI->DisableDepthTest();
+        mLightingPassTimer->Begin();
         switch (inBufferType)
         {
         case BufferType::FinalScene:
-            mLightingModelShader->Bind();
-            mGBuffer->BindAllAttachments();
+            SetPipelineState(mLightingModelState, currentState);
+            gBuffer->BindAllAttachments();
             mRendererAPI->DrawIndexed(mFullScreenQuad);
             break;
         case BufferType::BaseColor:
-            mBlitRGBShader->Bind();
-            mGBuffer->BindColorAttachmentTexture(0, 0);
+            SetPipelineState(mBlitRGBState, currentState);
+            gBuffer->BindColorAttachmentTexture(0, 0);
             mRendererAPI->DrawIndexed(mFullScreenQuad);
             break;
         case BufferType::Normal:
-            mBlitRGBShader->Bind();
-            mGBuffer->BindColorAttachmentTexture(1, 0);
+            SetPipelineState(mBlitRGBState, currentState);
+            gBuffer->BindColorAttachmentTexture(1, 0);
             mRendererAPI->DrawIndexed(mFullScreenQuad);
             break;
         case BufferType::Specular:
-            mBlitAlphaShader->Bind();
-            mGBuffer->BindColorAttachmentTexture(0, 0);
+            SetPipelineState(mBlitAlphaState, currentState);
+            gBuffer->BindColorAttachmentTexture(0, 0);
             mRendererAPI->DrawIndexed(mFullScreenQuad);
             break;
         case BufferType::Depth:
-            mBlitDepth->Bind();
-            mGBuffer->BindDepthAttachmentTexture(0);
+            SetPipelineState(mBlitDepthState, currentState);
+            gBuffer->BindDepthAttachmentTexture(0);
             mRendererAPI->DrawIndexed(mFullScreenQuad);
             break;
         case BufferType::WorldPosition:
-            mBlitWorldPositionShader->Bind();
-            mGBuffer->BindDepthAttachmentTexture(0);
+            SetPipelineState(mBlitWorldPositionState, currentState);
+            gBuffer->BindDepthAttachmentTexture(0);
             mRendererAPI->DrawIndexed(mFullScreenQuad);
             break;
         }
+        mLightingPassTimer->End();
+        mStatistics.DrawCalls++;
+
+        DrawParticles(gBuffer, currentState);
+        DrawDebugGeometry(gBuffer, currentState);
+
+        if (targetFramebuffer != nullptr) 
+            targetFramebuffer->Unbind();
+
+        UpdateStatistics();
+    }
+
+    void Renderer::Submit(VertexArrayHandle inVertexArray, const glm::mat4 &inTransform, Material &inMaterial)
+    {
+        Submit(inVertexArray, inTransform, glm::vec3(inTransform[3]), inMaterial);
+    }
+
+    void Renderer::Submit(VertexArrayHandle inVertexArray, const glm::mat4 &inTransform, const glm::vec3 &inSortPosition, Material &inMaterial)
+    {
+        auto *vertexArray = ResourceRegistry::Get().Resolve(inVertexArray);
+        if (vertexArray == nullptr) return;
+        PipelineStateId pipelineState = inMaterial.GetPipelineState(vertexArray->GetLayoutHash());
+        float distanceFromEye = glm::length(inSortPosition - mShaderGlobals.EyePosition);
+        mGeometryQueue.push_back({ inVertexArray, &inMaterial, pipelineState, inTransform, distanceFromEye, 0, 0, 0, -1, -1 });
+    }
+
+    void Renderer::Submit(VertexArrayHandle inVertexArray, const glm::mat4 &inTransform, Material &inMaterial, const OcclusionTest &inOcclusion)
+    {
+        size_t queued = mGeometryQueue.size();
+        Submit(inVertexArray, inTransform, inMaterial);
+        if (mGeometryQueue.size() == queued) return;
+        mGeometryQueue.back().Query = inOcclusion.Query;
+        mGeometryQueue.back().Predicate = inOcclusion.Predicate;
+    }
+
+    void Renderer::SubmitOcclusionQuery(uint32_t inQuery, const Math::BoundingBox &inBounds)
+    {
+        if (!inBounds.IsValid()) return;
+        mOcclusionQueue.push_back({ inQuery, inBounds });
+    }
+
+    void Renderer::SubmitInstanced(VertexArrayHandle inVertexArray, uint32_t inInstanceCount, const glm::mat4 &inTransform, Material &inMaterial)
+    {
+        auto *vertexArray = ResourceRegistry::Get().Resolve(inVertexArray);
+        if (vertexArray == nullptr || inInstanceCount == 0) return;
+        PipelineStateId pipelineState = inMaterial.GetPipelineState(vertexArray->GetLayoutHash());
+        // the instances are spread around, the origin of the batch is only a rough key for the front to back order
+        float distanceFromEye = glm::length(glm::vec3(inTransform[3]) - mShaderGlobals.EyePosition);
+        mGeometryQueue.push_back({ inVertexArray, &inMaterial, pipelineState, inTransform, distanceFromEye, inInstanceCount, 0, 0, -1, -1 });
+    }
 
-        if (inTargetFramebuffer != nullptr) 
-            inTargetFramebuffer->Unbind();
+    void Renderer::SubmitRanges(VertexArrayHandle inVertexArray, const RendererAPI::IndexRange *inRanges, uint32_t inRangeCount, const glm::mat4 &inTransform, Material &inMaterial)
+    {
+        auto *vertexArray = ResourceRegistry::Get().Resolve(inVertexArray);
+        if (vertexArray == nullptr || inRangeCount == 0) return;
+        PipelineStateId pipelineState = inMaterial.GetPipelineState(vertexArray->GetLayoutHash());
+        float distanceFromEye = glm::length(glm::vec3(inTransform[3]) - mShaderGlobals.EyePosition);
+        uint32_t firstRange = static_cast<uint32_t>(mIndexRanges.size());
+        mIndexRanges.insert(mIndexRanges.end(), inRanges, inRanges + inRangeCount);
+        mGeometryQueue.push_back({ inVertexArray, &inMaterial, pipelineState, inTransform, distanceFromEye, 0, firstRange, inRangeCount, -1, -1 });
     }
 
-    void Renderer::Submit(const std::shared_ptr<class VertexArray> &inVertexArray, const glm::mat4 &inTransform, const std::shared_ptr<Material> &inMaterial)
+    void Renderer::SubmitParticles(ParticleEmitter &inEmitter, Texture2DHandle inTexture)
     {
-        mGeometryQueue.push({ inVertexArray, inMaterial, inTransform });
+        uint32_t count = inEmitter.Upload(mShaderGlobals.EyePosition);
+        if (count == 0) return;
+        float distanceFromEye = glm::length(inEmitter.GetBounds().GetCenter() - mShaderGlobals.EyePosition);
+        mParticleQueue.push_back({ inEmitter.GetVertexArray(), count, inTexture, inEmitter.GetSettings().Blend, distanceFromEye });
+    }
+
+    void Renderer::SubmitTerrain(Terrain &inTerrain, const glm::vec3 &inPosition, Texture2DHandle inTexture)
+    {
+        if (inTerrain.Update(inPosition, mShaderGlobals.EyePosition, mViewFrustum) == 0) return;
+        mTerrainQueue.push_back({ &inTerrain, glm::translate(glm::mat4(1.0f), inPosition), inTexture });
     }
 
     void Renderer::SetViewport(uint32_t inX, uint32_t inY, uint32_t inWidth, uint32_t inHeight)
     {
-        mGBuffer->Resize(inWidth, inHeight);
+        ResourceRegistry::Get().Resolve(mGBuffer)->Resize(inWidth, inHeight);
         mRendererAPI->SetViewport(inX, inY, inWidth, inHeight);
+        mViewportHeight = inHeight;
+    }
+
+    float Renderer::GetProjectedSize(float inRadius, float inDistance) const
+    {
+        // with a perspective the scale is cot(fov / 2): a sphere spans radius * scale / distance of half the viewport
+        float size = inRadius * mProjectionScale * static_cast<float>(mViewportHeight);
+        return mIsPerspective ? size / std::max(inDistance, mShaderGlobals.NearPlane) : size;
+    }
+
+    float Renderer::GetProjectedSize(const Math::BoundingBox &inWorldBounds) const
+    {
+        float radius = glm::length(inWorldBounds.GetExtents());
+        return GetProjectedSize(radius, glm::distance(inWorldBounds.GetCenter(), mShaderGlobals.EyePosition) - radius);
+    }
+
+    void Renderer::SwapBuffers()
+    {
+        mRenderContext->SwapBuffers();
+        mUploadManager->EndFrame();
+        TextureStreamer::Get().Update();
+        mResourceLoader->Update();
+        ResourceRegistry::Get().EndFrame();
     }
 
     void Renderer::RecompileLightingModelShader()
     {
-        mLightingModelShader = Shader::Create("resources/Shaders/DeferredShading.hlsl");
+        auto shader = Shader::Create("resources/Shaders/DeferredShading.hlsl");
+        if (mLightingModelShader.IsNull())
+            mLightingModelShader = ResourceRegistry::Get().Register(shader);
+        else
+            ResourceRegistry::Get().Replace(mLightingModelShader, shader);
+    }
+
+    void Renderer::SetModelMatrix(const glm::mat4 &inTransform)
+    {
+        mShaderGlobals.ModelMatrix = inTransform;
+        ResourceRegistry::Get().Resolve(mShaderGlobalsBuffer)->SetData(&mShaderGlobals.ModelMatrix, sizeof(glm::mat4), offsetof(ShaderGlobals, ModelMatrix));
+    }
+
+    void Renderer::DrawGeometry(const GeometryInfo &inGeometry)
+    {
+        if (inGeometry.InstanceCount > 0)
+            mRendererAPI->DrawIndexedInstanced(inGeometry.VertexArray, inGeometry.InstanceCount);
+        else if (inGeometry.RangeCount > 0)
+            mRendererAPI->DrawIndexedRanges(inGeometry.VertexArray, mIndexRanges.data() + inGeometry.FirstRange, inGeometry.RangeCount);
+        else
+            mRendererAPI->DrawIndexed(inGeometry.VertexArray);
+    }
+
+    void Renderer::DrawDebugGeometry(Framebuffer *inGBuffer, PipelineStateId &ioCurrentState)
+    {
+        uint32_t vertexCount = DebugDraw::Get().Upload();
+        if (vertexCount == 0) return;
+        SetPipelineState(mDebugDrawState, ioCurrentState);
+        inGBuffer->BindDepthAttachmentTexture(0);
+        mRendererAPI->DrawLines(DebugDraw::Get().GetVertexArray(), vertexCount);
+        ++mStatistics.DrawCalls;
+    }
+
+    void Renderer::DrawParticles(Framebuffer *inGBuffer, PipelineStateId &ioCurrentState)
+    {
+        mStatistics.Particles = 0;
+        if (mParticleQueue.empty()) return;
+
+        std::sort(mParticleQueue.begin(), mParticleQueue.end(), [](const ParticleInfo &inA, const ParticleInfo &inB)
+        {
+            return inA.DistanceFromEye > inB.DistanceFromEye;
+        });
+
+        auto &registry = ResourceRegistry::Get();
+        inGBuffer->BindDepthAttachmentTexture(0);
+        for (const auto &particles : mParticleQueue)
+        {
+            auto *vertexArray = registry.Resolve(particles.VertexArray);
+            if (vertexArray == nullptr) continue;
+
+            PipelineState state;
+            state.Shader = mParticleShader;
+            state.VertexLayout = vertexArray->GetLayoutHash();
+            // the target has no scene depth, the shader tests against the G-buffer one
+            state.DepthTest = false;
+            state.DepthWrite = false;
+            state.Blend = true;
+            if (particles.Blend == ParticleEmitter::BlendMode::Additive)
+                state.DestinationBlend = RendererAPI::BlendFunction::One;
+            SetPipelineState(mPipelineStateCache.CreateOrGet(state), ioCurrentState);
+
+            auto *texture = registry.Resolve(particles.Texture);
+            (texture != nullptr ? texture : registry.Resolve(mWhiteTexture))->Bind(1);
+            mRendererAPI->DrawIndexedInstanced(particles.VertexArray, particles.Count);
+            ++mStatistics.DrawCalls;
+            mStatistics.Particles += particles.Count;
+        }
+        mParticleQueue.clear();
     }
 
+    void Renderer::DrawTerrains(bool inDepthOnly, PipelineStateId &ioCurrentState)
+    {
+        auto &registry = ResourceRegistry::Get();
+        auto *shader = registry.Resolve(mTerrainShader);
+        if (shader == nullptr) return;
+
+        for (const auto &terrain : mTerrainQueue)
+        {
+            auto *vertexArray = registry.Resolve(terrain.TerrainData->GetVertexArray());
+            auto *heights = registry.Resolve(terrain.TerrainData->GetHeightTexture());
+            if (vertexArray == nullptr || heights == nullptr) continue;
+
+            // the pre-pass runs the same vertex shader so the geometry pass finds the exact same depth
+            PipelineState state;
+            state.Shader = mTerrainShader;
+            state.VertexLayout = vertexArray->GetLayoutHash();
+            state.ColorWrite = !inDepthOnly;
+            PipelineStateId stateId = mPipelineStateCache.CreateOrGet(state);
+            if (!inDepthOnly && mDepthPrePassEnabled)
+                stateId = GetPrePassDepthState(stateId);
+            SetPipelineState(stateId, ioCurrentState);
+            SetModelMatrix(terrain.Transform);
+
+            const auto &surface = terrain.TerrainData->GetSurface();
+            glm::vec2 size = terrain.TerrainData->GetHeightMap().GetSize();
+            shader->SetFloat4("ClipmapParameters", terrain.TerrainData->GetClipmapParameters());
+            shader->SetFloat2("TerrainSize", size);
+            shader->SetFloat3("BaseColor", surface.BaseColor);
+            shader->SetFloat("Specular", surface.Specular);
+            shader->SetFloat("Shininess", surface.Shininess);
+            shader->SetFloat("TextureScale", surface.TextureScale);
+
+            auto *texture = registry.Resolve(terrain.Texture);
+            (texture != nullptr ? texture : registry.Resolve(mWhiteTexture))->Bind(0);
+            heights->Bind(1);
+
+            uint32_t patches = terrain.TerrainData->GetPatchCount();
+            mRendererAPI->DrawIndexedInstanced(terrain.TerrainData->GetVertexArray(), patches);
+            ++mStatistics.DrawCalls;
+            if (!inDepthOnly)
+            {
+                mStatistics.Instances += patches;
+                mStatistics.TerrainPatches += patches;
+            }
+        }
+    }
+
+    void Renderer::DrawOcclusionQueries(PipelineStateId &ioCurrentState)
+    {
+        if (mOcclusionQueue.empty()) return;
+
+        SetPipelineState(mOcclusionQueryState, ioCurrentState);
+        for (const auto &[query, bounds] : mOcclusionQueue)
+        {
+            // grown a little so the faces of a box never fight with the depth of the object inside it
+            glm::vec3 extents = bounds.GetExtents() * 1.01f + glm::vec3(1e-3f);
+            SetModelMatrix(glm::scale(glm::translate(glm::mat4(1.0f), bounds.GetCenter()), extents));
+            mOcclusionQueries->Begin(query);
+            mRendererAPI->DrawIndexed(mBoundingBoxCube);
+            mOcclusionQueries->End(query);
+            ++mStatistics.DrawCalls;
+            ++mStatistics.OcclusionQueries;
+        }
+        mOcclusionQueue.clear();
+    }
+
+    void Renderer::SetPipelineState(PipelineStateId inState, PipelineStateId &ioCurrentState)
+    {
+        if (inState == ioCurrentState) return;
+        mRendererAPI->SetPipelineState(mPipelineStateCache.Get(inState));
+        ioCurrentState = inState;
+        ++mStatistics.PipelineStateChanges;
+    }
+
+    PipelineStateId Renderer::CreateFullScreenPassState(ShaderHandle inShader)
+    {
+        PipelineState state;
+        state.Shader = inShader;
+        state.VertexLayout = ResourceRegistry::Get().Resolve(mFullScreenQuad)->GetLayoutHash();
+        state.DepthTest = false;
+        return mPipelineStateCache.CreateOrGet(state);
+    }
+
+    PipelineStateId Renderer::GetPrePassDepthState(PipelineStateId inState)
+    {
+        if (inState >= mPrePassDepthStates.size())
+            mPrePassDepthStates.resize(inState + 1, InvalidPipelineState);
+
+        if (mPrePassDepthStates[inState] == InvalidPipelineState)
+        {
+            // not EQUAL, a material vertex shader may compute a position a rounding step closer than the pre-pass did.
+            // The depth buffer only holds the closest surfaces, so the overdraw is still none
+            PipelineState state = mPipelineStateCache.Get(inState);
+            state.DepthFunction = RendererAPI::DepthFunction::LessEqual;
+            state.DepthWrite = false;
+            mPrePassDepthStates[inState] = mPipelineStateCache.CreateOrGet(state);
+        }
+        return mPrePassDepthStates[inState];
+    }
+
+    void Renderer::UpdateStatistics()
+    {
+        mStatistics.PipelineStateCount = mPipelineStateCache.GetSize();
+
+        auto &uploads = mUploadManager->GetStatistics();
+        mStatistics.UploadBytes = uploads.Bytes;
+        mStatistics.Uploads = uploads.Uploads;
+        mStatistics.UploadStalls = uploads.Stalls;
+        mStatistics.PendingUploadBytes = uploads.PendingBytes;
+        mStatistics.PendingLoads = mResourceLoader->GetPendingCount();
+
+        // timer results lag a few frames behind, the smoothing hides the frames right after a toggle
+        constexpr float smoothing = 0.05f;
+
+        mStatistics.DepthPrePassTime = mDepthPrePassEnabled? mDepthPrePassTimer->GetElapsedMilliseconds() : 0.0f;
+        mStatistics.GeometryPassTime = mGeometryPassTimer->GetElapsedMilliseconds();
+        mStatistics.LightingPassTime = mLightingPassTimer->GetElapsedMilliseconds();
+
+        float opaqueTime = mStatistics.DepthPrePassTime + mStatistics.GeometryPassTime;
+        float &smoothedTime = mDepthPrePassEnabled? mStatistics.OpaqueTimeWithPrePass : mStatistics.OpaqueTimeWithoutPrePass;
+        smoothedTime = glm::mix(smoothedTime, opaqueTime, smoothing);
+    }
 
     void RenderCommand::Clear(uint32_t inFlags)
     {
@@ -1,6 +1,5 @@
 #pragma once
 
-#include <queue>
 #include <memory>
 #include <string>
 #include <sstream>
@@ -13,8 +12,18 @@
 #include "Framebuffer.h"
 #include "VertexArray.h"
 #include "Material.h"
+#include "GPUTimer.h"
+#include "OcclusionQuery.h"
+#include "UploadManager.h"
+#include "ResourceLoader.h"
+#include "ResourceRegistry.h"
+#include "PipelineState.h"
+#include "DebugDraw.h"
+#include "ParticleEmitter.h"
+#include "Terrain.h"
 
 #include "ZenEngine/Core/Log.h"
+#include "ZenEngine/Core/Math.h"
 #include "ZenEngine/Core/Window.h"
 #include "ZenEngine/Editor/EditorGUI.h"
 
@@ -88,9 +97,73 @@ namespace ZenEngine
 
         struct GeometryInfo
         {
-            std::shared_ptr<VertexArray> VertexArray;
-            std::shared_ptr<Material> Mat;
+            VertexArrayHandle VertexArray;
+            Material *Mat;
+            PipelineStateId PipelineState;
             glm::mat4 Transform;
+            float DistanceFromEye;
+            // 0 for a plain draw, the vertex array carries the instance data otherwise
+            uint32_t InstanceCount;
+            // index ranges stored in mIndexRanges, no ranges draws the whole index buffer
+            uint32_t FirstRange;
+            uint32_t RangeCount;
+            // occlusion queries of the draw, see OcclusionTest
+            int32_t Query;
+            int32_t Predicate;
+        };
+
+        /// @brief How a draw takes part in occlusion culling, the indices are queries of GetOcclusionQueries
+        struct OcclusionTest
+        {
+            // the samples of the draw that pass the depth test are counted by this query, -1 for none
+            int32_t Query = -1;
+            // the GPU drops the draw when this query saw no samples, -1 to always draw. Such draws are left out of the
+            // depth pre-pass and go after everything else without it, the box query they wait for is tested in between
+            int32_t Predicate = -1;
+        };
+
+        struct ParticleInfo
+        {
+            VertexArrayHandle VertexArray;
+            uint32_t Count;
+            Texture2DHandle Texture;
+            ParticleEmitter::BlendMode Blend;
+            float DistanceFromEye;
+        };
+
+        struct TerrainInfo
+        {
+            Terrain *TerrainData;
+            glm::mat4 Transform;
+            Texture2DHandle Texture;
+        };
+
+        struct Statistics
+        {
+            uint32_t DrawCalls = 0;
+            uint32_t Instances = 0;
+            uint32_t Particles = 0;
+            uint32_t TerrainPatches = 0;
+            uint32_t PipelineStateChanges = 0;
+            uint32_t PipelineStateCount = 0;
+            uint32_t OcclusionQueries = 0;
+            uint32_t ConditionalDraws = 0;
+
+            // uploads of the last finished frame
+            uint64_t UploadBytes = 0;
+            uint32_t Uploads = 0;
+            uint32_t UploadStalls = 0;
+            uint64_t PendingUploadBytes = 0;
+            uint32_t PendingLoads = 0;
+
+            // GPU times of the last measured frame in milliseconds
+            float DepthPrePassTime = 0.0f;
+            float GeometryPassTime = 0.0f;
+            float LightingPassTime = 0.0f;
+
+            // smoothed depth pre-pass + geometry pass time for each mode, so the two can be compared
+            float OpaqueTimeWithPrePass = 0.0f;
+            float OpaqueTimeWithoutPrePass = 0.0f;
         };
 
         enum class BufferType : uint32_t
@@ -114,34 +187,121 @@ namespace ZenEngine
         void Shutdown();
 
         void BeginScene(const CameraView &inCameraView, const LightInfo &inLightInfo);
-        void Flush(std::shared_ptr<Framebuffer> inTargetFramebuffer = nullptr, BufferType inBufferType = BufferType::FinalScene);
-        void Submit(const std::shared_ptr<VertexArray> &inVertexArray, const glm::mat4 &inTransform,  const std::shared_ptr<Material> &inMaterial);
+        void Flush(FramebufferHandle inTargetFramebuffer = FramebufferHandle::Null, BufferType inBufferType = BufferType::FinalScene);
+        // the material must stay alive until the next Flush
+        void Submit(VertexArrayHandle inVertexArray, const glm::mat4 &inTransform, Material &inMaterial);
+        /// @brief For geometry not centered on the origin of its transform, e.g. pre-transformed batches.
+        /// The world space inSortPosition is used for the front to back ordering
+        void Submit(VertexArrayHandle inVertexArray, const glm::mat4 &inTransform, const glm::vec3 &inSortPosition, Material &inMaterial);
+        void Submit(VertexArrayHandle inVertexArray, const glm::mat4 &inTransform, Material &inMaterial, const OcclusionTest &inOcclusion);
+        /// @brief Tests a world space box against the depth of the frame, after the depth pre-pass when it is enabled
+        /// and after the geometry pass otherwise. Nothing is drawn, only the query is written
+        void SubmitOcclusionQuery(uint32_t inQuery, const Math::BoundingBox &inBounds);
+        /// @brief Draws the first instances of a vertex array with per instance transforms, relative to inTransform.
+        /// The material shader has to read them, see InstanceToClipPosition in ZenShaderLib
+        void SubmitInstanced(VertexArrayHandle inVertexArray, uint32_t inInstanceCount, const glm::mat4 &inTransform, Material &inMaterial);
+        /// @brief Draws only some runs of the index buffer, e.g. the visible meshlets. The ranges are copied
+        void SubmitRanges(VertexArrayHandle inVertexArray, const RendererAPI::IndexRange *inRanges, uint32_t inRangeCount, const glm::mat4 &inTransform, Material &inMaterial);
+        /// @brief Particles are blended over the lit scene after the lighting pass, emitters are drawn back to front
+        /// @param inTexture a null handle draws plain colored quads
+        void SubmitParticles(ParticleEmitter &inEmitter, Texture2DHandle inTexture);
+        /// @brief Selects the patches of the terrain for the current view and queues them, the terrain is drawn before
+        /// the other geometry since it usually covers most of the screen
+        /// @param inTexture base color texture tiled over the terrain, a null handle draws it in the plain base color
+        void SubmitTerrain(Terrain &inTerrain, const glm::vec3 &inPosition, Texture2DHandle inTexture);
+
+        /// @brief World space frustum of the camera passed to BeginScene
+        const Math::Frustum &GetViewFrustum() const { return mViewFrustum; }
+        const glm::vec3 &GetEyePosition() const { return mShaderGlobals.EyePosition; }
+        float GetNearPlane() const { return mShaderGlobals.NearPlane; }
+        /// @brief Height in pixels a sphere of the radius covers on screen at the distance from the eye
+        float GetProjectedSize(float inRadius, float inDistance) const;
+        /// @brief Height in pixels the bounding sphere of the box covers on screen
+        float GetProjectedSize(const Math::BoundingBox &inWorldBounds) const;
 
         void SetViewport(uint32_t inX, uint32_t inY, uint32_t inWidth, uint32_t inHeight);
 
-        void SwapBuffers() { Get().mRenderContext->SwapBuffers(); }
+        void SwapBuffers();
 
         const std::unique_ptr<RendererAPI> &GetRendererAPI() const { return mRendererAPI; }
 
 
         void RecompileLightingModelShader();
+
+        void SetDepthPrePassEnabled(bool inEnabled) { mDepthPrePassEnabled = inEnabled; }
+        bool IsDepthPrePassEnabled() const { return mDepthPrePassEnabled; }
+
+        const Statistics &GetStatistics() const { return mStatistics; }
+
+        PipelineStateCache &GetPipelineStateCache() { return mPipelineStateCache; }
+        OcclusionQueryPool &GetOcclusionQueries() { return *mOcclusionQueries; }
+        UploadManager &GetUploadManager() { return *mUploadManager; }
+        ResourceLoader &GetResourceLoader() { return *mResourceLoader; }
     private:
         std::unique_ptr<RendererAPI> mRendererAPI;
         std::unique_ptr<RenderContext> mRenderContext;
-        std::shared_ptr<UniformBuffer> mShaderGlobalsBuffer;
+        UniformBufferHandle mShaderGlobalsBuffer;
         ShaderGlobals mShaderGlobals;
+        Math::Frustum mViewFrustum;
+        float mProjectionScale = 1.0f;
+        bool mIsPerspective = true;
+        uint32_t mViewportHeight = 1;
+
+        FramebufferHandle mGBuffer;
+        ShaderHandle mLightingModelShader;
+        ShaderHandle mBlitRGBShader;
+        ShaderHandle mBlitDepth;
+        ShaderHandle mBlitAlphaShader;
+        ShaderHandle mBlitWorldPositionShader;
+        ShaderHandle mDepthPrePassShader;
+        ShaderHandle mDepthPrePassInstancedShader;
+        ShaderHandle mParticleShader;
+        ShaderHandle mTerrainShader;
+        Texture2DHandle mWhiteTexture;
+        VertexArrayHandle mFullScreenQuad;
+        // -1 to 1 on every axis, scaled to the boxes of the occlusion queries
+        VertexArrayHandle mBoundingBoxCube;
 
-        std::shared_ptr<Framebuffer> mGBuffer;
-        std::shared_ptr<Shader> mLightingModelShader;
-        std::shared_ptr<Shader> mBlitRGBShader;
-        std::shared_ptr<Shader> mBlitDepth;
-        std::shared_ptr<Shader> mBlitAlphaShader;
-        std::shared_ptr<Shader> mBlitWorldPositionShader;
-        std::shared_ptr<VertexArray> mFullScreenQuad;
+        PipelineStateCache mPipelineStateCache;
+        PipelineStateId mDepthPrePassState;
+        PipelineStateId mDepthPrePassInstancedState;
+        PipelineStateId mLightingModelState;
+        PipelineStateId mBlitRGBState;
+        PipelineStateId mBlitDepthState;
+        PipelineStateId mBlitAlphaState;
+        PipelineStateId mBlitWorldPositionState;
+        PipelineStateId mDebugDrawState;
+        PipelineStateId mOcclusionQueryState;
+        // geometry pass variants of the material states, used after the depth pre-pass. indexed by the original id
+        std::vector<PipelineStateId> mPrePassDepthStates;
 
         std::unique_ptr<EditorGUI> mEditorGUI;
 
-        std::queue<GeometryInfo> mGeometryQueue;
+        std::vector<GeometryInfo> mGeometryQueue;
+        std::vector<RendererAPI::IndexRange> mIndexRanges;
+        std::vector<ParticleInfo> mParticleQueue;
+        std::vector<TerrainInfo> mTerrainQueue;
+        std::vector<std::pair<uint32_t, Math::BoundingBox>> mOcclusionQueue;
+
+        bool mDepthPrePassEnabled = true;
+        Statistics mStatistics;
+        std::unique_ptr<GPUTimer> mDepthPrePassTimer;
+        std::unique_ptr<GPUTimer> mGeometryPassTimer;
+        std::unique_ptr<GPUTimer> mLightingPassTimer;
+        std::unique_ptr<OcclusionQueryPool> mOcclusionQueries;
+        std::unique_ptr<UploadManager> mUploadManager;
+        std::unique_ptr<ResourceLoader> mResourceLoader;
+
+        void SetModelMatrix(const glm::mat4 &inTransform);
+        void DrawGeometry(const GeometryInfo &inGeometry);
+        void DrawDebugGeometry(Framebuffer *inGBuffer, PipelineStateId &ioCurrentState);
+        void DrawParticles(Framebuffer *inGBuffer, PipelineStateId &ioCurrentState);
+        void DrawTerrains(bool inDepthOnly, PipelineStateId &ioCurrentState);
+        void DrawOcclusionQueries(PipelineStateId &ioCurrentState);
+        void SetPipelineState(PipelineStateId inState, PipelineStateId &ioCurrentState);
+        PipelineStateId CreateFullScreenPassState(ShaderHandle inShader);
+        PipelineStateId GetPrePassDepthState(PipelineStateId inState);
+        void UpdateStatistics();
 
         Renderer() = default;
         Renderer(const Renderer &) = delete;
@@ -2,6 +2,7 @@
 
 #include "ZenEngine/Core/Platform.h"
 #include "Platform/OpenGL/OpenGLRendererAPI.h"
+#include "Platform/Software/SoftwareRendererAPI.h"
 
 namespace ZenEngine
 {
@@ -9,7 +10,10 @@ namespace ZenEngine
 
     std::unique_ptr<RendererAPI> RendererAPI::Create()
     {
-#ifdef ZE_RENDERER_PLATFORM_OPENGL
+#if defined(ZE_RENDERER_PLATFORM_SOFTWARE)
+        sAPI = RendererAPI::API::Software;
+        return std::make_unique<SoftwareRendererAPI>();
+#elif defined(ZE_RENDERER_PLATFORM_OPENGL)
         sAPI = RendererAPI::API::OpenGL;
         return std::make_unique<OpenGLRendererAPI>();
 #else
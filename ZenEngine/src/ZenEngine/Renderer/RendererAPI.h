@@ -4,6 +4,7 @@
 #include <glm/glm.hpp>
 #include <memory>
 #include "ZenEngine/Core/Macros.h"
+#include "ResourceHandle.h"
 
 namespace ZenEngine
 {
@@ -13,7 +14,8 @@ namespace ZenEngine
         enum class API
         {
             None = 0, 
-            OpenGL
+            OpenGL,
+            Software
         };
 
         enum class BlendMode
@@ -43,6 +45,39 @@ namespace ZenEngine
             OneMinusConstantAlpha
         };
 
+        enum class DepthFunction
+        {
+            Never,
+            Less,
+            Equal,
+            LessEqual,
+            Greater,
+            NotEqual,
+            GreaterEqual,
+            Always
+        };
+
+        enum class CullMode
+        {
+            None,
+            Front,
+            Back
+        };
+
+        enum class PrimitiveTopology
+        {
+            Triangles,
+            Lines,
+            Points
+        };
+
+        /// @brief A run of consecutive indices of an index buffer
+        struct IndexRange
+        {
+            uint32_t First;
+            uint32_t Count;
+        };
+
         enum ClearFlags : uint32_t
         {
             None = 0,
@@ -56,6 +91,12 @@ namespace ZenEngine
 
         virtual void Init() = 0;
         virtual void SetViewport(uint32_t inX, uint32_t inY, uint32_t inWidth, uint32_t inHeight) = 0;
+
+        // applies a whole pipeline state, only what differs from the current state is changed
+        virtual void SetPipelineState(const struct PipelineState &inState) = 0;
+        // forgets the tracked state, the next SetPipelineState applies everything
+        virtual void InvalidatePipelineState() = 0;
+
         virtual void SetClearColor(const glm::vec4& inColor) = 0;
         virtual void Clear(uint32_t inFlags) = 0;
 
@@ -63,6 +104,10 @@ namespace ZenEngine
         virtual void EnableDepthTest() = 0;
         virtual void DisableDepthTest() = 0;
         virtual void SetDepthMask(bool inMask) = 0;
+        virtual void SetDepthFunction(DepthFunction inFunction) = 0;
+
+        // enables or disables writes to all the color attachments of the bound framebuffer
+        virtual void SetColorMask(bool inMask) = 0;
 
         // blend
         virtual void EnableBlend() = 0;
@@ -70,9 +115,13 @@ namespace ZenEngine
         virtual void SetBlendMode(BlendMode inMode) = 0;
         virtual void SetBlendFunction(BlendFunction inSource, BlendFunction inDestination) = 0;
 
-        virtual void DrawIndexed(const std::shared_ptr<class VertexArray> &inVertexArray) = 0;
-        virtual void DrawIndexed(const std::shared_ptr<class VertexArray> &inVertexArray, uint32_t inIndexCount) = 0;
-        virtual void DrawLines(const std::shared_ptr<class VertexArray> &inVertexArray, uint32_t inVertexCount) = 0;
+        virtual void DrawIndexed(VertexArrayHandle inVertexArray) = 0;
+        virtual void DrawIndexed(VertexArrayHandle inVertexArray, uint32_t inIndexCount) = 0;
+        // per instance attributes (the matrix elements of a layout) advance once per instance
+        virtual void DrawIndexedInstanced(VertexArrayHandle inVertexArray, uint32_t inInstanceCount) = 0;
+        // draws several parts of the index buffer with the same state, as one multi draw where the API has it
+        virtual void DrawIndexedRanges(VertexArrayHandle inVertexArray, const IndexRange *inRanges, uint32_t inRangeCount) = 0;
+        virtual void DrawLines(VertexArrayHandle inVertexArray, uint32_t inVertexCount) = 0;
         
         virtual void SetLineWidth(float inWidth) = 0;
 
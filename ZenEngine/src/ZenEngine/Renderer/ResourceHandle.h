@@ -0,0 +1,65 @@
+#pragma once
+
+#include <stdint.h>
+#include <functional>
+
+namespace ZenEngine
+{
+    /// @brief A 32 bit generational handle to a GPU resource owned by the ResourceRegistry.
+    /// The low bits index a slot, the high bits hold the generation of the slot at creation time,
+    /// so a handle to a destroyed resource never resolves to whatever reuses its slot.
+    template <typename T>
+    class ResourceHandle
+    {
+    public:
+        static constexpr uint32_t sIndexBits = 20;
+        static constexpr uint32_t sGenerationBits = 32 - sIndexBits;
+        static constexpr uint32_t sMaxIndex = (1u << sIndexBits) - 1;
+        static constexpr uint32_t sMaxGeneration = (1u << sGenerationBits) - 1;
+
+        constexpr ResourceHandle() = default;
+        constexpr ResourceHandle(uint32_t inIndex, uint32_t inGeneration) : mValue((inGeneration << sIndexBits) | (inIndex & sMaxIndex)) {}
+
+        constexpr uint32_t GetIndex() const { return mValue & sMaxIndex; }
+        constexpr uint32_t GetGeneration() const { return mValue >> sIndexBits; }
+        constexpr uint32_t GetValue() const { return mValue; }
+
+        // generations start at 1 so the zero handle is never valid
+        constexpr bool IsNull() const { return mValue == 0; }
+        constexpr explicit operator bool() const { return !IsNull(); }
+
+        constexpr bool operator==(const ResourceHandle &inOther) const { return mValue == inOther.mValue; }
+        constexpr bool operator!=(const ResourceHandle &inOther) const { return mValue != inOther.mValue; }
+
+        static const ResourceHandle Null;
+    private:
+        uint32_t mValue = 0;
+    };
+
+    template <typename T>
+    const ResourceHandle<T> ResourceHandle<T>::Null{};
+
+    class VertexArray;
+    class Texture2D;
+    class Shader;
+    class Framebuffer;
+    class UniformBuffer;
+
+    using VertexArrayHandle = ResourceHandle<VertexArray>;
+    using Texture2DHandle = ResourceHandle<Texture2D>;
+    using ShaderHandle = ResourceHandle<Shader>;
+    using FramebufferHandle = ResourceHandle<Framebuffer>;
+    using UniformBufferHandle = ResourceHandle<UniformBuffer>;
+}
+
+namespace std
+{
+    template <typename T>
+    struct hash<ZenEngine::ResourceHandle<T>>
+    {
+        std::size_t operator()(const ZenEngine::ResourceHandle<T> &inHandle) const
+        {
+            return hash<uint32_t>()(inHandle.GetValue());
+        }
+    };
+}
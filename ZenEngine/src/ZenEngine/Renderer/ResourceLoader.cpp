@@ -0,0 +1,33 @@
+#include "ResourceLoader.h"
+
+#include "RendererAPI.h"
+
+#include "ZenEngine/Core/Macros.h"
+#include "ZenEngine/Core/Window.h"
+
+#include "Platform/OpenGL/OpenGLGLFWResourceLoader.h"
+
+#include <GLFW/glfw3.h>
+
+namespace ZenEngine
+{
+    std::unique_ptr<ResourceLoader> ResourceLoader::Create(void *inNativeWindow)
+    {
+        switch (RendererAPI::GetAPI())
+        {
+        case RendererAPI::API::None: ZE_ASSERT_CORE_MSG(false, "RendererAPI::None is not supported!"); return nullptr;
+        case RendererAPI::API::OpenGL:
+        {
+            switch (Window::GetWindowPlatform())
+            {
+            case WindowPlatform::GLFW: return std::make_unique<OpenGLGLFWResourceLoader>(static_cast<GLFWwindow*>(inNativeWindow));
+            default:                   ZE_ASSERT_CORE_MSG(false, "The window platform is currently not supported by OpenGL!"); return nullptr;
+            }
+        }
+        // software resources are plain memory
+        case RendererAPI::API::Software: return std::make_unique<ResourceLoader>();
+        }
+        ZE_ASSERT_CORE_MSG(false, "Unknown Renderer API!");
+        return nullptr;
+    }
+}
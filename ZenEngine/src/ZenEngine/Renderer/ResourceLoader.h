@@ -0,0 +1,30 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <stdint.h>
+
+namespace ZenEngine
+{
+    /// @brief Creates GPU resources and fills them away from the main thread, so loading big assets does not
+    /// stall the frame. A load runs on the loader, its ready callback runs on the main thread in Update once
+    /// the GPU is done with what the load issued; until then the main thread keeps drawing without it.
+    /// The base class is used by the backends without a loader context and runs both right away
+    class ResourceLoader
+    {
+    public:
+        using Job = std::function<void()>;
+
+        virtual ~ResourceLoader() = default;
+
+        /// @brief The load may only create and fill resources, it must not touch anything the main thread uses.
+        /// Container objects such as vertex arrays are not shared between contexts and belong in the ready callback
+        virtual void Enqueue(Job inLoad, Job inReady) { inLoad(); inReady(); }
+        /// @brief Runs the ready callbacks of the finished loads, called once per frame on the main thread
+        virtual void Update() {}
+        /// @brief Loads enqueued whose ready callback has not run yet
+        virtual uint32_t GetPendingCount() const { return 0; }
+
+        static std::unique_ptr<ResourceLoader> Create(void *inNativeWindow);
+    };
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "ResourceHandle.h"
+#include "ZenEngine/Core/Macros.h"
+
+namespace ZenEngine
+{
+    /// @brief Slot map storage for one kind of GPU resource.
+    /// Slots live in fixed size chunks that never move, so resolving a handle never races
+    /// with the allocation of new slots, and a stale handle never resolves to the resource reusing its slot.
+    /// Insert/Remove/Exchange must be externally synchronized.
+    template <typename T>
+    class ResourcePool
+    {
+    public:
+        using Handle = ResourceHandle<T>;
+
+        Handle Insert(std::shared_ptr<T> inResource)
+        {
+            uint32_t index;
+            if (!mFreeList.empty())
+            {
+                index = mFreeList.back();
+                mFreeList.pop_back();
+            }
+            else
+            {
+                index = mSlotCount.load(std::memory_order_relaxed);
+                ZE_ASSERT_CORE_MSG(index <= Handle::sMaxIndex, "Resource pool is full!");
+                auto &chunk = mChunks[index / sChunkSize];
+                if (chunk == nullptr)
+                    chunk = std::make_unique<Chunk>();
+                // publish the slot only once its chunk exists
+                mSlotCount.store(index + 1, std::memory_order_release);
+            }
+
+            auto &slot = GetSlot(index);
+            slot.Pointer.store(inResource.get(), std::memory_order_release);
+            slot.Owner = std::move(inResource);
+            ++mSize;
+            return Handle(index, slot.Generation.load(std::memory_order_relaxed));
+        }
+
+        T *Get(Handle inHandle) const
+        {
+            if (inHandle.IsNull() || inHandle.GetIndex() >= mSlotCount.load(std::memory_order_acquire)) return nullptr;
+            const auto &slot = GetSlot(inHandle.GetIndex());
+            if (slot.Generation.load(std::memory_order_acquire) != inHandle.GetGeneration()) return nullptr;
+            T *pointer = slot.Pointer.load(std::memory_order_acquire);
+            // the slot may have been removed and reused between the two loads. Remove bumps the generation before
+            // Insert stores the next pointer, so reading that pointer means the generation read again has moved on
+            if (slot.Generation.load(std::memory_order_acquire) != inHandle.GetGeneration()) return nullptr;
+            return pointer;
+        }
+
+        bool Contains(Handle inHandle) const { return Get(inHandle) != nullptr; }
+
+        /// @brief Invalidates the handle and hands back ownership of the resource
+        std::shared_ptr<T> Remove(Handle inHandle)
+        {
+            if (!Contains(inHandle)) return nullptr;
+            auto &slot = GetSlot(inHandle.GetIndex());
+            slot.Pointer.store(nullptr, std::memory_order_release);
+            // bump the generation, skipping 0 which is reserved for the null handle
+            uint32_t generation = slot.Generation.load(std::memory_order_relaxed) % Handle::sMaxGeneration + 1;
+            slot.Generation.store(generation, std::memory_order_release);
+            mFreeList.push_back(inHandle.GetIndex());
+            --mSize;
+            return std::move(slot.Owner);
+        }
+
+        /// @brief Swaps the resource behind a handle keeping the handle valid, returns the old resource
+        std::shared_ptr<T> Exchange(Handle inHandle, std::shared_ptr<T> inResource)
+        {
+            if (!Contains(inHandle)) return nullptr;
+            auto &slot = GetSlot(inHandle.GetIndex());
+            slot.Pointer.store(inResource.get(), std::memory_order_release);
+            std::swap(slot.Owner, inResource);
+            return inResource;
+        }
+
+        template <typename Func>
+        void ForEach(Func inFunc) const
+        {
+            for (uint32_t i = 0; i < mSlotCount; ++i)
+            {
+                const auto &slot = GetSlot(i);
+                if (slot.Owner != nullptr)
+                    inFunc(Handle(i, slot.Generation.load(std::memory_order_relaxed)), slot.Owner);
+            }
+        }
+
+        void Clear()
+        {
+            for (uint32_t i = 0; i < mSlotCount; ++i)
+            {
+                const auto &slot = GetSlot(i);
+                if (slot.Owner != nullptr)
+                    Remove(Handle(i, slot.Generation.load(std::memory_order_relaxed)));
+            }
+        }
+
+        uint32_t GetSize() const { return mSize; }
+
+    private:
+        struct Slot
+        {
+            std::atomic<T*> Pointer = nullptr;
+            std::atomic<uint32_t> Generation = 1;
+            std::shared_ptr<T> Owner;
+        };
+
+        static constexpr uint32_t sChunkSize = 1024;
+        static constexpr uint32_t sMaxChunks = (Handle::sMaxIndex + 1) / sChunkSize;
+        using Chunk = std::array<Slot, sChunkSize>;
+
+        std::array<std::unique_ptr<Chunk>, sMaxChunks> mChunks;
+        std::vector<uint32_t> mFreeList;
+        std::atomic<uint32_t> mSlotCount = 0;
+        uint32_t mSize = 0;
+
+        Slot &GetSlot(uint32_t inIndex) { return (*mChunks[inIndex / sChunkSize])[inIndex % sChunkSize]; }
+        const Slot &GetSlot(uint32_t inIndex) const { return (*mChunks[inIndex / sChunkSize])[inIndex % sChunkSize]; }
+    };
+}
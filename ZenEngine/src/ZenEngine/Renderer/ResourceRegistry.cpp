@@ -0,0 +1,32 @@
+#include "ResourceRegistry.h"
+
+#include "VertexArray.h"
+#include "Texture2D.h"
+#include "Shader.h"
+#include "Framebuffer.h"
+#include "UniformBuffer.h"
+
+namespace ZenEngine
+{
+    void ResourceRegistry::EndFrame()
+    {
+        std::deque<PendingDeletion> released;
+        {
+            std::scoped_lock lock(mMutex);
+            ++mFrameIndex;
+            while (!mDeletionQueue.empty() && mFrameIndex - mDeletionQueue.front().Frame > sDeletionLatency)
+            {
+                released.push_back(std::move(mDeletionQueue.front()));
+                mDeletionQueue.pop_front();
+            }
+        }
+        // the destructors run outside the lock, they may call back into the registry
+    }
+
+    void ResourceRegistry::Shutdown()
+    {
+        std::scoped_lock lock(mMutex);
+        mDeletionQueue.clear();
+        std::apply([](auto &...inPools) { (inPools.Clear(), ...); }, mPools);
+    }
+}
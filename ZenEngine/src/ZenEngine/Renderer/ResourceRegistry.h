@@ -0,0 +1,105 @@
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <tuple>
+
+#include "ResourceHandle.h"
+#include "ResourcePool.h"
+
+namespace ZenEngine
+{
+    /// @brief Owns the GPU resources used by the renderer and hands out generational handles to them.
+    /// Destroying a resource invalidates its handle immediately, but the object itself is only
+    /// released a few frames later, once no frame in flight can still be using it.
+    class ResourceRegistry
+    {
+    public:
+        static ResourceRegistry &Get()
+        {
+            static ResourceRegistry instance;
+            return instance;
+        }
+
+        template <typename T>
+        ResourceHandle<T> Register(std::shared_ptr<T> inResource)
+        {
+            ZE_ASSERT_CORE_MSG(inResource != nullptr, "Cannot register a null resource!");
+            std::scoped_lock lock(mMutex);
+            return GetPool<T>().Insert(std::move(inResource));
+        }
+
+        template <typename T>
+        T *Resolve(ResourceHandle<T> inHandle) const
+        {
+            return GetPool<T>().Get(inHandle);
+        }
+
+        template <typename T>
+        bool IsValid(ResourceHandle<T> inHandle) const
+        {
+            return GetPool<T>().Contains(inHandle);
+        }
+
+        /// @brief Puts a new resource behind an existing handle, the old one is destroyed with the usual delay
+        template <typename T>
+        void Replace(ResourceHandle<T> inHandle, std::shared_ptr<T> inResource)
+        {
+            ZE_ASSERT_CORE_MSG(inResource != nullptr, "Cannot register a null resource!");
+            std::scoped_lock lock(mMutex);
+            if (auto old = GetPool<T>().Exchange(inHandle, std::move(inResource)))
+                mDeletionQueue.push_back({ std::move(old), mFrameIndex });
+        }
+
+        template <typename T>
+        void Destroy(ResourceHandle<T> inHandle)
+        {
+            if (inHandle.IsNull()) return;
+            std::scoped_lock lock(mMutex);
+            if (auto old = GetPool<T>().Remove(inHandle))
+                mDeletionQueue.push_back({ std::move(old), mFrameIndex });
+        }
+
+        template <typename T>
+        uint32_t GetResourceCount() const { return GetPool<T>().GetSize(); }
+        uint32_t GetPendingDeletionCount() const { return static_cast<uint32_t>(mDeletionQueue.size()); }
+
+        /// @brief Advances the frame counter and releases the resources that are no longer in flight
+        void EndFrame();
+
+        /// @brief Releases every resource right away, must be called while the render context is still alive
+        void Shutdown();
+
+    private:
+        struct PendingDeletion
+        {
+            std::shared_ptr<void> Resource;
+            uint64_t Frame;
+        };
+
+        // number of frames a destroyed resource is kept alive for
+        static constexpr uint64_t sDeletionLatency = 2;
+
+        std::tuple<
+            ResourcePool<VertexArray>,
+            ResourcePool<Texture2D>,
+            ResourcePool<Shader>,
+            ResourcePool<Framebuffer>,
+            ResourcePool<UniformBuffer>
+        > mPools;
+        std::deque<PendingDeletion> mDeletionQueue;
+        uint64_t mFrameIndex = 0;
+        mutable std::mutex mMutex;
+
+        template <typename T>
+        ResourcePool<T> &GetPool() { return std::get<ResourcePool<T>>(mPools); }
+
+        template <typename T>
+        const ResourcePool<T> &GetPool() const { return std::get<ResourcePool<T>>(mPools); }
+
+        ResourceRegistry() = default;
+        ResourceRegistry(const ResourceRegistry &) = delete;
+        ResourceRegistry &operator =(const ResourceRegistry &) = delete;
+    };
+}
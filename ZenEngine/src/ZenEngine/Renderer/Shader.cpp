@@ -2,6 +2,7 @@
 
 #include "RendererAPI.h"
 #include "Platform/OpenGL/OpenGLShader.h"
+#include "Platform/Software/SoftwareShader.h"
 #include "ZenEngine/Core/Macros.h"
 
 namespace ZenEngine
@@ -13,6 +14,7 @@ namespace ZenEngine
         {
         case RendererAPI::API::None:    ZE_ASSERT_CORE_MSG(false, "RendererAPI::None is currently not supported!"); return nullptr;
         case RendererAPI::API::OpenGL:  return std::make_shared<OpenGLShader>(inFilepath);
+        case RendererAPI::API::Software: return std::make_shared<SoftwareShader>(inFilepath);
         }
 
         ZE_ASSERT_CORE_MSG(false, "Unknown RendererAPI!");
@@ -25,6 +27,7 @@ namespace ZenEngine
         {
         case RendererAPI::API::None:    ZE_ASSERT_CORE_MSG(false, "RendererAPI::None is currently not supported!"); return nullptr;
         case RendererAPI::API::OpenGL:  return std::make_shared<OpenGLShader>(inName, inSrc);
+        case RendererAPI::API::Software: return std::make_shared<SoftwareShader>(inName, inSrc);
         }
 
         ZE_ASSERT_CORE_MSG(false, "Unknown RendererAPI!");
@@ -0,0 +1,196 @@
+#include "SpriteRenderer.h"
+
+#include <algorithm>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "Renderer.h"
+#include "ResourceRegistry.h"
+#include "Shader.h"
+#include "Texture2D.h"
+#include "VertexArray.h"
+#include "VertexBuffer.h"
+#include "IndexBuffer.h"
+
+namespace ZenEngine
+{
+    // the vertex buffer layout below has no padding
+    static_assert(sizeof(SpriteRenderer::Vertex) == 11 * sizeof(float));
+
+    static const glm::vec4 sQuadCorners[4] = {
+        { -0.5f, -0.5f, 0.0f, 1.0f },
+        {  0.5f, -0.5f, 0.0f, 1.0f },
+        {  0.5f,  0.5f, 0.0f, 1.0f },
+        { -0.5f,  0.5f, 0.0f, 1.0f }
+    };
+
+    void SpriteRenderer::Init()
+    {
+        auto &registry = ResourceRegistry::Get();
+        mShader = registry.Register(Shader::Create("resources/Shaders/Sprite.hlsl"));
+
+        Texture2D::Properties whiteProps;
+        whiteProps.GenerateMips = false;
+        uint32_t white = 0xffffffff;
+        mWhiteTexture = registry.Register(Texture2D::Create(whiteProps, &white, sizeof(white)));
+
+        std::vector<uint32_t> indices(MaxSpritesPerBatch * 6);
+        for (uint32_t i = 0; i < MaxSpritesPerBatch; ++i)
+        {
+            uint32_t first = i * 4;
+            indices[i * 6 + 0] = first + 0;
+            indices[i * 6 + 1] = first + 1;
+            indices[i * 6 + 2] = first + 2;
+            indices[i * 6 + 3] = first + 2;
+            indices[i * 6 + 4] = first + 3;
+            indices[i * 6 + 5] = first + 0;
+        }
+        mIndexBuffer = IndexBuffer::Create(indices);
+
+        PipelineState state;
+        state.Shader = mShader;
+        state.VertexLayout = registry.Resolve(GetBatchBuffer(0).VertexArray)->GetLayoutHash();
+        state.DepthTest = false;
+        state.DepthWrite = false;
+        state.Blend = true;
+        mPipelineState = Renderer::Get().GetPipelineStateCache().CreateOrGet(state);
+    }
+
+    void SpriteRenderer::Shutdown()
+    {
+        auto &registry = ResourceRegistry::Get();
+        for (auto &batchBuffer : mBatchBuffers)
+            registry.Destroy(batchBuffer.VertexArray);
+        mBatchBuffers.clear();
+        registry.Destroy(mWhiteTexture);
+        registry.Destroy(mShader);
+        mWhiteTexture = Texture2DHandle::Null;
+        mShader = ShaderHandle::Null;
+        mIndexBuffer.reset();
+    }
+
+    void SpriteRenderer::Begin(const glm::mat4 &inViewProjection)
+    {
+        mViewProjection = inViewProjection;
+        mSprites.clear();
+        mSortEntries.clear();
+    }
+
+    void SpriteRenderer::DrawQuad(const glm::mat4 &inTransform, Texture2DHandle inTexture, const glm::vec4 &inColor, int32_t inLayer, const glm::vec4 &inTexCoords)
+    {
+        // the quads are transformed here so sprites with different transforms still share a draw
+        glm::mat4 transform = mViewProjection * inTransform;
+        Sprite &sprite = mSprites.emplace_back();
+        for (uint32_t i = 0; i < 4; ++i)
+            sprite.Corners[i] = transform * sQuadCorners[i];
+        sprite.Color = inColor;
+        sprite.TexCoords = inTexCoords;
+        sprite.Texture = inTexture;
+
+        // flipping the sign bit keeps negative layers ordered before the positive ones
+        uint64_t layerKey = static_cast<uint32_t>(inLayer) ^ 0x80000000u;
+        mSortEntries.push_back({ (layerKey << 32) | inTexture.GetValue(), static_cast<uint32_t>(mSprites.size() - 1) });
+    }
+
+    void SpriteRenderer::DrawQuad(const glm::vec2 &inPosition, const glm::vec2 &inSize, float inRotation, Texture2DHandle inTexture, const glm::vec4 &inColor, int32_t inLayer)
+    {
+        glm::mat4 transform = glm::translate(glm::mat4(1.0f), glm::vec3(inPosition, 0.0f))
+            * glm::rotate(glm::mat4(1.0f), inRotation, glm::vec3(0.0f, 0.0f, 1.0f))
+            * glm::scale(glm::mat4(1.0f), glm::vec3(inSize, 1.0f));
+        DrawQuad(transform, inTexture, inColor, inLayer);
+    }
+
+    void SpriteRenderer::End(FramebufferHandle inTargetFramebuffer)
+    {
+        mStatistics = {};
+        mStatistics.Sprites = static_cast<uint32_t>(mSprites.size());
+        if (mSprites.empty()) return;
+
+        std::sort(mSortEntries.begin(), mSortEntries.end(), [](const SortEntry &inA, const SortEntry &inB)
+        {
+            if (inA.Key != inB.Key) return inA.Key < inB.Key;
+            return inA.Index < inB.Index;
+        });
+
+        auto &registry = ResourceRegistry::Get();
+        auto *targetFramebuffer = registry.Resolve(inTargetFramebuffer);
+        if (targetFramebuffer != nullptr)
+            targetFramebuffer->Bind();
+
+        const auto &rendererAPI = Renderer::Get().GetRendererAPI();
+        rendererAPI->InvalidatePipelineState();
+        rendererAPI->SetPipelineState(Renderer::Get().GetPipelineStateCache().Get(mPipelineState));
+
+        Texture2DHandle textures[MaxTexturesPerBatch];
+        uint32_t textureCount = 0;
+        uint32_t batch = 0;
+        mVertices.clear();
+        for (const auto &entry : mSortEntries)
+        {
+            const Sprite &sprite = mSprites[entry.Index];
+            Texture2DHandle texture = sprite.Texture.IsNull() ? mWhiteTexture : sprite.Texture;
+
+            uint32_t slot = static_cast<uint32_t>(std::find(textures, textures + textureCount, texture) - textures);
+            bool batchFull = mVertices.size() == MaxSpritesPerBatch * 4;
+            if (batchFull || (slot == textureCount && textureCount == MaxTexturesPerBatch))
+            {
+                FlushBatch(batch++, textures, textureCount);
+                textureCount = 0;
+                slot = 0;
+            }
+            if (slot == textureCount)
+                textures[textureCount++] = texture;
+
+            const glm::vec4 &uv = sprite.TexCoords;
+            const glm::vec2 texCoords[4] = { { uv.x, uv.y }, { uv.z, uv.y }, { uv.z, uv.w }, { uv.x, uv.w } };
+            for (uint32_t i = 0; i < 4; ++i)
+                mVertices.push_back({ sprite.Corners[i], sprite.Color, texCoords[i], static_cast<float>(slot) });
+        }
+        FlushBatch(batch, textures, textureCount);
+
+        if (targetFramebuffer != nullptr)
+            targetFramebuffer->Unbind();
+    }
+
+    SpriteRenderer::BatchBuffer &SpriteRenderer::GetBatchBuffer(uint32_t inBatch)
+    {
+        while (mBatchBuffers.size() <= inBatch)
+        {
+            BatchBuffer batchBuffer;
+            batchBuffer.Vertices = VertexBuffer::Create(MaxSpritesPerBatch * 4 * sizeof(Vertex));
+            batchBuffer.Vertices->SetLayout({
+                { ShaderDataType::Float4, "Position" },
+                { ShaderDataType::Float4, "Color" },
+                { ShaderDataType::Float2, "TexCoord" },
+                { ShaderDataType::Float, "TextureIndex" }
+            });
+            auto vertexArray = VertexArray::Create();
+            vertexArray->AddVertexBuffer(batchBuffer.Vertices);
+            vertexArray->SetIndexBuffer(mIndexBuffer);
+            batchBuffer.VertexArray = ResourceRegistry::Get().Register(vertexArray);
+            mBatchBuffers.push_back(std::move(batchBuffer));
+        }
+        return mBatchBuffers[inBatch];
+    }
+
+    void SpriteRenderer::FlushBatch(uint32_t inBatch, const Texture2DHandle *inTextures, uint32_t inTextureCount)
+    {
+        if (mVertices.empty()) return;
+
+        auto &registry = ResourceRegistry::Get();
+        auto &batchBuffer = GetBatchBuffer(inBatch);
+        batchBuffer.Vertices->SetData(mVertices.data(), static_cast<uint32_t>(mVertices.size() * sizeof(Vertex)));
+
+        // every register gets a texture, the unused ones and destroyed textures read as white
+        auto *white = registry.Resolve(mWhiteTexture);
+        for (uint32_t slot = 0; slot < MaxTexturesPerBatch; ++slot)
+        {
+            auto *texture = slot < inTextureCount ? registry.Resolve(inTextures[slot]) : nullptr;
+            (texture != nullptr ? texture : white)->Bind(slot);
+        }
+
+        uint32_t spriteCount = static_cast<uint32_t>(mVertices.size() / 4);
+        Renderer::Get().GetRendererAPI()->DrawIndexed(batchBuffer.VertexArray, spriteCount * 6);
+        ++mStatistics.Batches;
+        mVertices.clear();
+    }
+}
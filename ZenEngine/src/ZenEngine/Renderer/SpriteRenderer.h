@@ -0,0 +1,105 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "ResourceHandle.h"
+#include "PipelineState.h"
+
+namespace ZenEngine
+{
+    class VertexBuffer;
+    class IndexBuffer;
+
+    /// @brief Batched textured quads for 2D content such as HUDs.
+    /// Sprites are collected between Begin and End, sorted by layer and then by texture, and drawn in batches of
+    /// up to MaxSpritesPerBatch sprites using at most MaxTexturesPerBatch textures, with one draw per batch.
+    /// Lower layers are drawn first. Within a layer sprites are grouped by texture, so overlapping sprites
+    /// that have to be drawn in a given order should be put on different layers
+    class SpriteRenderer
+    {
+    public:
+        static constexpr uint32_t MaxSpritesPerBatch = 4096;
+        // the texture registers all the backends provide
+        static constexpr uint32_t MaxTexturesPerBatch = 16;
+
+        struct Vertex
+        {
+            glm::vec4 Position;
+            glm::vec4 Color;
+            glm::vec2 TexCoord;
+            float TextureIndex;
+        };
+
+        struct Statistics
+        {
+            uint32_t Sprites = 0;
+            uint32_t Batches = 0;
+        };
+
+        static SpriteRenderer &Get()
+        {
+            static SpriteRenderer instance;
+            return instance;
+        }
+
+        void Init();
+        void Shutdown();
+
+        void Begin(const glm::mat4 &inViewProjection);
+        /// @brief The sprite is the unit quad centered on the origin of inTransform
+        /// @param inTexture a null handle draws a plain colored quad
+        /// @param inTexCoords min and max texture coordinates, e.g. to pick a frame of an atlas
+        void DrawQuad(const glm::mat4 &inTransform, Texture2DHandle inTexture, const glm::vec4 &inColor = glm::vec4(1.0f), int32_t inLayer = 0,
+            const glm::vec4 &inTexCoords = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f));
+        void DrawQuad(const glm::vec2 &inPosition, const glm::vec2 &inSize, float inRotation, Texture2DHandle inTexture,
+            const glm::vec4 &inColor = glm::vec4(1.0f), int32_t inLayer = 0);
+        /// @brief Draws everything submitted since Begin into the target, or the bound framebuffer when null
+        void End(FramebufferHandle inTargetFramebuffer = FramebufferHandle::Null);
+
+        const Statistics &GetStatistics() const { return mStatistics; }
+    private:
+        struct Sprite
+        {
+            glm::vec4 Corners[4];
+            glm::vec4 Color;
+            glm::vec4 TexCoords;
+            Texture2DHandle Texture;
+        };
+
+        struct SortEntry
+        {
+            // layer in the high half, texture in the low half
+            uint64_t Key;
+            uint32_t Index;
+        };
+
+        // each batch streams into its own buffer, so a batch never overwrites the data of one still to be drawn
+        struct BatchBuffer
+        {
+            std::shared_ptr<VertexBuffer> Vertices;
+            VertexArrayHandle VertexArray;
+        };
+
+        glm::mat4 mViewProjection = glm::mat4(1.0f);
+        std::vector<Sprite> mSprites;
+        std::vector<SortEntry> mSortEntries;
+        std::vector<Vertex> mVertices;
+
+        std::vector<BatchBuffer> mBatchBuffers;
+        std::shared_ptr<IndexBuffer> mIndexBuffer;
+        ShaderHandle mShader;
+        Texture2DHandle mWhiteTexture;
+        PipelineStateId mPipelineState = InvalidPipelineState;
+
+        Statistics mStatistics;
+
+        BatchBuffer &GetBatchBuffer(uint32_t inBatch);
+        void FlushBatch(uint32_t inBatch, const Texture2DHandle *inTextures, uint32_t inTextureCount);
+
+        SpriteRenderer() = default;
+        SpriteRenderer(const SpriteRenderer &) = delete;
+        SpriteRenderer &operator =(const SpriteRenderer &) = delete;
+    };
+}
@@ -0,0 +1,152 @@
+#include "StaticBatch.h"
+
+#include <algorithm>
+
+#include "ZenEngine/Asset/StaticMesh.h"
+#include "Material.h"
+#include "Renderer.h"
+#include "ResourceRegistry.h"
+#include "VertexArray.h"
+#include "VertexBuffer.h"
+#include "IndexBuffer.h"
+
+namespace ZenEngine
+{
+    StaticBatch::~StaticBatch()
+    {
+        DestroyClusters();
+    }
+
+    void StaticBatch::Add(const std::shared_ptr<StaticMesh> &inMesh, const glm::mat4 &inTransform, const std::shared_ptr<Material> &inMaterial)
+    {
+        if (inMesh == nullptr || inMaterial == nullptr || inMesh->GetIndices().empty()) return;
+        mItems.push_back({ inMesh, inTransform, inMaterial, inMesh->GetBounds().Transform(inTransform), 0 });
+    }
+
+    void StaticBatch::Build()
+    {
+        DestroyClusters();
+        mStatistics = {};
+        mStatistics.Meshes = static_cast<uint32_t>(mItems.size());
+        if (mItems.empty()) return;
+
+        // order the meshes along a Morton curve so that neighbours in the list are neighbours in space
+        Math::BoundingBox sceneBounds;
+        for (const auto &item : mItems)
+            sceneBounds.Extend(item.Bounds);
+        glm::vec3 sceneSize = glm::max(sceneBounds.Max - sceneBounds.Min, glm::vec3(1e-6f));
+        for (auto &item : mItems)
+            item.MortonCode = GetMortonCode((item.Bounds.GetCenter() - sceneBounds.Min) / sceneSize);
+
+        std::vector<Item*> items;
+        items.reserve(mItems.size());
+        for (auto &item : mItems)
+            items.push_back(&item);
+        std::sort(items.begin(), items.end(), [](const Item *inA, const Item *inB)
+        {
+            if (inA->Mat != inB->Mat) return inA->Mat < inB->Mat;
+            return inA->MortonCode < inB->MortonCode;
+        });
+
+        // each material gets its own clusters, they are drawn with different states anyway
+        auto first = items.begin();
+        while (first != items.end())
+        {
+            auto last = std::find_if(first, items.end(), [first](const Item *inItem) { return inItem->Mat != (*first)->Mat; });
+            std::vector<Item*> materialItems(first, last);
+            BuildClusters(materialItems);
+            first = last;
+        }
+        mStatistics.Clusters = static_cast<uint32_t>(mClusters.size());
+        ZE_CORE_INFO("Static batch: {} meshes merged into {} clusters", mStatistics.Meshes, mStatistics.Clusters);
+    }
+
+    void StaticBatch::Clear()
+    {
+        DestroyClusters();
+        mItems.clear();
+        mStatistics = {};
+    }
+
+    void StaticBatch::Submit(const Math::Frustum &inFrustum)
+    {
+        mStatistics.VisibleClusters = 0;
+        for (const auto &cluster : mClusters)
+        {
+            if (inFrustum.Test(cluster.Bounds) == Math::Frustum::Result::Outside) continue;
+            // the vertices are already in world space
+            Renderer::Get().Submit(cluster.VertexArray, glm::mat4(1.0f), cluster.Bounds.GetCenter(), *cluster.Mat);
+            ++mStatistics.VisibleClusters;
+        }
+    }
+
+    void StaticBatch::BuildClusters(std::vector<Item*> &ioItems)
+    {
+        std::vector<Vertex> vertices;
+        std::vector<uint32_t> indices;
+        Math::BoundingBox bounds;
+
+        auto closeCluster = [&]()
+        {
+            if (indices.empty()) return;
+            auto vertexArray = VertexArray::Create();
+            VertexStreams::Create(vertices).AddTo(*vertexArray);
+            vertexArray->SetIndexBuffer(IndexBuffer::Create(indices));
+            mClusters.push_back({ ResourceRegistry::Get().Register(vertexArray), bounds, ioItems.front()->Mat });
+
+            vertices.clear();
+            indices.clear();
+            bounds = Math::BoundingBox();
+        };
+
+        for (Item *item : ioItems)
+        {
+            const auto &meshVertices = item->Mesh->GetVertices();
+            const auto &meshIndices = item->Mesh->GetIndices();
+
+            Math::BoundingBox extended = bounds;
+            extended.Extend(item->Bounds);
+            glm::vec3 size = extended.Max - extended.Min;
+            bool tooLarge = std::max({ size.x, size.y, size.z }) > MaxClusterExtent;
+            if (!vertices.empty() && (vertices.size() + meshVertices.size() > MaxClusterVertices || tooLarge))
+                closeCluster();
+
+            uint32_t baseVertex = static_cast<uint32_t>(vertices.size());
+            glm::mat3 normalMatrix = glm::transpose(glm::inverse(glm::mat3(item->Transform)));
+            for (const auto &vertex : meshVertices)
+            {
+                glm::vec3 position = glm::vec3(item->Transform * glm::vec4(vertex.Position, 1.0f));
+                glm::vec3 normal = glm::normalize(normalMatrix * vertex.Normal);
+                vertices.push_back({ position, normal, vertex.TexCoord });
+            }
+            for (uint32_t index : meshIndices)
+                indices.push_back(baseVertex + index);
+            bounds.Extend(item->Bounds);
+        }
+        closeCluster();
+    }
+
+    void StaticBatch::DestroyClusters()
+    {
+        auto &registry = ResourceRegistry::Get();
+        for (auto &cluster : mClusters)
+            registry.Destroy(cluster.VertexArray);
+        mClusters.clear();
+    }
+
+    uint32_t StaticBatch::GetMortonCode(const glm::vec3 &inNormalizedPosition)
+    {
+        // spreads the 10 low bits of a value so there are two zero bits between each of them
+        auto expandBits = [](uint32_t inValue)
+        {
+            inValue = (inValue * 0x00010001u) & 0xFF0000FFu;
+            inValue = (inValue * 0x00000101u) & 0x0F00F00Fu;
+            inValue = (inValue * 0x00000011u) & 0xC30C30C3u;
+            inValue = (inValue * 0x00000005u) & 0x49249249u;
+            return inValue;
+        };
+
+        glm::uvec3 cell = glm::uvec3(glm::clamp(inNormalizedPosition * 1024.0f, glm::vec3(0.0f), glm::vec3(1023.0f)));
+        return (expandBits(cell.x) << 2) | (expandBits(cell.y) << 1) | expandBits(cell.z);
+    }
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "ResourceHandle.h"
+#include "ZenEngine/Core/Math.h"
+
+namespace ZenEngine
+{
+    class StaticMesh;
+    class Material;
+
+    /// @brief Meshes that never move, merged ahead of time.
+    /// The meshes sharing a material are transformed to world space and packed into clusters of nearby meshes,
+    /// each cluster is one vertex array with its own bounds. Drawing the batch culls the clusters and submits
+    /// the visible ones, so a static level costs a draw per visible cluster instead of one per entity
+    class StaticBatch
+    {
+    public:
+        // a cluster is closed when it would go past either limit
+        static constexpr uint32_t MaxClusterVertices = 16384;
+        static constexpr float MaxClusterExtent = 32.0f;
+
+        struct Statistics
+        {
+            uint32_t Meshes = 0;
+            uint32_t Clusters = 0;
+            uint32_t VisibleClusters = 0;
+        };
+
+        StaticBatch() = default;
+        ~StaticBatch();
+
+        StaticBatch(const StaticBatch &) = delete;
+        StaticBatch &operator =(const StaticBatch &) = delete;
+
+        void Add(const std::shared_ptr<StaticMesh> &inMesh, const glm::mat4 &inTransform, const std::shared_ptr<Material> &inMaterial);
+        /// @brief Merges everything added since the last Clear, replacing the previous clusters
+        void Build();
+        void Clear();
+
+        /// @brief Submits the clusters intersecting the world space frustum to the renderer
+        void Submit(const Math::Frustum &inFrustum);
+
+        bool IsEmpty() const { return mClusters.empty(); }
+        const Statistics &GetStatistics() const { return mStatistics; }
+    private:
+        struct Item
+        {
+            std::shared_ptr<StaticMesh> Mesh;
+            glm::mat4 Transform;
+            std::shared_ptr<Material> Mat;
+            Math::BoundingBox Bounds;
+            uint32_t MortonCode;
+        };
+
+        struct Cluster
+        {
+            VertexArrayHandle VertexArray;
+            Math::BoundingBox Bounds;
+            std::shared_ptr<Material> Mat;
+        };
+
+        std::vector<Item> mItems;
+        std::vector<Cluster> mClusters;
+        Statistics mStatistics;
+
+        void BuildClusters(std::vector<Item*> &ioItems);
+        void DestroyClusters();
+
+        static uint32_t GetMortonCode(const glm::vec3 &inNormalizedPosition);
+    };
+}
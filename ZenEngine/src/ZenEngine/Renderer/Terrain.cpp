@@ -0,0 +1,275 @@
+#include "Terrain.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "ResourceRegistry.h"
+#include "Texture2D.h"
+#include "VertexArray.h"
+#include "VertexBuffer.h"
+#include "IndexBuffer.h"
+#include "ZenEngine/Core/JobSystem.h"
+#include "ZenEngine/Core/Log.h"
+
+namespace ZenEngine
+{
+    // clipmap rows refilled per job
+    static constexpr uint32_t ClipmapRowsPerJob = 16;
+
+    static bool IntersectsSphere(const Math::BoundingBox &inBox, const glm::vec3 &inCenter, float inRadius)
+    {
+        glm::vec3 offset = glm::clamp(inCenter, inBox.Min, inBox.Max) - inCenter;
+        return glm::dot(offset, offset) <= inRadius * inRadius;
+    }
+
+    Terrain::~Terrain()
+    {
+        Unload();
+        ResourceRegistry::Get().Destroy(mVertexArray);
+    }
+
+    bool Terrain::Load(const std::filesystem::path &inFilepath)
+    {
+        Unload();
+        if (!mHeightMap.Open(inFilepath)) return false;
+
+        // enough levels for the coarsest node to cover the terrain, the roots tile it otherwise
+        glm::vec2 size = mHeightMap.GetSize();
+        float leafSize = PatchResolution * mHeightMap.GetSampleSpacing();
+        mLodCount = 1;
+        while (mLodCount < MaxLodCount && leafSize * static_cast<float>(1u << (mLodCount - 1)) < std::max(size.x, size.y))
+            ++mLodCount;
+        UpdateLodRanges();
+
+        glm::vec2 heights = mHeightMap.GetHeightRange(0, 0, static_cast<int32_t>(mHeightMap.GetWidth()) - 1, static_cast<int32_t>(mHeightMap.GetDepth()) - 1);
+        mBounds = Math::BoundingBox();
+        mBounds.Extend(glm::vec3(0.0f, heights.x, 0.0f));
+        mBounds.Extend(glm::vec3(size.x, heights.y, size.y));
+
+        Texture2D::Properties props;
+        props.Width = ClipmapResolution;
+        props.Height = ClipmapResolution * mLodCount;
+        props.Format = Texture2D::Format::R32F;
+        props.GenerateMips = false;
+        mHeightTexture = ResourceRegistry::Get().Register(Texture2D::Create(props));
+        mClipmapData.resize(static_cast<size_t>(props.Width) * props.Height);
+        mClipmapValid = false;
+        return true;
+    }
+
+    void Terrain::Unload()
+    {
+        mHeightMap.Close();
+        ResourceRegistry::Get().Destroy(mHeightTexture);
+        mHeightTexture = Texture2DHandle::Null;
+        mClipmapData.clear();
+        mClipmapValid = false;
+        mPatches.clear();
+        mLodCount = 0;
+        mStatistics = {};
+    }
+
+    void Terrain::SetDetailDistance(float inDistance)
+    {
+        mDetailDistance = inDistance;
+        UpdateLodRanges();
+    }
+
+    uint32_t Terrain::Update(const glm::vec3 &inPosition, const glm::vec3 &inEyePosition, const Math::Frustum &inFrustum)
+    {
+        mPatches.clear();
+        mStatistics.Patches = 0;
+        if (!IsLoaded()) return 0;
+
+        // the selection runs in the local space of the terrain, the frustum test moves the nodes to world space
+        mPosition = inPosition;
+        glm::vec3 eye = inEyePosition - inPosition;
+        UpdateClipmap(eye);
+
+        glm::vec2 size = mHeightMap.GetSize();
+        float rootSize = PatchResolution * mHeightMap.GetSampleSpacing() * static_cast<float>(1u << (mLodCount - 1));
+        uint32_t rootsX = std::max(static_cast<uint32_t>(std::ceil(size.x / rootSize)), 1u);
+        uint32_t rootsZ = std::max(static_cast<uint32_t>(std::ceil(size.y / rootSize)), 1u);
+        for (uint32_t z = 0; z < rootsZ; ++z)
+        {
+            for (uint32_t x = 0; x < rootsX; ++x)
+                SelectNode(glm::vec2(x, z) * rootSize, mLodCount - 1, eye, inFrustum);
+        }
+
+        mStatistics.Patches = GetPatchCount();
+        if (mPatches.empty()) return 0;
+
+        if (mVertexArray.IsNull() || mStatistics.Patches > mInstanceCapacity)
+            RebuildVertexArray(std::max(mStatistics.Patches, mInstanceCapacity * 2));
+        mInstanceBuffer->SetData(mPatches.data(), mStatistics.Patches * sizeof(glm::mat4));
+        return mStatistics.Patches;
+    }
+
+    glm::vec4 Terrain::GetClipmapParameters() const
+    {
+        return glm::vec4(glm::vec2(mClipmapCenter), mHeightMap.GetSampleSpacing(), static_cast<float>(mLodCount));
+    }
+
+    void Terrain::UpdateLodRanges()
+    {
+        if (mLodCount == 0) return;
+
+        // a node has to be well inside the range of its level, or its finer neighbours could still be morphing
+        float leafSize = PatchResolution * mHeightMap.GetSampleSpacing();
+        float detailDistance = std::max(mDetailDistance, 2.0f * leafSize);
+        for (uint32_t lod = 0; lod < mLodCount; ++lod)
+        {
+            float previous = lod > 0 ? mLodRanges[lod - 1] : 0.0f;
+            mLodRanges[lod] = detailDistance * static_cast<float>(1u << lod);
+            mMorphRanges[lod] = { glm::mix(previous, mLodRanges[lod], 1.0f - MorphRegion), mLodRanges[lod] };
+        }
+        // the coarsest level covers everything further and never morphs
+        mLodRanges[mLodCount - 1] = std::numeric_limits<float>::max();
+        mMorphRanges[mLodCount - 1] = { 1e30f, 2e30f };
+    }
+
+    Math::BoundingBox Terrain::GetNodeBounds(const glm::vec2 &inOrigin, float inSize) const
+    {
+        // the vertex shader clamps the patches to the terrain, so do the bounds
+        glm::vec2 size = mHeightMap.GetSize();
+        glm::vec2 end = glm::min(inOrigin + inSize, size);
+        float spacing = mHeightMap.GetSampleSpacing();
+        glm::vec2 heights = mHeightMap.GetHeightRange(
+            static_cast<int32_t>(inOrigin.x / spacing), static_cast<int32_t>(inOrigin.y / spacing),
+            static_cast<int32_t>(std::ceil(end.x / spacing)), static_cast<int32_t>(std::ceil(end.y / spacing)));
+
+        Math::BoundingBox bounds;
+        bounds.Extend(glm::vec3(inOrigin.x, heights.x, inOrigin.y));
+        bounds.Extend(glm::vec3(end.x, heights.y, end.y));
+        return bounds;
+    }
+
+    bool Terrain::SelectNode(const glm::vec2 &inOrigin, uint32_t inLod, const glm::vec3 &inEyePosition, const Math::Frustum &inFrustum)
+    {
+        float size = PatchResolution * mHeightMap.GetSampleSpacing() * static_cast<float>(1u << inLod);
+        Math::BoundingBox bounds = GetNodeBounds(inOrigin, size);
+        // out of range, the parent draws this area at its own level
+        if (!IntersectsSphere(bounds, inEyePosition, mLodRanges[inLod])) return false;
+
+        Math::BoundingBox worldBounds = bounds;
+        worldBounds.Min += mPosition;
+        worldBounds.Max += mPosition;
+        if (inFrustum.Test(worldBounds) == Math::Frustum::Result::Outside) return true;
+
+        if (inLod == 0 || !IntersectsSphere(bounds, inEyePosition, mLodRanges[inLod - 1]))
+        {
+            AddPatch(inOrigin, inLod);
+            return true;
+        }
+
+        glm::vec2 terrainSize = mHeightMap.GetSize();
+        float half = size * 0.5f;
+        for (uint32_t child = 0; child < 4; ++child)
+        {
+            glm::vec2 origin = inOrigin + glm::vec2(child & 1, child >> 1) * half;
+            if (origin.x >= terrainSize.x || origin.y >= terrainSize.y) continue;
+            if (SelectNode(origin, inLod - 1, inEyePosition, inFrustum)) continue;
+
+            // the child is past its own range so it morphs completely and looks like this level
+            Math::BoundingBox childBounds = GetNodeBounds(origin, half);
+            childBounds.Min += mPosition;
+            childBounds.Max += mPosition;
+            if (inFrustum.Test(childBounds) != Math::Frustum::Result::Outside)
+                AddPatch(origin, inLod - 1);
+        }
+        return true;
+    }
+
+    void Terrain::AddPatch(const glm::vec2 &inOrigin, uint32_t inLod)
+    {
+        float size = PatchResolution * mHeightMap.GetSampleSpacing() * static_cast<float>(1u << inLod);
+        // the layout of the PatchData matrix read by Terrain.hlsl
+        mPatches.emplace_back(
+            glm::vec4(inOrigin.x, inOrigin.y, size, static_cast<float>(inLod)),
+            glm::vec4(mMorphRanges[inLod], 0.0f, 0.0f),
+            glm::vec4(0.0f),
+            glm::vec4(0.0f));
+    }
+
+    void Terrain::UpdateClipmap(const glm::vec3 &inEyePosition)
+    {
+        // the clipmap is only recentered once the eye has moved an eighth of the finest level away
+        glm::ivec2 center = glm::ivec2(glm::round(glm::vec2(inEyePosition.x, inEyePosition.z) / mHeightMap.GetSampleSpacing()));
+        glm::ivec2 offset = glm::abs(center - mClipmapCenter);
+        int32_t threshold = static_cast<int32_t>(ClipmapResolution / 8);
+        if (mClipmapValid && offset.x <= threshold && offset.y <= threshold) return;
+        mClipmapCenter = center;
+        mClipmapValid = true;
+
+        // texel i of level l holds the sample 2^l * (i - R / 2) away from the center, the coarse levels skip samples
+        int32_t halfResolution = static_cast<int32_t>(ClipmapResolution / 2);
+        JobSystem::Get().ParallelFor(ClipmapResolution * mLodCount, ClipmapRowsPerJob, [&](uint32_t inBegin, uint32_t inEnd)
+        {
+            for (uint32_t row = inBegin; row < inEnd; ++row)
+            {
+                int32_t step = 1 << (row / ClipmapResolution);
+                int32_t z = center.y + (static_cast<int32_t>(row % ClipmapResolution) - halfResolution) * step;
+                float *texels = mClipmapData.data() + static_cast<size_t>(row) * ClipmapResolution;
+                for (int32_t i = 0; i < static_cast<int32_t>(ClipmapResolution); ++i)
+                    texels[i] = mHeightMap.GetHeight(center.x + (i - halfResolution) * step, z);
+            }
+        });
+
+        if (auto *texture = ResourceRegistry::Get().Resolve(mHeightTexture))
+            texture->SetData(mClipmapData.data(), static_cast<uint32_t>(mClipmapData.size() * sizeof(float)));
+        ++mStatistics.ClipmapUpdates;
+    }
+
+    void Terrain::RebuildVertexArray(uint32_t inCapacity)
+    {
+        if (mGridVertices == nullptr)
+        {
+            // integer grid coordinates, the morph in the vertex shader relies on them
+            constexpr uint32_t side = PatchResolution + 1;
+            std::vector<float> vertices;
+            vertices.reserve(side * side * 2);
+            for (uint32_t z = 0; z < side; ++z)
+            {
+                for (uint32_t x = 0; x < side; ++x)
+                {
+                    vertices.push_back(static_cast<float>(x));
+                    vertices.push_back(static_cast<float>(z));
+                }
+            }
+            mGridVertices = VertexBuffer::Create(vertices.data(), static_cast<uint32_t>(vertices.size() * sizeof(float)));
+            mGridVertices->SetLayout({
+                { ShaderDataType::Float2, "GridPosition" }
+            });
+
+            std::vector<uint32_t> indices;
+            indices.reserve(PatchResolution * PatchResolution * 6);
+            for (uint32_t z = 0; z < PatchResolution; ++z)
+            {
+                for (uint32_t x = 0; x < PatchResolution; ++x)
+                {
+                    uint32_t first = z * side + x;
+                    indices.insert(indices.end(), { first, first + side, first + 1, first + 1, first + side, first + side + 1 });
+                }
+            }
+            mGridIndices = IndexBuffer::Create(indices);
+        }
+
+        mInstanceBuffer = VertexBuffer::Create(inCapacity * sizeof(glm::mat4));
+        mInstanceBuffer->SetLayout({
+            { ShaderDataType::Mat4, "PatchData" }
+        });
+        mInstanceCapacity = inCapacity;
+
+        auto vertexArray = VertexArray::Create();
+        vertexArray->AddVertexBuffer(mGridVertices);
+        vertexArray->AddVertexBuffer(mInstanceBuffer);
+        vertexArray->SetIndexBuffer(mGridIndices);
+
+        auto &registry = ResourceRegistry::Get();
+        if (mVertexArray.IsNull())
+            mVertexArray = registry.Register(vertexArray);
+        else
+            registry.Replace(mVertexArray, vertexArray);
+    }
+}
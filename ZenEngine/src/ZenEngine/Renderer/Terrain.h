@@ -0,0 +1,115 @@
+#pragma once
+
+#include <array>
+#include <filesystem>
+#include <memory>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "ResourceHandle.h"
+#include "TerrainHeightMap.h"
+#include "ZenEngine/Core/Math.h"
+
+namespace ZenEngine
+{
+    class VertexBuffer;
+    class IndexBuffer;
+
+    /// @brief Heightfield terrain drawn with a quadtree of patches that all share one grid mesh.
+    /// Each frame the quadtree is walked from the coarsest level: a node is split while the eye is within the
+    /// range of the next finer level, nodes outside the frustum are dropped. Every selected node becomes one instance
+    /// of the grid, and near the end of its range the grid vertices morph onto the grid of the next coarser level so
+    /// the switch between two levels never pops.
+    /// The vertex shader reads the heights from a clipmap, a stack of textures of the same resolution each covering
+    /// twice the area of the previous one, centered on the eye and refilled from the mapped height tiles as it moves
+    class Terrain
+    {
+    public:
+        // quads along a side of the patch grid
+        static constexpr uint32_t PatchResolution = 32;
+        static constexpr uint32_t MaxLodCount = 8;
+        // texels along a side of a clipmap level
+        static constexpr uint32_t ClipmapResolution = 256;
+        // fraction of the range of a level over which its patches morph into the next one
+        static constexpr float MorphRegion = 0.3f;
+
+        struct Surface
+        {
+            glm::vec3 BaseColor = glm::vec3(1.0f);
+            float Specular = 0.0f;
+            float Shininess = 32.0f;
+            // repetitions of the base color texture per world unit
+            float TextureScale = 0.1f;
+        };
+
+        struct Statistics
+        {
+            uint32_t Patches = 0;
+            uint32_t ClipmapUpdates = 0;
+        };
+
+        Terrain() = default;
+        ~Terrain();
+
+        Terrain(const Terrain &) = delete;
+        Terrain &operator =(const Terrain &) = delete;
+
+        /// @brief Maps a height map written by TerrainHeightMap, returns false if it cannot be read
+        bool Load(const std::filesystem::path &inFilepath);
+        void Unload();
+        bool IsLoaded() const { return mHeightMap.IsOpen(); }
+        const TerrainHeightMap &GetHeightMap() const { return mHeightMap; }
+
+        /// @brief Distance up to which the full resolution patches are drawn, each coarser level doubles it
+        void SetDetailDistance(float inDistance);
+        float GetDetailDistance() const { return mDetailDistance; }
+
+        void SetSurface(const Surface &inSurface) { mSurface = inSurface; }
+        const Surface &GetSurface() const { return mSurface; }
+
+        /// @brief Selects the patches seen from the eye, streams the heights around it and uploads the instances.
+        /// The terrain only follows the translation of its entity so the LOD ranges stay in world units
+        /// @return the number of patches to draw
+        uint32_t Update(const glm::vec3 &inPosition, const glm::vec3 &inEyePosition, const Math::Frustum &inFrustum);
+
+        uint32_t GetPatchCount() const { return static_cast<uint32_t>(mPatches.size()); }
+        VertexArrayHandle GetVertexArray() const { return mVertexArray; }
+        Texture2DHandle GetHeightTexture() const { return mHeightTexture; }
+        /// @brief Clipmap center in samples, sample spacing and level count, the layout read by Terrain.hlsl
+        glm::vec4 GetClipmapParameters() const;
+        /// @brief Local space bounds of the whole terrain
+        const Math::BoundingBox &GetBounds() const { return mBounds; }
+        const Statistics &GetStatistics() const { return mStatistics; }
+    private:
+        TerrainHeightMap mHeightMap;
+        Math::BoundingBox mBounds;
+        Surface mSurface;
+        float mDetailDistance = 64.0f;
+        uint32_t mLodCount = 0;
+        std::array<float, MaxLodCount> mLodRanges{};
+        std::array<glm::vec2, MaxLodCount> mMorphRanges{};
+
+        glm::vec3 mPosition = glm::vec3(0.0f);
+        std::vector<glm::mat4> mPatches;
+        Statistics mStatistics;
+
+        // the levels are stacked vertically in one texture, level 0 at the top
+        Texture2DHandle mHeightTexture;
+        std::vector<float> mClipmapData;
+        glm::ivec2 mClipmapCenter = glm::ivec2(0);
+        bool mClipmapValid = false;
+
+        std::shared_ptr<VertexBuffer> mGridVertices;
+        std::shared_ptr<IndexBuffer> mGridIndices;
+        std::shared_ptr<VertexBuffer> mInstanceBuffer;
+        uint32_t mInstanceCapacity = 0;
+        VertexArrayHandle mVertexArray;
+
+        void UpdateLodRanges();
+        Math::BoundingBox GetNodeBounds(const glm::vec2 &inOrigin, float inSize) const;
+        bool SelectNode(const glm::vec2 &inOrigin, uint32_t inLod, const glm::vec3 &inEyePosition, const Math::Frustum &inFrustum);
+        void AddPatch(const glm::vec2 &inOrigin, uint32_t inLod);
+        void UpdateClipmap(const glm::vec3 &inEyePosition);
+        void RebuildVertexArray(uint32_t inCapacity);
+    };
+}
@@ -0,0 +1,155 @@
+#include "TerrainHeightMap.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+#include <stb_image.h>
+
+#include "ZenEngine/Core/Log.h"
+
+namespace ZenEngine
+{
+    bool TerrainHeightMap::Open(const std::filesystem::path &inFilepath)
+    {
+        Close();
+        if (!mFile.Open(inFilepath)) return false;
+
+        if (mFile.GetSize() < sizeof(Header))
+        {
+            ZE_CORE_ERROR("{} is not a terrain height map", inFilepath.string());
+            Close();
+            return false;
+        }
+        std::memcpy(&mHeader, mFile.GetData(), sizeof(Header));
+
+        uint64_t tileCount = static_cast<uint64_t>(mHeader.TilesX) * mHeader.TilesZ;
+        uint64_t tileSamples = static_cast<uint64_t>(mHeader.TileSize) * mHeader.TileSize;
+        uint64_t expectedSize = sizeof(Header) + tileCount * 2 * sizeof(uint16_t) + tileCount * tileSamples * sizeof(uint16_t);
+        if (mHeader.Magic != Magic || mHeader.Version != Version || tileCount == 0 || tileSamples == 0 || mFile.GetSize() < expectedSize)
+        {
+            ZE_CORE_ERROR("{} is not a terrain height map or is truncated", inFilepath.string());
+            Close();
+            return false;
+        }
+
+        mTileRanges = reinterpret_cast<const uint16_t*>(mFile.GetData() + sizeof(Header));
+        mSamples = mTileRanges + tileCount * 2;
+        ZE_CORE_INFO("Mapped terrain height map {}: {}x{} samples in {}x{} tiles", inFilepath.string(), GetWidth(), GetDepth(), mHeader.TilesX, mHeader.TilesZ);
+        return true;
+    }
+
+    void TerrainHeightMap::Close()
+    {
+        mFile.Close();
+        mHeader = {};
+        mTileRanges = nullptr;
+        mSamples = nullptr;
+    }
+
+    glm::vec2 TerrainHeightMap::GetSize() const
+    {
+        return glm::vec2(GetWidth() - 1, GetDepth() - 1) * mHeader.SampleSpacing;
+    }
+
+    float TerrainHeightMap::GetHeight(int32_t inX, int32_t inZ) const
+    {
+        uint32_t x = static_cast<uint32_t>(std::clamp(inX, 0, static_cast<int32_t>(GetWidth()) - 1));
+        uint32_t z = static_cast<uint32_t>(std::clamp(inZ, 0, static_cast<int32_t>(GetDepth()) - 1));
+        uint32_t tileSize = mHeader.TileSize;
+        uint64_t tile = static_cast<uint64_t>(z / tileSize) * mHeader.TilesX + x / tileSize;
+        uint64_t sample = tile * tileSize * tileSize + (z % tileSize) * tileSize + (x % tileSize);
+        return ToHeight(mSamples[sample]);
+    }
+
+    glm::vec2 TerrainHeightMap::GetHeightRange(int32_t inMinX, int32_t inMinZ, int32_t inMaxX, int32_t inMaxZ) const
+    {
+        int32_t tileSize = static_cast<int32_t>(mHeader.TileSize);
+        int32_t lastTileX = static_cast<int32_t>(mHeader.TilesX) - 1;
+        int32_t lastTileZ = static_cast<int32_t>(mHeader.TilesZ) - 1;
+        int32_t minTileX = std::clamp(inMinX / tileSize, 0, lastTileX);
+        int32_t maxTileX = std::clamp(inMaxX / tileSize, 0, lastTileX);
+        int32_t minTileZ = std::clamp(inMinZ / tileSize, 0, lastTileZ);
+        int32_t maxTileZ = std::clamp(inMaxZ / tileSize, 0, lastTileZ);
+
+        uint16_t low = 65535;
+        uint16_t high = 0;
+        for (int32_t z = minTileZ; z <= maxTileZ; ++z)
+        {
+            for (int32_t x = minTileX; x <= maxTileX; ++x)
+            {
+                const uint16_t *range = mTileRanges + (static_cast<size_t>(z) * mHeader.TilesX + x) * 2;
+                low = std::min(low, range[0]);
+                high = std::max(high, range[1]);
+            }
+        }
+        return { ToHeight(low), ToHeight(high) };
+    }
+
+    bool TerrainHeightMap::Write(const std::filesystem::path &inFilepath, const uint16_t *inSamples, uint32_t inWidth, uint32_t inDepth,
+        uint32_t inTileSize, float inSampleSpacing, float inHeightScale, float inHeightOffset)
+    {
+        if (inSamples == nullptr || inWidth == 0 || inDepth == 0 || inTileSize == 0) return false;
+
+        Header header;
+        header.Magic = Magic;
+        header.Version = Version;
+        header.TileSize = inTileSize;
+        header.TilesX = (inWidth + inTileSize - 1) / inTileSize;
+        header.TilesZ = (inDepth + inTileSize - 1) / inTileSize;
+        header.SampleSpacing = inSampleSpacing;
+        header.HeightScale = inHeightScale;
+        header.HeightOffset = inHeightOffset;
+
+        size_t tileCount = static_cast<size_t>(header.TilesX) * header.TilesZ;
+        size_t tileSamples = static_cast<size_t>(inTileSize) * inTileSize;
+        std::vector<uint16_t> ranges(tileCount * 2);
+        std::vector<uint16_t> tiles(tileCount * tileSamples);
+        for (uint32_t tileZ = 0; tileZ < header.TilesZ; ++tileZ)
+        {
+            for (uint32_t tileX = 0; tileX < header.TilesX; ++tileX)
+            {
+                size_t tile = static_cast<size_t>(tileZ) * header.TilesX + tileX;
+                uint16_t low = 65535;
+                uint16_t high = 0;
+                for (uint32_t z = 0; z < inTileSize; ++z)
+                {
+                    uint32_t sourceZ = std::min(tileZ * inTileSize + z, inDepth - 1);
+                    for (uint32_t x = 0; x < inTileSize; ++x)
+                    {
+                        uint32_t sourceX = std::min(tileX * inTileSize + x, inWidth - 1);
+                        uint16_t value = inSamples[static_cast<size_t>(sourceZ) * inWidth + sourceX];
+                        tiles[tile * tileSamples + static_cast<size_t>(z) * inTileSize + x] = value;
+                        low = std::min(low, value);
+                        high = std::max(high, value);
+                    }
+                }
+                ranges[tile * 2] = low;
+                ranges[tile * 2 + 1] = high;
+            }
+        }
+
+        std::vector<uint8_t> bytes(sizeof(Header) + (ranges.size() + tiles.size()) * sizeof(uint16_t));
+        std::memcpy(bytes.data(), &header, sizeof(Header));
+        std::memcpy(bytes.data() + sizeof(Header), ranges.data(), ranges.size() * sizeof(uint16_t));
+        std::memcpy(bytes.data() + sizeof(Header) + ranges.size() * sizeof(uint16_t), tiles.data(), tiles.size() * sizeof(uint16_t));
+        Filesystem::WriteBytes(inFilepath, bytes.data(), bytes.size());
+        return std::filesystem::exists(inFilepath);
+    }
+
+    bool TerrainHeightMap::CreateFromImage(const std::filesystem::path &inImagePath, const std::filesystem::path &inFilepath,
+        float inSampleSpacing, float inHeightScale, float inHeightOffset)
+    {
+        int width, height, channels;
+        // 8 bit images are widened to 16 bits by stb
+        uint16_t *samples = stbi_load_16(inImagePath.string().c_str(), &width, &height, &channels, 1);
+        if (samples == nullptr)
+        {
+            ZE_CORE_ERROR("Cannot load height map image {}", inImagePath.string());
+            return false;
+        }
+        bool written = Write(inFilepath, samples, static_cast<uint32_t>(width), static_cast<uint32_t>(height),
+            DefaultTileSize, inSampleSpacing, inHeightScale, inHeightOffset);
+        stbi_image_free(samples);
+        return written;
+    }
+}
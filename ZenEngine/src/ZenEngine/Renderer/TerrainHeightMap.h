@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <glm/glm.hpp>
+
+#include "ZenEngine/Core/Filesystem.h"
+
+namespace ZenEngine
+{
+    /// @brief Terrain heights stored as square tiles of 16 bit samples, read through a memory mapping.
+    /// The file is a header, the min and max sample of every tile, then the tiles row by row with the samples of each
+    /// tile contiguous. Reading a region only touches the pages of the tiles it overlaps, so a large world never has
+    /// to sit in memory as a whole
+    class TerrainHeightMap
+    {
+    public:
+        // "ZTHF" read as a little endian integer
+        static constexpr uint32_t Magic = 0x4648545A;
+        static constexpr uint32_t Version = 1;
+        static constexpr uint32_t DefaultTileSize = 256;
+
+        struct Header
+        {
+            uint32_t Magic;
+            uint32_t Version;
+            // samples along a side of a tile
+            uint32_t TileSize;
+            uint32_t TilesX;
+            uint32_t TilesZ;
+            // distance between two samples
+            float SampleSpacing;
+            // a sample maps to HeightOffset + HeightScale * value / 65535
+            float HeightScale;
+            float HeightOffset;
+        };
+
+        /// @brief Returns false if the file is missing or is not a height map
+        bool Open(const std::filesystem::path &inFilepath);
+        void Close();
+        bool IsOpen() const { return mFile.IsOpen(); }
+
+        const Header &GetHeader() const { return mHeader; }
+        // number of samples along x and z
+        uint32_t GetWidth() const { return mHeader.TilesX * mHeader.TileSize; }
+        uint32_t GetDepth() const { return mHeader.TilesZ * mHeader.TileSize; }
+        float GetSampleSpacing() const { return mHeader.SampleSpacing; }
+        // extent of the terrain on the xz plane, sample (0, 0) sits at the origin
+        glm::vec2 GetSize() const;
+
+        /// @brief Height of a sample, coordinates outside the map are clamped to its border
+        float GetHeight(int32_t inX, int32_t inZ) const;
+        /// @brief Lowest and highest height over a rectangle of samples, from the per tile ranges so it is conservative
+        glm::vec2 GetHeightRange(int32_t inMinX, int32_t inMinZ, int32_t inMaxX, int32_t inMaxZ) const;
+
+        /// @brief Writes a height map file out of row major samples. The sides are padded to a multiple of the tile
+        /// size by repeating the last row and column
+        static bool Write(const std::filesystem::path &inFilepath, const uint16_t *inSamples, uint32_t inWidth, uint32_t inDepth,
+            uint32_t inTileSize, float inSampleSpacing, float inHeightScale, float inHeightOffset);
+        /// @brief Converts a grayscale image, 16 bit PNGs keep their full precision
+        static bool CreateFromImage(const std::filesystem::path &inImagePath, const std::filesystem::path &inFilepath,
+            float inSampleSpacing, float inHeightScale, float inHeightOffset);
+    private:
+        Filesystem::MappedFile mFile;
+        Header mHeader{};
+        const uint16_t *mTileRanges = nullptr;
+        const uint16_t *mSamples = nullptr;
+
+        float ToHeight(uint16_t inValue) const { return mHeader.HeightOffset + mHeader.HeightScale * (inValue / 65535.0f); }
+    };
+}
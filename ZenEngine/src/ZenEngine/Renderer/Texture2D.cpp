@@ -3,6 +3,7 @@
 #include "RendererAPI.h"
 #include "ZenEngine/Core/Macros.h"
 #include "Platform/OpenGL/OpenGLTexture2D.h"
+#include "Platform/Software/SoftwareTexture2D.h"
 
 namespace ZenEngine
 {
@@ -12,6 +13,7 @@ namespace ZenEngine
         {
         case RendererAPI::API::None: ZE_ASSERT_CORE_MSG(false, "RendererAPI::None is currently not supported!"); return nullptr;
         case RendererAPI::API::OpenGL: return std::make_shared<OpenGLTexture2D>(inProperties);
+        case RendererAPI::API::Software: return std::make_shared<SoftwareTexture2D>(inProperties);
         }
         ZE_ASSERT_CORE_MSG(false, "Unknown renderer API!");
     }
@@ -17,9 +17,22 @@ namespace ZenEngine
             R8,
             RGB8,
             RGBA8,
-            RGBA32F
+            RGBA32F,
+            // single float channel, e.g. height data. Unlike the other formats the data is 32 bit floats
+            R32F,
+            // block compressed, each block of 4x4 texels takes 8 bytes with BC1 and BC4 and 16 with the others
+            BC1,
+            BC3,
+            BC4,
+            BC5,
+            BC7
         };
 
+        static bool IsCompressedFormat(Texture2D::Format inFormat)
+        {
+            return inFormat >= Texture2D::Format::BC1 && inFormat <= Texture2D::Format::BC7;
+        }
+
         static uint32_t Texture2DFormatBytes(Texture2D::Format inFormat)
         {
             switch (inFormat)
@@ -28,9 +41,18 @@ namespace ZenEngine
             case Texture2D::Format::RGB8: return 3;
             case Texture2D::Format::RGBA32F: return 4;
             case Texture2D::Format::RGBA8: return 4; 
+            case Texture2D::Format::R32F: return 4;
             default: ZE_ASSERT_CORE_MSG(false, "Texture2D::Format default case!"); return 0;
             }
         }
+
+        /// @brief Bytes of a whole level, compressed levels are rounded up to entire blocks
+        static uint32_t Texture2DDataSize(Texture2D::Format inFormat, uint32_t inWidth, uint32_t inHeight)
+        {
+            if (!IsCompressedFormat(inFormat)) return inWidth * inHeight * Texture2DFormatBytes(inFormat);
+            uint32_t blockBytes = inFormat == Texture2D::Format::BC1 || inFormat == Texture2D::Format::BC4 ? 8 : 16;
+            return ((inWidth + 3) / 4) * ((inHeight + 3) / 4) * blockBytes;
+        }
         
         enum class Filter
         {
@@ -45,6 +67,8 @@ namespace ZenEngine
             uint32_t Height = 1;
             Texture2D::Format Format = Texture2D::Format::RGBA8;
             bool GenerateMips = true;
+            // levels filled with SetMipData, ignored with GenerateMips which always makes the whole chain
+            uint32_t MipLevels = 1;
             Texture2D::Filter MagFilter = Texture2D::Filter::Linear;
             Texture2D::Filter MinFilter = Texture2D::Filter::Linear;
         };
@@ -63,11 +87,22 @@ namespace ZenEngine
         void SetData(void *inData)
         {
             auto &props = GetProperties();
-            SetData(inData, props.Width * props.Height * Texture2DFormatBytes(props.Format));
+            SetData(inData, Texture2DDataSize(props.Format, props.Width, props.Height));
         }
 
+        /// @brief Fills one level of a texture created with several MipLevels, the data must be the entire level
+        virtual void SetMipData(uint32_t inLevel, void *inData, uint32_t inSize) = 0;
+
         virtual void Bind(uint32_t inSlot = 0) const = 0;
 
+        /// @brief Number of levels of a full chain, down to a single texel
+        static uint32_t GetFullMipCount(uint32_t inWidth, uint32_t inHeight)
+        {
+            uint32_t count = 1;
+            while ((inWidth >> count) > 0 || (inHeight >> count) > 0) ++count;
+            return count;
+        }
+
         static std::shared_ptr<Texture2D> Create(const Texture2D::Properties& inProperties);
         static std::shared_ptr<Texture2D> Create(const Texture2D::Properties& inProperties, void *inData, uint32_t inSize);
     };
@@ -0,0 +1,642 @@
+#include "TextureCompression.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <glm/glm.hpp>
+
+#include "ZenEngine/Core/JobSystem.h"
+#include "ZenEngine/Core/Log.h"
+#include "ZenEngine/Core/Macros.h"
+
+namespace ZenEngine
+{
+    namespace
+    {
+        // texels of a block in [0, 255], row by row
+        using Block = std::array<glm::vec4, 16>;
+
+        // rows of blocks encoded by a single job
+        constexpr uint32_t BlockRowsPerJob = 4;
+        // weights of the BC7 palettes with 4 bit indices, out of 64
+        constexpr uint32_t BC7Weights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+        class BitWriter
+        {
+        public:
+            BitWriter(uint8_t *outData) : mData(outData) {}
+
+            void Write(uint32_t inValue, uint32_t inBits)
+            {
+                for (uint32_t i = 0; i < inBits; ++i, ++mPosition)
+                    if ((inValue >> i) & 1) mData[mPosition >> 3] |= static_cast<uint8_t>(1 << (mPosition & 7));
+            }
+        private:
+            uint8_t *mData;
+            uint32_t mPosition = 0;
+        };
+
+        class BitReader
+        {
+        public:
+            BitReader(const uint8_t *inData) : mData(inData) {}
+
+            uint32_t Read(uint32_t inBits)
+            {
+                uint32_t value = 0;
+                for (uint32_t i = 0; i < inBits; ++i, ++mPosition)
+                    value |= ((mData[mPosition >> 3] >> (mPosition & 7)) & 1u) << i;
+                return value;
+            }
+        private:
+            const uint8_t *mData;
+            uint32_t mPosition = 0;
+        };
+
+        uint32_t GetBlockBytes(Texture2D::Format inFormat)
+        {
+            return Texture2D::Texture2DDataSize(inFormat, 4, 4);
+        }
+
+        // the edge texels are repeated where the level does not fill the block
+        Block LoadBlock(const uint8_t *inTexels, uint32_t inChannels, uint32_t inWidth, uint32_t inHeight, uint32_t inBlockX, uint32_t inBlockY)
+        {
+            Block block;
+            for (uint32_t y = 0; y < 4; ++y)
+            {
+                uint32_t row = std::min(inBlockY * 4 + y, inHeight - 1);
+                for (uint32_t x = 0; x < 4; ++x)
+                {
+                    uint32_t column = std::min(inBlockX * 4 + x, inWidth - 1);
+                    const uint8_t *texel = inTexels + (static_cast<size_t>(row) * inWidth + column) * inChannels;
+                    glm::vec4 value(0.0f, 0.0f, 0.0f, 255.0f);
+                    for (uint32_t c = 0; c < inChannels; ++c)
+                        value[c] = static_cast<float>(texel[c]);
+                    block[y * 4 + x] = value;
+                }
+            }
+            return block;
+        }
+
+        glm::vec4 Mask(const glm::vec4 &inValue, uint32_t inChannels)
+        {
+            return inChannels == 4 ? inValue : glm::vec4(inValue.x, inValue.y, inValue.z, 0.0f);
+        }
+
+        float Distance2(const glm::vec4 &inA, const glm::vec4 &inB, uint32_t inChannels)
+        {
+            glm::vec4 d = Mask(inA - inB, inChannels);
+            return glm::dot(d, d);
+        }
+
+        /// @brief First guess of the two endpoints of the line the palette of the block is on
+        void ChooseEndpoints(const Block &inBlock, uint32_t inChannels, TextureCompression::Quality inQuality, glm::vec4 &outStart, glm::vec4 &outEnd)
+        {
+            glm::vec4 minimum(255.0f);
+            glm::vec4 maximum(0.0f);
+            glm::vec4 mean(0.0f);
+            for (const auto &texel : inBlock)
+            {
+                minimum = glm::min(minimum, texel);
+                maximum = glm::max(maximum, texel);
+                mean += texel;
+            }
+            mean /= 16.0f;
+
+            if (inQuality == TextureCompression::Quality::Fast)
+            {
+                // pulled in a little, the extremes are rarely worth a palette entry each
+                glm::vec4 inset = (maximum - minimum) / 16.0f;
+                outStart = maximum - inset;
+                outEnd = minimum + inset;
+                return;
+            }
+
+            glm::mat4 covariance(0.0f);
+            for (const auto &texel : inBlock)
+            {
+                glm::vec4 d = Mask(texel - mean, inChannels);
+                covariance += glm::outerProduct(d, d);
+            }
+            // a few power iterations are enough to find the dominant direction of a 4x4 block
+            glm::vec4 axis = Mask(maximum - minimum, inChannels);
+            float length = glm::length(axis);
+            if (length > 1e-4f)
+            {
+                axis /= length;
+                for (uint32_t i = 0; i < 8; ++i)
+                {
+                    glm::vec4 next = covariance * axis;
+                    length = glm::length(next);
+                    if (length < 1e-4f) break;
+                    axis = next / length;
+                }
+            }
+
+            float lowest = 0.0f;
+            float highest = 0.0f;
+            for (const auto &texel : inBlock)
+            {
+                float t = glm::dot(Mask(texel - mean, inChannels), axis);
+                lowest = std::min(lowest, t);
+                highest = std::max(highest, t);
+            }
+            outStart = glm::clamp(mean + axis * highest, 0.0f, 255.0f);
+            outEnd = glm::clamp(mean + axis * lowest, 0.0f, 255.0f);
+        }
+
+        /// @brief Least squares fit of the endpoints, with each texel at the fraction of the way from start to end its index chose
+        bool RefineEndpoints(const Block &inBlock, const float *inWeights, glm::vec4 &outStart, glm::vec4 &outEnd)
+        {
+            float aa = 0.0f;
+            float ab = 0.0f;
+            float bb = 0.0f;
+            glm::vec4 ax(0.0f);
+            glm::vec4 bx(0.0f);
+            for (uint32_t i = 0; i < 16; ++i)
+            {
+                float b = inWeights[i];
+                float a = 1.0f - b;
+                aa += a * a;
+                ab += a * b;
+                bb += b * b;
+                ax += a * inBlock[i];
+                bx += b * inBlock[i];
+            }
+            float determinant = aa * bb - ab * ab;
+            // every texel on the same index, the line is not determined
+            if (std::abs(determinant) < 1e-6f) return false;
+            outStart = glm::clamp((ax * bb - bx * ab) / determinant, 0.0f, 255.0f);
+            outEnd = glm::clamp((bx * aa - ax * ab) / determinant, 0.0f, 255.0f);
+            return true;
+        }
+
+        uint32_t RefineIterations(TextureCompression::Quality inQuality)
+        {
+            switch (inQuality)
+            {
+            case TextureCompression::Quality::Normal: return 1;
+            case TextureCompression::Quality::High: return 8;
+            default: return 0;
+            }
+        }
+
+        uint16_t Pack565(const glm::vec4 &inColor)
+        {
+            uint32_t r = static_cast<uint32_t>(std::lround(inColor.r * 31.0f / 255.0f));
+            uint32_t g = static_cast<uint32_t>(std::lround(inColor.g * 63.0f / 255.0f));
+            uint32_t b = static_cast<uint32_t>(std::lround(inColor.b * 31.0f / 255.0f));
+            return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+        }
+
+        glm::vec4 Unpack565(uint16_t inColor)
+        {
+            uint32_t r = (inColor >> 11) & 31;
+            uint32_t g = (inColor >> 5) & 63;
+            uint32_t b = inColor & 31;
+            return glm::vec4((r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2), 255);
+        }
+
+        /// @brief The colors the indices of a BC1 block pick from. BC3 blocks are always in the four color mode
+        void BC1Palette(uint16_t inColor0, uint16_t inColor1, bool inFourColors, glm::vec4 *outPalette)
+        {
+            glm::vec4 c0 = Unpack565(inColor0);
+            glm::vec4 c1 = Unpack565(inColor1);
+            outPalette[0] = c0;
+            outPalette[1] = c1;
+            if (inFourColors || inColor0 > inColor1)
+            {
+                outPalette[2] = glm::floor((2.0f * c0 + c1) / 3.0f);
+                outPalette[3] = glm::floor((c0 + 2.0f * c1) / 3.0f);
+            }
+            else
+            {
+                outPalette[2] = glm::floor((c0 + c1) / 2.0f);
+                outPalette[3] = glm::vec4(0.0f);
+            }
+        }
+
+        struct BC1Fit
+        {
+            uint16_t Color0;
+            uint16_t Color1;
+            uint32_t Indices = 0;
+            float Error = 0.0f;
+        };
+
+        BC1Fit FitBC1(const Block &inBlock, const glm::vec4 &inStart, const glm::vec4 &inEnd)
+        {
+            BC1Fit fit;
+            fit.Color0 = Pack565(inStart);
+            fit.Color1 = Pack565(inEnd);
+            // the larger color first selects the four color mode, equal colors only ever use the first entry
+            if (fit.Color0 < fit.Color1) std::swap(fit.Color0, fit.Color1);
+            glm::vec4 palette[4];
+            BC1Palette(fit.Color0, fit.Color1, true, palette);
+            uint32_t entries = fit.Color0 == fit.Color1 ? 1 : 4;
+
+            for (uint32_t i = 0; i < 16; ++i)
+            {
+                uint32_t best = 0;
+                float bestError = Distance2(inBlock[i], palette[0], 3);
+                for (uint32_t entry = 1; entry < entries; ++entry)
+                {
+                    float error = Distance2(inBlock[i], palette[entry], 3);
+                    if (error < bestError)
+                    {
+                        bestError = error;
+                        best = entry;
+                    }
+                }
+                fit.Indices |= best << (i * 2);
+                fit.Error += bestError;
+            }
+            return fit;
+        }
+
+        // punch-through alpha is not used, BC1 is meant for opaque textures
+        void EncodeBC1(const Block &inBlock, TextureCompression::Quality inQuality, uint8_t *outBlock)
+        {
+            // fraction of the way from color 0 to color 1 of each index
+            static constexpr float weights[4] = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+
+            glm::vec4 start;
+            glm::vec4 end;
+            ChooseEndpoints(inBlock, 3, inQuality, start, end);
+            BC1Fit best = FitBC1(inBlock, start, end);
+            for (uint32_t iteration = 0; iteration < RefineIterations(inQuality); ++iteration)
+            {
+                float texelWeights[16];
+                for (uint32_t i = 0; i < 16; ++i)
+                    texelWeights[i] = weights[(best.Indices >> (i * 2)) & 3];
+                start = Unpack565(best.Color0);
+                end = Unpack565(best.Color1);
+                if (!RefineEndpoints(inBlock, texelWeights, start, end)) break;
+                BC1Fit fit = FitBC1(inBlock, start, end);
+                if (fit.Error >= best.Error) break;
+                best = fit;
+            }
+
+            std::memcpy(outBlock, &best.Color0, 2);
+            std::memcpy(outBlock + 2, &best.Color1, 2);
+            std::memcpy(outBlock + 4, &best.Indices, 4);
+        }
+
+        /// @brief The values the indices of a BC4 block pick from. The first endpoint being larger selects eight interpolated
+        /// values, otherwise six are interpolated and the last two indices are 0 and 255
+        void BC4Palette(uint32_t inValue0, uint32_t inValue1, uint32_t *outPalette)
+        {
+            outPalette[0] = inValue0;
+            outPalette[1] = inValue1;
+            if (inValue0 > inValue1)
+            {
+                for (uint32_t i = 1; i < 7; ++i)
+                    outPalette[i + 1] = ((7 - i) * inValue0 + i * inValue1) / 7;
+            }
+            else
+            {
+                for (uint32_t i = 1; i < 5; ++i)
+                    outPalette[i + 1] = ((5 - i) * inValue0 + i * inValue1) / 5;
+                outPalette[6] = 0;
+                outPalette[7] = 255;
+            }
+        }
+
+        uint32_t FitBC4(const uint32_t *inValues, uint32_t inValue0, uint32_t inValue1, uint64_t &outIndices)
+        {
+            uint32_t palette[8];
+            BC4Palette(inValue0, inValue1, palette);
+            uint32_t total = 0;
+            outIndices = 0;
+            for (uint32_t i = 0; i < 16; ++i)
+            {
+                uint32_t best = 0;
+                uint32_t bestError = UINT32_MAX;
+                for (uint32_t entry = 0; entry < 8; ++entry)
+                {
+                    int32_t d = static_cast<int32_t>(inValues[i]) - static_cast<int32_t>(palette[entry]);
+                    uint32_t error = static_cast<uint32_t>(d * d);
+                    if (error < bestError)
+                    {
+                        bestError = error;
+                        best = entry;
+                    }
+                }
+                outIndices |= static_cast<uint64_t>(best) << (i * 3);
+                total += bestError;
+            }
+            return total;
+        }
+
+        void EncodeBC4(const Block &inBlock, uint32_t inChannel, TextureCompression::Quality inQuality, uint8_t *outBlock)
+        {
+            uint32_t values[16];
+            uint32_t minimum = 255;
+            uint32_t maximum = 0;
+            // the extremes of the values that are not exactly 0 or 255, which the six value mode has for free
+            uint32_t innerMinimum = 255;
+            uint32_t innerMaximum = 0;
+            for (uint32_t i = 0; i < 16; ++i)
+            {
+                values[i] = static_cast<uint32_t>(inBlock[i][inChannel]);
+                minimum = std::min(minimum, values[i]);
+                maximum = std::max(maximum, values[i]);
+                if (values[i] != 0 && values[i] != 255)
+                {
+                    innerMinimum = std::min(innerMinimum, values[i]);
+                    innerMaximum = std::max(innerMaximum, values[i]);
+                }
+            }
+
+            uint32_t value0 = maximum;
+            uint32_t value1 = minimum;
+            uint64_t indices;
+            uint32_t error = FitBC4(values, value0, value1, indices);
+            auto tryEndpoints = [&](uint32_t inValue0, uint32_t inValue1)
+            {
+                uint64_t candidateIndices;
+                uint32_t candidateError = FitBC4(values, inValue0, inValue1, candidateIndices);
+                if (candidateError >= error) return;
+                error = candidateError;
+                value0 = inValue0;
+                value1 = inValue1;
+                indices = candidateIndices;
+            };
+
+            if (inQuality != TextureCompression::Quality::Fast && innerMinimum <= innerMaximum)
+                tryEndpoints(innerMinimum, innerMaximum);
+            if (inQuality == TextureCompression::Quality::High)
+            {
+                // the palette rarely wants its ends right on the extremes, a few steps inwards are tried
+                for (uint32_t d0 = 0; d0 < 4; ++d0)
+                    for (uint32_t d1 = 0; d1 < 4; ++d1)
+                        if (maximum >= minimum + d0 + d1 + 1) tryEndpoints(maximum - d0, minimum + d1);
+            }
+
+            outBlock[0] = static_cast<uint8_t>(value0);
+            outBlock[1] = static_cast<uint8_t>(value1);
+            for (uint32_t i = 0; i < 6; ++i)
+                outBlock[2 + i] = static_cast<uint8_t>(indices >> (i * 8));
+        }
+
+        struct BC7Fit
+        {
+            // endpoints with 7 bits per channel and the shared lowest bit of each
+            glm::u8vec4 Endpoint0;
+            glm::u8vec4 Endpoint1;
+            uint32_t PBit0;
+            uint32_t PBit1;
+            uint8_t Indices[16];
+            float Error = 0.0f;
+        };
+
+        glm::u8vec4 QuantizeBC7(const glm::vec4 &inEndpoint, uint32_t &outPBit)
+        {
+            glm::u8vec4 best;
+            float bestError = std::numeric_limits<float>::max();
+            for (uint32_t pBit = 0; pBit < 2; ++pBit)
+            {
+                glm::u8vec4 quantized;
+                float error = 0.0f;
+                for (uint32_t c = 0; c < 4; ++c)
+                {
+                    float value = std::clamp(std::round((inEndpoint[c] - static_cast<float>(pBit)) / 2.0f), 0.0f, 127.0f);
+                    quantized[c] = static_cast<uint8_t>(value);
+                    float d = static_cast<float>((quantized[c] << 1) | pBit) - inEndpoint[c];
+                    error += d * d;
+                }
+                if (error < bestError)
+                {
+                    bestError = error;
+                    best = quantized;
+                    outPBit = pBit;
+                }
+            }
+            return best;
+        }
+
+        glm::vec4 ExpandBC7(const glm::u8vec4 &inEndpoint, uint32_t inPBit)
+        {
+            return glm::vec4((glm::uvec4(inEndpoint) << 1u) | glm::uvec4(inPBit));
+        }
+
+        void BC7Palette(const glm::vec4 &inEndpoint0, const glm::vec4 &inEndpoint1, glm::vec4 *outPalette)
+        {
+            for (uint32_t i = 0; i < 16; ++i)
+                outPalette[i] = glm::floor(((64.0f - BC7Weights[i]) * inEndpoint0 + static_cast<float>(BC7Weights[i]) * inEndpoint1 + 32.0f) / 64.0f);
+        }
+
+        BC7Fit FitBC7(const Block &inBlock, const glm::vec4 &inStart, const glm::vec4 &inEnd)
+        {
+            BC7Fit fit;
+            fit.Endpoint0 = QuantizeBC7(inStart, fit.PBit0);
+            fit.Endpoint1 = QuantizeBC7(inEnd, fit.PBit1);
+            glm::vec4 palette[16];
+            BC7Palette(ExpandBC7(fit.Endpoint0, fit.PBit0), ExpandBC7(fit.Endpoint1, fit.PBit1), palette);
+            for (uint32_t i = 0; i < 16; ++i)
+            {
+                uint32_t best = 0;
+                float bestError = Distance2(inBlock[i], palette[0], 4);
+                for (uint32_t entry = 1; entry < 16; ++entry)
+                {
+                    float error = Distance2(inBlock[i], palette[entry], 4);
+                    if (error < bestError)
+                    {
+                        bestError = error;
+                        best = entry;
+                    }
+                }
+                fit.Indices[i] = static_cast<uint8_t>(best);
+                fit.Error += bestError;
+            }
+            return fit;
+        }
+
+        // mode 6: a single subset with RGBA endpoints and 4 bit indices, the best fit for most blocks of a texture with alpha
+        void EncodeBC7(const Block &inBlock, TextureCompression::Quality inQuality, uint8_t *outBlock)
+        {
+            glm::vec4 start;
+            glm::vec4 end;
+            ChooseEndpoints(inBlock, 4, inQuality, start, end);
+            BC7Fit best = FitBC7(inBlock, start, end);
+            for (uint32_t iteration = 0; iteration < RefineIterations(inQuality); ++iteration)
+            {
+                float texelWeights[16];
+                for (uint32_t i = 0; i < 16; ++i)
+                    texelWeights[i] = static_cast<float>(BC7Weights[best.Indices[i]]) / 64.0f;
+                start = ExpandBC7(best.Endpoint0, best.PBit0);
+                end = ExpandBC7(best.Endpoint1, best.PBit1);
+                if (!RefineEndpoints(inBlock, texelWeights, start, end)) break;
+                BC7Fit fit = FitBC7(inBlock, start, end);
+                if (fit.Error >= best.Error) break;
+                best = fit;
+            }
+
+            // the highest bit of the first index is implied zero, the endpoints are swapped to make it so
+            if (best.Indices[0] & 8)
+            {
+                std::swap(best.Endpoint0, best.Endpoint1);
+                std::swap(best.PBit0, best.PBit1);
+                for (auto &index : best.Indices)
+                    index = static_cast<uint8_t>(15 - index);
+            }
+
+            std::memset(outBlock, 0, 16);
+            BitWriter writer(outBlock);
+            writer.Write(1 << 6, 7);
+            for (uint32_t c = 0; c < 4; ++c)
+            {
+                writer.Write(best.Endpoint0[c], 7);
+                writer.Write(best.Endpoint1[c], 7);
+            }
+            writer.Write(best.PBit0, 1);
+            writer.Write(best.PBit1, 1);
+            writer.Write(best.Indices[0], 3);
+            for (uint32_t i = 1; i < 16; ++i)
+                writer.Write(best.Indices[i], 4);
+        }
+
+        void EncodeBlock(Texture2D::Format inFormat, TextureCompression::Quality inQuality, const Block &inBlock, uint8_t *outBlock)
+        {
+            switch (inFormat)
+            {
+            case Texture2D::Format::BC1: EncodeBC1(inBlock, inQuality, outBlock); break;
+            case Texture2D::Format::BC3:
+                EncodeBC4(inBlock, 3, inQuality, outBlock);
+                EncodeBC1(inBlock, inQuality, outBlock + 8);
+                break;
+            case Texture2D::Format::BC4: EncodeBC4(inBlock, 0, inQuality, outBlock); break;
+            case Texture2D::Format::BC5:
+                EncodeBC4(inBlock, 0, inQuality, outBlock);
+                EncodeBC4(inBlock, 1, inQuality, outBlock + 8);
+                break;
+            case Texture2D::Format::BC7: EncodeBC7(inBlock, inQuality, outBlock); break;
+            default: ZE_ASSERT_CORE_MSG(false, "Not a block compressed format!");
+            }
+        }
+
+        void DecodeBC1(const uint8_t *inBlock, bool inFourColors, glm::vec4 *outTexels)
+        {
+            uint16_t color0;
+            uint16_t color1;
+            uint32_t indices;
+            std::memcpy(&color0, inBlock, 2);
+            std::memcpy(&color1, inBlock + 2, 2);
+            std::memcpy(&indices, inBlock + 4, 4);
+            glm::vec4 palette[4];
+            BC1Palette(color0, color1, inFourColors, palette);
+            for (uint32_t i = 0; i < 16; ++i)
+            {
+                glm::vec4 color = palette[(indices >> (i * 2)) & 3];
+                outTexels[i] = glm::vec4(color.r, color.g, color.b, outTexels[i].a);
+                if (!inFourColors) outTexels[i].a = color.a;
+            }
+        }
+
+        void DecodeBC4(const uint8_t *inBlock, uint32_t inChannel, glm::vec4 *outTexels)
+        {
+            uint32_t palette[8];
+            BC4Palette(inBlock[0], inBlock[1], palette);
+            uint64_t indices = 0;
+            for (uint32_t i = 0; i < 6; ++i)
+                indices |= static_cast<uint64_t>(inBlock[2 + i]) << (i * 8);
+            for (uint32_t i = 0; i < 16; ++i)
+                outTexels[i][inChannel] = static_cast<float>(palette[(indices >> (i * 3)) & 7]);
+        }
+
+        void DecodeBC7(const uint8_t *inBlock, glm::vec4 *outTexels)
+        {
+            BitReader reader(inBlock);
+            // the mode is the number of zero bits before the first one
+            if (reader.Read(7) != (1 << 6))
+            {
+                static bool sWarned = false;
+                if (!sWarned) ZE_CORE_WARN("Only the single subset RGBA mode of BC7 is decoded");
+                sWarned = true;
+                for (uint32_t i = 0; i < 16; ++i)
+                    outTexels[i] = glm::vec4(255.0f, 0.0f, 255.0f, 255.0f);
+                return;
+            }
+            glm::u8vec4 endpoint0;
+            glm::u8vec4 endpoint1;
+            for (uint32_t c = 0; c < 4; ++c)
+            {
+                endpoint0[c] = static_cast<uint8_t>(reader.Read(7));
+                endpoint1[c] = static_cast<uint8_t>(reader.Read(7));
+            }
+            uint32_t pBit0 = reader.Read(1);
+            uint32_t pBit1 = reader.Read(1);
+            glm::vec4 palette[16];
+            BC7Palette(ExpandBC7(endpoint0, pBit0), ExpandBC7(endpoint1, pBit1), palette);
+            for (uint32_t i = 0; i < 16; ++i)
+                outTexels[i] = palette[reader.Read(i == 0 ? 3 : 4)];
+        }
+    }
+
+    std::vector<uint8_t> TextureCompression::Encode(Texture2D::Format inFormat, Quality inQuality, const uint8_t *inTexels, Texture2D::Format inTexelFormat, uint32_t inWidth, uint32_t inHeight)
+    {
+        ZE_ASSERT_CORE_MSG(inTexelFormat == Texture2D::Format::R8 || inTexelFormat == Texture2D::Format::RGB8 || inTexelFormat == Texture2D::Format::RGBA8, "Only 8 bit texels can be compressed!");
+        uint32_t channels = Texture2D::Texture2DFormatBytes(inTexelFormat);
+        uint32_t blocksX = (inWidth + BlockSize - 1) / BlockSize;
+        uint32_t blocksY = (inHeight + BlockSize - 1) / BlockSize;
+        uint32_t blockBytes = GetBlockBytes(inFormat);
+        std::vector<uint8_t> blocks(static_cast<size_t>(blocksX) * blocksY * blockBytes);
+
+        JobSystem::Get().ParallelFor(blocksY, BlockRowsPerJob, [&](uint32_t inBegin, uint32_t inEnd)
+        {
+            for (uint32_t blockY = inBegin; blockY < inEnd; ++blockY)
+            {
+                for (uint32_t blockX = 0; blockX < blocksX; ++blockX)
+                {
+                    Block block = LoadBlock(inTexels, channels, inWidth, inHeight, blockX, blockY);
+                    EncodeBlock(inFormat, inQuality, block, blocks.data() + (static_cast<size_t>(blockY) * blocksX + blockX) * blockBytes);
+                }
+            }
+        });
+        return blocks;
+    }
+
+    void TextureCompression::Decode(Texture2D::Format inFormat, const uint8_t *inBlocks, uint32_t inWidth, uint32_t inHeight, uint8_t *outTexels)
+    {
+        uint32_t blocksX = (inWidth + BlockSize - 1) / BlockSize;
+        uint32_t blocksY = (inHeight + BlockSize - 1) / BlockSize;
+        uint32_t blockBytes = GetBlockBytes(inFormat);
+        for (uint32_t blockY = 0; blockY < blocksY; ++blockY)
+        {
+            for (uint32_t blockX = 0; blockX < blocksX; ++blockX)
+            {
+                const uint8_t *source = inBlocks + (static_cast<size_t>(blockY) * blocksX + blockX) * blockBytes;
+                Block block;
+                block.fill(glm::vec4(0.0f, 0.0f, 0.0f, 255.0f));
+                switch (inFormat)
+                {
+                case Texture2D::Format::BC1: DecodeBC1(source, false, block.data()); break;
+                case Texture2D::Format::BC3:
+                    DecodeBC4(source, 3, block.data());
+                    DecodeBC1(source + 8, true, block.data());
+                    break;
+                case Texture2D::Format::BC4: DecodeBC4(source, 0, block.data()); break;
+                case Texture2D::Format::BC5:
+                    DecodeBC4(source, 0, block.data());
+                    DecodeBC4(source + 8, 1, block.data());
+                    break;
+                case Texture2D::Format::BC7: DecodeBC7(source, block.data()); break;
+                default: ZE_ASSERT_CORE_MSG(false, "Not a block compressed format!");
+                }
+
+                // the texels past the edge of the level are dropped
+                for (uint32_t y = 0; y < BlockSize && blockY * BlockSize + y < inHeight; ++y)
+                {
+                    for (uint32_t x = 0; x < BlockSize && blockX * BlockSize + x < inWidth; ++x)
+                    {
+                        uint8_t *texel = outTexels + ((static_cast<size_t>(blockY) * BlockSize + y) * inWidth + blockX * BlockSize + x) * 4;
+                        for (uint32_t c = 0; c < 4; ++c)
+                            texel[c] = static_cast<uint8_t>(block[y * BlockSize + x][c]);
+                    }
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+
+#include "Texture2D.h"
+
+namespace ZenEngine
+{
+    /// @brief CPU encoders and decoders of the block compressed texture formats.
+    /// A level is split in blocks of 4x4 texels, which are encoded in parallel on the job system.
+    /// BC7 is written in its single subset RGBA mode, which is also the only one the decoder reads
+    class TextureCompression
+    {
+    public:
+        static constexpr uint32_t BlockSize = 4;
+
+        enum class Quality
+        {
+            // endpoints from the bounding box of the block
+            Fast = 0,
+            // endpoints along the principal axis of the block, refined once
+            Normal,
+            // refined until the error stops going down, the alternative modes of the formats are tried too
+            High
+        };
+
+        /// @brief Encodes a level of R8, RGB8 or RGBA8 texels. Channels the texels do not have read as zero, alpha as opaque
+        static std::vector<uint8_t> Encode(Texture2D::Format inFormat, Quality inQuality, const uint8_t *inTexels, Texture2D::Format inTexelFormat, uint32_t inWidth, uint32_t inHeight);
+        /// @brief Expands a level to RGBA8 texels, for the backends that can not sample the format
+        static void Decode(Texture2D::Format inFormat, const uint8_t *inBlocks, uint32_t inWidth, uint32_t inHeight, uint8_t *outTexels);
+    };
+}
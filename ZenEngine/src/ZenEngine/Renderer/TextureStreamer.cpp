@@ -0,0 +1,107 @@
+#include "TextureStreamer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "Material.h"
+#include "ZenEngine/Asset/Texture2DAsset.h"
+
+namespace ZenEngine
+{
+    void TextureStreamer::Register(Texture2DAsset &inTexture)
+    {
+        Entry &entry = mEntries[&inTexture];
+        // a new asset may live where a deleted one did
+        entry = {};
+        entry.Lifetime = inTexture.GetLifetimeToken();
+        entry.WantedMip = inTexture.GetInitialMip();
+        entry.LastRequestFrame = mFrame;
+    }
+
+    void TextureStreamer::Request(Texture2DAsset &inTexture, float inScreenSize)
+    {
+        auto it = mEntries.find(&inTexture);
+        if (it == mEntries.end() || inTexture.GetMipCount() == 0) return;
+
+        uint32_t lastMip = inTexture.GetMipCount() - 1;
+        uint32_t size = std::max(inTexture.GetMipWidth(0), inTexture.GetMipHeight(0));
+        // the level whose size is the first one not smaller than the screen size
+        uint32_t mip = lastMip;
+        if (inScreenSize >= 1.0f)
+            mip = static_cast<uint32_t>(std::clamp(std::floor(std::log2(static_cast<float>(size) / inScreenSize)), 0.0f, static_cast<float>(lastMip)));
+        it->second.RequestedMip = std::min(it->second.RequestedMip, mip);
+        it->second.LastRequestFrame = mFrame;
+    }
+
+    void TextureStreamer::Request(const Material &inMaterial, float inScreenSize)
+    {
+        for (auto &[_, texture] : inMaterial.GetTextures())
+            if (texture.Asset != nullptr) Request(*texture.Asset, inScreenSize);
+    }
+
+    void TextureStreamer::Update()
+    {
+        ++mFrame;
+        mStatistics = {};
+        std::erase_if(mEntries, [](const auto &inEntry) { return inEntry.second.Lifetime.expired(); });
+
+        for (auto &[texture, entry] : mEntries)
+        {
+            if (entry.RequestedMip != UINT32_MAX)
+                entry.WantedMip = entry.RequestedMip;
+            else if (mFrame - entry.LastRequestFrame > RequestTimeout)
+                entry.WantedMip = texture->GetInitialMip();
+            entry.RequestedMip = UINT32_MAX;
+            mStatistics.WantedBytes += texture->GetMipChainBytes(entry.WantedMip);
+        }
+
+        auto getTarget = [](Texture2DAsset *inTexture, const Entry &inEntry, uint32_t inBias)
+        {
+            return std::min(inEntry.WantedMip + inBias, inTexture->GetMipCount() - 1);
+        };
+        uint32_t bias = 0;
+        for (uint64_t bytes = mStatistics.WantedBytes; bytes > mBudget && bias < 32;)
+        {
+            ++bias;
+            bytes = 0;
+            for (auto &[texture, entry] : mEntries)
+                bytes += texture->GetMipChainBytes(getTarget(texture, entry, bias));
+        }
+        mStatistics.MipBias = bias;
+
+        // dropping first frees memory before raising takes more of it
+        std::vector<std::pair<Texture2DAsset*, uint32_t>> drops;
+        std::vector<std::pair<Texture2DAsset*, uint32_t>> raises;
+        for (auto &[texture, entry] : mEntries)
+        {
+            mStatistics.ResidentBytes += texture->GetMipChainBytes(texture->GetResidentMip());
+            if (texture->IsStreaming())
+            {
+                ++mStatistics.Streaming;
+                continue;
+            }
+            uint32_t target = getTarget(texture, entry, bias);
+            if (target > texture->GetResidentMip()) drops.push_back({ texture, target });
+            else if (target < texture->GetResidentMip()) raises.push_back({ texture, target });
+        }
+        // the textures missing the most levels go first
+        std::sort(raises.begin(), raises.end(), [](const auto &inA, const auto &inB)
+        {
+            return inA.first->GetResidentMip() - inA.second > inB.first->GetResidentMip() - inB.second;
+        });
+
+        uint32_t changes = 0;
+        for (auto *list : { &drops, &raises })
+        {
+            for (auto &[texture, target] : *list)
+            {
+                if (changes == MaxChangesPerFrame) break;
+                texture->StreamMips(target);
+                ++changes;
+                ++mStatistics.Streaming;
+            }
+        }
+        mStatistics.Textures = static_cast<uint32_t>(mEntries.size());
+    }
+}
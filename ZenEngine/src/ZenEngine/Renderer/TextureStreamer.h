@@ -0,0 +1,77 @@
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+#include <stdint.h>
+
+namespace ZenEngine
+{
+    class Material;
+    class Texture2DAsset;
+
+    /// @brief Keeps textures at the detail they are seen at, within a GPU memory budget. Whatever draws a texture
+    /// reports how many pixels it covers on screen and the texture is given the level whose size matches that.
+    /// When the levels asked for do not fit the budget every texture gives up the same number of levels until they
+    /// do. Textures nobody asked for in a while go back to their initial levels
+    class TextureStreamer
+    {
+    public:
+        static constexpr uint64_t DefaultBudget = 256ull * 1024 * 1024;
+        // frames a texture keeps its detail after the last request for it
+        static constexpr uint64_t RequestTimeout = 120;
+        // each change uploads the whole chain of a texture on the loader, so only a few are started per frame
+        static constexpr uint32_t MaxChangesPerFrame = 4;
+
+        struct Entry
+        {
+            std::weak_ptr<const void> Lifetime;
+            // finest level asked for since the last update, or none
+            uint32_t RequestedMip = UINT32_MAX;
+            uint32_t WantedMip = 0;
+            uint64_t LastRequestFrame = 0;
+        };
+
+        struct Statistics
+        {
+            uint32_t Textures = 0;
+            uint32_t Streaming = 0;
+            uint64_t ResidentBytes = 0;
+            // bytes of the levels asked for, before the budget is applied
+            uint64_t WantedBytes = 0;
+            // levels every texture gives up to fit the budget
+            uint32_t MipBias = 0;
+        };
+
+        static TextureStreamer &Get()
+        {
+            static TextureStreamer instance;
+            return instance;
+        }
+
+        void SetBudget(uint64_t inBytes) { mBudget = inBytes; }
+        uint64_t GetBudget() const { return mBudget; }
+
+        /// @brief Called by the texture when it is first uploaded, it is forgotten once the asset is gone
+        void Register(Texture2DAsset &inTexture);
+
+        /// @brief Asks for enough detail to spread the whole texture over inScreenSize pixels
+        void Request(Texture2DAsset &inTexture, float inScreenSize);
+        void Request(const Material &inMaterial, float inScreenSize);
+
+        /// @brief Picks the levels for the frame and starts the uploads, called once per frame on the main thread
+        void Update();
+
+        const Statistics &GetStatistics() const { return mStatistics; }
+        /// @brief The entries of textures that were deleted since the last Update have an expired lifetime
+        const std::unordered_map<Texture2DAsset*, Entry> &GetEntries() const { return mEntries; }
+    private:
+        std::unordered_map<Texture2DAsset*, Entry> mEntries;
+        uint64_t mBudget = DefaultBudget;
+        uint64_t mFrame = 0;
+        Statistics mStatistics;
+
+        TextureStreamer() = default;
+        TextureStreamer(const TextureStreamer &) = delete;
+        TextureStreamer &operator =(const TextureStreamer &) = delete;
+    };
+}
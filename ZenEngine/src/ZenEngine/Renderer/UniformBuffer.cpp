@@ -5,6 +5,7 @@
 #include "ZenEngine/Core/Macros.h"
 
 #include "Platform/OpenGL/OpenGLUniformBuffer.h"
+#include "Platform/Software/SoftwareUniformBuffer.h"
 
 namespace ZenEngine
 {
@@ -14,6 +15,7 @@ namespace ZenEngine
         {
         case RendererAPI::API::None: ZE_ASSERT_CORE_MSG(false, "RendererAPI::None is not supported!"); return nullptr;
         case RendererAPI::API::OpenGL: return std::make_unique<OpenGLUniformBuffer>(inSize, inBinding);
+        case RendererAPI::API::Software: return std::make_unique<SoftwareUniformBuffer>(inSize, inBinding);
         }
         ZE_ASSERT_CORE_MSG(false, "Unknown Renderer API!");
         return nullptr;
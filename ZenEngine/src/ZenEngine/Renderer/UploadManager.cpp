@@ -0,0 +1,23 @@
+#include "UploadManager.h"
+
+#include "RendererAPI.h"
+
+#include "ZenEngine/Core/Macros.h"
+
+#include "Platform/OpenGL/OpenGLUploadManager.h"
+
+namespace ZenEngine
+{
+    std::unique_ptr<UploadManager> UploadManager::Create()
+    {
+        switch (RendererAPI::GetAPI())
+        {
+        case RendererAPI::API::None: ZE_ASSERT_CORE_MSG(false, "RendererAPI::None is not supported!"); return nullptr;
+        case RendererAPI::API::OpenGL: return std::make_unique<OpenGLUploadManager>();
+        // software buffers live in system memory
+        case RendererAPI::API::Software: return std::make_unique<UploadManager>();
+        }
+        ZE_ASSERT_CORE_MSG(false, "Unknown Renderer API!");
+        return nullptr;
+    }
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <memory>
+#include <stdint.h>
+
+namespace ZenEngine
+{
+    /// @brief Moves dynamic data from the CPU to the GPU. Buffer updates are staged and copied in order with the
+    /// draws around them, texture updates are queued and run in Flush, at most a frame budget worth of bytes per frame.
+    /// The base class is used by the backends that write their data directly and only keeps the budget
+    class UploadManager
+    {
+    public:
+        static constexpr uint64_t DefaultFrameBudget = 16 * 1024 * 1024;
+
+        struct Statistics
+        {
+            uint64_t Bytes = 0;
+            uint32_t Uploads = 0;
+            // waits for the GPU to release staging memory
+            uint32_t Stalls = 0;
+            // uploads that did not fit in the staging memory and were handed to the driver as they were
+            uint32_t Direct = 0;
+            // queued bytes that did not fit in the budget and were left for the next frames
+            uint64_t PendingBytes = 0;
+        };
+
+        virtual ~UploadManager() = default;
+
+        void SetFrameBudget(uint64_t inBytes) { mFrameBudget = inBytes; }
+        uint64_t GetFrameBudget() const { return mFrameBudget; }
+
+        /// @brief Runs the queued uploads that fit in what is left of the frame budget, before anything is drawn
+        virtual void Flush() {}
+        /// @brief Runs what is left of the budget and closes the frame, its staging memory is reused once the GPU is done with it
+        virtual void EndFrame() {}
+
+        /// @brief Returns the uploads of the last finished frame
+        const Statistics &GetStatistics() const { return mLastFrameStatistics; }
+
+        static std::unique_ptr<UploadManager> Create();
+    protected:
+        uint64_t mFrameBudget = DefaultFrameBudget;
+        Statistics mStatistics;
+        Statistics mLastFrameStatistics;
+    };
+}
@@ -5,6 +5,7 @@
 
 #include "RendererAPI.h"
 #include "Platform/OpenGL/OpenGLVertexArray.h"
+#include "Platform/Software/SoftwareVertexArray.h"
 
 namespace ZenEngine
 {
@@ -14,6 +15,7 @@ namespace ZenEngine
         {
         case RendererAPI::API::None:    ZE_ASSERT_CORE_MSG(false, "RendererAPI::None is currently not supported!"); return nullptr;
         case RendererAPI::API::OpenGL:  return std::make_shared<OpenGLVertexArray>();
+        case RendererAPI::API::Software: return std::make_shared<SoftwareVertexArray>();
         }
 
         ZE_ASSERT_CORE_MSG(false, "Unknown RendererAPI!");
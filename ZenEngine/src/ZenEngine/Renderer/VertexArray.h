@@ -8,16 +8,33 @@ namespace ZenEngine
     class VertexArray
     {
     public:
+        /// @brief Which of the vertex buffers a draw reads
+        enum class Streams
+        {
+            All = 0,
+            // the position buffer and the per instance buffers, for the passes that only write depth
+            Position
+        };
+
         virtual ~VertexArray() = default;
 
         virtual void Bind() const = 0;
+        virtual void Bind(Streams inStreams) const = 0;
         virtual void Unbind() const = 0;
 
         virtual void AddVertexBuffer(const std::shared_ptr<class VertexBuffer>& inVertexBuffer) = 0;
+        /// @brief Adds a buffer holding only the positions, tightly packed, before any other buffer.
+        /// Depth only draws fetch from it alone instead of striding over the whole vertex
+        virtual void AddPositionBuffer(const std::shared_ptr<class VertexBuffer>& inVertexBuffer) = 0;
         virtual void SetIndexBuffer(const std::shared_ptr<class IndexBuffer>& inIndexBuffer) = 0;
 
         virtual const std::vector<std::shared_ptr<class VertexBuffer>>& GetVertexBuffers() const = 0;
         virtual const std::shared_ptr<class IndexBuffer>& GetIndexBuffer() const = 0;
+        // null when the positions are interleaved with the other attributes
+        virtual const std::shared_ptr<class VertexBuffer>& GetPositionBuffer() const = 0;
+
+        // identifies the combined layout of all the vertex buffers
+        virtual uint64_t GetLayoutHash() const = 0;
 
         static std::shared_ptr<VertexArray> Create();
     };
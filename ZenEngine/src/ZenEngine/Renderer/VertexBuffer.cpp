@@ -5,6 +5,7 @@
 #include "Renderer.h"
 #include "ZenEngine/Core/Macros.h"
 #include "Platform/OpenGL/OpenGLVertexBuffer.h"
+#include "Platform/Software/SoftwareVertexBuffer.h"
 
 namespace ZenEngine
 {
@@ -14,6 +15,7 @@ namespace ZenEngine
         {
         case RendererAPI::API::None:    ZE_ASSERT_CORE_MSG(false, "RendererAPI::None is currently not supported!"); return nullptr;
         case RendererAPI::API::OpenGL:  return std::make_shared<OpenGLVertexBuffer>(inSize);
+        case RendererAPI::API::Software: return std::make_shared<SoftwareVertexBuffer>(inSize);
         }
 
         ZE_ASSERT_CORE_MSG(false, "Unknown RendererAPI!");
@@ -26,6 +28,7 @@ namespace ZenEngine
         {
         case RendererAPI::API::None:    ZE_ASSERT_CORE_MSG(false, "RendererAPI::None is currently not supported!"); return nullptr;
         case RendererAPI::API::OpenGL:  return std::make_shared<OpenGLVertexBuffer>(inVertices, inSize);
+        case RendererAPI::API::Software: return std::make_shared<SoftwareVertexBuffer>(inVertices, inSize);
         }
 
         ZE_ASSERT_CORE_MSG(false, "Unknown RendererAPI!");
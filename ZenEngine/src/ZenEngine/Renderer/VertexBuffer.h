@@ -1,6 +1,7 @@
 #pragma once
 
 #include "ZenEngine/Core/Macros.h"
+#include "ZenEngine/Core/Hash.h"
 
 namespace ZenEngine
 {
@@ -82,6 +83,18 @@ namespace ZenEngine
         uint32_t GetStride() const { return mStride; }
         const std::vector<BufferElement>& GetElements() const { return mElements; }
 
+        uint64_t GetHash() const
+        {
+            uint64_t hash = mStride;
+            for (const auto &element : mElements)
+            {
+                Hash::Combine(hash, static_cast<uint32_t>(element.Type));
+                Hash::Combine(hash, element.Offset);
+                Hash::Combine(hash, element.Normalized);
+            }
+            return hash;
+        }
+
         std::vector<BufferElement>::iterator begin() { return mElements.begin(); }
         std::vector<BufferElement>::iterator end() { return mElements.end(); }
         std::vector<BufferElement>::const_iterator begin() const { return mElements.begin(); }
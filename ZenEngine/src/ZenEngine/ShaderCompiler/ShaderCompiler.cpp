@@ -135,7 +135,7 @@ namespace ZenEngine
         return result;
     }
 
-    ShaderCompiler::CompilationResult ShaderCompiler::Compile(const std::string &inSource)
+    ShaderCompiler::CompilationResult ShaderCompiler::Compile(const std::string &inSource, Target inTarget)
     {
         CreateFolderStructure();
         CompilationResult result;
@@ -156,6 +156,11 @@ namespace ZenEngine
         }
         
         CacheVulkanBinary(vulkanSPIRV);
+        if (inTarget == Target::Vulkan)
+        {
+            result.SPIRV = std::move(vulkanSPIRV);
+            return result;
+        }
 
         auto glslSource = CompileVulkanSPIRVToGLSL(std::move(vulkanSPIRV));
 
@@ -26,10 +26,12 @@ namespace ZenEngine
         {
             ShaderReflector::ReflectionResult VertexReflectionInfo;
             ShaderReflector::ReflectionResult PixelReflectionInfo;
+            // binary for the requested target
             ShaderSPIRV SPIRV;
         };
 
         enum class ShaderStage { Vertex, Pixel };
+        enum class Target { OpenGL, Vulkan };
 
         ShaderCompiler(const std::string &inName) : mName(inName) {}
 
@@ -37,7 +39,7 @@ namespace ZenEngine
         GLSLShaderSource CompileVulkanSPIRVToGLSL(ShaderSPIRV inVulkanSPIRV);
         ShaderSPIRV CompileGLSLToOpenGLSPIRV(const GLSLShaderSource &inGLSLSource);
 
-        CompilationResult Compile(const std::string &inSource);
+        CompilationResult Compile(const std::string &inSource, Target inTarget = Target::OpenGL);
     private:   
         std::string mName;
 
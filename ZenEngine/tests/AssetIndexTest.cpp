@@ -0,0 +1,159 @@
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "Check.h"
+#include "ZenEngine/Core/JobSystem.h"
+#include "ZenEngine/Asset/AssetIndex.h"
+#include "ZenEngine/Asset/AssetLoader.h"
+
+using namespace ZenEngine;
+
+// takes the .test files, which hold nothing but the id of their asset, and counts how often a header is read
+class TestLoader : public AssetLoader
+{
+public:
+    TestLoader() { sAllLoaders.push_back(this); }
+    ~TestLoader() { std::erase(sAllLoaders, this); }
+
+    virtual const char *GetName() const override { return "TestLoader"; }
+    virtual bool Save(const std::shared_ptr<Asset> &inAssetInstance, const std::filesystem::path &inFilepath) const override { return false; }
+    virtual std::shared_ptr<Asset> Load(const std::filesystem::path &inFilepath) const override { return nullptr; }
+    virtual std::shared_ptr<Asset> LoadPacked(const PackedAsset &inPacked) const override { return nullptr; }
+    virtual bool CanLoad(const std::filesystem::path &inFilepath) const override { return inFilepath.extension() == ".test"; }
+
+    virtual std::pair<UUID, const char*> GetAssetIdAssetClass(const std::filesystem::path &inFilepath) const override
+    {
+        ++mHeaderReads;
+        std::ifstream ifs(inFilepath);
+        uint64_t id = 0;
+        ifs >> id;
+        return { id, "TestAsset" };
+    }
+
+    /// @brief Headers read since the last call
+    uint32_t TakeHeaderReads() { return mHeaderReads.exchange(0); }
+private:
+    mutable std::atomic<uint32_t> mHeaderReads = 0;
+};
+
+static void WriteAsset(const std::filesystem::path &inFilepath, const std::string &inContent)
+{
+    std::ofstream ofs(inFilepath);
+    ofs << inContent;
+}
+
+// timestamps can be coarse, a change made within the same tick as the scan is pushed past it
+static void Touch(const std::filesystem::path &inPath, int inSeconds)
+{
+    std::filesystem::last_write_time(inPath, std::filesystem::last_write_time(inPath) + std::chrono::seconds(inSeconds));
+}
+
+static uint64_t GetId(const AssetIndex &inIndex, const std::filesystem::path &inFilepath)
+{
+    auto it = inIndex.GetFiles().find(inFilepath.generic_string());
+    return it != inIndex.GetFiles().end() ? static_cast<uint64_t>(it->second.Id) : 0;
+}
+
+int main()
+{
+    Log::Init();
+    JobSystem::Get().Init(2);
+    TestLoader loader;
+
+    std::filesystem::path directory = std::filesystem::temp_directory_path() / "ZenEngineAssetIndexTest";
+    std::filesystem::remove_all(directory);
+    std::filesystem::path root = directory / "Assets";
+    std::filesystem::path sub = root / "Meshes";
+    std::filesystem::create_directories(sub);
+    std::filesystem::path indexPath = directory / "AssetIndex.bin";
+
+    std::filesystem::path a = root / "a.test";
+    std::filesystem::path b = sub / "b.test";
+    std::filesystem::path c = sub / "c.test";
+    WriteAsset(a, "1");
+    WriteAsset(b, "2");
+    WriteAsset(root / "readme.txt", "no loader takes this");
+
+    {
+        // the first time everything is scanned
+        AssetIndex index;
+        ZE_CHECK(!index.Load(indexPath));
+        index.Update(root);
+        uint32_t reads = loader.TakeHeaderReads();
+        ZE_CHECK_MSG(reads == 2, "{} headers read on the first scan", reads);
+        ZE_CHECK(index.GetFiles().size() == 2);
+        ZE_CHECK(GetId(index, a) == 1 && GetId(index, b) == 2);
+        ZE_CHECK(index.GetFiles().at(a.generic_string()).ClassName == "TestAsset");
+        ZE_CHECK(index.Save(indexPath));
+    }
+
+    {
+        // nothing changed, the saved index is used as it is
+        AssetIndex index;
+        ZE_CHECK(index.Load(indexPath));
+        ZE_CHECK(index.GetFiles().size() == 2);
+        index.Update(root);
+        uint32_t reads = loader.TakeHeaderReads();
+        ZE_CHECK_MSG(reads == 0, "{} headers read with nothing changed", reads);
+        ZE_CHECK(GetId(index, a) == 1 && GetId(index, b) == 2);
+        ZE_CHECK(index.Save(indexPath));
+    }
+
+    {
+        // a file written in a directory that is otherwise unchanged is scanned again, one of the same size too
+        WriteAsset(b, "22");
+        Touch(b, 10);
+        WriteAsset(a, "3");
+        Touch(a, 10);
+        AssetIndex index;
+        ZE_CHECK(index.Load(indexPath));
+        index.Update(root);
+        uint32_t reads = loader.TakeHeaderReads();
+        ZE_CHECK_MSG(reads == 2, "{} headers read with two files changed", reads);
+        ZE_CHECK(GetId(index, a) == 3 && GetId(index, b) == 22);
+        ZE_CHECK(index.Save(indexPath));
+    }
+
+    {
+        // a new file is found, only it is scanned
+        WriteAsset(c, "4");
+        Touch(sub, 20);
+        AssetIndex index;
+        ZE_CHECK(index.Load(indexPath));
+        index.Update(root);
+        uint32_t reads = loader.TakeHeaderReads();
+        ZE_CHECK_MSG(reads == 1, "{} headers read with one file added", reads);
+        ZE_CHECK(index.GetFiles().size() == 3 && GetId(index, c) == 4);
+        ZE_CHECK(index.Save(indexPath));
+    }
+
+    {
+        // a removed file is dropped without scanning the others
+        std::filesystem::remove(a);
+        Touch(root, 30);
+        AssetIndex index;
+        ZE_CHECK(index.Load(indexPath));
+        index.Update(root);
+        uint32_t reads = loader.TakeHeaderReads();
+        ZE_CHECK_MSG(reads == 0, "{} headers read with one file removed", reads);
+        ZE_CHECK(index.GetFiles().size() == 2 && GetId(index, a) == 0);
+        ZE_CHECK(GetId(index, b) == 22 && GetId(index, c) == 4);
+    }
+
+    {
+        // an index that can not be read is as good as none
+        WriteAsset(indexPath, "not an index");
+        AssetIndex index;
+        ZE_CHECK(!index.Load(indexPath));
+        ZE_CHECK(index.GetFiles().empty());
+    }
+
+    JobSystem::Get().Shutdown();
+    std::error_code error;
+    std::filesystem::remove_all(directory, error);
+    return Test::Finish();
+}
@@ -0,0 +1,141 @@
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "Check.h"
+#include "ZenEngine/Asset/BlobLoader.h"
+
+using namespace ZenEngine;
+
+static std::vector<uint8_t> ReadBytes(const std::filesystem::path &inFilepath)
+{
+    std::ifstream ifs(inFilepath, std::ios::binary);
+    return std::vector<uint8_t>(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+}
+
+static void WriteBytes(const std::filesystem::path &inFilepath, const std::vector<uint8_t> &inData)
+{
+    std::ofstream ofs(inFilepath, std::ios::binary);
+    ofs.write(reinterpret_cast<const char*>(inData.data()), inData.size());
+}
+
+static void CheckBlobs(const BlobFile &inFile, const std::vector<std::vector<uint8_t>> &inBlobs, uintptr_t inStart, const char *inName)
+{
+    ZE_CHECK_MSG(inFile.GetBlobCount() == inBlobs.size(), "{}: {} blobs", inName, inFile.GetBlobCount());
+    if (inFile.GetBlobCount() != inBlobs.size()) return;
+    for (uint32_t i = 0; i < inFile.GetBlobCount(); ++i)
+    {
+        auto blob = inFile.GetBlob(i);
+        ZE_CHECK_MSG(std::vector<uint8_t>(blob.begin(), blob.end()) == inBlobs[i], "{}: blob {} reads back other bytes", inName, i);
+        // used in place, e.g. uploaded straight from the mapped file. A mapping starts on a page
+        ZE_CHECK_MSG((reinterpret_cast<uintptr_t>(blob.data()) - inStart) % BlobFile::Alignment == 0, "{}: blob {} is not aligned", inName, i);
+    }
+}
+
+int main()
+{
+    Log::Init();
+
+    std::filesystem::path directory = std::filesystem::temp_directory_path() / "ZenEngineBlobFileTest";
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+
+    std::vector<float> positions(1000);
+    for (size_t i = 0; i < positions.size(); ++i)
+        positions[i] = static_cast<float>(i) * 0.25f;
+    std::vector<uint32_t> indices = { 0, 1, 2 };
+    std::string metadata = "cereal";
+
+    BlobWriter writer;
+    writer.Add(metadata.data(), metadata.size());
+    writer.Add(positions);
+    writer.Add(std::vector<uint8_t>());
+    writer.Add(indices);
+    writer.Add(std::vector<uint8_t>{ 0xff });
+
+    std::vector<std::vector<uint8_t>> expected;
+    expected.emplace_back(metadata.begin(), metadata.end());
+    expected.emplace_back(reinterpret_cast<const uint8_t*>(positions.data()), reinterpret_cast<const uint8_t*>(positions.data() + positions.size()));
+    expected.emplace_back();
+    expected.emplace_back(reinterpret_cast<const uint8_t*>(indices.data()), reinterpret_cast<const uint8_t*>(indices.data() + indices.size()));
+    expected.push_back({ 0xff });
+
+    // the longest class name there is room for
+    std::string className(BlobFile::MaxClassNameLength, 'x');
+    className.replace(0, 11, "ZenEngine::");
+    std::filesystem::path filepath = directory / "asset.zasset";
+    ZE_CHECK(writer.Write(filepath, UUID(0x0123456789abcdefull), className.c_str()));
+
+    {
+        auto header = BlobFile::ReadHeader(filepath);
+        ZE_CHECK(header.has_value());
+        if (header.has_value())
+        {
+            ZE_CHECK(header->Id == 0x0123456789abcdefull);
+            ZE_CHECK(className == header->ClassName);
+            ZE_CHECK(header->BlobCount == expected.size());
+        }
+    }
+
+    {
+        BlobFile file;
+        bool opened = file.Open(filepath);
+        ZE_CHECK(opened);
+        if (opened)
+        {
+            ZE_CHECK(static_cast<uint64_t>(file.GetId()) == 0x0123456789abcdefull);
+            ZE_CHECK(className == file.GetClassName());
+            CheckBlobs(file, expected, 0, "mapped");
+            auto floats = file.GetBlobAs<float>(1);
+            ZE_CHECK(floats.size() == positions.size() && floats[999] == positions[999]);
+            // bytes past the last whole element are left out
+            ZE_CHECK(file.GetBlobAs<uint32_t>(0).size() == metadata.size() / sizeof(uint32_t));
+        }
+    }
+
+    // the same bytes read from memory, as from a pak
+    std::vector<uint8_t> original = ReadBytes(filepath);
+    {
+        auto bytes = std::make_shared<std::vector<uint8_t>>(original);
+        ZE_CHECK(BlobFile::IsBlobFile(*bytes));
+        BlobFile file;
+        bool opened = file.Open(*bytes, bytes);
+        ZE_CHECK(opened);
+        if (opened) CheckBlobs(file, expected, reinterpret_cast<uintptr_t>(bytes->data()), "in memory");
+    }
+
+    // each change breaks the file in a way Open must notice, rather than read past its end
+    auto headerAt = [](std::vector<uint8_t> &ioFile) { return reinterpret_cast<BlobFile::Header*>(ioFile.data()); };
+    auto blobAt = [](std::vector<uint8_t> &ioFile, uint32_t inIndex) { return reinterpret_cast<BlobFile::BlobEntry*>(ioFile.data() + sizeof(BlobFile::Header)) + inIndex; };
+    const std::pair<const char*, std::function<void(std::vector<uint8_t>&)>> corruptions[] = {
+        { "magic", [&](auto &ioFile) { headerAt(ioFile)->Magic ^= 1; } },
+        { "version", [&](auto &ioFile) { headerAt(ioFile)->Version = BlobFile::Version + 1; } },
+        { "class name without a zero", [&](auto &ioFile) { headerAt(ioFile)->ClassName[BlobFile::MaxClassNameLength] = 'x'; } },
+        { "no blobs", [&](auto &ioFile) { headerAt(ioFile)->BlobCount = 0; } },
+        { "table past the end", [&](auto &ioFile) { headerAt(ioFile)->BlobCount = 1u << 28; } },
+        { "unaligned blob", [&](auto &ioFile) { blobAt(ioFile, 1)->Offset += 4; } },
+        { "blob over the table", [&](auto &ioFile) { blobAt(ioFile, 0)->Offset = 0; } },
+        { "blob past the end", [&](auto &ioFile) { blobAt(ioFile, 3)->Offset = ioFile.size() + BlobFile::Alignment; } },
+        { "blob too long", [&](auto &ioFile) { blobAt(ioFile, 4)->Size = ioFile.size(); } },
+        { "cut short", [&](auto &ioFile) { ioFile.resize(ioFile.size() - 1); } },
+        { "shorter than the header", [&](auto &ioFile) { ioFile.resize(sizeof(BlobFile::Header) - 1); } },
+    };
+    std::filesystem::path corruptedPath = directory / "corrupted.zasset";
+    for (const auto &[name, corrupt] : corruptions)
+    {
+        std::vector<uint8_t> bytes = original;
+        corrupt(bytes);
+        BlobFile file;
+        ZE_CHECK_MSG(!file.Open(bytes, nullptr), "a blob file with {} opens from memory", name);
+        WriteBytes(corruptedPath, bytes);
+        BlobFile mapped;
+        ZE_CHECK_MSG(!mapped.Open(corruptedPath), "a blob file with {} opens", name);
+    }
+
+    std::error_code error;
+    std::filesystem::remove_all(directory, error);
+    return Test::Finish();
+}
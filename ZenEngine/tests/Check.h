@@ -0,0 +1,25 @@
+#pragma once
+
+#include "ZenEngine/Core/Log.h"
+
+// the tests are plain executables run by CTest, a failed check is printed and the test returns non zero at the end
+namespace ZenEngine::Test
+{
+    inline int sFailures = 0;
+
+    inline int Finish()
+    {
+        if (sFailures > 0) fmt::print(stderr, "{} checks failed\n", sFailures);
+        return sFailures == 0 ? 0 : 1;
+    }
+}
+
+#define ZE_CHECK(condition) ZE_CHECK_MSG(condition, "")
+#define ZE_CHECK_MSG(condition, ...) \
+    do { \
+        if (!(condition)) \
+        { \
+            fmt::print(stderr, "{}:{}: check failed: {} {}\n", __FILE__, __LINE__, #condition, fmt::format(__VA_ARGS__)); \
+            ++::ZenEngine::Test::sFailures; \
+        } \
+    } while (false)
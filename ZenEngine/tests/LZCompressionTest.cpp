@@ -0,0 +1,130 @@
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Check.h"
+#include "ZenEngine/Core/LZCompression.h"
+
+using namespace ZenEngine;
+
+static std::vector<uint8_t> MakeRandom(size_t inSize, uint32_t inSeed)
+{
+    std::mt19937 random(inSeed);
+    std::vector<uint8_t> data(inSize);
+    for (auto &byte : data)
+        byte = static_cast<uint8_t>(random() & 0xff);
+    return data;
+}
+
+// returns the compressed size
+static size_t CheckRoundTrip(const std::vector<uint8_t> &inData, const char *inName)
+{
+    std::vector<uint8_t> block = LZCompression::Compress(inData);
+    std::vector<uint8_t> decoded(inData.size());
+    ZE_CHECK_MSG(LZCompression::Decompress(block, decoded), "{}: the block does not decode", inName);
+    ZE_CHECK_MSG(decoded == inData, "{}: the block decodes to other bytes", inName);
+
+    // the size is part of the format, one byte more or less is an error rather than a short or padded result
+    std::vector<uint8_t> longer(inData.size() + 1);
+    ZE_CHECK_MSG(!LZCompression::Decompress(block, longer), "{}: the block decodes into one byte more", inName);
+    if (!inData.empty())
+    {
+        std::vector<uint8_t> shorter(inData.size() - 1);
+        ZE_CHECK_MSG(!LZCompression::Decompress(block, shorter), "{}: the block decodes into one byte less", inName);
+    }
+    return block.size();
+}
+
+int main()
+{
+    Log::Init();
+
+    CheckRoundTrip({}, "empty");
+    CheckRoundTrip({ 42 }, "one byte");
+    CheckRoundTrip({ 1, 2, 3, 1, 2, 3, 1, 2, 3 }, "shorter than a match and the last literals");
+
+    {
+        // a copy from one byte back repeats it, a long match takes many extra count bytes
+        std::vector<uint8_t> zeros(1 << 20, 0);
+        size_t size = CheckRoundTrip(zeros, "zeros");
+        ZE_CHECK_MSG(size < zeros.size() / 200, "a megabyte of zeros compresses to {} bytes", size);
+    }
+
+    {
+        // overlapping copies with every short period
+        for (uint32_t period = 1; period <= 9; ++period)
+        {
+            std::vector<uint8_t> pattern = MakeRandom(period, period);
+            std::vector<uint8_t> data;
+            for (uint32_t i = 0; i < 5000; ++i)
+                data.push_back(pattern[i % period]);
+            std::string name = "period " + std::to_string(period);
+            size_t size = CheckRoundTrip(data, name.c_str());
+            ZE_CHECK_MSG(size < data.size() / 20, "{} compresses to {} bytes", name, size);
+        }
+    }
+
+    {
+        // nothing to find, the literal counts take extra bytes and the block is a little larger than the data
+        std::vector<uint8_t> noise = MakeRandom(100000, 1);
+        size_t size = CheckRoundTrip(noise, "noise");
+        ZE_CHECK_MSG(size <= noise.size() + noise.size() / 255 + 16, "noise grows to {} bytes", size);
+    }
+
+    {
+        // text like data, literals and matches of all lengths mixed
+        const char *words[] = { "zen", "engine", "asset", "texture", "mesh", "pak", "block", "the", "a", "of" };
+        std::mt19937 random(2);
+        std::vector<uint8_t> text;
+        while (text.size() < 200000)
+        {
+            const char *word = words[random() % 10];
+            text.insert(text.end(), word, word + std::char_traits<char>::length(word));
+            text.push_back(random() % 8 == 0 ? '\n' : ' ');
+            if (random() % 16 == 0) text.push_back(static_cast<uint8_t>('0' + random() % 10));
+        }
+        size_t size = CheckRoundTrip(text, "text");
+        ZE_CHECK_MSG(size < text.size() / 2, "text compresses to {} bytes", size);
+    }
+
+    {
+        // repeats right at the largest distance and just past it
+        for (size_t distance : { size_t(LZCompression::MaxDistance), size_t(LZCompression::MaxDistance) + 1 })
+        {
+            std::vector<uint8_t> data = MakeRandom(distance, 3);
+            data.insert(data.end(), data.begin(), data.begin() + 3000);
+            CheckRoundTrip(data, "far repeat");
+        }
+    }
+
+    {
+        // a cut off block never decodes, whatever is left of it
+        std::vector<uint8_t> data = MakeRandom(300, 4);
+        data.insert(data.end(), data.begin(), data.begin() + 300);
+        data.insert(data.end(), 400, 7);
+        std::vector<uint8_t> block = LZCompression::Compress(data);
+        std::vector<uint8_t> decoded(data.size());
+        uint32_t decodedPrefixes = 0;
+        for (size_t size = 0; size < block.size(); ++size)
+            decodedPrefixes += LZCompression::Decompress(std::span<const uint8_t>(block.data(), size), decoded);
+        ZE_CHECK_MSG(decodedPrefixes == 0, "{} cut off blocks decode", decodedPrefixes);
+
+        // a copy from before the start of the data is refused, here the distance of the first match
+        std::vector<uint8_t> bad = { 0x00, 0x10, 0x00 };
+        ZE_CHECK(!LZCompression::Decompress(bad, decoded));
+        std::vector<uint8_t> zeroDistance = { 0x10, 0x55, 0x00, 0x00 };
+        std::vector<uint8_t> five(5);
+        ZE_CHECK(!LZCompression::Decompress(zeroDistance, five));
+
+        // flipped bits either decode to something of the right size or are refused, never read or write out of bounds
+        std::mt19937 random(6);
+        for (uint32_t i = 0; i < 2000; ++i)
+        {
+            std::vector<uint8_t> corrupted = block;
+            corrupted[random() % corrupted.size()] ^= static_cast<uint8_t>(1u << (random() % 8));
+            LZCompression::Decompress(corrupted, decoded);
+        }
+    }
+
+    return Test::Finish();
+}
@@ -0,0 +1,224 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <random>
+#include <unordered_set>
+#include <vector>
+
+#include "Check.h"
+#include "ZenEngine/Asset/StaticMesh.h"
+
+using namespace ZenEngine;
+
+using Triangle = std::array<uint32_t, 3>;
+
+static std::vector<Triangle> GetTriangles(std::span<const uint32_t> inIndices)
+{
+    std::vector<Triangle> triangles;
+    for (size_t i = 0; i + 2 < inIndices.size(); i += 3)
+        triangles.push_back({ inIndices[i], inIndices[i + 1], inIndices[i + 2] });
+    std::sort(triangles.begin(), triangles.end());
+    return triangles;
+}
+
+static void SetMesh(StaticMesh &ioMesh, const std::vector<glm::vec3> &inPositions, const std::vector<uint32_t> &inIndices)
+{
+    std::vector<Vertex> vertices;
+    for (const auto &position : inPositions)
+        vertices.push_back({ position, glm::vec3(0.0f), glm::vec2(0.0f) });
+    ioMesh.SetVertices(vertices);
+    ioMesh.SetIndices(inIndices);
+}
+
+// a sphere around the origin, the triangles face outwards
+static void MakeSphere(StaticMesh &ioMesh, uint32_t inRings, uint32_t inSegments)
+{
+    std::vector<glm::vec3> positions{ { 0.0f, 1.0f, 0.0f }, { 0.0f, -1.0f, 0.0f } };
+    for (uint32_t r = 1; r < inRings; ++r)
+    {
+        float theta = 3.14159265f * static_cast<float>(r) / static_cast<float>(inRings);
+        for (uint32_t s = 0; s < inSegments; ++s)
+        {
+            float phi = 6.2831853f * static_cast<float>(s) / static_cast<float>(inSegments);
+            positions.push_back({ std::sin(theta) * std::cos(phi), std::cos(theta), -std::sin(theta) * std::sin(phi) });
+        }
+    }
+    auto ring = [&](uint32_t inRing, uint32_t inSegment) { return 2 + (inRing - 1) * inSegments + inSegment % inSegments; };
+
+    std::vector<uint32_t> indices;
+    for (uint32_t s = 0; s < inSegments; ++s)
+    {
+        indices.insert(indices.end(), { 0, ring(1, s), ring(1, s + 1) });
+        indices.insert(indices.end(), { 1, ring(inRings - 1, s + 1), ring(inRings - 1, s) });
+        for (uint32_t r = 1; r + 1 < inRings; ++r)
+        {
+            indices.insert(indices.end(), { ring(r, s), ring(r + 1, s), ring(r + 1, s + 1) });
+            indices.insert(indices.end(), { ring(r, s), ring(r + 1, s + 1), ring(r, s + 1) });
+        }
+    }
+    SetMesh(ioMesh, positions, indices);
+}
+
+// a grid in the xz plane facing up
+static void MakePlane(StaticMesh &ioMesh, uint32_t inSize)
+{
+    std::vector<glm::vec3> positions;
+    for (uint32_t z = 0; z <= inSize; ++z)
+        for (uint32_t x = 0; x <= inSize; ++x)
+            positions.push_back({ static_cast<float>(x), 0.0f, -static_cast<float>(z) });
+
+    std::vector<uint32_t> indices;
+    for (uint32_t z = 0; z < inSize; ++z)
+    {
+        for (uint32_t x = 0; x < inSize; ++x)
+        {
+            uint32_t corner = z * (inSize + 1) + x;
+            indices.insert(indices.end(), { corner, corner + 1, corner + inSize + 2 });
+            indices.insert(indices.end(), { corner, corner + inSize + 2, corner + inSize + 1 });
+        }
+    }
+    SetMesh(ioMesh, positions, indices);
+}
+
+// triangles that share no vertices, every one of them brings three new ones
+static void MakeSoup(StaticMesh &ioMesh, uint32_t inTriangleCount)
+{
+    std::mt19937 random(7);
+    auto coordinate = [&]() { return static_cast<float>(random() % 2000) / 100.0f - 10.0f; };
+
+    std::vector<glm::vec3> positions;
+    std::vector<uint32_t> indices;
+    for (uint32_t i = 0; i < inTriangleCount * 3; ++i)
+    {
+        positions.push_back({ coordinate(), coordinate(), coordinate() });
+        indices.push_back(i);
+    }
+    SetMesh(ioMesh, positions, indices);
+}
+
+// the meshlets are consecutive ranges covering the reordered indices, within the limits and their bounds
+static void CheckPartition(StaticMesh &ioMesh, const char *inName)
+{
+    std::vector<Triangle> original = GetTriangles(ioMesh.GetIndices());
+    const auto &meshlets = ioMesh.GetMeshlets();
+    auto indices = ioMesh.GetIndices();
+    const auto &vertices = ioMesh.GetVertices();
+
+    ZE_CHECK_MSG(GetTriangles(indices) == original, "{}: the meshlets do not hold the same triangles", inName);
+    uint32_t next = 0;
+    for (const auto &meshlet : meshlets)
+    {
+        ZE_CHECK_MSG(meshlet.FirstIndex == next, "{}: a meshlet starts at {} instead of {}", inName, meshlet.FirstIndex, next);
+        ZE_CHECK_MSG(meshlet.IndexCount > 0 && meshlet.IndexCount % 3 == 0, "{}: a meshlet has {} indices", inName, meshlet.IndexCount);
+        ZE_CHECK_MSG(meshlet.IndexCount <= StaticMesh::MaxMeshletTriangles * 3, "{}: a meshlet has {} triangles", inName, meshlet.IndexCount / 3);
+        next = meshlet.FirstIndex + meshlet.IndexCount;
+        if (next > indices.size()) break;
+
+        std::unordered_set<uint32_t> unique;
+        for (uint32_t i = meshlet.FirstIndex; i < next; ++i)
+        {
+            unique.insert(indices[i]);
+            const glm::vec3 &position = vertices[indices[i]].Position;
+            bool inside = position.x >= meshlet.Bounds.Min.x && position.y >= meshlet.Bounds.Min.y && position.z >= meshlet.Bounds.Min.z
+                && position.x <= meshlet.Bounds.Max.x && position.y <= meshlet.Bounds.Max.y && position.z <= meshlet.Bounds.Max.z;
+            ZE_CHECK_MSG(inside, "{}: vertex {} is outside the bounds of its meshlet", inName, indices[i]);
+        }
+        ZE_CHECK_MSG(unique.size() <= StaticMesh::MaxMeshletVertices, "{}: a meshlet has {} vertices", inName, unique.size());
+    }
+    ZE_CHECK_MSG(next == indices.size(), "{}: the meshlets cover {} of {} indices", inName, next, indices.size());
+}
+
+// the same test the meshlet culler runs, from an eye in the space of the mesh
+static bool IsCulled(const Meshlet &inMeshlet, const glm::vec3 &inEye)
+{
+    glm::vec3 toCenter = inMeshlet.Bounds.GetCenter() - inEye;
+    float radius = glm::length(inMeshlet.Bounds.GetExtents());
+    return glm::dot(toCenter, inMeshlet.ConeAxis) >= inMeshlet.ConeCutoff * glm::length(toCenter) + radius;
+}
+
+// the cones hold the normals of their triangles, and a meshlet culled from an eye only has triangles facing away from it.
+// Returns how many meshlets were culled from the eyes
+static uint32_t CheckCones(StaticMesh &ioMesh, const std::vector<glm::vec3> &inEyes, const char *inName)
+{
+    const auto &meshlets = ioMesh.GetMeshlets();
+    auto indices = ioMesh.GetIndices();
+    const auto &vertices = ioMesh.GetVertices();
+
+    uint32_t culled = 0;
+    for (const auto &meshlet : meshlets)
+    {
+        bool hasCone = glm::dot(meshlet.ConeAxis, meshlet.ConeAxis) > 0.0f;
+        float minDot = std::sqrt(std::max(0.0f, 1.0f - meshlet.ConeCutoff * meshlet.ConeCutoff));
+        for (uint32_t i = meshlet.FirstIndex; i < meshlet.FirstIndex + meshlet.IndexCount && hasCone; i += 3)
+        {
+            const glm::vec3 &a = vertices[indices[i]].Position;
+            glm::vec3 normal = glm::cross(vertices[indices[i + 1]].Position - a, vertices[indices[i + 2]].Position - a);
+            if (glm::length(normal) == 0.0f) continue;
+            float cosine = glm::dot(glm::normalize(normal), meshlet.ConeAxis);
+            ZE_CHECK_MSG(cosine >= minDot - 1e-4f, "{}: a normal is at cosine {} to the cone axis, the cone reaches {}", inName, cosine, minDot);
+        }
+
+        for (const auto &eye : inEyes)
+        {
+            if (!IsCulled(meshlet, eye)) continue;
+            ++culled;
+            for (uint32_t i = meshlet.FirstIndex; i < meshlet.FirstIndex + meshlet.IndexCount; i += 3)
+            {
+                const glm::vec3 &a = vertices[indices[i]].Position;
+                glm::vec3 normal = glm::cross(vertices[indices[i + 1]].Position - a, vertices[indices[i + 2]].Position - a);
+                ZE_CHECK_MSG(glm::dot(normal, a - eye) >= -1e-4f * glm::length(normal), "{}: a culled meshlet has a triangle facing the eye at ({}, {}, {})", inName, eye.x, eye.y, eye.z);
+            }
+        }
+    }
+    return culled;
+}
+
+int main()
+{
+    Log::Init();
+
+    {
+        StaticMesh sphere;
+        MakeSphere(sphere, 32, 64);
+        CheckPartition(sphere, "sphere");
+        std::vector<glm::vec3> eyes;
+        for (float distance : { 1.5f, 4.0f, 50.0f })
+            for (const glm::vec3 &direction : { glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, -1.0f, 0.0f), glm::vec3(0.0f, 0.6f, 0.8f), glm::vec3(-0.48f, 0.6f, -0.64f) })
+                eyes.push_back(direction * distance);
+        uint32_t culled = CheckCones(sphere, eyes, "sphere");
+        ZE_CHECK_MSG(culled > 0, "no meshlet of the sphere was culled from behind");
+    }
+
+    {
+        // every meshlet of a flat grid faces straight up, all of them are culled from below and none from above
+        StaticMesh plane;
+        MakePlane(plane, 40);
+        CheckPartition(plane, "plane");
+        for (const auto &meshlet : plane.GetMeshlets())
+            ZE_CHECK_MSG(glm::dot(meshlet.ConeAxis, glm::vec3(0.0f, 1.0f, 0.0f)) > 0.999f, "a meshlet of the plane does not face up");
+        uint32_t meshletCount = static_cast<uint32_t>(plane.GetMeshlets().size());
+        ZE_CHECK(CheckCones(plane, { glm::vec3(20.0f, -30.0f, -20.0f) }, "plane") == meshletCount);
+        ZE_CHECK(CheckCones(plane, { glm::vec3(20.0f, 30.0f, -20.0f) }, "plane") == 0);
+    }
+
+    {
+        // the vertex limit ends the meshlets
+        StaticMesh soup;
+        MakeSoup(soup, 500);
+        CheckPartition(soup, "soup");
+        CheckCones(soup, { glm::vec3(0.0f, 0.0f, 40.0f) }, "soup");
+    }
+
+    {
+        // the same few vertices over and over, only the triangle limit ends the meshlets
+        StaticMesh repeated;
+        std::vector<uint32_t> indices;
+        for (uint32_t i = 0; i < 300; ++i)
+            indices.insert(indices.end(), { 0, 1, 2 + i % 2 });
+        SetMesh(repeated, { { 0.0f, 0.0f, 0.0f }, { 1.0f, 0.0f, 0.0f }, { 1.0f, 1.0f, 0.0f }, { 0.0f, 1.0f, 0.0f } }, indices);
+        CheckPartition(repeated, "repeated");
+        ZE_CHECK(repeated.GetMeshlets().size() == 3);
+    }
+
+    return Test::Finish();
+}
@@ -0,0 +1,150 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "Check.h"
+#include "ZenEngine/Core/JobSystem.h"
+#include "ZenEngine/Renderer/MipGenerator.h"
+
+using namespace ZenEngine;
+
+// every texel of a box filtered level is the mean of the top level texels under it. The levels are
+// made from each other in floats, so even the small ones are within rounding of the mean of the top level
+static void CheckBoxLevels(const std::vector<uint8_t> &inTop, uint32_t inWidth, uint32_t inHeight, uint32_t inChannels)
+{
+    Texture2D::Format format = inChannels == 1 ? Texture2D::Format::R8 : inChannels == 3 ? Texture2D::Format::RGB8 : Texture2D::Format::RGBA8;
+    auto levels = MipGenerator::Generate(inTop, format, inWidth, inHeight, MipGenerator::Filter::Box, false);
+    ZE_CHECK(levels.size() + 1 == Texture2D::GetFullMipCount(inWidth, inHeight));
+
+    uint32_t width = inWidth;
+    uint32_t height = inHeight;
+    for (size_t level = 0; level < levels.size(); ++level)
+    {
+        width = std::max(width / 2, 1u);
+        height = std::max(height / 2, 1u);
+        uint32_t footprintX = inWidth / width;
+        uint32_t footprintY = inHeight / height;
+        ZE_CHECK_MSG(levels[level].size() == static_cast<size_t>(width) * height * inChannels, "level {} has {} bytes", level + 1, levels[level].size());
+        if (levels[level].size() != static_cast<size_t>(width) * height * inChannels) return;
+
+        uint32_t wrong = 0;
+        for (uint32_t y = 0; y < height; ++y)
+        {
+            for (uint32_t x = 0; x < width; ++x)
+            {
+                for (uint32_t c = 0; c < inChannels; ++c)
+                {
+                    uint32_t sum = 0;
+                    for (uint32_t sy = 0; sy < footprintY; ++sy)
+                        for (uint32_t sx = 0; sx < footprintX; ++sx)
+                            sum += inTop[((static_cast<size_t>(y) * footprintY + sy) * inWidth + x * footprintX + sx) * inChannels + c];
+                    double mean = static_cast<double>(sum) / (footprintX * footprintY);
+                    wrong += std::abs(levels[level][(static_cast<size_t>(y) * width + x) * inChannels + c] - mean) > 0.5 + 1e-3;
+                }
+            }
+        }
+        ZE_CHECK_MSG(wrong == 0, "{} values of level {} are not the mean of the {}x{} texels under them", wrong, level + 1, footprintX, footprintY);
+    }
+}
+
+int main()
+{
+    Log::Init();
+    JobSystem::Get().Init(4);
+
+    {
+        std::mt19937 random(3);
+        std::vector<uint8_t> top(64 * 32 * 4);
+        for (auto &channel : top)
+            channel = static_cast<uint8_t>(random() & 0xff);
+        CheckBoxLevels(top, 64, 32, 4);
+
+        std::vector<uint8_t> gray(16 * 16);
+        for (auto &channel : gray)
+            channel = static_cast<uint8_t>(random() & 0xff);
+        CheckBoxLevels(gray, 16, 16, 1);
+    }
+
+    {
+        // floats are averaged as they are
+        std::vector<float> heights(8 * 8);
+        for (size_t i = 0; i < heights.size(); ++i)
+            heights[i] = static_cast<float>(i % 7) * 10.0f - 25.0f;
+        std::vector<uint8_t> top(heights.size() * sizeof(float));
+        std::memcpy(top.data(), heights.data(), top.size());
+        auto levels = MipGenerator::Generate(top, Texture2D::Format::R32F, 8, 8, MipGenerator::Filter::Box, true);
+        ZE_CHECK(levels.size() == 3 && levels[0].size() == 4 * 4 * sizeof(float));
+        if (levels.size() == 3 && levels[0].size() == 4 * 4 * sizeof(float))
+        {
+            const float *level = reinterpret_cast<const float *>(levels[0].data());
+            for (uint32_t y = 0; y < 4; ++y)
+            {
+                for (uint32_t x = 0; x < 4; ++x)
+                {
+                    float mean = (heights[y * 16 + x * 2] + heights[y * 16 + x * 2 + 1] + heights[y * 16 + 8 + x * 2] + heights[y * 16 + 8 + x * 2 + 1]) / 4.0f;
+                    ZE_CHECK_MSG(std::abs(level[y * 4 + x] - mean) < 1e-4f, "height {} is not the mean {}", level[y * 4 + x], mean);
+                }
+            }
+        }
+    }
+
+    {
+        // a 2x2 square of the same color filters to that color again, so every 8 bit value comes back through linear space
+        std::vector<uint8_t> top(32 * 32 * 4);
+        for (uint32_t y = 0; y < 32; ++y)
+        {
+            for (uint32_t x = 0; x < 32; ++x)
+            {
+                uint8_t value = static_cast<uint8_t>(y / 2 * 16 + x / 2);
+                for (uint32_t c = 0; c < 4; ++c)
+                    top[(y * 32 + x) * 4 + c] = value;
+            }
+        }
+        auto levels = MipGenerator::Generate(top, Texture2D::Format::RGBA8, 32, 32, MipGenerator::Filter::Box, true);
+        uint32_t wrong = 0;
+        for (uint32_t i = 0; i < 16 * 16 * 4; ++i)
+            wrong += levels[0][i] != i / 4;
+        ZE_CHECK_MSG(wrong == 0, "{} values do not survive the sRGB round trip", wrong);
+    }
+
+    {
+        // the weights of every filter add up to one, a flat color stays the same down to the last level
+        std::vector<uint8_t> top(24 * 10 * 3, 200);
+        for (auto filter : { MipGenerator::Filter::Box, MipGenerator::Filter::Kaiser, MipGenerator::Filter::Lanczos })
+        {
+            for (bool srgb : { false, true })
+            {
+                uint32_t wrong = 0;
+                for (const auto &level : MipGenerator::Generate(top, Texture2D::Format::RGB8, 24, 10, filter, srgb))
+                    for (uint8_t value : level)
+                        wrong += value != 200;
+                ZE_CHECK_MSG(wrong == 0, "{} values of a flat color changed with filter {} and sRGB {}", wrong, static_cast<int>(filter), srgb);
+            }
+        }
+    }
+
+    {
+        // black and white average to half the light, not half the sRGB value. Alpha is linear either way
+        std::vector<uint8_t> top(2 * 2 * 4);
+        for (uint32_t i = 0; i < 4; ++i)
+        {
+            uint8_t value = i == 0 || i == 3 ? 255 : 0;
+            for (uint32_t c = 0; c < 4; ++c)
+                top[i * 4 + c] = value;
+        }
+        auto srgb = MipGenerator::Generate(top, Texture2D::Format::RGBA8, 2, 2, MipGenerator::Filter::Box, true);
+        auto linear = MipGenerator::Generate(top, Texture2D::Format::RGBA8, 2, 2, MipGenerator::Filter::Box, false);
+        ZE_CHECK(srgb.size() == 1 && linear.size() == 1);
+        if (srgb.size() == 1 && linear.size() == 1)
+        {
+            ZE_CHECK_MSG(srgb[0][0] == 188 && srgb[0][1] == 188 && srgb[0][2] == 188, "sRGB mean {}", srgb[0][0]);
+            ZE_CHECK_MSG(srgb[0][3] == 128, "sRGB alpha mean {}", srgb[0][3]);
+            ZE_CHECK_MSG(linear[0][0] == 128 && linear[0][3] == 128, "linear mean {}", linear[0][0]);
+        }
+    }
+
+    JobSystem::Get().Shutdown();
+    return Test::Finish();
+}
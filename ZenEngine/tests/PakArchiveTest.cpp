@@ -0,0 +1,171 @@
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <random>
+#include <vector>
+
+#include "Check.h"
+#include "ZenEngine/Core/JobSystem.h"
+#include "ZenEngine/Asset/PakArchive.h"
+
+using namespace ZenEngine;
+
+struct SourceFile
+{
+    uint64_t Id;
+    const char *ClassName;
+    std::filesystem::path Filepath;
+    std::vector<uint8_t> Data;
+    // a file that does not compress is left as it is
+    bool Compresses;
+};
+
+static std::vector<uint8_t> ReadBytes(const std::filesystem::path &inFilepath)
+{
+    std::ifstream ifs(inFilepath, std::ios::binary);
+    return std::vector<uint8_t>(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+}
+
+static void WriteBytes(const std::filesystem::path &inFilepath, const std::vector<uint8_t> &inData)
+{
+    std::ofstream ofs(inFilepath, std::ios::binary);
+    ofs.write(reinterpret_cast<const char*>(inData.data()), inData.size());
+}
+
+static void CheckPak(const std::filesystem::path &inFilepath, const std::vector<SourceFile> &inSources, bool inCompressed)
+{
+    PakArchive pak;
+    ZE_CHECK_MSG(pak.Open(inFilepath), "cannot open {}", inFilepath.string());
+    ZE_CHECK(pak.GetEntryCount() == inSources.size());
+    for (uint32_t i = 1; i < pak.GetEntryCount(); ++i)
+        ZE_CHECK_MSG(pak.GetEntry(i - 1).Id < pak.GetEntry(i).Id, "the table of contents is not sorted at {}", i);
+
+    for (const auto &source : inSources)
+    {
+        const PakArchive::Entry *entry = pak.Find(source.Id);
+        ZE_CHECK_MSG(entry != nullptr, "asset {} is not found", source.Id);
+        if (entry == nullptr) continue;
+        ZE_CHECK(entry->Size == source.Data.size());
+        ZE_CHECK(std::strcmp(pak.GetClassName(*entry), source.ClassName) == 0);
+        ZE_CHECK(pak.GetPath(*entry) == source.Filepath.generic_string());
+        ZE_CHECK_MSG(pak.IsCompressed(*entry) == (inCompressed && source.Compresses), "asset {} is compressed: {}", source.Id, pak.IsCompressed(*entry));
+
+        PackedAsset packed = pak.Read(*entry);
+        ZE_CHECK_MSG(packed.Owner != nullptr, "asset {} cannot be read", source.Id);
+        ZE_CHECK(static_cast<uint64_t>(packed.Id) == source.Id);
+        ZE_CHECK_MSG(std::vector<uint8_t>(packed.Data.begin(), packed.Data.end()) == source.Data, "asset {} reads back other bytes", source.Id);
+        // used in place, the mapping starts on a page so the file is as aligned as its offset
+        if (!pak.IsCompressed(*entry))
+            ZE_CHECK_MSG(reinterpret_cast<uintptr_t>(packed.Data.data()) % PakArchive::Alignment == 0, "asset {} is not aligned in the pak", source.Id);
+        else
+            ZE_CHECK_MSG(pak.GetStoredSize(*entry) < entry->Size, "asset {} takes {} bytes compressed", source.Id, pak.GetStoredSize(*entry));
+    }
+    ZE_CHECK(pak.Find(UUID(12345)) == nullptr);
+    ZE_CHECK(pak.Find(UUID(0)) == nullptr);
+    ZE_CHECK(pak.Find(UUID(~uint64_t(0))) == nullptr);
+}
+
+int main()
+{
+    Log::Init();
+    JobSystem::Get().Init(2);
+
+    std::filesystem::path directory = std::filesystem::temp_directory_path() / "ZenEnginePakArchiveTest";
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+
+    std::mt19937 random(9);
+    std::vector<SourceFile> sources;
+    {
+        // several blocks of text, the last one partly full
+        std::vector<uint8_t> text;
+        const char *line = "a pak holds many asset files in one, split in blocks compressed on their own\n";
+        while (text.size() < 3 * PakArchive::BlockSize + 1000)
+            text.insert(text.end(), line, line + std::strlen(line));
+        sources.push_back({ 300, "ZenEngine::ShaderAsset", directory / "shader.zasset", text, true });
+
+        std::vector<uint8_t> noise(100000);
+        for (auto &byte : noise)
+            byte = static_cast<uint8_t>(random() & 0xff);
+        sources.push_back({ 100, "ZenEngine::Texture2DAsset", directory / "texture.zasset", noise, false });
+
+        sources.push_back({ 200, "ZenEngine::Texture2DAsset", directory / "small.zasset", { 1, 2, 3, 4, 5 }, false });
+        // ids near the ends of the range are searched like any other
+        sources.push_back({ ~uint64_t(0) - 1, "ZenEngine::StaticMesh", directory / "last.zasset", std::vector<uint8_t>(5000, 0x5a), true });
+        sources.push_back({ 1, "ZenEngine::StaticMesh", directory / "first.zasset", std::vector<uint8_t>(PakArchive::BlockSize, 0), true });
+    }
+    for (const auto &source : sources)
+        WriteBytes(source.Filepath, source.Data);
+
+    PakWriter writer;
+    for (const auto &source : sources)
+        writer.Add(source.Id, source.ClassName, source.Filepath);
+    // a file that is gone is left out, and only one asset of an id is packed
+    writer.Add(400, "ZenEngine::ShaderAsset", directory / "missing.zasset");
+    writer.Add(100, "ZenEngine::Texture2DAsset", directory / "texture.zasset");
+
+    std::filesystem::path compressedPak = directory / "compressed.zpak";
+    std::filesystem::path storedPak = directory / "stored.zpak";
+    ZE_CHECK(writer.Write(compressedPak, true));
+    ZE_CHECK(writer.Write(storedPak, false));
+    CheckPak(compressedPak, sources, true);
+    CheckPak(storedPak, sources, false);
+
+    // each change breaks the tables in a way Open must notice, the pak is refused rather than read out of bounds
+    std::vector<uint8_t> original = ReadBytes(compressedPak);
+    PakArchive::Header header;
+    std::memcpy(&header, original.data(), sizeof(PakArchive::Header));
+    auto headerAt = [](std::vector<uint8_t> &ioPak) { return reinterpret_cast<PakArchive::Header*>(ioPak.data()); };
+    auto entryAt = [&](std::vector<uint8_t> &ioPak, uint32_t inIndex) { return reinterpret_cast<PakArchive::Entry*>(ioPak.data() + header.EntriesOffset) + inIndex; };
+    auto blockAt = [&](std::vector<uint8_t> &ioPak, uint32_t inIndex) { return reinterpret_cast<PakArchive::Block*>(ioPak.data() + header.BlocksOffset) + inIndex; };
+
+    const std::pair<const char*, std::function<void(std::vector<uint8_t>&)>> corruptions[] = {
+        { "magic", [&](auto &ioPak) { headerAt(ioPak)->Magic ^= 1; } },
+        { "version", [&](auto &ioPak) { headerAt(ioPak)->Version = PakArchive::Version + 1; } },
+        { "entry count", [&](auto &ioPak) { headerAt(ioPak)->EntryCount = 1u << 30; } },
+        { "block count", [&](auto &ioPak) { headerAt(ioPak)->BlockCount += 1000; } },
+        { "unaligned entries", [&](auto &ioPak) { headerAt(ioPak)->EntriesOffset += 8; } },
+        { "blocks past the end", [&](auto &ioPak) { headerAt(ioPak)->BlocksOffset = ioPak.size() + PakArchive::Alignment; } },
+        { "strings past the end", [&](auto &ioPak) { headerAt(ioPak)->StringsSize += 1; } },
+        { "strings without a zero", [&](auto &ioPak) { ioPak.back() = 'x'; } },
+        { "unsorted entries", [&](auto &ioPak) { std::swap(*entryAt(ioPak, 0), *entryAt(ioPak, 1)); } },
+        { "size and blocks disagree", [&](auto &ioPak) { entryAt(ioPak, 0)->Size += PakArchive::BlockSize; } },
+        { "blocks out of range", [&](auto &ioPak) { entryAt(ioPak, 2)->FirstBlock = header.BlockCount; } },
+        { "class name out of range", [&](auto &ioPak) { entryAt(ioPak, 1)->ClassNameOffset = static_cast<uint32_t>(header.StringsSize); } },
+        { "block past the end", [&](auto &ioPak) { blockAt(ioPak, 0)->Offset = ioPak.size(); } },
+        { "block too long", [&](auto &ioPak) { blockAt(ioPak, header.BlockCount - 1)->StoredSize += static_cast<uint32_t>(ioPak.size()); } },
+        { "cut short", [&](auto &ioPak) { ioPak.resize(ioPak.size() / 2); } },
+        { "shorter than the header", [&](auto &ioPak) { ioPak.resize(sizeof(PakArchive::Header) - 1); } },
+    };
+    std::filesystem::path corruptedPak = directory / "corrupted.zpak";
+    for (const auto &[name, corrupt] : corruptions)
+    {
+        std::vector<uint8_t> bytes = original;
+        corrupt(bytes);
+        WriteBytes(corruptedPak, bytes);
+        PakArchive pak;
+        ZE_CHECK_MSG(!pak.Open(corruptedPak), "a pak with {} opens", name);
+    }
+
+    {
+        // a block that does not decompress is only found when it is read, the asset then has no data
+        std::vector<uint8_t> bytes = original;
+        PakArchive pak;
+        ZE_CHECK(pak.Open(compressedPak));
+        const PakArchive::Entry *entry = pak.Find(UUID(300));
+        if (entry != nullptr && pak.IsCompressed(*entry))
+        {
+            blockAt(bytes, entry->FirstBlock)->StoredSize -= 1;
+            WriteBytes(corruptedPak, bytes);
+            PakArchive corrupted;
+            ZE_CHECK(corrupted.Open(corruptedPak));
+            ZE_CHECK(corrupted.Read(*corrupted.Find(UUID(300))).Owner == nullptr);
+        }
+    }
+
+    JobSystem::Get().Shutdown();
+    std::error_code error;
+    std::filesystem::remove_all(directory, error);
+    return Test::Finish();
+}
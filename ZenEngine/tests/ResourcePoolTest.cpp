@@ -0,0 +1,106 @@
+#include <array>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "Check.h"
+#include "ZenEngine/Renderer/ResourcePool.h"
+
+using namespace ZenEngine;
+
+// remembers the handle it was inserted with, a handle resolving to a resource with another one is a stale handle let through
+struct TestResource
+{
+    std::atomic<uint32_t> HandleValue = 0;
+};
+
+using TestPool = ResourcePool<TestResource>;
+
+int main()
+{
+    Log::Init();
+
+    {
+        TestPool pool;
+        auto first = pool.Insert(std::make_shared<TestResource>());
+        ZE_CHECK(pool.Get(first) != nullptr && pool.GetSize() == 1);
+        ZE_CHECK(pool.Remove(first) != nullptr && pool.Get(first) == nullptr);
+        // the slot is reused with the next generation, the old handle stays dead
+        auto second = pool.Insert(std::make_shared<TestResource>());
+        ZE_CHECK(second.GetIndex() == first.GetIndex() && second.GetGeneration() != first.GetGeneration());
+        ZE_CHECK(pool.Get(first) == nullptr && pool.Get(second) != nullptr);
+        ZE_CHECK(pool.Remove(first) == nullptr && pool.GetSize() == 1);
+        ZE_CHECK(pool.Get(TestPool::Handle::Null) == nullptr);
+
+        // an exchange keeps the handle
+        auto replacement = std::make_shared<TestResource>();
+        ZE_CHECK(pool.Exchange(second, replacement) != nullptr && pool.Get(second) == replacement.get());
+    }
+
+    {
+        // one thread removes and inserts again over a few slots, as the registry does under its lock, while others
+        // resolve every handle they saw. A handle resolves to its own resource or to nothing
+        static constexpr uint32_t SlotCount = 4;
+        static constexpr uint32_t Recycles = 200000;
+        TestPool pool;
+        std::array<std::atomic<uint32_t>, SlotCount> published;
+        for (uint32_t i = 0; i < SlotCount; ++i)
+        {
+            auto resource = std::make_shared<TestResource>();
+            auto handle = pool.Insert(resource);
+            resource->HandleValue = handle.GetValue();
+            published[i] = handle.GetValue();
+        }
+
+        std::atomic<bool> done = false;
+        std::atomic<uint32_t> wrong = 0;
+        std::atomic<uint64_t> resolved = 0;
+        std::vector<std::thread> readers;
+        for (uint32_t r = 0; r < 3; ++r)
+        {
+            readers.emplace_back([&, r]()
+            {
+                std::vector<uint32_t> seen;
+                uint64_t count = 0;
+                for (uint32_t i = r; !done.load(std::memory_order_relaxed); i = (i + 1) % SlotCount)
+                {
+                    seen.push_back(published[i].load(std::memory_order_acquire));
+                    if (seen.size() > 64) seen.erase(seen.begin());
+                    for (uint32_t value : seen)
+                    {
+                        TestPool::Handle handle(value & TestPool::Handle::sMaxIndex, value >> TestPool::Handle::sIndexBits);
+                        if (const TestResource *resource = pool.Get(handle))
+                        {
+                            wrong += resource->HandleValue.load(std::memory_order_relaxed) != value;
+                            ++count;
+                        }
+                    }
+                }
+                resolved += count;
+            });
+        }
+
+        // removed resources are kept alive, like the deferred destruction of the registry does for a frame
+        std::vector<std::shared_ptr<TestResource>> removed;
+        removed.reserve(Recycles);
+        for (uint32_t i = 0; i < Recycles; ++i)
+        {
+            uint32_t value = published[i % SlotCount].load(std::memory_order_relaxed);
+            removed.push_back(pool.Remove(TestPool::Handle(value & TestPool::Handle::sMaxIndex, value >> TestPool::Handle::sIndexBits)));
+            auto resource = std::make_shared<TestResource>();
+            auto handle = pool.Insert(resource);
+            resource->HandleValue = handle.GetValue();
+            published[i % SlotCount].store(handle.GetValue(), std::memory_order_release);
+        }
+        done = true;
+        for (auto &reader : readers)
+            reader.join();
+
+        ZE_CHECK_MSG(wrong == 0, "{} stale handles resolved to the resource that reused their slot", wrong.load());
+        ZE_CHECK_MSG(resolved > 0, "no handle was resolved while the slots were reused");
+        ZE_CHECK(pool.GetSize() == SlotCount);
+    }
+
+    return Test::Finish();
+}
@@ -0,0 +1,159 @@
+#include <cstdlib>
+#include <vector>
+
+#include "Check.h"
+#include "ZenEngine/Core/JobSystem.h"
+#include "Platform/Software/SoftwareRasterizer.h"
+
+using namespace ZenEngine;
+
+// renders a fixed scene on the rasterizer and compares it with golden/SoftwareRasterizer.ppm.
+// Set ZE_UPDATE_GOLDEN to write the golden image again instead, e.g. after an intended change of the output
+static const char *sGoldenFile = "golden/SoftwareRasterizer.ppm";
+static constexpr uint32_t Width = 160;
+static constexpr uint32_t Height = 120;
+
+// position in view space, color with alpha and texture coordinate. The camera looks down -z
+struct SceneVertex
+{
+    glm::vec4 Position;
+    glm::vec4 Color;
+    glm::vec2 TexCoord;
+};
+
+class SceneProgram : public SoftwareShaderProgram
+{
+public:
+    static constexpr float Near = 0.5f;
+    static constexpr float Far = 20.0f;
+    // 1 / tan(30 degrees), a 60 degree vertical field of view
+    static constexpr float Focal = 1.7320508f;
+
+    virtual uint32_t GetVaryingCount() const override { return 6; }
+
+    virtual glm::vec4 Vertex(const glm::vec4 *inAttributes, float *outVaryings, const SoftwareShaderContext &inContext) const override
+    {
+        const glm::vec4 &position = inAttributes[0];
+        for (uint32_t i = 0; i < 4; ++i)
+            outVaryings[i] = inAttributes[1][i];
+        outVaryings[4] = inAttributes[2].x;
+        outVaryings[5] = inAttributes[2].y;
+        float aspect = static_cast<float>(Width) / static_cast<float>(Height);
+        return { position.x * Focal / aspect, position.y * Focal, (position.z * (Far + Near) + 2.0f * Far * Near) / (Near - Far), -position.z };
+    }
+
+    virtual bool Pixel(const float *inVaryings, glm::vec4 *outColors, const SoftwareShaderContext &inContext) const override
+    {
+        glm::vec4 texel = inContext.Sample(0, { inVaryings[4], inVaryings[5] });
+        outColors[0] = glm::vec4(inVaryings[0], inVaryings[1], inVaryings[2], inVaryings[3]) * texel;
+        return true;
+    }
+};
+
+static void Draw(SoftwareRasterizer &ioRasterizer, SoftwareDrawCall &ioDraw, const SceneProgram &inProgram, const std::vector<SceneVertex> &inVertices, const std::vector<uint32_t> &inIndices)
+{
+    // the vertex stage as the software renderer runs it
+    std::vector<SoftwareClipVertex> clipVertices(inVertices.size());
+    for (size_t i = 0; i < inVertices.size(); ++i)
+    {
+        glm::vec4 attributes[3] = { inVertices[i].Position, inVertices[i].Color, glm::vec4(inVertices[i].TexCoord.x, inVertices[i].TexCoord.y, 0.0f, 1.0f) };
+        clipVertices[i].Position = inProgram.Vertex(attributes, clipVertices[i].Varyings, *ioDraw.Context);
+    }
+    ioRasterizer.DrawTriangles(ioDraw, clipVertices, inIndices.data(), static_cast<uint32_t>(inIndices.size()));
+}
+
+// without workers every tile is shaded on the calling thread
+static SoftwareImage Render(uint32_t inWorkerCount)
+{
+    if (inWorkerCount > 0) JobSystem::Get().Init(inWorkerCount);
+
+    SoftwareImage checker(8, 8, SoftwareImage::Format::RGBA8);
+    for (uint32_t y = 0; y < 8; ++y)
+        for (uint32_t x = 0; x < 8; ++x)
+            checker.Store(x, y, (x + y) % 2 == 0 ? glm::vec4(1.0f) : glm::vec4(0.35f, 0.35f, 0.35f, 1.0f));
+
+    SoftwareShaderContext context;
+    context.Textures[0].Image = &checker;
+    context.Textures[0].Sampler.Linear = true;
+    context.Textures[0].Sampler.Repeat = true;
+
+    SoftwareImage color(Width, Height, SoftwareImage::Format::RGBA8);
+    SoftwareImage depth(Width, Height, SoftwareImage::Format::Depth32F);
+    color.Clear({ 0.1f, 0.1f, 0.15f, 1.0f });
+    depth.Clear(glm::vec4(1.0f));
+
+    SceneProgram program;
+    SoftwareDrawCall draw;
+    draw.Program = &program;
+    draw.Context = &context;
+    draw.Target.Colors[0] = &color;
+    draw.Target.ColorCount = 1;
+    draw.Target.Depth = &depth;
+    draw.Target.Width = Width;
+    draw.Target.Height = Height;
+    draw.Viewport[2] = static_cast<int32_t>(Width);
+    draw.Viewport[3] = static_cast<int32_t>(Height);
+
+    SoftwareRasterizer rasterizer;
+    // a floor going into the distance, the texture repeats and is sampled in perspective
+    Draw(rasterizer, draw, program, {
+        { { -6.0f, -1.0f, -1.0f, 1.0f }, { 0.9f, 0.9f, 0.8f, 1.0f }, { 0.0f, 0.0f } },
+        { { 6.0f, -1.0f, -1.0f, 1.0f }, { 0.9f, 0.9f, 0.8f, 1.0f }, { 6.0f, 0.0f } },
+        { { 6.0f, -1.0f, -18.0f, 1.0f }, { 0.9f, 0.9f, 0.8f, 1.0f }, { 6.0f, 9.0f } },
+        { { -6.0f, -1.0f, -18.0f, 1.0f }, { 0.9f, 0.9f, 0.8f, 1.0f }, { 0.0f, 9.0f } },
+    }, { 0, 1, 2, 0, 2, 3 });
+    // two triangles going through each other, the depth test decides which one shows along the line they cross
+    Draw(rasterizer, draw, program, {
+        { { -2.0f, -0.8f, -4.0f, 1.0f }, { 1.0f, 0.2f, 0.2f, 1.0f }, { 0.0f, 0.0f } },
+        { { 1.5f, -0.8f, -7.0f, 1.0f }, { 1.0f, 0.2f, 0.2f, 1.0f }, { 2.0f, 0.0f } },
+        { { -0.5f, 1.6f, -5.5f, 1.0f }, { 1.0f, 0.2f, 0.2f, 1.0f }, { 1.0f, 2.0f } },
+        { { -2.0f, -0.8f, -7.0f, 1.0f }, { 0.2f, 0.4f, 1.0f, 1.0f }, { 0.0f, 0.0f } },
+        { { 1.5f, -0.8f, -4.0f, 1.0f }, { 0.2f, 0.4f, 1.0f, 1.0f }, { 2.0f, 0.0f } },
+        { { 0.5f, 1.6f, -5.5f, 1.0f }, { 0.2f, 0.4f, 1.0f, 1.0f }, { 1.0f, 2.0f } },
+    }, { 0, 1, 2, 3, 4, 5 });
+    // reaches behind the eye, it is clipped against the near plane
+    Draw(rasterizer, draw, program, {
+        { { 1.2f, -0.9f, 1.0f, 1.0f }, { 0.3f, 1.0f, 0.4f, 1.0f }, { 0.0f, 0.0f } },
+        { { 2.5f, -0.9f, -6.0f, 1.0f }, { 0.3f, 1.0f, 0.4f, 1.0f }, { 1.0f, 0.0f } },
+        { { 2.0f, 0.8f, -3.0f, 1.0f }, { 0.3f, 1.0f, 0.4f, 1.0f }, { 0.5f, 1.0f } },
+    }, { 0, 1, 2 });
+    // blended over everything drawn so far, without writing depth
+    draw.State.Blend = true;
+    draw.State.DepthWrite = false;
+    Draw(rasterizer, draw, program, {
+        { { -2.5f, -0.5f, -3.0f, 1.0f }, { 1.0f, 0.9f, 0.2f, 0.5f }, { 0.0f, 0.0f } },
+        { { 0.5f, -0.5f, -3.0f, 1.0f }, { 1.0f, 0.9f, 0.2f, 0.5f }, { 1.0f, 0.0f } },
+        { { 0.5f, 0.7f, -3.0f, 1.0f }, { 1.0f, 0.9f, 0.2f, 0.5f }, { 1.0f, 1.0f } },
+        { { -2.5f, 0.7f, -3.0f, 1.0f }, { 1.0f, 0.9f, 0.2f, 0.5f }, { 0.0f, 1.0f } },
+    }, { 0, 1, 2, 0, 2, 3 });
+
+    JobSystem::Get().Shutdown();
+    return color;
+}
+
+int main()
+{
+    Log::Init();
+
+    // the tiles are shaded in parallel, the image must not depend on how many threads there are
+    SoftwareImage reference = Render(0);
+    for (uint32_t workers : { 1u, 3u, 7u })
+    {
+        SoftwareImage image = Render(workers);
+        uint32_t mismatches = SoftwareImage::CountMismatches(reference, image);
+        ZE_CHECK_MSG(mismatches == 0, "{} texels differ with {} workers", mismatches, workers);
+    }
+
+    if (std::getenv("ZE_UPDATE_GOLDEN") != nullptr)
+    {
+        ZE_CHECK(reference.SavePPM(sGoldenFile));
+        return Test::Finish();
+    }
+
+    SoftwareImage golden;
+    ZE_CHECK_MSG(SoftwareImage::LoadPPM(sGoldenFile, golden), "cannot read {}", sGoldenFile);
+    // pixel exact, the rasterizer and these tests are built without contracted floating point operations
+    uint32_t mismatches = SoftwareImage::CountMismatches(reference, golden);
+    ZE_CHECK_MSG(mismatches == 0, "{} texels differ from {}", mismatches, sGoldenFile);
+    return Test::Finish();
+}
@@ -0,0 +1,191 @@
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "Check.h"
+#include "ZenEngine/Core/JobSystem.h"
+#include "ZenEngine/Renderer/TextureCompression.h"
+
+using namespace ZenEngine;
+
+struct Image
+{
+    uint32_t Width;
+    uint32_t Height;
+    // RGBA8
+    std::vector<uint8_t> Texels;
+};
+
+struct Bounds
+{
+    // root mean square and largest error over the channels the format stores, in 8 bit steps
+    float Rms;
+    uint32_t Max;
+};
+
+struct Error
+{
+    float Rms = 0.0f;
+    uint32_t Max = 0;
+};
+
+static const char *GetName(Texture2D::Format inFormat)
+{
+    switch (inFormat)
+    {
+    case Texture2D::Format::BC1: return "BC1";
+    case Texture2D::Format::BC3: return "BC3";
+    case Texture2D::Format::BC4: return "BC4";
+    case Texture2D::Format::BC5: return "BC5";
+    case Texture2D::Format::BC7: return "BC7";
+    default: return "?";
+    }
+}
+
+// the channels each format keeps, the others decode as zero and alpha as opaque
+static uint32_t GetChannels(Texture2D::Format inFormat)
+{
+    switch (inFormat)
+    {
+    case Texture2D::Format::BC1: return 3;
+    case Texture2D::Format::BC4: return 1;
+    case Texture2D::Format::BC5: return 2;
+    default: return 4;
+    }
+}
+
+// smooth in every channel, what most blocks of a real texture look like
+static Image MakeGradient(uint32_t inWidth, uint32_t inHeight)
+{
+    Image image{ inWidth, inHeight, std::vector<uint8_t>(static_cast<size_t>(inWidth) * inHeight * 4) };
+    for (uint32_t y = 0; y < inHeight; ++y)
+    {
+        for (uint32_t x = 0; x < inWidth; ++x)
+        {
+            uint8_t *texel = &image.Texels[(static_cast<size_t>(y) * inWidth + x) * 4];
+            texel[0] = static_cast<uint8_t>(x * 255 / (inWidth - 1));
+            texel[1] = static_cast<uint8_t>(y * 255 / (inHeight - 1));
+            texel[2] = static_cast<uint8_t>((x + y) * 255 / (inWidth + inHeight - 2));
+            texel[3] = static_cast<uint8_t>(255 - x * 191 / (inWidth - 1));
+        }
+    }
+    return image;
+}
+
+// the worst case, no two texels are related
+static Image MakeNoise(uint32_t inWidth, uint32_t inHeight)
+{
+    std::mt19937 random(11);
+    Image image{ inWidth, inHeight, std::vector<uint8_t>(static_cast<size_t>(inWidth) * inHeight * 4) };
+    for (auto &channel : image.Texels)
+        channel = static_cast<uint8_t>(random() & 0xff);
+    return image;
+}
+
+// one color per block, each block of a different one
+static Image MakeSolidBlocks(uint32_t inWidth, uint32_t inHeight)
+{
+    std::mt19937 random(5);
+    Image image{ inWidth, inHeight, std::vector<uint8_t>(static_cast<size_t>(inWidth) * inHeight * 4) };
+    uint32_t blocksX = (inWidth + TextureCompression::BlockSize - 1) / TextureCompression::BlockSize;
+    uint32_t blocksY = (inHeight + TextureCompression::BlockSize - 1) / TextureCompression::BlockSize;
+    std::vector<uint32_t> colors(blocksX * blocksY);
+    for (auto &color : colors)
+        color = static_cast<uint32_t>(random());
+    for (uint32_t y = 0; y < inHeight; ++y)
+    {
+        for (uint32_t x = 0; x < inWidth; ++x)
+        {
+            uint32_t color = colors[y / TextureCompression::BlockSize * blocksX + x / TextureCompression::BlockSize];
+            for (uint32_t c = 0; c < 4; ++c)
+                image.Texels[(static_cast<size_t>(y) * inWidth + x) * 4 + c] = static_cast<uint8_t>(color >> (c * 8));
+        }
+    }
+    return image;
+}
+
+static Error RoundTrip(const Image &inImage, Texture2D::Format inFormat, TextureCompression::Quality inQuality, const char *inName)
+{
+    std::vector<uint8_t> blocks = TextureCompression::Encode(inFormat, inQuality, inImage.Texels.data(), Texture2D::Format::RGBA8, inImage.Width, inImage.Height);
+    ZE_CHECK_MSG(blocks.size() == Texture2D::Texture2DDataSize(inFormat, inImage.Width, inImage.Height), "{} {}: {} bytes of blocks", GetName(inFormat), inName, blocks.size());
+
+    std::vector<uint8_t> decoded(inImage.Texels.size());
+    TextureCompression::Decode(inFormat, blocks.data(), inImage.Width, inImage.Height, decoded.data());
+
+    uint32_t channels = GetChannels(inFormat);
+    uint32_t unused = 0;
+    double sum = 0.0;
+    Error error;
+    for (size_t i = 0; i < decoded.size(); i += 4)
+    {
+        for (uint32_t c = 0; c < 4; ++c)
+        {
+            if (c >= channels)
+            {
+                unused += decoded[i + c] != (c == 3 ? 255 : 0);
+                continue;
+            }
+            uint32_t difference = static_cast<uint32_t>(std::abs(decoded[i + c] - inImage.Texels[i + c]));
+            sum += static_cast<double>(difference) * difference;
+            error.Max = std::max(error.Max, difference);
+        }
+    }
+    ZE_CHECK_MSG(unused == 0, "{} {}: {} channels the format does not store are not zero or opaque", GetName(inFormat), inName, unused);
+    error.Rms = static_cast<float>(std::sqrt(sum / static_cast<double>(decoded.size() / 4 * channels)));
+    return error;
+}
+
+static void Check(const Image &inImage, Texture2D::Format inFormat, TextureCompression::Quality inQuality, const Bounds &inBounds, const char *inName)
+{
+    Error error = RoundTrip(inImage, inFormat, inQuality, inName);
+    ZE_CHECK_MSG(error.Rms <= inBounds.Rms && error.Max <= inBounds.Max, "{} {} at quality {}: the error is {} rms and {} at most, more than {} and {}",
+        GetName(inFormat), inName, static_cast<int>(inQuality), error.Rms, error.Max, inBounds.Rms, inBounds.Max);
+}
+
+int main()
+{
+    Log::Init();
+    JobSystem::Get().Init(4);
+
+    // not a multiple of the block size, the blocks along the edges are partly outside the level
+    Image gradient = MakeGradient(70, 37);
+    Image noise = MakeNoise(37, 21);
+    Image solid = MakeSolidBlocks(64, 32);
+
+    constexpr TextureCompression::Quality qualities[] = { TextureCompression::Quality::Fast, TextureCompression::Quality::Normal, TextureCompression::Quality::High };
+    struct FormatBounds
+    {
+        Texture2D::Format Format;
+        Bounds Gradient;
+        Bounds Noise;
+        Bounds Solid;
+    };
+    // measured with some room for other compilers. Noise is only bounded on average, a block of it has no good fit.
+    // A solid block is at most a quantization step off, 5 bits for BC1 colors and 7 and a shared bit for BC7
+    const FormatBounds formats[] = {
+        { Texture2D::Format::BC1, { 4.5f, 14 }, { 70.0f, 255 }, { 2.5f, 4 } },
+        { Texture2D::Format::BC3, { 4.0f, 14 }, { 60.0f, 255 }, { 2.5f, 4 } },
+        { Texture2D::Format::BC4, { 0.5f, 1 }, { 10.0f, 24 }, { 0.0f, 0 } },
+        { Texture2D::Format::BC5, { 0.75f, 1 }, { 10.0f, 24 }, { 0.0f, 0 } },
+        { Texture2D::Format::BC7, { 4.0f, 12 }, { 70.0f, 255 }, { 1.0f, 1 } },
+    };
+
+    for (const auto &format : formats)
+    {
+        for (auto quality : qualities)
+        {
+            Check(gradient, format.Format, quality, format.Gradient, "gradient");
+            Check(noise, format.Format, quality, format.Noise, "noise");
+            Check(solid, format.Format, quality, format.Solid, "solid blocks");
+        }
+
+        // the better qualities never do worse than the fast one
+        float fast = RoundTrip(noise, format.Format, TextureCompression::Quality::Fast, "noise").Rms;
+        float high = RoundTrip(noise, format.Format, TextureCompression::Quality::High, "noise").Rms;
+        ZE_CHECK_MSG(high <= fast, "{}: the high quality error {} is above the fast one {}", GetName(format.Format), high, fast);
+    }
+
+    JobSystem::Get().Shutdown();
+    return Test::Finish();
+}
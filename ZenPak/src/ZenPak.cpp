@@ -0,0 +1,87 @@
+#include <cstring>
+#include <filesystem>
+#include <string>
+
+#include "ZenEngine/Core/Log.h"
+#include "ZenEngine/Core/JobSystem.h"
+#include "ZenEngine/Asset/AssetManager.h"
+#include "ZenEngine/Asset/PakArchive.h"
+
+using namespace ZenEngine;
+
+static void PrintUsage()
+{
+    fmt::print("Usage:\n");
+    fmt::print("  ZenPak build <pak> [--store]   packs the assets under Assets/ of the current directory\n");
+    fmt::print("                                 --store keeps every file as it is, mapped without decompressing\n");
+    fmt::print("  ZenPak list <pak>              prints the table of contents\n");
+}
+
+static int Build(const std::string &inPakPath, bool inCompress)
+{
+    // the database is built the same way the game builds it, the loaders tell what each file is.
+    // The pak it would mount is not, everything packed comes from the loose files
+    AssetManager::Get().InitDatabase();
+
+    // rebuilding drops what is only left in the pak being replaced, e.g. files deleted since
+    {
+        PakArchive previous;
+        if (std::filesystem::exists(inPakPath) && previous.Open(inPakPath))
+        {
+            uint32_t dropped = 0;
+            for (uint32_t i = 0; i < previous.GetEntryCount(); ++i)
+            {
+                const auto &entry = previous.GetEntry(i);
+                if (AssetManager::Get().Exists(entry.Id)) continue;
+                ZE_CORE_WARN("{} has no loose file, it is left out of the new pak", previous.GetPath(entry));
+                ++dropped;
+            }
+            if (dropped > 0) ZE_CORE_WARN("{} assets of {} are not packed again", dropped, inPakPath);
+        }
+    }
+    bool written = AssetManager::Get().WritePak(inPakPath, inCompress);
+    AssetManager::Get().Shutdown();
+    return written ? 0 : 1;
+}
+
+static int List(const std::string &inPakPath)
+{
+    PakArchive pak;
+    if (!pak.Open(inPakPath)) return 1;
+
+    uint64_t totalSize = 0;
+    uint64_t totalStored = 0;
+    fmt::print("{:<20} {:<28} {:>12} {:>12}  {}\n", "Id", "Class", "Size", "Stored", "Path");
+    for (uint32_t i = 0; i < pak.GetEntryCount(); ++i)
+    {
+        const auto &entry = pak.GetEntry(i);
+        uint64_t stored = pak.GetStoredSize(entry);
+        fmt::print("{:<20} {:<28} {:>12} {:>12}{} {}\n", entry.Id, pak.GetClassName(entry), entry.Size, stored, pak.IsCompressed(entry) ? "*" : " ", pak.GetPath(entry));
+        totalSize += entry.Size;
+        totalStored += stored;
+    }
+    fmt::print("{} assets, {} bytes stored in {} bytes, * marks the compressed ones\n", pak.GetEntryCount(), totalSize, totalStored);
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 3)
+    {
+        PrintUsage();
+        return 1;
+    }
+    Log::Init();
+    JobSystem::Get().Init();
+
+    int result = 1;
+    if (std::strcmp(argv[1], "build") == 0)
+        result = Build(argv[2], !(argc > 3 && std::strcmp(argv[3], "--store") == 0));
+    else if (std::strcmp(argv[1], "list") == 0)
+        result = List(argv[2]);
+    else
+        PrintUsage();
+
+    JobSystem::Get().Shutdown();
+    return result;
+}